@@ -0,0 +1,194 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/benchmark_utils.h
+///
+/// \details
+/// Helpers shared by the benchmark executables: a deterministic generator of
+/// random tree collections and a wall-clock timer.
+
+#pragma once
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+/// Generates a random tree in bracket notation.
+///
+/// The parent of every node is chosen uniformly among the previous
+/// max_fanout_window nodes in preorder. Labels are chosen uniformly from
+/// alphabet_size labels.
+///
+/// \param rd Random number generator.
+/// \param tree_size Number of nodes of the tree.
+/// \param alphabet_size Number of distinct labels.
+/// \param max_fanout_window Number of candidate parents of a node. Smaller
+///                          values result in deeper trees.
+/// \return A tree in bracket notation.
+std::string generate_random_tree(std::mt19937& rd, const int tree_size,
+    const int alphabet_size, const int max_fanout_window) {
+  // Children of every node. Nodes are created in preorder, hence a parent has
+  // always a smaller id than its children.
+  std::vector<std::vector<int>> children(tree_size);
+  std::vector<int> parent(tree_size, -1);
+  // Rightmost path of the tree built so far. A new node in preorder must be a
+  // child of a node on that path.
+  std::vector<int> rightmost_path = {0};
+  for (int i = 1; i < tree_size; ++i) {
+    int window = std::min(max_fanout_window,
+        static_cast<int>(rightmost_path.size()));
+    std::uniform_int_distribution<int> dist(0, window - 1);
+    int depth = static_cast<int>(rightmost_path.size()) - 1 - dist(rd);
+    int p = rightmost_path[depth];
+    rightmost_path.resize(depth + 1);
+    rightmost_path.push_back(i);
+    children[p].push_back(i);
+    parent[i] = p;
+  }
+  std::uniform_int_distribution<int> label_dist(0, alphabet_size - 1);
+  std::vector<int> labels(tree_size);
+  for (auto& l : labels) {
+    l = label_dist(rd);
+  }
+  // Emit the bracket notation. Nodes are in preorder, so a node's subtree
+  // is closed right before the next node that is not its descendant.
+  std::string tree;
+  std::vector<int> open;
+  for (int i = 0; i < tree_size; ++i) {
+    while (!open.empty() && open.back() != parent[i]) {
+      tree += "}";
+      open.pop_back();
+    }
+    tree += "{l" + std::to_string(labels[i]);
+    open.push_back(i);
+  }
+  tree += std::string(open.size(), '}');
+  return tree;
+}
+
+/// Generates a collection of random trees in bracket notation.
+///
+/// \param number_of_trees Number of trees in the collection.
+/// \param tree_size Number of nodes of every tree.
+/// \param seed Seed of the random number generator.
+/// \return Vector of trees in bracket notation.
+std::vector<std::string> generate_random_collection(const int number_of_trees,
+    const int tree_size, const unsigned int seed) {
+  std::mt19937 rd(seed);
+  std::vector<std::string> collection;
+  for (int i = 0; i < number_of_trees; ++i) {
+    collection.push_back(generate_random_tree(rd, tree_size, 16, 4));
+  }
+  return collection;
+}
+
+/// Generates a collection of random trees of different sizes.
+///
+/// \param number_of_trees Number of trees in the collection.
+/// \param min_tree_size Minimum number of nodes of a tree.
+/// \param max_tree_size Maximum number of nodes of a tree.
+/// \param seed Seed of the random number generator.
+/// \return Vector of trees in bracket notation.
+std::vector<std::string> generate_random_collection(const int number_of_trees,
+    const int min_tree_size, const int max_tree_size,
+    const unsigned int seed) {
+  std::mt19937 rd(seed);
+  std::uniform_int_distribution<int> size_dist(min_tree_size, max_tree_size);
+  std::vector<std::string> collection;
+  for (int i = 0; i < number_of_trees; ++i) {
+    collection.push_back(generate_random_tree(rd, size_dist(rd), 16, 4));
+  }
+  return collection;
+}
+
+/// Generates a random JSON document in bracket notation, i.e., objects with
+/// keys, arrays, and literals as produced by the JSON parser.
+///
+/// \param rd Random number generator.
+/// \param max_depth Maximum number of nested objects and arrays.
+/// \param max_fanout Maximum number of members of an object or array.
+/// \param alphabet_size Number of distinct keys and literals.
+/// \return A JSON tree in bracket notation.
+std::string generate_random_json_tree(std::mt19937& rd, const int max_depth,
+    const int max_fanout, const int alphabet_size) {
+  std::uniform_int_distribution<int> type_dist(0, 2);
+  std::uniform_int_distribution<int> fanout_dist(1, max_fanout);
+  std::uniform_int_distribution<int> label_dist(0, alphabet_size - 1);
+  // Literals at the maximum depth, otherwise literals, objects, or arrays.
+  int type = max_depth == 0 ? 0 : type_dist(rd);
+  if (type == 0) {
+    return "{" + std::to_string(label_dist(rd)) + "}";
+  }
+  std::string tree = type == 1 ? "{\\{\\}" : "{[]";
+  int fanout = fanout_dist(rd);
+  for (int i = 0; i < fanout; ++i) {
+    std::string value = generate_random_json_tree(rd, max_depth - 1,
+        max_fanout, alphabet_size);
+    if (type == 1) {
+      tree += "{\"k" + std::to_string(label_dist(rd)) + "\":" + value + "}";
+    } else {
+      tree += value;
+    }
+  }
+  return tree + "}";
+}
+
+/// Generates a collection of random JSON documents in bracket notation. The
+/// root of every document is an object.
+///
+/// \param number_of_trees Number of trees in the collection.
+/// \param max_depth Maximum number of nested objects and arrays.
+/// \param seed Seed of the random number generator.
+/// \return Vector of JSON trees in bracket notation.
+std::vector<std::string> generate_random_json_collection(
+    const int number_of_trees, const int max_depth, const unsigned int seed) {
+  std::mt19937 rd(seed);
+  std::vector<std::string> collection;
+  while ((int) collection.size() < number_of_trees) {
+    std::string tree = generate_random_json_tree(rd, max_depth, 4, 16);
+    if (tree.compare(0, 5, "{\\{\\}") == 0) {
+      collection.push_back(tree);
+    }
+  }
+  return collection;
+}
+
+/// Measures wall-clock time since its construction.
+class Timer {
+public:
+  /// Constructor. Starts the timer.
+  Timer() : start_(std::chrono::steady_clock::now()) {}
+  /// Returns the number of seconds since the construction.
+  ///
+  /// \return Elapsed time in seconds.
+  double get_seconds() const {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_).count();
+  }
+private:
+  /// Point in time of the construction.
+  std::chrono::steady_clock::time_point start_;
+};
+
+}
@@ -0,0 +1,124 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/binary_collection_benchmark.cc
+///
+/// \details
+/// Compares loading a collection from bracket notation with loading it from
+/// the binary collection format. For both formats, it measures the time to
+/// obtain the Node trees and the time to obtain a TreeIndexCollection. The
+/// collection is generated and written to output_file (text) and
+/// output_file.bin (binary) first.
+///
+/// Usage: binary_collection_benchmark [number_of_trees] [tree_size]
+///                                    [output_file]
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "string_label.h"
+#include "unit_cost_model.h"
+#include "bracket_notation_parser.h"
+#include "binary_collection.h"
+#include "tree_indexer.h"
+#include "tree_index_collection.h"
+
+using Label = label::StringLabel;
+using CostModel = cost_model::UnitCostModelLD<Label>;
+using TreeIndexCollection =
+    node::TreeIndexCollection<Label, node::TreeIndexAPTED>;
+
+int main(int argc, char** argv) {
+  int number_of_trees = argc > 1 ? std::stoi(argv[1]) : 20000;
+  int tree_size = argc > 2 ? std::stoi(argv[2]) : 200;
+  std::string file_path =
+      argc > 3 ? argv[3] : "binary_collection_benchmark_data.txt";
+  std::string binary_file_path = file_path + ".bin";
+
+  {
+    std::vector<std::string> trees = benchmark::generate_random_collection(
+        number_of_trees, tree_size, 1);
+    std::ofstream trees_file(file_path);
+    for (const auto& t : trees) {
+      trees_file << t << "\n";
+    }
+  }
+  {
+    std::vector<node::Node<Label>> trees_collection;
+    parser::BracketNotationParser<Label> bnp;
+    bnp.parse_collection(trees_collection, file_path);
+    parser::BinaryCollection<Label>::write(trees_collection, binary_file_path);
+  }
+
+  long long int nodes = 0;
+
+  benchmark::Timer text_trees_timer;
+  {
+    std::vector<node::Node<Label>> trees_collection;
+    parser::BracketNotationParser<Label> bnp;
+    bnp.parse_collection(trees_collection, file_path);
+    nodes += trees_collection.size();
+  }
+  std::cout << "text trees: " << text_trees_timer.get_seconds() * 1000
+      << " ms" << std::endl;
+
+  benchmark::Timer binary_trees_timer;
+  {
+    std::vector<node::Node<Label>> trees_collection;
+    parser::BinaryCollection<Label> binary_collection(binary_file_path);
+    binary_collection.get_trees(trees_collection);
+    nodes += trees_collection.size();
+  }
+  std::cout << "binary trees: " << binary_trees_timer.get_seconds() * 1000
+      << " ms" << std::endl;
+
+  benchmark::Timer text_index_timer;
+  {
+    std::vector<node::Node<Label>> trees_collection;
+    parser::BracketNotationParser<Label> bnp;
+    bnp.parse_collection(trees_collection, file_path);
+    TreeIndexCollection tree_indexes;
+    CostModel cm(tree_indexes.get_label_dictionary());
+    tree_indexes.build(trees_collection, cm);
+    nodes += tree_indexes.size();
+  }
+  std::cout << "text index collection: "
+      << text_index_timer.get_seconds() * 1000 << " ms" << std::endl;
+
+  benchmark::Timer binary_index_timer;
+  {
+    parser::BinaryCollection<Label> binary_collection(binary_file_path);
+    TreeIndexCollection tree_indexes;
+    CostModel cm(tree_indexes.get_label_dictionary());
+    binary_collection.build_indexes(tree_indexes, cm);
+    nodes += tree_indexes.size();
+  }
+  std::cout << "binary index collection: "
+      << binary_index_timer.get_seconds() * 1000 << " ms" << std::endl;
+
+  // Prevents the compiler from removing the computations.
+  std::cout << "trees: " << nodes << std::endl;
+
+  return 0;
+}
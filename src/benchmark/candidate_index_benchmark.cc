@@ -0,0 +1,172 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/candidate_index_benchmark.cc
+///
+/// \details
+/// Measures the candidate generation of TJoin, i.e., CandidateIndex::lookup
+/// called by TJoinTI::retrieve_candidates, with a single thread and with
+/// multiple threads on a random collection sorted by tree size, the latter
+/// also with compressed inverted lists. The candidate pairs of all have to
+/// be identical.
+///
+/// Then measures the candidate generation of TJoin, LHJoin, and BBJoin with
+/// uncompressed and with compressed inverted lists, and prints the bytes of
+/// the inverted lists. The candidate pairs have to be identical as well.
+///
+/// Usage: candidate_index_benchmark [number_of_trees] [tree_size] [threads]
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "string_label.h"
+#include "bracket_notation_parser.h"
+#include "unit_cost_model.h"
+#include "touzet_baseline_tree_index.h"
+#include "t_join_ti.h"
+#include "histogram_collection.h"
+#include "lh_join_ti.h"
+#include "bb_join_ti.h"
+
+using Label = label::StringLabel;
+using CostModel = cost_model::UnitCostModelLD<Label>;
+using TJoin = join::TJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>>;
+
+void print_lists(const std::string& name, const double seconds,
+    const std::size_t candidates, const std::size_t il_bytes) {
+  std::cout << "  " << name << ": " << seconds << " s, " << candidates
+      << " candidates, " << il_bytes << " list bytes" << std::endl;
+}
+
+/// Retrieves the candidates of a histogram join with uncompressed and with
+/// compressed inverted lists. Returns false if they differ.
+template <typename Join>
+bool compare_histogram_lists(const std::string& name,
+    std::vector<node::Node<Label>>& trees_collection,
+    const double distance_threshold) {
+  std::vector<std::pair<int, int>> candidates[2];
+  for (const bool compress : {false, true}) {
+    Join join_algorithm;
+    join_algorithm.set_candidate_index_compression(compress);
+    data_structures::HistogramCollection histograms;
+    join_algorithm.convert_trees_to_histograms(trees_collection, histograms);
+    benchmark::Timer timer;
+    join_algorithm.retrieve_candidates(histograms, candidates[compress],
+        distance_threshold);
+    print_lists(name + (compress ? " compressed" : ""), timer.get_seconds(),
+        candidates[compress].size(), join_algorithm.get_number_of_il_bytes());
+  }
+  return candidates[0] == candidates[1];
+}
+
+int main(int argc, char** argv) {
+  int number_of_trees = argc > 1 ? std::stoi(argv[1]) : 5000;
+  int tree_size = argc > 2 ? std::stoi(argv[2]) : 20;
+  int threads = argc > 3 ? std::stoi(argv[3]) : 0;
+
+  // The candidate index expects the sets in ascending size.
+  parser::BracketNotationParser<Label> bnp;
+  std::vector<node::Node<Label>> trees_collection;
+  for (const auto& t : benchmark::generate_random_collection(
+      number_of_trees, tree_size / 2, tree_size * 3 / 2, 1)) {
+    trees_collection.push_back(bnp.parse_single(t));
+  }
+  std::stable_sort(trees_collection.begin(), trees_collection.end(),
+      [](const node::Node<Label>& a, const node::Node<Label>& b) {
+        return a.get_tree_size() < b.get_tree_size();
+      });
+
+  std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> sets_collection;
+  TJoin serial_join;
+  serial_join.convert_trees_to_sets(trees_collection, sets_collection);
+  std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> parallel_sets_collection;
+  TJoin parallel_join(threads);
+  parallel_join.convert_trees_to_sets(trees_collection,
+      parallel_sets_collection);
+
+  for (double distance_threshold : {1.0, 3.0, 5.0, 10.0}) {
+    std::cout << "threshold " << distance_threshold << std::endl;
+    std::vector<std::pair<int, int>> candidates;
+    benchmark::Timer timer;
+    serial_join.retrieve_candidates(sets_collection, candidates,
+        distance_threshold);
+    std::cout << "  1 thread: " << timer.get_seconds() << " s, "
+        << candidates.size() << " candidates, "
+        << serial_join.get_number_of_il_lookups() << " lookups" << std::endl;
+
+    std::vector<std::pair<int, int>> parallel_candidates;
+    benchmark::Timer parallel_timer;
+    parallel_join.retrieve_candidates(parallel_sets_collection,
+        parallel_candidates, distance_threshold);
+    std::cout << "  parallel: " << parallel_timer.get_seconds() << " s, "
+        << parallel_candidates.size() << " candidates, "
+        << parallel_join.get_number_of_il_lookups() << " lookups"
+        << std::endl;
+
+    // The parallel probing starts compressed lists at their skip table.
+    std::vector<std::pair<int, int>> compressed_candidates;
+    parallel_join.set_candidate_index_compression(true);
+    benchmark::Timer compressed_timer;
+    parallel_join.retrieve_candidates(parallel_sets_collection,
+        compressed_candidates, distance_threshold);
+    std::cout << "  parallel compressed: " << compressed_timer.get_seconds()
+        << " s, " << compressed_candidates.size() << " candidates, "
+        << parallel_join.get_number_of_il_lookups() << " lookups"
+        << std::endl;
+    parallel_join.set_candidate_index_compression(false);
+    if (parallel_candidates != candidates ||
+        compressed_candidates != candidates) {
+      std::cerr << "Different candidates for threshold "
+          << distance_threshold << "." << std::endl;
+      return -1;
+    }
+  }
+
+  for (double distance_threshold : {1.0, 3.0, 5.0, 10.0}) {
+    std::cout << "inverted lists, threshold " << distance_threshold
+        << std::endl;
+    std::vector<std::pair<int, int>> candidates[2];
+    for (const bool compress : {false, true}) {
+      serial_join.set_candidate_index_compression(compress);
+      benchmark::Timer timer;
+      serial_join.retrieve_candidates(sets_collection, candidates[compress],
+          distance_threshold);
+      print_lists(compress ? "TJoin compressed" : "TJoin", timer.get_seconds(),
+          candidates[compress].size(), serial_join.get_number_of_il_bytes());
+    }
+    if (candidates[0] != candidates[1] ||
+        !compare_histogram_lists<join::LHJoinTI<Label,
+            ted::TouzetBaselineTreeIndex<CostModel>>>("LHJoin",
+            trees_collection, distance_threshold) ||
+        !compare_histogram_lists<join::BBJoinTI<Label,
+            ted::TouzetBaselineTreeIndex<CostModel>>>("BBJoin",
+            trees_collection, distance_threshold)) {
+      std::cerr << "Different candidates with compressed lists for threshold "
+          << distance_threshold << "." << std::endl;
+      return -1;
+    }
+  }
+
+  return 0;
+}
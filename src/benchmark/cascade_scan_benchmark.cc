@@ -0,0 +1,105 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/cascade_scan_benchmark.cc
+///
+/// \details
+/// Compares VerificationUBkScan with CascadeScan on random JSON documents.
+/// Both use JOFilter as the upper bound and QuickJEDI as the verification.
+/// Prints the time per query and the number of trees every stage of the
+/// cascade pruned, accepted, or verified.
+///
+/// Usage: cascade_scan_benchmark [number_of_trees] [queries] [threads]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "json_label.h"
+#include "unit_cost_model.h"
+#include "bracket_notation_parser.h"
+#include "tree_index_collection.h"
+#include "quickjedi_index.h"
+#include "jofilter_index.h"
+#include "scan.h"
+#include "cascade_scan.h"
+
+using Label = label::JSONLabel;
+using CostModel = cost_model::UnitCostModelJSON<Label>;
+using QUICKJEDI = json::QuickJEDITreeIndex<CostModel>;
+using JOFILTER = json::JOFilterTreeIndex<CostModel>;
+
+int main(int argc, char** argv) {
+  int number_of_trees = argc > 1 ? std::stoi(argv[1]) : 2000;
+  int queries = argc > 2 ? std::stoi(argv[2]) : 5;
+  int threads = argc > 3 ? std::stoi(argv[3]) : 0;
+
+  parser::BracketNotationParser<Label> bnp;
+  std::vector<node::Node<Label>> trees_collection;
+  for (const auto& t : benchmark::generate_random_json_collection(
+      number_of_trees, 4, 1)) {
+    trees_collection.push_back(bnp.parse_single(t));
+  }
+  node::TreeIndexCollection<Label, QUICKJEDI::AlgsTreeIndex> indexed_collection;
+  CostModel ucm(indexed_collection.get_label_dictionary());
+  indexed_collection.build(trees_collection, ucm);
+
+  for (double distance_threshold : {1.0, 3.0, 5.0}) {
+    std::cout << "threshold " << distance_threshold << std::endl;
+    lookup::VerificationUBkScan<Label, QUICKJEDI, JOFILTER> scan;
+    long long int scan_results = 0;
+    benchmark::Timer scan_timer;
+    for (int q = 0; q < queries; ++q) {
+      scan_results += scan.execute_lookup(indexed_collection, q,
+          distance_threshold).size();
+    }
+    std::cout << "  VerificationUBkScan: "
+        << scan_timer.get_seconds() / queries * 1e3 << " ms/query, "
+        << scan_results << " results" << std::endl;
+
+    lookup::CascadeScan<Label, QUICKJEDI, JOFILTER> cascade_scan(threads);
+    long long int cascade_results = 0;
+    benchmark::Timer cascade_timer;
+    for (int q = 0; q < queries; ++q) {
+      cascade_results += cascade_scan.execute_lookup(indexed_collection, q,
+          distance_threshold).size();
+    }
+    std::cout << "  CascadeScan: "
+        << cascade_timer.get_seconds() / queries * 1e3 << " ms/query, "
+        << cascade_results << " results" << std::endl;
+    const lookup::CascadeStatistics& s = cascade_scan.get_statistics();
+    std::cout << "    candidates " << s.candidates
+        << ", size pruned " << s.size_pruned
+        << ", label intersection pruned " << s.label_intersection_pruned
+        << ", upper bound accepted " << s.upper_bound_accepted
+        << ", verified " << s.verifications
+        << ", verification accepted " << s.verification_accepted
+        << std::endl;
+    if (scan_results != cascade_results) {
+      std::cerr << "Different results for threshold " << distance_threshold
+          << "." << std::endl;
+      return -1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/guha_metric_benchmark.cc
+///
+/// \details
+/// Compares evaluating the metric bounds of GuhaJoinTI for every pair with
+/// GuhaJoinTI::retrieve_metric_candidates, with and without the pivot table.
+/// The TED vectors are computed once, with the given number of threads, for a
+/// random collection and a random reference set. Prints the run times and the numbers of candidates and
+/// result pairs, which have to be equal.
+///
+/// Usage: guha_metric_benchmark [number_of_trees] [tree_size]
+///        [reference_set_size] [threads]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "string_label.h"
+#include "bracket_notation_parser.h"
+#include "unit_cost_model.h"
+#include "touzet_baseline_tree_index.h"
+#include "guha_join_ti.h"
+
+using Label = label::StringLabel;
+using CostModel = cost_model::UnitCostModelLD<Label>;
+using GuhaJoin = join::GuhaJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>>;
+
+int main(int argc, char** argv) {
+  int number_of_trees = argc > 1 ? std::stoi(argv[1]) : 5000;
+  int tree_size = argc > 2 ? std::stoi(argv[2]) : 20;
+  int reference_set_size = argc > 3 ? std::stoi(argv[3]) : 8;
+  int threads = argc > 4 ? std::stoi(argv[4]) : 0;
+
+  parser::BracketNotationParser<Label> bnp;
+  std::vector<node::Node<Label>> trees_collection;
+  for (const auto& t : benchmark::generate_random_collection(
+      number_of_trees, tree_size / 2, tree_size * 3 / 2, 1)) {
+    trees_collection.push_back(bnp.parse_single(t));
+  }
+
+  node::TreeIndexCollection<Label, GuhaJoin::JoinTreeIndex> indexed_collection;
+  CostModel cm(indexed_collection.get_label_dictionary());
+  indexed_collection.build(trees_collection, cm);
+
+  GuhaJoin vector_algorithm(threads);
+  std::vector<int> reference_set = vector_algorithm.get_random_reference_set(
+      indexed_collection, reference_set_size);
+  data_structures::Matrix<double> ted_vectors(indexed_collection.size(),
+      reference_set.size());
+  benchmark::Timer vector_timer;
+  vector_algorithm.compute_vectors(indexed_collection, reference_set,
+      ted_vectors);
+  std::cout << "compute_vectors: " << vector_timer.get_seconds() << " s"
+      << std::endl;
+
+  std::vector<std::vector<double>> ted_rows(indexed_collection.size());
+  for (std::size_t t = 0; t < indexed_collection.size(); ++t) {
+    for (std::size_t l = 0; l < reference_set.size(); ++l) {
+      ted_rows[t].push_back(ted_vectors.read_at(t, l));
+    }
+  }
+
+  for (double distance_threshold : {2.0, 5.0, 10.0}) {
+    std::cout << "threshold " << distance_threshold << std::endl;
+
+    // Evaluate l_t and u_t for every pair of rows.
+    GuhaJoin pair_algorithm;
+    std::vector<std::pair<int, int>> pair_candidates;
+    std::vector<join::JoinResultElement> pair_result;
+    benchmark::Timer pair_timer;
+    for (int v1 = 0; v1 < (int)ted_rows.size(); ++v1) {
+      for (int v2 = v1 + 1; v2 < (int)ted_rows.size(); ++v2) {
+        if (pair_algorithm.l_t(ted_rows[v1], ted_rows[v2]) <= distance_threshold) {
+          double pair_u_t = pair_algorithm.u_t(ted_rows[v1], ted_rows[v2]);
+          if (pair_u_t <= distance_threshold) {
+            pair_result.emplace_back(v1, v2, pair_u_t);
+          } else {
+            pair_candidates.push_back({v1, v2});
+          }
+        }
+      }
+    }
+    std::cout << "  every pair: " << pair_timer.get_seconds() << " s, "
+        << pair_candidates.size() << " candidates, " << pair_result.size()
+        << " results" << std::endl;
+
+    for (bool use_pivot_table : {false, true}) {
+      GuhaJoin join_algorithm(threads, use_pivot_table);
+      std::vector<std::pair<int, int>> candidates;
+      std::vector<join::JoinResultElement> join_result;
+      benchmark::Timer timer;
+      join_algorithm.retrieve_metric_candidates(candidates, join_result,
+          distance_threshold, ted_vectors);
+      std::cout << "  retrieve_metric_candidates"
+          << (use_pivot_table ? " with pivot table: " : ": ")
+          << timer.get_seconds() << " s, " << candidates.size()
+          << " candidates, " << join_result.size() << " results" << std::endl;
+      if (candidates.size() != pair_candidates.size() ||
+          join_result.size() != pair_result.size()) {
+        std::cerr << "Different candidates for threshold "
+            << distance_threshold << "." << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
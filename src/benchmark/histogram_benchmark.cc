@@ -0,0 +1,202 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/histogram_benchmark.cc
+///
+/// \details
+/// Measures the histogram joins on the join test datasets, or on the given
+/// files. The label histograms of all trees are copied into hash maps, the
+/// representation the histogram joins used before. Then all pairwise
+/// histogram intersections are computed with hash lookups and with the merge
+/// of the sorted arrays. Next, LHJoin, DHJoin, LDHJoin, BBJoin, and HJoin are
+/// run at a few thresholds. Prints the run times, the memory of both
+/// histogram representations, and the numbers of candidates and results.
+///
+/// Usage: histogram_benchmark [dataset_file ...]
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "string_label.h"
+#include "bracket_notation_parser.h"
+#include "unit_cost_model.h"
+#include "touzet_baseline_tree_index.h"
+#include "histogram_collection.h"
+#include "lh_join_ti.h"
+#include "dh_join_ti.h"
+#include "ldh_join_ti.h"
+#include "bb_join_ti.h"
+#include "histo_join_ti.h"
+
+using Label = label::StringLabel;
+using CostModel = cost_model::UnitCostModelLD<Label>;
+using Verification = ted::TouzetBaselineTreeIndex<CostModel>;
+
+void print_join(const std::string& name, const double seconds,
+    const std::size_t candidates, const std::size_t results) {
+  std::cout << "    " << name << ": " << seconds << " s, " << candidates
+      << " candidates, " << results << " results" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  std::vector<std::string> file_names;
+  for (int i = 1; i < argc; ++i) {
+    file_names.push_back(argv[i]);
+  }
+  if (file_names.empty()) {
+    for (const std::string size : {"20", "129", "299"}) {
+      file_names.push_back(std::string(JOIN_TEST_DATA_DIR) +
+          "/join_test_data_" + size + ".txt");
+    }
+  }
+
+  for (const auto& file_name : file_names) {
+    parser::BracketNotationParser<Label> bnp;
+    std::vector<node::Node<Label>> trees_collection;
+    bnp.parse_collection(trees_collection, file_name);
+    std::cout << file_name << ": " << trees_collection.size() << " trees"
+        << std::endl;
+
+    // Sorted arrays, as produced by the converters.
+    data_structures::HistogramCollection histogram_collection;
+    label_histogram_converter::Converter<Label> lhc;
+    benchmark::Timer convert_timer;
+    lhc.create_histogram(trees_collection, histogram_collection);
+    std::cout << "  label histograms: " << convert_timer.get_seconds()
+        << " s, " << histogram_collection.get_number_of_elements()
+        << " elements, " << histogram_collection.get_memory_usage()
+        << " bytes" << std::endl;
+
+    // Hash maps with the same content. The memory is an estimate of the
+    // buckets and the nodes, without allocator overhead.
+    std::vector<std::unordered_map<int, int>> hash_histograms(
+        histogram_collection.size());
+    std::size_t hash_memory = hash_histograms.capacity() *
+        sizeof(std::unordered_map<int, int>);
+    for (std::size_t t = 0; t < histogram_collection.size(); ++t) {
+      for (auto element = histogram_collection.begin(t);
+          element != histogram_collection.end(t); ++element) {
+        hash_histograms[t][element->key] = element->count;
+      }
+      hash_memory += hash_histograms[t].bucket_count() * sizeof(void*) +
+          hash_histograms[t].size() *
+          (sizeof(std::pair<const int, int>) + sizeof(void*));
+    }
+    std::cout << "  hash map histograms: about " << hash_memory << " bytes"
+        << std::endl;
+
+    long long int hash_sum = 0;
+    benchmark::Timer hash_timer;
+    for (std::size_t t_1 = 0; t_1 < hash_histograms.size(); ++t_1) {
+      for (std::size_t t_2 = t_1 + 1; t_2 < hash_histograms.size(); ++t_2) {
+        for (const auto& element : hash_histograms[t_1]) {
+          auto other = hash_histograms[t_2].find(element.first);
+          if (other != hash_histograms[t_2].end()) {
+            hash_sum += std::min(element.second, other->second);
+          }
+        }
+      }
+    }
+    std::cout << "  all-pairs intersection with hash lookups: "
+        << hash_timer.get_seconds() << " s" << std::endl;
+
+    long long int merge_sum = 0;
+    benchmark::Timer merge_timer;
+    for (std::size_t t_1 = 0; t_1 < histogram_collection.size(); ++t_1) {
+      for (std::size_t t_2 = t_1 + 1; t_2 < histogram_collection.size(); ++t_2) {
+        merge_sum += histogram_collection.get_intersection(t_1, t_2);
+      }
+    }
+    std::cout << "  all-pairs intersection with merges: "
+        << merge_timer.get_seconds() << " s" << std::endl;
+    if (hash_sum != merge_sum) {
+      std::cerr << "Different intersections." << std::endl;
+      return -1;
+    }
+
+    for (double distance_threshold : {1.0, 5.0, 10.0}) {
+      std::cout << "  threshold " << distance_threshold << std::endl;
+      {
+        data_structures::HistogramCollection histograms;
+        std::vector<std::pair<int, int>> candidates;
+        std::vector<join::JoinResultElement> join_result;
+        join::LHJoinTI<Label, Verification> join_algorithm;
+        benchmark::Timer timer;
+        join_algorithm.execute_join(trees_collection, histograms, candidates,
+            join_result, distance_threshold);
+        print_join("LHJoin", timer.get_seconds(), candidates.size(),
+            join_result.size());
+      }
+      {
+        data_structures::HistogramCollection histograms;
+        std::vector<std::pair<int, int>> candidates;
+        std::vector<join::JoinResultElement> join_result;
+        join::DHJoinTI<Label, Verification> join_algorithm;
+        benchmark::Timer timer;
+        join_algorithm.execute_join(trees_collection, histograms, candidates,
+            join_result, distance_threshold);
+        print_join("DHJoin", timer.get_seconds(), candidates.size(),
+            join_result.size());
+      }
+      {
+        data_structures::HistogramCollection histograms;
+        std::vector<std::pair<int, int>> candidates;
+        std::vector<join::JoinResultElement> join_result;
+        join::LDHJoinTI<Label, Verification> join_algorithm;
+        benchmark::Timer timer;
+        join_algorithm.execute_join(trees_collection, histograms, candidates,
+            join_result, distance_threshold);
+        print_join("LDHJoin", timer.get_seconds(), candidates.size(),
+            join_result.size());
+      }
+      {
+        data_structures::HistogramCollection histograms;
+        std::vector<std::pair<int, int>> candidates;
+        std::vector<join::JoinResultElement> join_result;
+        join::BBJoinTI<Label, Verification> join_algorithm;
+        benchmark::Timer timer;
+        join_algorithm.execute_join(trees_collection, histograms, candidates,
+            join_result, distance_threshold);
+        print_join("BBJoin", timer.get_seconds(), candidates.size(),
+            join_result.size());
+      }
+      {
+        data_structures::HistogramCollection label_histograms;
+        data_structures::HistogramCollection degree_histograms;
+        data_structures::HistogramCollection leaf_distance_histograms;
+        std::vector<std::pair<int, int>> candidates;
+        std::vector<join::JoinResultElement> join_result;
+        join::HJoinTI<Label, Verification> join_algorithm;
+        benchmark::Timer timer;
+        join_algorithm.execute_join(trees_collection, label_histograms,
+            degree_histograms, leaf_distance_histograms, candidates,
+            join_result, distance_threshold);
+        print_join("HJoin", timer.get_seconds(), candidates.size(),
+            join_result.size());
+      }
+    }
+  }
+
+  return 0;
+}
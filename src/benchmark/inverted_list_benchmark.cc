@@ -0,0 +1,169 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/inverted_list_benchmark.cc
+///
+/// \details
+/// Compares the lookup latency of the flat TwoStageInvertedList with the
+/// map-based TwoStageInvertedListMap. Every tree of a random collection is a
+/// query; the prefix of its label set is looked up as in
+/// VerificationIndex::execute_lookup. The candidate sets of both indexes are
+/// checked to be identical. The same queries are also answered at once with
+/// retrieve_batch_candidates and by a TwoStageInvertedList with compressed
+/// postings, whose memory usage is printed next to the uncompressed one.
+///
+/// Usage: inverted_list_benchmark [number_of_trees] [tree_size] [repetitions]
+
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "string_label.h"
+#include "bracket_notation_parser.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+#include "two_stage_inverted_list_map.h"
+#include "batch_lookup.h"
+
+using Label = label::StringLabel;
+using SetsCollection = std::vector<std::pair<int,
+    std::vector<label_set_converter_index::LabelSetElement>>>;
+
+/// Looks up the prefix of every set in index and returns the candidates of
+/// every query.
+template <typename Index>
+std::vector<std::unordered_set<long int>> lookup_all(Index& index,
+    SetsCollection& sets_collection, const double distance_threshold) {
+  std::vector<std::unordered_set<long int>> all_candidates(
+      sets_collection.size());
+  for (std::size_t q = 0; q < sets_collection.size(); ++q) {
+    auto& set = sets_collection[q];
+    long int prefix = std::min((int) set.second.size() - 1,
+        (int) distance_threshold + 1);
+    for (long int pos = 0; pos <= prefix; pos++) {
+      index.lookup(set.second[pos].id, set.second[pos].descendants,
+          set.second[pos].ancestors, set.first, all_candidates[q],
+          distance_threshold);
+    }
+  }
+  return all_candidates;
+}
+
+/// Runs all queries repetitions times and prints the latency per query.
+template <typename Index>
+std::vector<std::unordered_set<long int>> benchmark_lookup(
+    const std::string& name, Index& index, SetsCollection& sets_collection,
+    const double distance_threshold, const int repetitions) {
+  std::vector<std::unordered_set<long int>> all_candidates;
+  long long int nr_of_candidates = 0;
+  benchmark::Timer timer;
+  for (int r = 0; r < repetitions; ++r) {
+    all_candidates = lookup_all(index, sets_collection, distance_threshold);
+  }
+  double seconds = timer.get_seconds();
+  for (const auto& c : all_candidates) {
+    nr_of_candidates += c.size();
+  }
+  std::cout << "  " << name << ": "
+      << seconds / repetitions / sets_collection.size() * 1e6
+      << " us/query, " << nr_of_candidates << " candidates" << std::endl;
+  return all_candidates;
+}
+
+int main(int argc, char** argv) {
+  int number_of_trees = argc > 1 ? std::stoi(argv[1]) : 5000;
+  int tree_size = argc > 2 ? std::stoi(argv[2]) : 50;
+  int repetitions = argc > 3 ? std::stoi(argv[3]) : 5;
+
+  parser::BracketNotationParser<Label> bnp;
+  std::vector<node::Node<Label>> trees_collection;
+  for (const auto& t : benchmark::generate_random_collection(
+      number_of_trees, tree_size / 2, tree_size * 3 / 2, 1)) {
+    trees_collection.push_back(bnp.parse_single(t));
+  }
+
+  SetsCollection sets_collection;
+  std::vector<std::pair<int, int>> size_setid_map;
+  label_set_converter_index::Converter<Label> lsc;
+  lsc.assignFrequencyIdentifiers(trees_collection, sets_collection,
+      size_setid_map);
+
+  benchmark::Timer map_build_timer;
+  lookup::TwoStageInvertedListMap map_index(lsc.get_number_of_labels());
+  map_index.build(sets_collection);
+  std::cout << "build TwoStageInvertedListMap: "
+      << map_build_timer.get_seconds() << " s" << std::endl;
+  benchmark::Timer build_timer;
+  lookup::TwoStageInvertedList index(lsc.get_number_of_labels());
+  index.build(sets_collection);
+  std::cout << "build TwoStageInvertedList: " << build_timer.get_seconds()
+      << " s, " << index.get_memory_usage() << " bytes" << std::endl;
+  benchmark::Timer compressed_build_timer;
+  lookup::TwoStageInvertedList compressed_index(lsc.get_number_of_labels(),
+      true);
+  compressed_index.build(sets_collection);
+  std::cout << "build compressed TwoStageInvertedList: "
+      << compressed_build_timer.get_seconds() << " s, "
+      << compressed_index.get_memory_usage() << " bytes" << std::endl;
+
+  for (double distance_threshold : {1.0, 3.0, 5.0, 10.0}) {
+    std::cout << "threshold " << distance_threshold << std::endl;
+    auto map_candidates = benchmark_lookup("TwoStageInvertedListMap",
+        map_index, sets_collection, distance_threshold, repetitions);
+    auto candidates = benchmark_lookup("TwoStageInvertedList", index,
+        sets_collection, distance_threshold, repetitions);
+    auto compressed_candidates = benchmark_lookup(
+        "compressed TwoStageInvertedList", compressed_index, sets_collection,
+        distance_threshold, repetitions);
+    if (map_candidates != candidates || compressed_candidates != candidates) {
+      std::cerr << "Different candidates for threshold "
+          << distance_threshold << "." << std::endl;
+      return -1;
+    }
+
+    std::vector<unsigned int> query_tree_ids(sets_collection.size());
+    for (unsigned int q = 0; q < query_tree_ids.size(); ++q) {
+      query_tree_ids[q] = q;
+    }
+    std::vector<std::pair<unsigned int, long int>> batch_candidates;
+    benchmark::Timer batch_timer;
+    for (int r = 0; r < repetitions; ++r) {
+      batch_candidates.clear();
+      lookup::retrieve_batch_candidates(sets_collection, size_setid_map,
+          index, query_tree_ids, distance_threshold, batch_candidates);
+    }
+    std::cout << "  retrieve_batch_candidates: "
+        << batch_timer.get_seconds() / repetitions / query_tree_ids.size() * 1e6
+        << " us/query, " << batch_candidates.size() << " candidates"
+        << std::endl;
+    for (const auto& c : batch_candidates) {
+      if (candidates[c.first].count(c.second) == 0) {
+        std::cerr << "Different batch candidates for threshold "
+            << distance_threshold << "." << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
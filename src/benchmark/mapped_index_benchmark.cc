@@ -0,0 +1,143 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/mapped_index_benchmark.cc
+///
+/// \details
+/// Compares the startup time of a candidate index built from a binary
+/// collection with the startup time of a mapped index file. Building loads
+/// the trees, converts them into label sets, and builds the
+/// TwoStageInvertedList. Mapping only checks the header and the section
+/// bounds of the index file written by MappedIndex::write. Both are followed by the same queries; the
+/// time of the first queries includes reading the touched pages of the
+/// mapped file. The candidates of both are checked to be identical.
+///
+/// Usage: mapped_index_benchmark [number_of_trees] [tree_size]
+///                               [number_of_queries] [output_file]
+
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "string_label.h"
+#include "bracket_notation_parser.h"
+#include "binary_collection.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+#include "mapped_index.h"
+
+using Label = label::StringLabel;
+using SetsCollection = std::vector<std::pair<int,
+    std::vector<label_set_converter_index::LabelSetElement>>>;
+
+int main(int argc, char** argv) {
+  int number_of_trees = argc > 1 ? std::stoi(argv[1]) : 20000;
+  int tree_size = argc > 2 ? std::stoi(argv[2]) : 100;
+  int number_of_queries = argc > 3 ? std::stoi(argv[3]) : 100;
+  std::string file_path =
+      argc > 4 ? argv[4] : "mapped_index_benchmark_data.bin";
+  std::string index_file_path = file_path + ".idx";
+  const double distance_threshold = 5.0;
+
+  {
+    parser::BracketNotationParser<Label> bnp;
+    std::vector<node::Node<Label>> trees_collection;
+    for (const auto& t : benchmark::generate_random_collection(
+        number_of_trees, tree_size / 2, tree_size * 3 / 2, 1)) {
+      trees_collection.push_back(bnp.parse_single(t));
+    }
+    parser::BinaryCollection<Label>::write(trees_collection, file_path);
+  }
+
+  // Startup by building the index from the binary collection.
+  std::vector<std::unordered_set<long int>> built_candidates(
+      number_of_queries);
+  {
+    benchmark::Timer build_timer;
+    std::vector<node::Node<Label>> trees_collection;
+    parser::BinaryCollection<Label>(file_path).get_trees(trees_collection);
+    SetsCollection sets_collection;
+    std::vector<std::pair<int, int>> size_setid_map;
+    label_set_converter_index::Converter<Label> lsc;
+    lsc.assignFrequencyIdentifiers(trees_collection, sets_collection,
+        size_setid_map);
+    lookup::TwoStageInvertedList index(lsc.get_number_of_labels());
+    index.build(sets_collection);
+    double build_seconds = build_timer.get_seconds();
+
+    benchmark::Timer query_timer;
+    for (int q = 0; q < number_of_queries; ++q) {
+      auto& set = sets_collection[q % sets_collection.size()];
+      long int prefix = std::min((int) set.second.size() - 1,
+          (int) distance_threshold + 1);
+      for (long int pos = 0; pos <= prefix; pos++) {
+        index.lookup(set.second[pos].id, set.second[pos].descendants,
+            set.second[pos].ancestors, set.first, built_candidates[q],
+            distance_threshold);
+      }
+    }
+    double query_seconds = query_timer.get_seconds();
+    std::cout << "build index: " << build_seconds << " s, "
+        << number_of_queries << " queries: " << query_seconds * 1e3 << " ms"
+        << std::endl;
+
+    benchmark::Timer write_timer;
+    lookup::MappedIndex::write(index, sets_collection, size_setid_map,
+        index_file_path);
+    std::cout << "write index file: " << write_timer.get_seconds() << " s"
+        << std::endl;
+  }
+
+  // Startup by mapping the index file.
+  std::vector<std::unordered_set<long int>> mapped_candidates(
+      number_of_queries);
+  {
+    benchmark::Timer map_timer;
+    lookup::MappedIndex mapped_index(index_file_path);
+    double map_seconds = map_timer.get_seconds();
+
+    benchmark::Timer query_timer;
+    for (int q = 0; q < number_of_queries; ++q) {
+      std::size_t set_id = q % mapped_index.get_number_of_sets();
+      const auto* elements = mapped_index.get_set_elements(set_id);
+      long int prefix = std::min((int) mapped_index.get_set_size(set_id) - 1,
+          (int) distance_threshold + 1);
+      for (long int pos = 0; pos <= prefix; pos++) {
+        mapped_index.lookup(elements[pos].id, elements[pos].descendants,
+            elements[pos].ancestors, mapped_index.get_tree_size(set_id),
+            mapped_candidates[q], distance_threshold);
+      }
+    }
+    double query_seconds = query_timer.get_seconds();
+    std::cout << "map index file: " << map_seconds << " s, "
+        << number_of_queries << " queries: " << query_seconds * 1e3 << " ms"
+        << std::endl;
+  }
+
+  if (built_candidates != mapped_candidates) {
+    std::cerr << "Different candidates of the mapped index." << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
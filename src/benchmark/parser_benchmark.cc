@@ -0,0 +1,93 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/parser_benchmark.cc
+///
+/// \details
+/// Measures the throughput of the bracket notation parser in MB/s, both for
+/// trees in memory (parse_single) and for a collection file
+/// (parse_collection on one and on number_of_threads threads). The collection
+/// is generated and written to output_file first.
+///
+/// Usage: parser_benchmark [number_of_trees] [tree_size] [output_file]
+///                         [number_of_threads]
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "string_label.h"
+#include "bracket_notation_parser.h"
+
+using Label = label::StringLabel;
+
+int main(int argc, char** argv) {
+  int number_of_trees = argc > 1 ? std::stoi(argv[1]) : 20000;
+  int tree_size = argc > 2 ? std::stoi(argv[2]) : 200;
+  std::string file_path = argc > 3 ? argv[3] : "parser_benchmark_data.txt";
+  int number_of_threads = argc > 4 ? std::stoi(argv[4]) : 0;
+
+  std::vector<std::string> trees = benchmark::generate_random_collection(
+      number_of_trees, tree_size, 1);
+  double megabytes = 0;
+  {
+    std::ofstream trees_file(file_path);
+    for (const auto& t : trees) {
+      trees_file << t << "\n";
+      megabytes += (t.size() + 1) / 1e6;
+    }
+  }
+
+  parser::BracketNotationParser<Label> bnp;
+  long long int nodes = 0;
+  benchmark::Timer single_timer;
+  for (const auto& t : trees) {
+    nodes += bnp.parse_single(t).get_tree_size();
+  }
+  std::cout << "parse_single: " << megabytes / single_timer.get_seconds()
+      << " MB/s" << std::endl;
+
+  std::vector<node::Node<Label>> trees_collection;
+  benchmark::Timer collection_timer;
+  bnp.parse_collection(trees_collection, file_path);
+  std::cout << "parse_collection: "
+      << megabytes / collection_timer.get_seconds() << " MB/s" << std::endl;
+
+  std::vector<node::Node<Label>> parallel_trees_collection;
+  benchmark::Timer parallel_timer;
+  bnp.parse_collection(parallel_trees_collection, file_path, number_of_threads);
+  std::cout << "parse_collection ("
+      << parallel::get_number_of_threads(number_of_threads) << " threads): "
+      << megabytes / parallel_timer.get_seconds() << " MB/s" << std::endl;
+
+  for (const auto& t : trees_collection) {
+    nodes += t.get_tree_size();
+  }
+  for (const auto& t : parallel_trees_collection) {
+    nodes += t.get_tree_size();
+  }
+  // Prevents the compiler from removing the computations.
+  std::cout << "nodes: " << nodes << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/shared_index_benchmark.cc
+///
+/// \details
+/// Measures the throughput of a SharedIndex that several threads query at
+/// once. Every thread claims the next query tree from a shared counter and
+/// collects its counters in its own LookupStatistics. Prints the queries per
+/// second for 1, 2, 4, ... threads up to max_threads; the number of results
+/// and the summed counters have to be the same for all thread counts.
+///
+/// Usage: shared_index_benchmark [number_of_trees] [queries] [max_threads]
+///                               [threshold]
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "json_label.h"
+#include "unit_cost_model.h"
+#include "bracket_notation_parser.h"
+#include "tree_index_collection.h"
+#include "quickjedi_index.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+#include "shared_index.h"
+#include "parallel_for.h"
+
+using Label = label::JSONLabel;
+using CostModel = cost_model::UnitCostModelJSON<Label>;
+using QUICKJEDI = json::QuickJEDITreeIndex<CostModel>;
+
+int main(int argc, char** argv) {
+  int number_of_trees = argc > 1 ? std::stoi(argv[1]) : 5000;
+  int queries = argc > 2 ? std::stoi(argv[2]) : 2000;
+  int max_threads = argc > 3 ? std::stoi(argv[3]) : 0;
+  double distance_threshold = argc > 4 ? std::stod(argv[4]) : 3.0;
+  max_threads = parallel::get_number_of_threads(max_threads);
+
+  parser::BracketNotationParser<Label> bnp;
+  std::vector<node::Node<Label>> trees_collection;
+  for (const auto& t : benchmark::generate_random_json_collection(
+      number_of_trees, 4, 1)) {
+    trees_collection.push_back(bnp.parse_single(t));
+  }
+  node::TreeIndexCollection<Label, QUICKJEDI::AlgsTreeIndex> indexed_collection;
+  CostModel ucm(indexed_collection.get_label_dictionary());
+  indexed_collection.build(trees_collection, ucm);
+  std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>> sets_collection;
+  std::vector<std::pair<int, int>> size_setid_map;
+  label_set_converter_index::Converter<Label> lsc;
+  lsc.assignFrequencyIdentifiers(trees_collection, sets_collection,
+      size_setid_map);
+  lookup::TwoStageInvertedList index(lsc.get_number_of_labels());
+  index.build(sets_collection);
+  const lookup::SharedIndex<Label, QUICKJEDI, QUICKJEDI> shared_index(
+      indexed_collection, sets_collection, size_setid_map, index);
+
+  long long int first_results = -1;
+  lookup::LookupStatistics first_statistics;
+  for (int threads = 1; threads <= max_threads; threads *= 2) {
+    std::atomic<int> next_query(0);
+    std::vector<long long int> thread_results(threads, 0);
+    std::vector<lookup::LookupStatistics> thread_statistics(threads);
+    benchmark::Timer timer;
+    parallel::run_workers(threads, [&](const unsigned int thread_id) {
+      for (int q = next_query++; q < queries; q = next_query++) {
+        thread_results[thread_id] += shared_index.execute_lookup(
+            q % number_of_trees, distance_threshold,
+            thread_statistics[thread_id]).size();
+      }
+    });
+    double seconds = timer.get_seconds();
+    long long int results = 0;
+    lookup::LookupStatistics statistics;
+    for (int t = 0; t < threads; ++t) {
+      results += thread_results[t];
+      statistics.add(thread_statistics[t]);
+    }
+    std::cout << threads << " threads: " << queries / seconds << " queries/s, "
+        << results << " results, " << statistics.pre_candidates
+        << " precandidates, " << statistics.verifications << " verifications"
+        << std::endl;
+    if (first_results == -1) {
+      first_results = results;
+      first_statistics = statistics;
+    } else if (results != first_results ||
+        statistics.pre_candidates != first_statistics.pre_candidates ||
+        statistics.verifications != first_statistics.verifications) {
+      std::cerr << "Different results for " << threads << " threads."
+          << std::endl;
+      return -1;
+    }
+  }
+
+  return 0;
+}
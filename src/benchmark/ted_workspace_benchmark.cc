@@ -0,0 +1,132 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/ted_workspace_benchmark.cc
+///
+/// \details
+/// Measures the TED algorithms on a stream of differently sized tree pairs
+/// and reports how often their DP workspaces allocate. The stream is
+/// processed twice with the same algorithm objects. The second pass must not
+/// allocate.
+///
+/// Usage: ted_workspace_benchmark [number_of_trees] [max_tree_size] [threshold]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "string_label.h"
+#include "unit_cost_model.h"
+#include "bracket_notation_parser.h"
+#include "tree_indexer.h"
+#include "zhang_shasha_tree_index.h"
+#include "apted_tree_index.h"
+#include "touzet_baseline_tree_index.h"
+#include "cted_tree_index.h"
+
+using Label = label::StringLabel;
+using CostModel = cost_model::UnitCostModelLD<Label>;
+
+/// Computes the distances between consecutive trees twice and prints the
+/// throughput of the second pass together with the allocations of both
+/// passes. The distance function takes the algorithm and two tree indexes.
+template <typename Algorithm, typename TreeIndex, typename Function>
+void benchmark_algorithm(const std::string& name, Algorithm& algorithm,
+    const std::vector<TreeIndex>& indexes, Function distance) {
+  double checksum = 0;
+  long long int allocations[2];
+  double seconds = 0;
+  for (int pass = 0; pass < 2; ++pass) {
+    long long int allocations_before =
+        algorithm.get_workspace().get_allocation_count();
+    benchmark::Timer timer;
+    for (std::size_t i = 0; i + 1 < indexes.size(); ++i) {
+      checksum += distance(algorithm, indexes[i], indexes[i + 1]);
+    }
+    seconds = timer.get_seconds();
+    allocations[pass] = algorithm.get_workspace().get_allocation_count() -
+        allocations_before;
+  }
+  std::cout << name << ": " << (indexes.size() - 1) / seconds << " pairs/s"
+      << ", allocations " << allocations[0] << " + " << allocations[1]
+      << ", borrows " << algorithm.get_workspace().get_borrow_count()
+      << ", checksum " << checksum << std::endl;
+}
+
+/// Indexes all trees of trees_collection with the given TreeIndex.
+template <typename TreeIndex>
+std::vector<TreeIndex> index_collection(
+    const std::vector<node::Node<Label>>& trees_collection,
+    label::LabelDictionary<Label>& ld, const CostModel& cm) {
+  std::vector<TreeIndex> indexes(trees_collection.size());
+  for (std::size_t i = 0; i < trees_collection.size(); ++i) {
+    node::index_tree(indexes[i], trees_collection[i], ld, cm);
+  }
+  return indexes;
+}
+
+int main(int argc, char** argv) {
+  int number_of_trees = argc > 1 ? std::stoi(argv[1]) : 200;
+  int max_tree_size = argc > 2 ? std::stoi(argv[2]) : 200;
+  double threshold = argc > 3 ? std::stod(argv[3]) : 10;
+
+  parser::BracketNotationParser<Label> bnp;
+  std::vector<node::Node<Label>> trees_collection;
+  for (const auto& t : benchmark::generate_random_collection(
+      number_of_trees, 1, max_tree_size, 1)) {
+    trees_collection.push_back(bnp.parse_single(t));
+  }
+
+  label::LabelDictionary<Label> ld;
+  CostModel cm(ld);
+
+  auto ted = [](auto& algorithm, const auto& t1, const auto& t2) {
+    return algorithm.ted(t1, t2);
+  };
+  auto ted_k = [threshold](auto& algorithm, const auto& t1, const auto& t2) {
+    double ted_value = algorithm.ted_k(t1, t2, threshold);
+    return ted_value <= threshold ? ted_value : 0.0;
+  };
+
+  auto zs_indexes = index_collection<node::TreeIndexZhangShasha>(
+      trees_collection, ld, cm);
+  ted::ZhangShashaTreeIndex<CostModel, node::TreeIndexZhangShasha> zs(cm);
+  benchmark_algorithm("ted ZhangShasha", zs, zs_indexes, ted);
+
+  auto apted_indexes = index_collection<node::TreeIndexAPTED>(
+      trees_collection, ld, cm);
+  ted::APTEDTreeIndex<CostModel, node::TreeIndexAPTED> apted(cm);
+  benchmark_algorithm("ted APTED", apted, apted_indexes, ted);
+
+  auto touzet_indexes = index_collection<node::TreeIndexTouzetBaseline>(
+      trees_collection, ld, cm);
+  ted::TouzetBaselineTreeIndex<CostModel, node::TreeIndexTouzetBaseline>
+      touzet(cm);
+  benchmark_algorithm("ted_k Touzet", touzet, touzet_indexes, ted_k);
+
+  auto cted_indexes = index_collection<node::TreeIndexCTED>(
+      trees_collection, ld, cm);
+  ted_ub::CTEDTreeIndex<CostModel, node::TreeIndexCTED> cted(cm);
+  benchmark_algorithm("ted CTED", cted, cted_indexes, ted);
+
+  return 0;
+}
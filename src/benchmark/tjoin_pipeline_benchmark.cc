@@ -0,0 +1,96 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/tjoin_pipeline_benchmark.cc
+///
+/// \details
+/// Compares TJoinTI::execute_join, whose steps run one after another, with
+/// TJoinTI::execute_pipelined_join on a random collection sorted by tree
+/// size. Prints the run times, the number of precandidates, and the number
+/// of result pairs, which have to be equal.
+///
+/// Usage: tjoin_pipeline_benchmark [number_of_trees] [tree_size] [threads]
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "string_label.h"
+#include "bracket_notation_parser.h"
+#include "unit_cost_model.h"
+#include "touzet_baseline_tree_index.h"
+#include "t_join_ti.h"
+
+using Label = label::StringLabel;
+using CostModel = cost_model::UnitCostModelLD<Label>;
+using TJoin = join::TJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>>;
+
+int main(int argc, char** argv) {
+  int number_of_trees = argc > 1 ? std::stoi(argv[1]) : 2000;
+  int tree_size = argc > 2 ? std::stoi(argv[2]) : 10;
+  int threads = argc > 3 ? std::stoi(argv[3]) : 0;
+
+  parser::BracketNotationParser<Label> bnp;
+  std::vector<node::Node<Label>> trees_collection;
+  for (const auto& t : benchmark::generate_random_collection(
+      number_of_trees, tree_size / 2, tree_size * 3 / 2, 1)) {
+    trees_collection.push_back(bnp.parse_single(t));
+  }
+  std::stable_sort(trees_collection.begin(), trees_collection.end(),
+      [](const node::Node<Label>& a, const node::Node<Label>& b) {
+        return a.get_tree_size() < b.get_tree_size();
+      });
+
+  for (double distance_threshold : {3.0, 5.0, 8.0}) {
+    std::cout << "threshold " << distance_threshold << std::endl;
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> sets_collection;
+    std::vector<std::pair<int, int>> candidates;
+    std::vector<join::JoinResultElement> join_result;
+    TJoin join_algorithm(threads);
+    benchmark::Timer timer;
+    join_algorithm.execute_join(trees_collection, sets_collection,
+        candidates, join_result, distance_threshold);
+    std::cout << "  execute_join: " << timer.get_seconds() << " s, "
+        << join_algorithm.get_number_of_pre_candidates()
+        << " precandidates, " << join_result.size() << " results"
+        << std::endl;
+
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> pipeline_sets_collection;
+    std::vector<join::JoinResultElement> pipeline_result;
+    TJoin pipeline_algorithm(threads);
+    benchmark::Timer pipeline_timer;
+    pipeline_algorithm.execute_pipelined_join(trees_collection,
+        pipeline_sets_collection, pipeline_result, distance_threshold);
+    std::cout << "  execute_pipelined_join: " << pipeline_timer.get_seconds()
+        << " s, " << pipeline_algorithm.get_number_of_pre_candidates()
+        << " precandidates, " << pipeline_result.size() << " results"
+        << std::endl;
+    if (pipeline_result.size() != join_result.size()) {
+      std::cerr << "Different results for threshold " << distance_threshold
+          << "." << std::endl;
+      return -1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,127 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/tree_index_benchmark.cc
+///
+/// \details
+/// Measures the throughput of indexing trees and of the APTED and Touzet
+/// algorithms on the indexed trees.
+///
+/// Usage: tree_index_benchmark [number_of_trees] [tree_size] [threshold]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "string_label.h"
+#include "unit_cost_model.h"
+#include "bracket_notation_parser.h"
+#include "tree_indexer.h"
+#include "apted_tree_index.h"
+#include "touzet_baseline_tree_index.h"
+
+using Label = label::StringLabel;
+using CostModel = cost_model::UnitCostModelLD<Label>;
+
+/// Indexes every tree of trees_collection repetitions times with a single
+/// TreeIndex object and prints the throughput.
+template <typename TreeIndex>
+void benchmark_indexing(const std::string& name,
+    const std::vector<node::Node<Label>>& trees_collection,
+    const int repetitions) {
+  label::LabelDictionary<Label> ld;
+  CostModel cm(ld);
+  TreeIndex ti;
+  long long int nodes = 0;
+  benchmark::Timer timer;
+  for (int r = 0; r < repetitions; ++r) {
+    for (const auto& t : trees_collection) {
+      node::index_tree(ti, t, ld, cm);
+      nodes += ti.tree_size_;
+    }
+  }
+  double seconds = timer.get_seconds();
+  std::cout << "index " << name << ": " << nodes / seconds / 1e6
+      << " Mnodes/s" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  int number_of_trees = argc > 1 ? std::stoi(argv[1]) : 200;
+  int tree_size = argc > 2 ? std::stoi(argv[2]) : 200;
+  double threshold = argc > 3 ? std::stod(argv[3]) : 10;
+
+  parser::BracketNotationParser<Label> bnp;
+  std::vector<node::Node<Label>> trees_collection;
+  for (const auto& t : benchmark::generate_random_collection(
+      number_of_trees, tree_size, 1)) {
+    trees_collection.push_back(bnp.parse_single(t));
+  }
+
+  benchmark_indexing<node::TreeIndexAPTED>("TreeIndexAPTED",
+      trees_collection, 20);
+  benchmark_indexing<node::TreeIndexTouzetBaseline>("TreeIndexTouzetBaseline",
+      trees_collection, 20);
+  benchmark_indexing<node::TreeIndexAll>("TreeIndexAll",
+      trees_collection, 20);
+
+  // Index the trees once for the TED algorithms.
+  label::LabelDictionary<Label> ld;
+  CostModel cm(ld);
+  std::vector<node::TreeIndexAPTED> apted_indexes(trees_collection.size());
+  std::vector<node::TreeIndexTouzetBaseline> touzet_indexes(
+      trees_collection.size());
+  for (std::size_t i = 0; i < trees_collection.size(); ++i) {
+    node::index_tree(apted_indexes[i], trees_collection[i], ld, cm);
+    node::index_tree(touzet_indexes[i], trees_collection[i], ld, cm);
+  }
+
+  // Compute TED between consecutive trees.
+  ted::APTEDTreeIndex<CostModel, node::TreeIndexAPTED> apted(cm);
+  double checksum = 0;
+  benchmark::Timer apted_timer;
+  for (std::size_t i = 0; i + 1 < apted_indexes.size(); ++i) {
+    checksum += apted.ted(apted_indexes[i], apted_indexes[i + 1]);
+  }
+  double apted_seconds = apted_timer.get_seconds();
+  std::cout << "ted APTED: " << (apted_indexes.size() - 1) / apted_seconds
+      << " pairs/s" << std::endl;
+
+  ted::TouzetBaselineTreeIndex<CostModel, node::TreeIndexTouzetBaseline>
+      touzet(cm);
+  benchmark::Timer touzet_timer;
+  for (std::size_t i = 0; i + 1 < touzet_indexes.size(); ++i) {
+    double ted_value = touzet.ted_k(touzet_indexes[i], touzet_indexes[i + 1],
+        threshold);
+    if (ted_value <= threshold) {
+      checksum += ted_value;
+    }
+  }
+  double touzet_seconds = touzet_timer.get_seconds();
+  std::cout << "ted_k Touzet (k=" << threshold << "): "
+      << (touzet_indexes.size() - 1) / touzet_seconds << " pairs/s"
+      << std::endl;
+
+  // Prevents the compiler from removing the computations.
+  std::cout << "checksum: " << checksum << std::endl;
+
+  return 0;
+}
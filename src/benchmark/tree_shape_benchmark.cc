@@ -0,0 +1,126 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file benchmark/tree_shape_benchmark.cc
+///
+/// \details
+/// Measures get_tree_size, get_all_labels, and index_tree in Mnodes/s on a
+/// deep tree (a path of depth nodes), a wide tree (a root with width leaves),
+/// and random trees. Deep trees stress the traversal itself, wide trees the
+/// handling of long children lists.
+///
+/// Usage: tree_shape_benchmark [depth] [width] [repetitions]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "benchmark_utils.h"
+#include "node.h"
+#include "string_label.h"
+#include "unit_cost_model.h"
+#include "bracket_notation_parser.h"
+#include "tree_indexer.h"
+
+using Label = label::StringLabel;
+using CostModel = cost_model::UnitCostModelLD<Label>;
+
+/// Runs f repetitions times on every tree and prints the throughput.
+template <typename Function>
+void benchmark_trees(const std::string& name,
+    const std::vector<node::Node<Label>>& trees_collection,
+    const int repetitions, Function f) {
+  long long int nodes = 0;
+  benchmark::Timer timer;
+  for (int r = 0; r < repetitions; ++r) {
+    for (const auto& t : trees_collection) {
+      nodes += f(t);
+    }
+  }
+  std::cout << "  " << name << ": " << nodes / timer.get_seconds() / 1e6
+      << " Mnodes/s" << std::endl;
+}
+
+/// Runs all measurements on trees_collection.
+void benchmark_shape(const std::string& shape,
+    const std::vector<node::Node<Label>>& trees_collection,
+    const int repetitions) {
+  std::cout << shape << std::endl;
+  benchmark_trees("get_tree_size", trees_collection, repetitions,
+      [](const node::Node<Label>& t) {
+    return t.get_tree_size();
+  });
+  benchmark_trees("get_all_labels", trees_collection, repetitions,
+      [](const node::Node<Label>& t) {
+    return t.get_all_labels().size();
+  });
+  label::LabelDictionary<Label> ld;
+  CostModel cm(ld);
+  node::TreeIndexAPTED apted_index;
+  benchmark_trees("index_tree TreeIndexAPTED", trees_collection, repetitions,
+      [&](const node::Node<Label>& t) {
+    node::index_tree(apted_index, t, ld, cm);
+    return apted_index.tree_size_;
+  });
+  node::TreeIndexAll all_index;
+  benchmark_trees("index_tree TreeIndexAll", trees_collection, repetitions,
+      [&](const node::Node<Label>& t) {
+    node::index_tree(all_index, t, ld, cm);
+    return all_index.tree_size_;
+  });
+}
+
+int main(int argc, char** argv) {
+  int depth = argc > 1 ? std::stoi(argv[1]) : 10000;
+  int width = argc > 2 ? std::stoi(argv[2]) : 100000;
+  int repetitions = argc > 3 ? std::stoi(argv[3]) : 10;
+
+  parser::BracketNotationParser<Label> bnp;
+
+  std::string deep_tree;
+  for (int i = 0; i < depth; ++i) {
+    deep_tree += "{" + std::to_string(i % 10);
+  }
+  deep_tree += std::string(depth, '}');
+  std::vector<node::Node<Label>> deep_trees;
+  deep_trees.push_back(bnp.parse_single(deep_tree));
+  benchmark_shape("deep (" + std::to_string(depth) + " levels)", deep_trees,
+      repetitions);
+
+  std::string wide_tree = "{r";
+  for (int i = 0; i < width; ++i) {
+    wide_tree += "{" + std::to_string(i % 10) + "}";
+  }
+  wide_tree += "}";
+  std::vector<node::Node<Label>> wide_trees;
+  wide_trees.push_back(bnp.parse_single(wide_tree));
+  benchmark_shape("wide (" + std::to_string(width) + " children)", wide_trees,
+      repetitions);
+
+  std::vector<node::Node<Label>> random_trees;
+  for (const auto& t : benchmark::generate_random_collection(
+      1000, 100, 1)) {
+    random_trees.push_back(bnp.parse_single(t));
+  }
+  benchmark_shape("random (1000 trees, 100 nodes)", random_trees,
+      repetitions);
+
+  return 0;
+}
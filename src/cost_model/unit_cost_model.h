@@ -25,6 +25,7 @@
 #pragma once
 
 #include <limits>
+#include <type_traits>
 #include "../node/node.h"
 #include "../label/label_dictionary.h"
 
@@ -54,7 +55,7 @@ struct UnitCostModelLD {
   const label::LabelDictionary<Label>& ld_;
   
   /// Constructor. Takes a LabelDictionary.
-  UnitCostModelLD(label::LabelDictionary<Label>& ld);
+  UnitCostModelLD(const label::LabelDictionary<Label>& ld);
   
   /// Basic rename cost function (unit cost model).
   /**
@@ -96,7 +97,7 @@ struct UnitCostModelJSON {
   const label::LabelDictionary<Label>& ld_;
   
   /// Constructor. Takes a LabelDictionary.
-  UnitCostModelJSON(label::LabelDictionary<Label>& ld);
+  UnitCostModelJSON(const label::LabelDictionary<Label>& ld);
   
   /// Basic rename cost function (unit cost model).
   /**
@@ -121,6 +122,24 @@ struct UnitCostModelJSON {
   double ins(const int label_id) const;
 };
 
+/// True if every delete, insert, and rename of CostModel costs one.
+/**
+ * Algorithms that use the tree size difference as a lower bound, or the sum
+ * of the tree sizes as an upper bound of the distance, check this with a
+ * static_assert.
+ */
+template <typename CostModel>
+struct is_unit_cost_model : std::false_type {};
+
+template <typename Label>
+struct is_unit_cost_model<UnitCostModel<Label>> : std::true_type {};
+
+template <typename Label>
+struct is_unit_cost_model<UnitCostModelLD<Label>> : std::true_type {};
+
+template <typename Label>
+struct is_unit_cost_model<UnitCostModelJSON<Label>> : std::true_type {};
+
 // Implementational details
 #include "unit_cost_model_impl.h"
 
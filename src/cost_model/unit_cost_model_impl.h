@@ -43,7 +43,7 @@ int UnitCostModel<Label>::ins(const node::Node<Label>& node) const {
 
 
 template <class Label>
-UnitCostModelLD<Label>::UnitCostModelLD(label::LabelDictionary<Label>& ld) :
+UnitCostModelLD<Label>::UnitCostModelLD(const label::LabelDictionary<Label>& ld) :
     ld_(ld) {}
 
 template <typename Label>
@@ -69,7 +69,7 @@ double UnitCostModelLD<Label>::ins(const int) const {
 
 
 template <class Label>
-UnitCostModelJSON<Label>::UnitCostModelJSON(label::LabelDictionary<Label>& ld) :
+UnitCostModelJSON<Label>::UnitCostModelJSON(const label::LabelDictionary<Label>& ld) :
     ld_(ld) {}
 
 template <typename Label>
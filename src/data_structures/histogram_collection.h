@@ -0,0 +1,183 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file data_structures/histogram_collection.h
+///
+/// \details
+/// Stores a collection of sparse histograms, one per tree, as used by the
+/// histogram joins. A histogram is an array of (key, count) elements sorted by
+/// key. The arrays of all trees are stored one after another in one vector,
+/// such that a histogram is read sequentially and two histograms are
+/// intersected by a merge of their arrays.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace data_structures {
+
+/// One bin of a histogram.
+struct HistogramElement {
+  /// Key of the bin, e.g., a label id or a degree.
+  int key;
+  /// Number of nodes with this key.
+  int count;
+  /// Constructor.
+  HistogramElement(int key, int count);
+};
+
+inline HistogramElement::HistogramElement(int key, int count)
+    : key(key), count(count) {}
+
+class HistogramCollection {
+// Member functions.
+public:
+  /// Constructor.
+  HistogramCollection();
+  /// Appends the histogram of a tree. It gets the next histogram id.
+  ///
+  /// \param tree_size Number of nodes of the tree.
+  /// \param keys Key of every counted node, in any order. The vector is
+  ///             sorted in place.
+  void add_histogram(const int tree_size, std::vector<int>& keys);
+  /// Returns the number of histograms.
+  ///
+  /// \return The number of histograms.
+  std::size_t size() const;
+  /// Returns the size of the tree of a histogram.
+  ///
+  /// \param id Histogram id.
+  /// \return The tree size.
+  int get_tree_size(const std::size_t id) const;
+  /// Returns a pointer to the first element of a histogram.
+  ///
+  /// \param id Histogram id.
+  /// \return Pointer to the element with the smallest key.
+  const HistogramElement* begin(const std::size_t id) const;
+  /// Returns a pointer past the last element of a histogram.
+  ///
+  /// \param id Histogram id.
+  /// \return Pointer past the element with the largest key.
+  const HistogramElement* end(const std::size_t id) const;
+  /// Returns the sum of the minimum counts of the keys in both histograms.
+  /// The L1 distance between the histograms is the sum of their counts minus
+  /// twice the intersection.
+  ///
+  /// \param id_1 Histogram id.
+  /// \param id_2 Histogram id.
+  /// \return The size of the histogram intersection.
+  int get_intersection(const std::size_t id_1, const std::size_t id_2) const;
+  /// Returns the number of elements of all histograms.
+  ///
+  /// \return The number of elements.
+  std::size_t get_number_of_elements() const;
+  /// Returns the number of bytes allocated by the collection.
+  ///
+  /// \return The memory usage in bytes.
+  std::size_t get_memory_usage() const;
+  /// Removes all histograms.
+  void clear();
+// Member variables.
+private:
+  /// Elements of all histograms, each histogram sorted by key.
+  std::vector<HistogramElement> elements_;
+  /// Position of the first element of every histogram in elements_, followed
+  /// by the number of elements.
+  std::vector<std::size_t> offsets_;
+  /// Tree size of every histogram.
+  std::vector<int> tree_sizes_;
+};
+
+inline HistogramCollection::HistogramCollection() : offsets_(1, 0) {}
+
+inline void HistogramCollection::add_histogram(const int tree_size,
+    std::vector<int>& keys) {
+  // Equal keys are adjacent after sorting and become one element.
+  std::sort(keys.begin(), keys.end());
+  for (std::size_t i = 0; i < keys.size();) {
+    std::size_t j = i + 1;
+    while (j < keys.size() && keys[j] == keys[i]) {
+      ++j;
+    }
+    elements_.emplace_back(keys[i], static_cast<int>(j - i));
+    i = j;
+  }
+  offsets_.push_back(elements_.size());
+  tree_sizes_.push_back(tree_size);
+}
+
+inline std::size_t HistogramCollection::size() const {
+  return tree_sizes_.size();
+}
+
+inline int HistogramCollection::get_tree_size(const std::size_t id) const {
+  return tree_sizes_[id];
+}
+
+inline const HistogramElement* HistogramCollection::begin(
+    const std::size_t id) const {
+  return elements_.data() + offsets_[id];
+}
+
+inline const HistogramElement* HistogramCollection::end(
+    const std::size_t id) const {
+  return elements_.data() + offsets_[id + 1];
+}
+
+inline int HistogramCollection::get_intersection(const std::size_t id_1,
+    const std::size_t id_2) const {
+  const HistogramElement* element_1 = begin(id_1);
+  const HistogramElement* end_1 = end(id_1);
+  const HistogramElement* element_2 = begin(id_2);
+  const HistogramElement* end_2 = end(id_2);
+  int intersection = 0;
+  // Advance the side with the smaller key, or both on equal keys, without
+  // branching on the comparison.
+  while (element_1 != end_1 && element_2 != end_2) {
+    const int key_1 = element_1->key;
+    const int key_2 = element_2->key;
+    intersection += (key_1 == key_2) *
+        std::min(element_1->count, element_2->count);
+    element_1 += key_1 <= key_2;
+    element_2 += key_2 <= key_1;
+  }
+  return intersection;
+}
+
+inline std::size_t HistogramCollection::get_number_of_elements() const {
+  return elements_.size();
+}
+
+inline std::size_t HistogramCollection::get_memory_usage() const {
+  return elements_.capacity() * sizeof(HistogramElement) +
+      offsets_.capacity() * sizeof(std::size_t) +
+      tree_sizes_.capacity() * sizeof(int);
+}
+
+inline void HistogramCollection::clear() {
+  elements_.clear();
+  offsets_.assign(1, 0);
+  tree_sizes_.clear();
+}
+
+} // namespace data_structures
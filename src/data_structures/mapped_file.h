@@ -0,0 +1,173 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file data_structures/mapped_file.h
+///
+/// \details
+/// Read-only memory mapping of a whole file. The parsers and loaders scan the
+/// mapped bytes in place instead of copying the file into strings first.
+///
+/// Memory mapping is used on POSIX systems only
+/// (TREE_SIMILARITY_HAS_MMAP is 1). On other platforms the file is read into
+/// an aligned heap buffer instead.
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TREE_SIMILARITY_HAS_MMAP 1
+#else
+#define TREE_SIMILARITY_HAS_MMAP 0
+#endif
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#if TREE_SIMILARITY_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <cstdint>
+#include <fstream>
+#include <vector>
+#endif
+
+namespace data_structures {
+
+class MappedFile {
+public:
+  /// Maps the file at file_path into memory.
+  ///
+  /// \param file_path Path to the file.
+  /// \throws std::runtime_error if the file cannot be opened or mapped.
+  MappedFile(const std::string& file_path);
+  /// Unmaps the file.
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  /// Returns the first byte of the file, nullptr for an empty file.
+  const char* data() const;
+  /// Returns the number of bytes of the file.
+  std::size_t size() const;
+  /// Returns the first byte of the file.
+  const char* begin() const;
+  /// Returns one past the last byte of the file.
+  const char* end() const;
+  /// Hints that the file is read in random order from now on. Does nothing
+  /// if the file is not memory mapped.
+  void advise_random() const;
+
+private:
+  /// Mapped bytes of the file.
+  const char* data_ = nullptr;
+  /// Number of mapped bytes.
+  std::size_t size_ = 0;
+#if !TREE_SIMILARITY_HAS_MMAP
+  /// Bytes of the file. Words keep the data aligned for the binary formats.
+  std::vector<std::uint64_t> buffer_;
+#endif
+};
+
+#if TREE_SIMILARITY_HAS_MMAP
+inline MappedFile::MappedFile(const std::string& file_path) {
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::runtime_error("ERROR: Problem with opening the file '" +
+        file_path + "' in MappedFile.");
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1) {
+    close(fd);
+    throw std::runtime_error("ERROR: Problem with reading the size of the file '" +
+        file_path + "' in MappedFile.");
+  }
+  size_ = static_cast<std::size_t>(file_stat.st_size);
+  // An empty file cannot be mapped.
+  if (size_ > 0) {
+    void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error("ERROR: Problem with mapping the file '" +
+          file_path + "' in MappedFile.");
+    }
+    // The file is mostly read from the beginning to the end.
+    madvise(mapping, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(mapping);
+  }
+  // The mapping stays valid after closing the descriptor.
+  close(fd);
+}
+
+inline MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+inline void MappedFile::advise_random() const {
+  if (data_ != nullptr) {
+    madvise(const_cast<char*>(data_), size_, MADV_RANDOM);
+  }
+}
+#else
+inline MappedFile::MappedFile(const std::string& file_path) {
+  std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    throw std::runtime_error("ERROR: Problem with opening the file '" +
+        file_path + "' in MappedFile.");
+  }
+  size_ = static_cast<std::size_t>(file.tellg());
+  if (size_ > 0) {
+    buffer_.resize((size_ + sizeof(std::uint64_t) - 1) /
+        sizeof(std::uint64_t));
+    char* bytes = reinterpret_cast<char*>(buffer_.data());
+    file.seekg(0);
+    if (!file.read(bytes, static_cast<std::streamsize>(size_))) {
+      throw std::runtime_error("ERROR: Problem with reading the file '" +
+          file_path + "' in MappedFile.");
+    }
+    data_ = bytes;
+  }
+}
+
+inline MappedFile::~MappedFile() = default;
+
+inline void MappedFile::advise_random() const {}
+#endif
+
+inline const char* MappedFile::data() const {
+  return data_;
+}
+
+inline std::size_t MappedFile::size() const {
+  return size_;
+}
+
+inline const char* MappedFile::begin() const {
+  return data_;
+}
+
+inline const char* MappedFile::end() const {
+  return data_ + size_;
+}
+
+} // namespace data_structures
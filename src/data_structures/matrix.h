@@ -48,9 +48,9 @@ class Matrix {
 // Member variables.
 private:
   /// Number of rows in the matrix.
-  size_t rows_;
+  size_t rows_ = 0;
   /// Number of columns in the matrix.
-  size_t columns_;
+  size_t columns_ = 0;
   /// Consecutive-allocated long vector containing the matrix elements.
   std::vector<ElementType> data_;
 // Member functions.
@@ -78,6 +78,20 @@ public:
   /// \return Reference to the specified element.
   const ElementType& read_at(size_t row, size_t col) const;
   void fill_with(ElementType value);
+  /// Reshapes the matrix to the given dimensions and sets all its elements
+  /// to value. The storage is reused and only reallocated if the new matrix
+  /// does not fit into it.
+  ///
+  /// \param rows The new number of rows.
+  /// \param columns The new number of columns.
+  /// \param value The value of all elements.
+  ///
+  /// \return True if the storage had to grow, false otherwise.
+  bool resize(size_t rows, size_t columns,
+      const ElementType& value = ElementType());
+  /// Returns the number of elements that fit into the storage without
+  /// reallocation.
+  size_t get_capacity() const;
 };
 
 /// A specialised matrix, where only the elements on the diagonal band matter.
@@ -110,6 +124,9 @@ public:
   /// column coordinate is correctly translated to the shifted band.
   ElementType& at(size_t row, size_t col);
   const ElementType& read_at(size_t row, size_t col) const;
+  /// Reshapes the band matrix reusing its storage, see Matrix::resize.
+  bool resize(size_t rows, size_t band_width,
+      const ElementType& value = ElementType());
 };
 
 template<typename ElementType>
@@ -163,6 +180,22 @@ void Matrix<ElementType>::fill_with(ElementType value) {
   std::fill(data_.begin(), data_.end(), value);
 }
 
+template<typename ElementType>
+bool Matrix<ElementType>::resize(size_t rows, size_t columns,
+    const ElementType& value) {
+  const bool grows = rows * columns > data_.capacity();
+  rows_ = rows;
+  columns_ = columns;
+  // NOTE: assign() keeps the allocated storage if the new size fits into it.
+  data_.assign(rows_ * columns_, value);
+  return grows;
+}
+
+template<typename ElementType>
+size_t Matrix<ElementType>::get_capacity() const {
+  return data_.capacity();
+}
+
 template<typename ElementType>
 BandMatrix<ElementType>::BandMatrix(size_t rows, size_t band_width)
   : Matrix<ElementType>::Matrix(rows, 2 * band_width + 1), band_width_(band_width) {}
@@ -187,5 +220,12 @@ const ElementType& BandMatrix<ElementType>::read_at(size_t row, size_t col) cons
   return Matrix<ElementType>::read_at(row, col + band_width_ - row);
 }
 
+template<typename ElementType>
+bool BandMatrix<ElementType>::resize(size_t rows, size_t band_width,
+    const ElementType& value) {
+  band_width_ = band_width;
+  return Matrix<ElementType>::resize(rows, 2 * band_width + 1, value);
+}
+
 } // namespace data_structures
 
@@ -0,0 +1,136 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file data_structures/pair_inverted_list.h
+///
+/// \details
+/// Inverted lists of (tree id, count) pairs of the histogram join candidate
+/// indexes. Every key has a list, either a std::vector of pairs or a
+/// VarBytePairList if the lists are compressed. The entries of a list are
+/// appended in ascending tree id.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "var_byte_pair_list.h"
+
+namespace data_structures {
+
+class PairInvertedList {
+public:
+  /// Constructor.
+  ///
+  /// \param number_of_lists Number of keys, i.e., lists.
+  /// \param compress_lists True if the entries are stored in variable-byte
+  ///                       encoding.
+  PairInvertedList(const std::size_t number_of_lists,
+      const bool compress_lists);
+  /// Appends an entry to a list.
+  ///
+  /// \param key Key of the list.
+  /// \param id Id of the entry. Not smaller than the id of the last entry.
+  /// \param value Non-negative value of the entry.
+  void push_back(const std::size_t key, const int id, const int value);
+  /// Calls f(id, value) for every entry of a list in the order of the list.
+  ///
+  /// \param key Key of the list.
+  template <typename Function>
+  void for_each(const std::size_t key, Function f) const;
+  /// Adds the histogram intersection of a count with every entry of a list to
+  /// the intersection of the entry's tree, i.e., the minimum of both counts.
+  /// A tree whose intersection becomes non-zero for the first time is
+  /// appended to pre_candidates.
+  ///
+  /// \param key Key of the list.
+  /// \param count Count of the key in the probing histogram.
+  /// \param intersections Intersection per tree id, zero if not yet probed.
+  /// \param pre_candidates Tree ids with a non-zero intersection.
+  /// \param max_intersection Upper limit of every intersection.
+  void probe(const std::size_t key, const int count,
+      std::vector<int>& intersections, std::vector<int>& pre_candidates,
+      const int max_intersection) const;
+  /// Returns the number of bytes of all lists, including unused capacity.
+  std::size_t get_number_of_bytes() const;
+
+private:
+  /// True if the entries are compressed.
+  bool compress_lists_;
+  /// Uncompressed lists, empty if the entries are compressed.
+  std::vector<std::vector<std::pair<int, int>>> lists_;
+  /// Compressed lists, empty if the entries are not compressed.
+  std::vector<VarBytePairList> compressed_lists_;
+};
+
+inline PairInvertedList::PairInvertedList(const std::size_t number_of_lists,
+    const bool compress_lists)
+    : compress_lists_(compress_lists),
+      lists_(compress_lists ? 0 : number_of_lists),
+      compressed_lists_(compress_lists ? number_of_lists : 0) {}
+
+inline void PairInvertedList::push_back(const std::size_t key, const int id,
+    const int value) {
+  if (compress_lists_) {
+    compressed_lists_[key].push_back(id, value);
+  } else {
+    lists_[key].emplace_back(id, value);
+  }
+}
+
+template <typename Function>
+void PairInvertedList::for_each(const std::size_t key, Function f) const {
+  if (compress_lists_) {
+    compressed_lists_[key].for_each(f);
+  } else {
+    for (const auto& entry : lists_[key]) {
+      f(entry.first, entry.second);
+    }
+  }
+}
+
+inline void PairInvertedList::probe(const std::size_t key, const int count,
+    std::vector<int>& intersections, std::vector<int>& pre_candidates,
+    const int max_intersection) const {
+  for_each(key, [&](const int tree_id, const int entry_count) {
+    const int intersection = std::min(count, entry_count);
+    if (intersections[tree_id] == 0 && intersection != 0) {
+      pre_candidates.push_back(tree_id);
+    }
+    intersections[tree_id] = std::min(intersections[tree_id] + intersection,
+        max_intersection);
+  });
+}
+
+inline std::size_t PairInvertedList::get_number_of_bytes() const {
+  std::size_t bytes = lists_.size() * sizeof(std::vector<std::pair<int, int>>) +
+      compressed_lists_.size() * sizeof(VarBytePairList);
+  for (const auto& list : lists_) {
+    bytes += list.capacity() * sizeof(std::pair<int, int>);
+  }
+  for (const auto& list : compressed_lists_) {
+    bytes += list.get_number_of_bytes();
+  }
+  return bytes;
+}
+
+}
@@ -0,0 +1,160 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file data_structures/result_sink.h
+///
+/// \details
+/// Streams the result elements of a join or a lookup to a consumer instead
+/// of collecting them in one vector. The producer adds elements with
+/// emplace_back, like to a vector. The elements are buffered and handed to
+/// the consumer in batches of at most buffer_size elements, e.g., to write
+/// them to a file. Only the buffer is kept in memory, independent of the
+/// result size. A sink constructed on a vector appends every element to it
+/// directly, without a buffer and without calling a consumer.
+///
+/// A ResultSink is not thread-safe. Parallel producers pass their results
+/// on from one thread at a time (see parallel::ChunkSequencer).
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace data_structures {
+
+template <typename Element>
+class ResultSink {
+// Types.
+public:
+  /// Receives a batch of result elements. The batch is cleared after the
+  /// call.
+  typedef std::function<void(const std::vector<Element>&)> Consumer;
+// Member functions.
+public:
+  /// Constructor.
+  ///
+  /// \param consumer Callable receiving the batches.
+  /// \param buffer_size Maximum number of elements in a batch. Values
+  ///                    smaller than one are treated as one.
+  ResultSink(Consumer consumer, const std::size_t buffer_size = 4096);
+  /// Constructor. All elements are appended to results directly, flush does
+  /// nothing.
+  ///
+  /// \param results Vector to append to.
+  ResultSink(std::vector<Element>& results);
+  /// Adds a result element. Passes the buffer to the consumer when it is
+  /// full.
+  ///
+  /// \param args Arguments of the constructor of Element.
+  template <typename... Args>
+  void emplace_back(Args&&... args);
+  /// Adds result elements in their order.
+  ///
+  /// \param elements Elements to add.
+  void append(const std::vector<Element>& elements);
+  /// Passes the buffered elements to the consumer. Producers flush at the
+  /// end of a join or a lookup; the destructor does not.
+  void flush();
+  /// Returns the number of elements added so far.
+  ///
+  /// \return The number of elements.
+  long long int get_number_of_results() const;
+  /// Returns the maximum number of elements in a batch.
+  ///
+  /// \return The buffer size, zero for a sink appending to a vector.
+  std::size_t get_buffer_size() const;
+// Member variables.
+private:
+  /// Receives the batches.
+  Consumer consumer_;
+  /// Maximum number of elements in a batch.
+  std::size_t buffer_size_;
+  /// Elements not yet passed to the consumer.
+  std::vector<Element> buffer_;
+  /// Vector the elements are appended to directly, nullptr for a sink with a
+  /// consumer.
+  std::vector<Element>* results_;
+  /// Number of elements added so far.
+  long long int number_of_results_;
+};
+
+template <typename Element>
+ResultSink<Element>::ResultSink(Consumer consumer,
+    const std::size_t buffer_size)
+    : consumer_(std::move(consumer)),
+      buffer_size_(buffer_size > 0 ? buffer_size : 1),
+      results_(nullptr),
+      number_of_results_(0) {}
+
+template <typename Element>
+ResultSink<Element>::ResultSink(std::vector<Element>& results)
+    : buffer_size_(0),
+      results_(&results),
+      number_of_results_(0) {}
+
+template <typename Element>
+template <typename... Args>
+void ResultSink<Element>::emplace_back(Args&&... args) {
+  ++number_of_results_;
+  if (results_ != nullptr) {
+    results_->emplace_back(std::forward<Args>(args)...);
+    return;
+  }
+  buffer_.emplace_back(std::forward<Args>(args)...);
+  if (buffer_.size() >= buffer_size_) {
+    flush();
+  }
+}
+
+template <typename Element>
+void ResultSink<Element>::append(const std::vector<Element>& elements) {
+  if (results_ != nullptr) {
+    results_->insert(results_->end(), elements.begin(), elements.end());
+    number_of_results_ += elements.size();
+    return;
+  }
+  for (const auto& element : elements) {
+    emplace_back(element);
+  }
+}
+
+template <typename Element>
+void ResultSink<Element>::flush() {
+  if (buffer_.empty()) {
+    return;
+  }
+  consumer_(buffer_);
+  buffer_.clear();
+}
+
+template <typename Element>
+long long int ResultSink<Element>::get_number_of_results() const {
+  return number_of_results_;
+}
+
+template <typename Element>
+std::size_t ResultSink<Element>::get_buffer_size() const {
+  return buffer_size_;
+}
+
+} // namespace data_structures
@@ -0,0 +1,122 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file data_structures/var_byte.h
+///
+/// \details
+/// Variable-byte compression of ascending integer lists. A list is stored as
+/// the differences of consecutive values (the first value is its difference
+/// to zero). Every difference takes 7 bits per byte, lowest bits first; the
+/// high bit of a byte is set if more bytes of the same difference follow.
+/// Small differences, i.e., long lists of close values, take one byte.
+///
+/// The decoder checks eight bytes at once: if none of them continues a
+/// difference, all eight are one-byte differences and are summed up without
+/// branches. Only lists with large differences take the byte-by-byte path.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace data_structures {
+
+/// Appends the variable-byte encoding of value to bytes.
+///
+/// \param value Value to encode.
+/// \param bytes Bytes to append to.
+void var_byte_encode(std::uint32_t value, std::vector<std::uint8_t>& bytes);
+
+/// Decodes one value encoded by var_byte_encode.
+///
+/// \param position First byte of the value. Moved past its last byte.
+/// \return The decoded value.
+std::uint32_t var_byte_decode(const std::uint8_t*& position);
+
+/// Appends the differences of an ascending list of values in variable-byte
+/// encoding to bytes.
+///
+/// \param begin First value of the list.
+/// \param end One past the last value of the list.
+/// \param bytes Bytes to append to.
+void var_byte_encode_deltas(const int* begin, const int* end,
+    std::vector<std::uint8_t>& bytes);
+
+/// Decodes a list encoded by var_byte_encode_deltas and appends its values
+/// to values.
+///
+/// \param begin First byte of the encoded list.
+/// \param end One past the last byte of the encoded list.
+/// \param values Values to append to.
+void var_byte_decode_deltas(const std::uint8_t* begin,
+    const std::uint8_t* end, std::vector<int>& values);
+
+inline void var_byte_encode(std::uint32_t value,
+    std::vector<std::uint8_t>& bytes) {
+  while (value >= 0x80) {
+    bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  bytes.push_back(static_cast<std::uint8_t>(value));
+}
+
+inline std::uint32_t var_byte_decode(const std::uint8_t*& position) {
+  std::uint32_t value = 0;
+  int shift = 0;
+  while (*position & 0x80) {
+    value |= static_cast<std::uint32_t>(*position++ & 0x7F) << shift;
+    shift += 7;
+  }
+  return value | static_cast<std::uint32_t>(*position++) << shift;
+}
+
+inline void var_byte_encode_deltas(const int* begin, const int* end,
+    std::vector<std::uint8_t>& bytes) {
+  int previous = 0;
+  for (; begin != end; ++begin) {
+    var_byte_encode(static_cast<std::uint32_t>(*begin - previous), bytes);
+    previous = *begin;
+  }
+}
+
+inline void var_byte_decode_deltas(const std::uint8_t* begin,
+    const std::uint8_t* end, std::vector<int>& values) {
+  std::uint32_t previous = 0;
+  while (begin != end) {
+    if (end - begin >= 8) {
+      std::uint64_t word;
+      std::memcpy(&word, begin, sizeof(word));
+      if ((word & 0x8080808080808080ULL) == 0) {
+        for (int i = 0; i < 8; ++i) {
+          previous += begin[i];
+          values.push_back(static_cast<int>(previous));
+        }
+        begin += 8;
+        continue;
+      }
+    }
+    previous += var_byte_decode(begin);
+    values.push_back(static_cast<int>(previous));
+  }
+}
+
+}
@@ -0,0 +1,121 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file data_structures/var_byte_pair_list.h
+///
+/// \details
+/// Append-only list of (id, value) pairs in variable-byte encoding, e.g., the
+/// entries of an inverted list that are appended in ascending id. Every
+/// entry stores the difference of its id to the id of the previous entry and
+/// then its value (see data_structures/var_byte.h), hence entries with close
+/// ids and small values take two bytes instead of the eight bytes of a
+/// std::pair<int, int>. The entries are read front to back with a Cursor,
+/// which can also be stored to resume reading at an entry later.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "var_byte.h"
+
+namespace data_structures {
+
+class VarBytePairList {
+public:
+  /// Position of an entry in the list. The id of the previous entry is the
+  /// base of the next difference.
+  struct Cursor {
+    /// Byte position of the entry.
+    std::size_t byte = 0;
+    /// Id of the previous entry, zero at the beginning.
+    int id = 0;
+  };
+  /// Appends an entry.
+  ///
+  /// \param id Id of the entry. Not smaller than the id of the last entry.
+  /// \param value Non-negative value of the entry.
+  void push_back(const int id, const int value);
+  /// Reads the entry at cursor and moves cursor to the next entry.
+  ///
+  /// \param cursor Position of the entry.
+  /// \param id Overwritten with the id of the entry.
+  /// \param value Overwritten with the value of the entry.
+  /// \return False if cursor is at the end of the list.
+  bool next(Cursor& cursor, int& id, int& value) const;
+  /// Calls f(id, value) for every entry in the order of the list.
+  template <typename Function>
+  void for_each(Function f) const;
+  /// Returns the cursor behind the last entry, i.e., the position of the
+  /// next entry that is appended.
+  Cursor get_end() const;
+  /// Returns the number of bytes of the list, including unused capacity.
+  std::size_t get_number_of_bytes() const;
+
+private:
+  /// Encoded entries.
+  std::vector<std::uint8_t> bytes_;
+  /// Id of the last entry.
+  int last_id_ = 0;
+};
+
+inline void VarBytePairList::push_back(const int id, const int value) {
+  var_byte_encode(static_cast<std::uint32_t>(id - last_id_), bytes_);
+  var_byte_encode(static_cast<std::uint32_t>(value), bytes_);
+  last_id_ = id;
+}
+
+inline bool VarBytePairList::next(Cursor& cursor, int& id,
+    int& value) const {
+  if (cursor.byte == bytes_.size()) {
+    return false;
+  }
+  const std::uint8_t* position = bytes_.data() + cursor.byte;
+  id = cursor.id + static_cast<int>(var_byte_decode(position));
+  value = static_cast<int>(var_byte_decode(position));
+  cursor.byte = position - bytes_.data();
+  cursor.id = id;
+  return true;
+}
+
+template <typename Function>
+void VarBytePairList::for_each(Function f) const {
+  const std::uint8_t* position = bytes_.data();
+  const std::uint8_t* end = position + bytes_.size();
+  int id = 0;
+  while (position != end) {
+    id += static_cast<int>(var_byte_decode(position));
+    f(id, static_cast<int>(var_byte_decode(position)));
+  }
+}
+
+inline VarBytePairList::Cursor VarBytePairList::get_end() const {
+  Cursor end;
+  end.byte = bytes_.size();
+  end.id = last_id_;
+  return end;
+}
+
+inline std::size_t VarBytePairList::get_number_of_bytes() const {
+  return bytes_.capacity();
+}
+
+}
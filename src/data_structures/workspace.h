@@ -0,0 +1,122 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file data_structures/workspace.h
+///
+/// \details
+/// Grow-only working memory of the dynamic programming algorithms. An
+/// algorithm keeps its matrices and arrays across calls and borrows storage
+/// for them from its workspace at the beginning of every call. The storage
+/// only grows, so a stream of differently sized tree pairs reallocates only
+/// when a pair is larger than all pairs seen before. The counters make that
+/// observable.
+
+#pragma once
+
+#include <vector>
+#include "matrix.h"
+
+namespace data_structures {
+
+class Workspace {
+public:
+  /// Reshapes m to rows x columns with all elements set to value.
+  ///
+  /// \param m The matrix to be reused.
+  /// \param rows The number of rows.
+  /// \param columns The number of columns.
+  /// \param value The value of all elements.
+  template <typename ElementType>
+  void borrow(Matrix<ElementType>& m, size_t rows, size_t columns,
+      const ElementType& value = ElementType());
+  /// Reshapes the band matrix m with all elements set to value.
+  ///
+  /// \param m The band matrix to be reused.
+  /// \param rows The number of rows.
+  /// \param band_width The band width of m.
+  /// \param value The value of all elements.
+  template <typename ElementType>
+  void borrow(BandMatrix<ElementType>& m, size_t rows, size_t band_width,
+      const ElementType& value = ElementType());
+  /// Resizes v to size elements, all set to value.
+  ///
+  /// \param v The vector to be reused.
+  /// \param size The number of elements.
+  /// \param value The value of all elements.
+  template <typename ElementType>
+  void borrow(std::vector<ElementType>& v, size_t size,
+      const ElementType& value = ElementType());
+  /// Returns the number of borrows that had to allocate storage.
+  long long int get_allocation_count() const;
+  /// Returns the number of all borrows.
+  long long int get_borrow_count() const;
+  /// Sets both counters to zero.
+  void reset_counters();
+
+private:
+  /// Number of borrows that had to allocate storage.
+  long long int allocation_count_ = 0;
+  /// Number of all borrows.
+  long long int borrow_count_ = 0;
+};
+
+template <typename ElementType>
+void Workspace::borrow(Matrix<ElementType>& m, size_t rows, size_t columns,
+    const ElementType& value) {
+  ++borrow_count_;
+  if (m.resize(rows, columns, value)) {
+    ++allocation_count_;
+  }
+}
+
+template <typename ElementType>
+void Workspace::borrow(BandMatrix<ElementType>& m, size_t rows,
+    size_t band_width, const ElementType& value) {
+  ++borrow_count_;
+  if (m.resize(rows, band_width, value)) {
+    ++allocation_count_;
+  }
+}
+
+template <typename ElementType>
+void Workspace::borrow(std::vector<ElementType>& v, size_t size,
+    const ElementType& value) {
+  ++borrow_count_;
+  if (size > v.capacity()) {
+    ++allocation_count_;
+  }
+  v.assign(size, value);
+}
+
+inline long long int Workspace::get_allocation_count() const {
+  return allocation_count_;
+}
+
+inline long long int Workspace::get_borrow_count() const {
+  return borrow_count_;
+}
+
+inline void Workspace::reset_counters() {
+  allocation_count_ = 0;
+  borrow_count_ = 0;
+}
+
+} // namespace data_structures
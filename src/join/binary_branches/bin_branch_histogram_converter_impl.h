@@ -33,18 +33,19 @@ Converter<Label>::Converter() {}
 template<typename Label>
 void Converter<Label>::create_histogram(
     const std::vector<node::Node<Label>>& trees_collection,
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection) {
+    data_structures::HistogramCollection& histogram_collection) {
 
+  // stores the binary branch id of every node of the current tree
+  std::vector<int> bb_histogram;
   // for each tree in the tree collection
   for (const auto& tree: trees_collection) {
-    // stores the number of nodes per binary branch
-    std::unordered_map<int, int> bb_histogram;
+    bb_histogram.clear();
     // stores the number of nodes per binary branch
     int tree_size = 0;
     // traverse tree and store number of nodes per binary branch
     create_bin_branch_histrogram(tree, empty_string_, bb_histogram, tree_size);
     // add binary branch histogram to collection
-    histogram_collection.emplace_back(tree_size, bb_histogram);
+    histogram_collection.add_histogram(tree_size, bb_histogram);
   }
 }
 
@@ -52,7 +53,7 @@ template<typename Label>
 void Converter<Label>::create_bin_branch_histrogram(
     const node::Node<Label>& tree_node, 
     std::string& right_sibling_label, 
-    std::unordered_map<int, int>& bb_histogram, 
+    std::vector<int>& bb_histogram, 
     int& tree_size) {
 
   auto& children = tree_node.get_children();
@@ -75,8 +76,8 @@ void Converter<Label>::create_bin_branch_histrogram(
     // add binary branch id to map
     bb_id_map_[bb_string] = bb_id_++;
 
-  // increase binary branch count for current node
-  ++bb_histogram[bb_id_map_[bb_string]];
+  // add the binary branch of the current node, counted by the collection
+  bb_histogram.push_back(bb_id_map_[bb_string]);
 
   // do recursively for all children
   for (int i = 0; i < nr_of_children; i++) {
@@ -27,8 +27,9 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <vector>
 #include "../../node/node.h"
+#include "../../data_structures/histogram_collection.h"
 #include "../../label/string_label.h"
 
 namespace degree_histogram_converter {
@@ -39,14 +40,14 @@ class Converter {
 public:
   /// Constructor.
   Converter();
-  /// Converts a given tree to a histogram. Each element of the vector contains 
-  /// a value of the histogram.
+  /// Converts the given trees to histograms. Each histogram is appended to the
+  /// collection as an array of (key, count) elements sorted by key.
   ///
   /// \param tree_collection A collection of trees.
   /// \param histogram_collection A collection of histograms.
   void create_histogram(
     const std::vector<node::Node<Label>>& trees_collection,
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection);
+    data_structures::HistogramCollection& histogram_collection);
   /// Returns the maximum degree of a node in a tree collection.
   ///
   /// \return The the maximum degree of a node in a tree collection.
@@ -61,10 +62,10 @@ private:
   /// of the histogram.
   ///
   /// \param tree_node Current node of a tree.
-  /// \param degree_histogram Vector of histogram values.
+  /// \param degree_histogram Keys of the nodes visited so far.
   void create_degree_histrogram(
     const node::Node<Label>& tree_node, 
-    std::unordered_map<int, int>& degree_histogram, 
+    std::vector<int>& degree_histogram, 
     int& tree_size);
 };
 
@@ -33,25 +33,26 @@ Converter<Label>::Converter() {}
 template<typename Label>
 void Converter<Label>::create_histogram(
     const std::vector<node::Node<Label>>& trees_collection,
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection) {
+    data_structures::HistogramCollection& histogram_collection) {
 
+  // stores the degree of every node of the current tree
+  std::vector<int> degree_histogram;
   // for each tree in the tree collection
   for (const auto& tree: trees_collection) {
-    // stores the number of nodes per degree
-    std::unordered_map<int, int> degree_histogram;
+    degree_histogram.clear();
     // stores the number of nodes per degree
     int tree_size = 0;
     // traverse tree and store number of nodes per degree
     create_degree_histrogram(tree, degree_histogram, tree_size);
     // add degree histogram to collection
-    histogram_collection.emplace_back(tree_size, degree_histogram);
+    histogram_collection.add_histogram(tree_size, degree_histogram);
   }
 }
 
 template<typename Label>
 void Converter<Label>::create_degree_histrogram(
     const node::Node<Label>& tree_node, 
-    std::unordered_map<int, int>& degree_histogram, 
+    std::vector<int>& degree_histogram, 
     int& tree_size) {
 
   // count number of children
@@ -61,8 +62,8 @@ void Converter<Label>::create_degree_histrogram(
     create_degree_histrogram(child, degree_histogram, tree_size);
     ++number_of_children;
   }
-  // increase degree count for current node
-  ++degree_histogram[number_of_children];
+  // add the degree of the current node, counted by the collection
+  degree_histogram.push_back(number_of_children);
   // store maximum degree of the collection
   if(number_of_children > max_degree_)
     max_degree_ = number_of_children;
@@ -24,6 +24,10 @@
 /// \details
 /// Implements a candidate index that efficiently and effectively returns tree 
 /// pairs that satisfy the degree histogram lower bound by Kailing et al. 
+///
+/// The entries of the inverted lists can be stored in variable-byte encoding
+/// (see data_structures/var_byte_pair_list.h). This takes less memory for
+/// large collections, but the entries are decoded on every lookup.
 
 #pragma once
 
@@ -31,8 +35,9 @@
 #include <climits>
 #include <algorithm>
 #include <vector>
-#include <unordered_map>
 #include "../../node/node.h"
+#include "../../data_structures/histogram_collection.h"
+#include "../../data_structures/pair_inverted_list.h"
 
 namespace dh_candidate_index {
 
@@ -41,6 +46,11 @@ class CandidateIndex {
 public:
   /// Constructor.
   CandidateIndex();
+  /// Constructor.
+  ///
+  /// \param compress_lists True if the entries of the inverted lists are
+  ///                       stored in variable-byte encoding.
+  CandidateIndex(const bool compress_lists);
   /// Returns a set of candidates that satisfy the degree histogram lower bound. 
   ///
   /// \param histogram_collection Collection of all histograms.
@@ -48,7 +58,7 @@ public:
   /// \param il_size Size of the inverted list.
   /// \param distance_threshold Given similarity threshold.
   void lookup(
-      std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection,
+      const data_structures::HistogramCollection& histogram_collection,
       std::vector<std::pair<int, int>>& join_candidates,
       const int il_size,
       const double distance_threshold);
@@ -62,12 +72,20 @@ public:
   ///
   /// \return The number of lookups in the inverted list.
   long int get_number_of_il_lookups() const;
+  /// Returns the number of bytes of the inverted lists of the last lookup.
+  ///
+  /// \return The number of bytes of the inverted lists.
+  std::size_t get_number_of_il_bytes() const;
 // Member variables.
 private:
   /// Number of precandidates.
   long int pre_candidates_;
   /// Number of lookups in the inverted list.
   long int il_lookups_;
+  /// True if the entries of the inverted lists are compressed.
+  bool compress_lists_;
+  /// Number of bytes of the inverted lists of the last lookup.
+  std::size_t il_bytes_;
 };
 
 // Implementation details.
@@ -27,18 +27,22 @@
 
 #pragma once
 
-CandidateIndex::CandidateIndex() {
+CandidateIndex::CandidateIndex() : CandidateIndex(false) {}
+
+inline CandidateIndex::CandidateIndex(const bool compress_lists) {
   pre_candidates_ = 0;
   il_lookups_ = 0;
+  compress_lists_ = compress_lists;
+  il_bytes_ = 0;
 }
 
 void CandidateIndex::lookup(
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection,
+    const data_structures::HistogramCollection& histogram_collection,
     std::vector<std::pair<int, int>>& join_candidates,
     const int il_size,
     const double distance_threshold) {
-  // inverted list index
-  std::vector<std::vector<std::pair<int, int>>> il_index(il_size+1);
+  // inverted list index, either uncompressed or compressed
+  data_structures::PairInvertedList il_index(il_size+1, compress_lists_);
   // id of the tree that is currently processed
   int current_tree_id = 0;
   // overlap count for all trees
@@ -46,17 +50,16 @@ void CandidateIndex::lookup(
   // store ids of all tree with an overlap, called pre candidates
 
   // iterate through all histograms in the given collection
-  for (auto& histogram: histogram_collection) {
+  for (; current_tree_id < static_cast<int>(histogram_collection.size());
+      ++current_tree_id) {
+    const int tree_size = histogram_collection.get_tree_size(current_tree_id);
     std::vector<int> pre_candidates;
-    for (auto& element: histogram.second) {
-      for (auto& il_entry: il_index[element.first]) {
-        int intersection = std::min(element.second, il_entry.second);
-        if(intersection_cnt[il_entry.first] == 0 && intersection != 0)
-          pre_candidates.push_back(il_entry.first);
-        intersection_cnt[il_entry.first] += intersection;
-      }
-
-      il_index[element.first].emplace_back(current_tree_id, element.second);
+    for (auto element = histogram_collection.begin(current_tree_id);
+        element != histogram_collection.end(current_tree_id); ++element) {
+      // probe the list and add current element to the index
+      il_index.probe(element->key, element->count, intersection_cnt,
+          pre_candidates, INT_MAX);
+      il_index.push_back(element->key, current_tree_id, element->count);
     }
 
     // count the number of pre canidates
@@ -64,14 +67,15 @@ void CandidateIndex::lookup(
 
     // verify all pre candidates
     for(int pre_cand_id: pre_candidates) {
-      if((histogram_collection[current_tree_id].first + histogram_collection[pre_cand_id].first - 
+      if((tree_size + histogram_collection.get_tree_size(pre_cand_id) - 
           (2 * intersection_cnt[pre_cand_id])) / 3 <= distance_threshold)
         join_candidates.emplace_back(current_tree_id, pre_cand_id);
       // reset intersection counter
       intersection_cnt[pre_cand_id] = 0;
     }
-    current_tree_id++;
   }
+
+  il_bytes_ = il_index.get_number_of_bytes();
 }
 
 long int CandidateIndex::get_number_of_pre_candidates() const {
@@ -86,3 +90,7 @@ void CandidateIndex::set_number_of_pre_candidates(
 long int CandidateIndex::get_number_of_il_lookups() const {
   return il_lookups_;
 }
+
+inline std::size_t CandidateIndex::get_number_of_il_bytes() const {
+  return il_bytes_;
+}
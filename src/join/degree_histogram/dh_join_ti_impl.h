@@ -31,15 +31,29 @@ DHJoinTI<Label, VerificationAlgorithm>::DHJoinTI() {
   pre_candidates_ = 0;
   sum_subproblem_counter_ = 0;
   il_lookups_ = 0;
+  il_bytes_ = 0;
+  compress_candidate_index_ = false;
 }
 
 template <typename Label, typename VerificationAlgorithm>
 void DHJoinTI<Label, VerificationAlgorithm>::execute_join(
     std::vector<node::Node<Label>>& trees_collection,
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection,
+    data_structures::HistogramCollection& histogram_collection,
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result,
     const double distance_threshold) {
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  execute_join(trees_collection, histogram_collection, candidates, sink,
+      distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void DHJoinTI<Label, VerificationAlgorithm>::execute_join(
+    std::vector<node::Node<Label>>& trees_collection,
+    data_structures::HistogramCollection& histogram_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
 
   // Convert trees to degree histograms.
   convert_trees_to_histograms(trees_collection, histogram_collection);
@@ -47,15 +61,22 @@ void DHJoinTI<Label, VerificationAlgorithm>::execute_join(
   // Retrieves candidates from the candidate index.
   retrieve_candidates(histogram_collection, candidates, distance_threshold);
 
+  // Index every tree once for the verification.
+  node::TreeIndexCollection<Label,
+      typename VerificationAlgorithm::AlgsTreeIndex> indexed_collection;
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
+  indexed_collection.build(trees_collection, cm);
+
   // Verify all computed join candidates and return the join result.
-  verify_candidates(trees_collection, candidates, join_result, distance_threshold);
+  verify_candidates(indexed_collection, candidates, join_result, distance_threshold);
 }
 
 
 template <typename Label, typename VerificationAlgorithm>
 void DHJoinTI<Label, VerificationAlgorithm>::convert_trees_to_histograms(
     std::vector<node::Node<Label>>& trees_collection,
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection) {
+    data_structures::HistogramCollection& histogram_collection) {
 
   // Convert trees to degree histograms and get the result.
   degree_histogram_converter::Converter<Label> dhc;
@@ -65,12 +86,12 @@ void DHJoinTI<Label, VerificationAlgorithm>::convert_trees_to_histograms(
 
 template <typename Label, typename VerificationAlgorithm>
 void DHJoinTI<Label, VerificationAlgorithm>::retrieve_candidates(
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection,
+    data_structures::HistogramCollection& histogram_collection,
     std::vector<std::pair<int, int>>& candidates,
     const double distance_threshold) {
 
   // Initialize candidate index.
-  dh_candidate_index::CandidateIndex c_index;
+  dh_candidate_index::CandidateIndex c_index(compress_candidate_index_);
 
   // Retrieve candidates from the candidate index.
   c_index.lookup(histogram_collection, candidates, il_size_, distance_threshold);
@@ -79,31 +100,40 @@ void DHJoinTI<Label, VerificationAlgorithm>::retrieve_candidates(
   pre_candidates_ = c_index.get_number_of_pre_candidates();
   // Copy the number of inverted list lookups.
   il_lookups_ = c_index.get_number_of_il_lookups();
+  il_bytes_ = c_index.get_number_of_il_bytes();
 }
 
 template <typename Label, typename VerificationAlgorithm>
 void DHJoinTI<Label, VerificationAlgorithm>::verify_candidates(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result,
     const double distance_threshold) {
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  verify_candidates(indexed_collection, candidates, sink, distance_threshold);
+}
 
-  label::LabelDictionary<Label> ld;
-  typename VerificationAlgorithm::AlgsCostModel cm(ld);
+template <typename Label, typename VerificationAlgorithm>
+void DHJoinTI<Label, VerificationAlgorithm>::verify_candidates(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
   VerificationAlgorithm ted_algorithm(cm);
-  typename VerificationAlgorithm::AlgsTreeIndex ti_1;
-  typename VerificationAlgorithm::AlgsTreeIndex ti_2;
 
   // Verify each pair in the candidate set
   for(const auto& pair: candidates) {
-    node::index_tree(ti_1, trees_collection[pair.first], ld, cm);
-    node::index_tree(ti_2, trees_collection[pair.second], ld, cm);
-    double ted_value = ted_algorithm.ted_k(ti_1, ti_2, distance_threshold);
+    double ted_value = ted_algorithm.ted_k(indexed_collection[pair.first],
+        indexed_collection[pair.second], distance_threshold);
     if(ted_value <= distance_threshold)
       join_result.emplace_back(pair.first, pair.second, ted_value);
     // Sum up all number of subproblems
     sum_subproblem_counter_ += ted_algorithm.get_subproblem_count();
   }
+  join_result.flush();
 }
 
 template <typename Label, typename VerificationAlgorithm>
@@ -122,3 +152,15 @@ long long int
     DHJoinTI<Label, VerificationAlgorithm>::get_number_of_il_lookups() const {
   return il_lookups_;
 }
+
+template <typename Label, typename VerificationAlgorithm>
+std::size_t
+    DHJoinTI<Label, VerificationAlgorithm>::get_number_of_il_bytes() const {
+  return il_bytes_;
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void DHJoinTI<Label, VerificationAlgorithm>::set_candidate_index_compression(
+    const bool compress_lists) {
+  compress_candidate_index_ = compress_lists;
+}
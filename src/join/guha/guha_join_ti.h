@@ -33,8 +33,15 @@
 
 #include <vector>
 #include <random>
+#include <algorithm>
+#include <numeric>
+#include <limits>
 #include "../join_result_element.h"
+#include "../../data_structures/result_sink.h"
+#include "../../data_structures/matrix.h"
+#include "../../parallel/parallel_for.h"
 #include "../../node/node.h"
+#include "../../node/tree_index_collection.h"
 #include "../../ted/apted_tree_index.h"
 #include "../../ted_lb/sed_tree_index.h"
 #include "../../ted_ub/cted_tree_index.h"
@@ -48,12 +55,25 @@ template <typename Label, typename VerificationAlgorithm>
 class GuhaJoinTI {
 // Member functions.
 public:
-  /// Constructor.
+  /// TreeIndex with the indexes of VerificationAlgorithm, SED, CTED, and
+  /// APTED. Every tree is indexed once and used by all these algorithms.
+  typedef node::TreeIndexUnion<node::TreeIndexUnion<
+      typename VerificationAlgorithm::AlgsTreeIndex, node::TreeIndexSCTED>,
+      node::TreeIndexAPTED> JoinTreeIndex;
+  /// Constructor. The vectors and the metric filter are computed in a single
+  /// thread, the metric filter uses the pivot table.
   GuhaJoinTI();
-  /// Implements the original RSB algorithm.
+  /// Constructor.
   ///
-  /// TODO: Guha uses APTED, CTED, SED, and Touzet for verification. Parse
-  ///       trees once and use a super TreeIndex.
+  /// \param number_of_threads Number of threads used to compute the vectors
+  ///                          and by the metric filter. Values smaller than
+  ///                          one use all hardware threads.
+  /// \param use_pivot_table If true, the metric filter sorts the trees by
+  ///                        their distance to the first reference tree and
+  ///                        skips the pairs whose distances to it differ by
+  ///                        more than the threshold.
+  GuhaJoinTI(const int number_of_threads, const bool use_pivot_table = true);
+  /// Implements the original RSB algorithm.
   ///
   /// 1. Computes reference set.
   /// 2. Computes the exact TED from each tree to the reference set.
@@ -72,6 +92,17 @@ public:
       std::vector<join::JoinResultElement>& join_result,
       const double distance_threshold
   );
+  /// Same as execute_rsb_join above, but passes the result pairs to a sink
+  /// instead of a vector.
+  ///
+  /// \param join_result Sink receiving the result pairs. It is flushed before
+  ///        returning.
+  void execute_rsb_join(
+      std::vector<node::Node<Label>>& trees_collection,
+      std::vector<std::pair<int, int>>& candidates,
+      data_structures::ResultSink<join::JoinResultElement>& join_result,
+      const double distance_threshold
+  );
   /// Implements the original RSC algorithm.
   /// 1. Computes reference set.
   /// 2. Computes SED and CTED from each tree to the reference set.
@@ -90,112 +121,182 @@ public:
       std::vector<join::JoinResultElement>& join_result,
       const double distance_threshold
   );
-  /// Computes TED from each tree in trees_collection to all in reference_set,
-  /// and stores the values in ted_vectors.
+  /// Same as execute_rsc_join above, but passes the result pairs to a sink
+  /// instead of a vector.
   ///
-  /// \param trees_collection Input dataset to a join.
+  /// \param join_result Sink receiving the result pairs. It is flushed before
+  ///        returning.
+  void execute_rsc_join(
+      std::vector<node::Node<Label>>& trees_collection,
+      std::vector<std::pair<int, int>>& candidates,
+      data_structures::ResultSink<join::JoinResultElement>& join_result,
+      const double distance_threshold
+  );
+  /// Computes TED from each tree in indexed_collection to all in reference_set,
+  /// and stores the values in ted_vectors. The trees are distributed over the
+  /// threads, each thread uses its own TED algorithm.
+  ///
+  /// \param indexed_collection Indexed input dataset to a join.
   /// \param reference_set Reference set with tree IDs.
-  /// \param ted_vectors Output vector.
+  /// \param ted_vectors Output matrix with one row per tree and one column
+  ///        per reference tree.
   void compute_vectors(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
     std::vector<int>& reference_set,
-    std::vector<std::vector<double>>& ted_vectors
+    data_structures::Matrix<double>& ted_vectors
   );
-  /// Computes SED and CTED from each tree in trees_collection to all in
+  /// Computes SED and CTED from each tree in indexed_collection to all in
   /// reference_set, and stores the values in lb_vectors and ub_vectors,
-  /// respectively.
+  /// respectively. The trees are distributed over the threads, each thread
+  /// uses its own SED and CTED algorithms.
   ///
-  /// \param trees_collection Input dataset to a join.
+  /// \param indexed_collection Indexed input dataset to a join.
   /// \param reference_set Reference set with tree IDs.
-  /// \param lb_vectors Output vector for SED values.
-  /// \param ub_vectors Output vector for CTED values.
+  /// \param lb_vectors Output matrix for SED values.
+  /// \param ub_vectors Output matrix for CTED values.
   void compute_vectors(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
     std::vector<int>& reference_set,
-    std::vector<std::vector<double>>& lb_vectors,
-    std::vector<std::vector<double>>& ub_vectors
+    data_structures::Matrix<double>& lb_vectors,
+    data_structures::Matrix<double>& ub_vectors
   );
   /// Retrieves the candidates based on metric lower and upper bounds using
   /// vectors with TED values.
   ///
+  /// The candidates and the result pairs are ordered by their tree IDs, or
+  /// by their position in the pivot table if it is used. The order does not
+  /// depend on the number of threads.
+  ///
   /// \param candidates Output vecot to store candidates (pairs of tree IDs).
   /// \param join_result Output vector to stor partial join results (pairs of
   ///        tree IDs that passed an upper bound filter).
   /// \param distance_threshold Join similarity threshold.
-  /// \param ted_vectors Vectors with TED values.
+  /// \param ted_vectors Matrix with TED values.
   void retrieve_metric_candidates(
       std::vector<std::pair<int, int>>& candidates,
       std::vector<join::JoinResultElement>& join_result,
       const double distance_threshold,
-      std::vector<std::vector<double>>& ted_vectors
+      const data_structures::Matrix<double>& ted_vectors
+  );
+  /// Same as retrieve_metric_candidates above, but passes the result pairs to a sink
+  /// instead of a vector.
+  ///
+  /// \param join_result Sink receiving the result pairs. It is flushed before
+  ///        returning.
+  void retrieve_metric_candidates(
+      std::vector<std::pair<int, int>>& candidates,
+      data_structures::ResultSink<join::JoinResultElement>& join_result,
+      const double distance_threshold,
+      const data_structures::Matrix<double>& ted_vectors
   );
   /// Retrieves the candidates based on metric lower and upper bounds using
   /// vectors with SED and CTED values.
   ///
+  /// The output is ordered as for the TED vectors.
+  ///
   /// \param trees_collection Input dataset to a join.
   /// \param candidates Output vecot to store candidates (pairs of tree IDs).
   /// \param join_result Output vector to stor partial join results (pairs of
   ///        tree IDs that passed an upper bound filter).
   /// \param distance_threshold Join similarity threshold.
-  /// \param lb_vectors Vectors with SED values.
-  /// \param ub_vectors Vectors with CTED values.
+  /// \param lb_vectors Matrix with SED values.
+  /// \param ub_vectors Matrix with CTED values.
   void retrieve_metric_candidates(
       std::vector<std::pair<int, int>>& candidates,
       std::vector<join::JoinResultElement>& join_result,
       const double distance_threshold,
-      std::vector<std::vector<double>>& lb_vectors,
-      std::vector<std::vector<double>>& ub_vectors
+      const data_structures::Matrix<double>& lb_vectors,
+      const data_structures::Matrix<double>& ub_vectors
+  );
+  /// Same as retrieve_metric_candidates above, but passes the result pairs to a sink
+  /// instead of a vector.
+  ///
+  /// \param join_result Sink receiving the result pairs. It is flushed before
+  ///        returning.
+  void retrieve_metric_candidates(
+      std::vector<std::pair<int, int>>& candidates,
+      data_structures::ResultSink<join::JoinResultElement>& join_result,
+      const double distance_threshold,
+      const data_structures::Matrix<double>& lb_vectors,
+      const data_structures::Matrix<double>& ub_vectors
   );
   /// Refines the join candidates by computing SED and CTED.
   ///
-  /// \param trees_collection Input dataset to a join.
+  /// \param indexed_collection Indexed input dataset to a join.
   /// \param candidates Output vecot to store candidates (pairs of tree IDs).
   /// \param join_result Output vector to stor partial join results (pairs of
   ///        tree IDs that passed an upper bound filter).
   /// \param distance_threshold Join similarity threshold.
   void retrieve_sc_candidates(
-      std::vector<node::Node<Label>>& trees_collection,
+      const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
       std::vector<std::pair<int, int>>& candidates,
       std::vector<join::JoinResultElement>& join_result,
       const double distance_threshold
   );
+  /// Same as retrieve_sc_candidates above, but passes the result pairs to a sink
+  /// instead of a vector.
+  ///
+  /// \param join_result Sink receiving the result pairs. It is flushed before
+  ///        returning.
+  void retrieve_sc_candidates(
+      const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+      std::vector<std::pair<int, int>>& candidates,
+      data_structures::ResultSink<join::JoinResultElement>& join_result,
+      const double distance_threshold
+  );
   /// Verifies the jon candidates by computing APTED.
   ///
-  /// \param trees_collection Input dataset to a join.
+  /// \param indexed_collection Indexed input dataset to a join.
   /// \param candidates Output vecot to store candidates (pairs of tree IDs).
   /// \param join_result Output vector to stor partial join results (pairs of
   ///        tree IDs that passed an upper bound filter).
   /// \param distance_threshold Join similarity threshold.
   void verify_candidates(
-      std::vector<node::Node<Label>>& trees_collection,
+      const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
       std::vector<std::pair<int, int>>& candidates,
       std::vector<join::JoinResultElement>& join_result, 
       const double distance_threshold
   );
+  /// Same as verify_candidates above, but passes the result pairs to a sink
+  /// instead of a vector.
+  ///
+  /// \param join_result Sink receiving the result pairs. It is flushed before
+  ///        returning.
+  void verify_candidates(
+      const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+      std::vector<std::pair<int, int>>& candidates,
+      data_structures::ResultSink<join::JoinResultElement>& join_result,
+      const double distance_threshold
+  );
   /// Computes the reference set if the number of elements is not known.
   /// Implements the original method by Guha.
   ///
+  /// The sample and the reference trees are drawn with the random seed, see
+  /// set_random_seed. The same seed gives the same reference set.
+  ///
   /// NOTE: If too few clusters greater than 1 are found (the input may be too
-  ///       small), `get_random_reference_set(trees_collection, 2)` is returned.
+  ///       small), `get_random_reference_set(indexed_collection, 2)` is
+  ///       returned.
   ///
   /// NOTE: For details see comments in the implementation source code.
   ///
-  /// \param trees_collection Input dataset to a join.
+  /// \param indexed_collection Indexed input dataset to a join.
   /// \param distance_threshold Join similarity threshold.
   /// \return Reference set as a vector of tree IDs.
   std::vector<int> get_reference_set(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
     const double distance_threshold
   );
-  /// Chooses k trees from trees_collection at random.
+  /// Chooses k trees from indexed_collection at random, drawn with the
+  /// random seed.
   /// 
   /// NOTE: It was the first and easiest way to get a reference set.
   ///
-  /// \param trees_collection Input dataset to a join.
+  /// \param indexed_collection Indexed input dataset to a join.
   /// \param k Size of reference set.
   /// \return Reference set as a vector of tree IDs.
   std::vector<int> get_random_reference_set(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
     int k
   );
   /// Computes the metric upper bound using either TED or CTED values.
@@ -205,6 +306,12 @@ public:
   /// Computes the metric upper bound using SED and CTED values.
   double l_t(std::vector<double>& lb_v_i, std::vector<double>& ub_v_i,
       std::vector<double>& lb_v_j, std::vector<double>& ub_v_j);
+  /// Sets the seed of the random generator used to choose the reference set.
+  /// The default seed is 1.
+  void set_random_seed(const unsigned int seed);
+  /// Returns the seed of the random generator used to choose the reference
+  /// set.
+  unsigned int get_random_seed() const;
   /// Returns the number of candidates resulting from metric lower bound.
   long long int get_l_t_candidates() const;
   /// Returns the number of candidates resulting from SED lower bound.
@@ -214,8 +321,19 @@ public:
   /// Returns the number of result set pairs comming from CTED upper bound.
   long long int get_cted_result_pairs() const;
 private:
-  /// LabelDictionary for using with LGMTreeIndex and VerificationAlgorithm.
-  label::LabelDictionary<Label> ld_;
+  /// Number of trees whose metric lower bounds to one tree are computed in
+  /// one go.
+  static constexpr std::size_t kMetricBlockSize = 256;
+  /// Number of trees whose pairs are filtered by a thread in one go.
+  static constexpr std::size_t kMetricChunkSize = 16;
+  /// Number of trees whose vectors are computed by a thread in one go.
+  static constexpr std::size_t kVectorChunkSize = 8;
+  /// Number of threads used to compute the vectors and by the metric filter.
+  unsigned int number_of_threads_;
+  /// Seed of the random generator used to choose the reference set.
+  unsigned int random_seed_;
+  /// Whether the metric filter restricts the pairs with the pivot table.
+  bool use_pivot_table_;
   /// Stores the number of candidates resulting from metric lower bound.
   long long int l_t_candidates_;
   /// Stores the number of candidates resulting from SED lower bound.
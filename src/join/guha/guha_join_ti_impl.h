@@ -27,8 +27,14 @@
 #pragma once
 
 template <typename Label, typename VerificationAlgorithm>
-GuhaJoinTI<Label, VerificationAlgorithm>::GuhaJoinTI() {
-  ld_ = label::LabelDictionary<Label>();
+GuhaJoinTI<Label, VerificationAlgorithm>::GuhaJoinTI() : GuhaJoinTI(1) {}
+
+template <typename Label, typename VerificationAlgorithm>
+GuhaJoinTI<Label, VerificationAlgorithm>::GuhaJoinTI(
+    const int number_of_threads, const bool use_pivot_table) {
+  number_of_threads_ = parallel::get_number_of_threads(number_of_threads);
+  use_pivot_table_ = use_pivot_table;
+  random_seed_ = 1;
   l_t_candidates_ = 0;
   sed_candidates_ = 0;
   u_t_result_pairs_ = 0;
@@ -41,22 +47,38 @@ void GuhaJoinTI<Label, VerificationAlgorithm>::execute_rsb_join(
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result,
     const double distance_threshold) {
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  execute_rsb_join(trees_collection, candidates, sink, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void GuhaJoinTI<Label, VerificationAlgorithm>::execute_rsb_join(
+    std::vector<node::Node<Label>>& trees_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
+
+  // Index every tree once for all algorithms.
+  node::TreeIndexCollection<Label, JoinTreeIndex> indexed_collection;
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
+  indexed_collection.build(trees_collection, cm);
   
   std::vector<int> reference_set = get_reference_set(
-      trees_collection, distance_threshold
+      indexed_collection, distance_threshold
   );
   
-  std::vector<std::vector<double>> ted_vectors(trees_collection.size(), std::vector<double>(reference_set.size()));
+  data_structures::Matrix<double> ted_vectors(indexed_collection.size(), reference_set.size());
   
   // Compute the vectors.
-  compute_vectors(trees_collection, reference_set, ted_vectors);
+  compute_vectors(indexed_collection, reference_set, ted_vectors);
   
   // Retrieves candidates from the candidate index.
-  retrieve_metric_candidates(trees_collection, candidates, join_result, distance_threshold, ted_vectors);
-  retrieve_sc_candidates(trees_collection, candidates, join_result, distance_threshold);
+  retrieve_metric_candidates(candidates, join_result, distance_threshold, ted_vectors);
+  retrieve_sc_candidates(indexed_collection, candidates, join_result, distance_threshold);
 
   // Verify all computed join candidates and return the join result.
-  verify_candidates(trees_collection, candidates, join_result, distance_threshold);
+  verify_candidates(indexed_collection, candidates, join_result, distance_threshold);
 }
 
 template <typename Label, typename VerificationAlgorithm>
@@ -65,78 +87,103 @@ void GuhaJoinTI<Label, VerificationAlgorithm>::execute_rsc_join(
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result,
     const double distance_threshold) {
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  execute_rsc_join(trees_collection, candidates, sink, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void GuhaJoinTI<Label, VerificationAlgorithm>::execute_rsc_join(
+    std::vector<node::Node<Label>>& trees_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
+
+  // Index every tree once for all algorithms.
+  node::TreeIndexCollection<Label, JoinTreeIndex> indexed_collection;
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
+  indexed_collection.build(trees_collection, cm);
   
   std::vector<int> reference_set = get_reference_set(
-      trees_collection, distance_threshold
+      indexed_collection, distance_threshold
   );
   
-  std::vector<std::vector<double>> lb_vectors(trees_collection.size(), std::vector<double>(reference_set.size()));
-  std::vector<std::vector<double>> ub_vectors(trees_collection.size(), std::vector<double>(reference_set.size()));
+  data_structures::Matrix<double> lb_vectors(indexed_collection.size(), reference_set.size());
+  data_structures::Matrix<double> ub_vectors(indexed_collection.size(), reference_set.size());
   
   // Compute the vectors.
-  compute_vectors(trees_collection, reference_set, lb_vectors, ub_vectors);
+  compute_vectors(indexed_collection, reference_set, lb_vectors, ub_vectors);
   
   // Retrieves candidates from the candidate index.
   retrieve_metric_candidates(candidates, join_result, distance_threshold, lb_vectors, ub_vectors);
-  retrieve_sc_candidates(trees_collection, candidates, join_result, distance_threshold);
+  retrieve_sc_candidates(indexed_collection, candidates, join_result, distance_threshold);
 
   // Verify all computed join candidates and return the join result.
-  verify_candidates(trees_collection, candidates, join_result, distance_threshold);
+  verify_candidates(indexed_collection, candidates, join_result, distance_threshold);
 }
 
 template <typename Label, typename VerificationAlgorithm>
 void GuhaJoinTI<Label, VerificationAlgorithm>::compute_vectors(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
     std::vector<int>& reference_set,
-    std::vector<std::vector<double>>& ted_vectors) {
+    data_structures::Matrix<double>& ted_vectors) {
   // For each tree in the collection compute the distance to every element
-  // in the reference set. Store the values in a seperate vector for each tree.
-  typename VerificationAlgorithm::AlgsCostModel cm(ld_);
-  ted::APTEDTreeIndex<typename VerificationAlgorithm::AlgsCostModel> ted_algorithm(cm);
-  node::TreeIndexAPTED ti_1;
-  node::TreeIndexAPTED ti_2;
-  int data_tree_id = 0;
-  int rs_tree_id = 0;
-  for (auto t : trees_collection) {
-    node::index_tree(ti_1, t, ld_, cm);
-    rs_tree_id = 0;
-    for (auto t_id_rs : reference_set) {
-      node::index_tree(ti_2, trees_collection[t_id_rs], ld_, cm);
-      ted_vectors[data_tree_id][rs_tree_id] = ted_algorithm.ted(ti_1, ti_2);
-      ++rs_tree_id;
+  // in the reference set. Store the values in a seperate row for each tree.
+  // The trees are indexed once, the threads only read the indexes and write
+  // the rows of their chunks.
+  using AlgsCostModel = typename VerificationAlgorithm::AlgsCostModel;
+  AlgsCostModel cm(indexed_collection.get_label_dictionary());
+  parallel::ChunkQueue chunks(indexed_collection.size(), kVectorChunkSize);
+  parallel::run_workers(number_of_threads_, [&](const unsigned int) {
+    ted::APTEDTreeIndex<AlgsCostModel, JoinTreeIndex> ted_algorithm(cm);
+    std::size_t chunk_id = 0;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    while (chunks.next(chunk_id, begin, end)) {
+      for (std::size_t data_tree_id = begin; data_tree_id < end; ++data_tree_id) {
+        int rs_tree_id = 0;
+        for (auto t_id_rs : reference_set) {
+          ted_vectors.at(data_tree_id, rs_tree_id) = ted_algorithm.ted(
+              indexed_collection[data_tree_id], indexed_collection[t_id_rs]);
+          ++rs_tree_id;
+        }
+      }
     }
-    ++data_tree_id;
-  }
+  });
 }
 
 template <typename Label, typename VerificationAlgorithm>
 void GuhaJoinTI<Label, VerificationAlgorithm>::compute_vectors(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
     std::vector<int>& reference_set,
-    std::vector<std::vector<double>>& lb_vectors,
-    std::vector<std::vector<double>>& ub_vectors) {
+    data_structures::Matrix<double>& lb_vectors,
+    data_structures::Matrix<double>& ub_vectors) {
   // For each tree in the collection compute the distance to every element
-  // in the reference set. Store the values in a seperate vector for each tree.
+  // in the reference set. Store the values in a seperate row for each tree.
+  // The trees are indexed once, the threads only read the indexes and write
+  // the rows of their chunks.
   using AlgsCostModel = typename VerificationAlgorithm::AlgsCostModel;
-  AlgsCostModel cm(ld_);
-  ted_lb::SEDTreeIndex<AlgsCostModel, node::TreeIndexSCTED> sed_lb(cm);
-  ted_ub::CTEDTreeIndex<AlgsCostModel, node::TreeIndexSCTED> cted_ub(cm);
-  node::TreeIndexSCTED ti_1;
-  node::TreeIndexSCTED ti_2;
-
-  int data_tree_id = 0;
-  int rs_tree_id = 0;
-  for (auto t : trees_collection) {
-    node::index_tree(ti_1, t, ld_, cm);
-    rs_tree_id = 0;
-    for (auto t_id_rs : reference_set) {
-      node::index_tree(ti_2, trees_collection[t_id_rs], ld_, cm);
-      lb_vectors[data_tree_id][rs_tree_id] = sed_lb.ted(ti_1, ti_2);
-      ub_vectors[data_tree_id][rs_tree_id] = cted_ub.ted(ti_1, ti_2);
-      ++rs_tree_id;
+  AlgsCostModel cm(indexed_collection.get_label_dictionary());
+  parallel::ChunkQueue chunks(indexed_collection.size(), kVectorChunkSize);
+  parallel::run_workers(number_of_threads_, [&](const unsigned int) {
+    ted_lb::SEDTreeIndex<AlgsCostModel, JoinTreeIndex> sed_lb(cm);
+    ted_ub::CTEDTreeIndex<AlgsCostModel, JoinTreeIndex> cted_ub(cm);
+    std::size_t chunk_id = 0;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    while (chunks.next(chunk_id, begin, end)) {
+      for (std::size_t data_tree_id = begin; data_tree_id < end; ++data_tree_id) {
+        const JoinTreeIndex& ti_1 = indexed_collection[data_tree_id];
+        int rs_tree_id = 0;
+        for (auto t_id_rs : reference_set) {
+          const JoinTreeIndex& ti_2 = indexed_collection[t_id_rs];
+          lb_vectors.at(data_tree_id, rs_tree_id) = sed_lb.ted(ti_1, ti_2);
+          ub_vectors.at(data_tree_id, rs_tree_id) = cted_ub.ted(ti_1, ti_2);
+          ++rs_tree_id;
+        }
+      }
     }
-    ++data_tree_id;
-  }
+  });
 }
 
 template <typename Label, typename VerificationAlgorithm>
@@ -144,28 +191,22 @@ void GuhaJoinTI<Label, VerificationAlgorithm>::retrieve_metric_candidates(
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result,
     const double distance_threshold,
-    std::vector<std::vector<double>>& ted_vectors) {
-  
-  // For each ted vector pair, verify the triangle unequality lower bound
-  // condition. If the condition is satisfied, add the pair to candidate set.
-  double pair_l_t = 0;
-  double pair_u_t = 0;
-  for (int v1_id = 0; v1_id < ted_vectors.size(); ++v1_id) {
-    for (int v2_id = v1_id+1; v2_id < ted_vectors.size(); ++v2_id) {
-      // std::cout << v1_id << "," << v2_id << std::endl;
-      pair_l_t = l_t(ted_vectors[v1_id], ted_vectors[v2_id]);
-      if (pair_l_t <= distance_threshold) {
-        ++l_t_candidates_;
-        pair_u_t = u_t(ted_vectors[v1_id], ted_vectors[v2_id]);
-        if (pair_u_t <= distance_threshold) {
-          ++u_t_result_pairs_;
-          join_result.emplace_back(v1_id, v2_id, pair_u_t);
-          continue;
-        }
-        candidates.push_back({v1_id, v2_id});
-      }
-    }
-  }
+    const data_structures::Matrix<double>& ted_vectors) {
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  retrieve_metric_candidates(candidates, sink, distance_threshold, ted_vectors);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void GuhaJoinTI<Label, VerificationAlgorithm>::retrieve_metric_candidates(
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold,
+    const data_structures::Matrix<double>& ted_vectors) {
+  // With exact TED values, both interval bounds of a tree are the same and
+  // the SED/CTED metric bounds become the TED ones: the gap between the
+  // intervals is |TED(i,l) - TED(j,l)| and the upper bound is a sum of TEDs.
+  retrieve_metric_candidates(candidates, join_result, distance_threshold,
+      ted_vectors, ted_vectors);
 }
 
 template <typename Label, typename VerificationAlgorithm>
@@ -173,52 +214,160 @@ void GuhaJoinTI<Label, VerificationAlgorithm>::retrieve_metric_candidates(
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result,
     const double distance_threshold,
-    std::vector<std::vector<double>>& lb_vectors,
-    std::vector<std::vector<double>>& ub_vectors) {
-  
-  // For each ted vector pair, verify the triangle unequality lower bound
-  // condition. If the condition is satisfied, add the pair to candidate set.
-  double pair_l_t = 0;
-  double pair_u_t = 0;
-  for (std::size_t v1_id = 0; v1_id < lb_vectors.size(); ++v1_id) {
-    for (std::size_t v2_id = v1_id+1; v2_id < lb_vectors.size(); ++v2_id) {
-      // std::cout << v1_id << "," << v2_id << std::endl;
-      pair_l_t = l_t(lb_vectors[v1_id], ub_vectors[v1_id], lb_vectors[v2_id], ub_vectors[v2_id]);
-      if (pair_l_t <= distance_threshold) {
-        ++l_t_candidates_;
-        pair_u_t = u_t(ub_vectors[v1_id], ub_vectors[v2_id]);
-        if (pair_u_t <= distance_threshold) {
-          ++u_t_result_pairs_;
-          join_result.emplace_back(v1_id, v2_id, pair_u_t);
-          continue;
-        }
-        candidates.push_back({v1_id, v2_id});
-      }
+    const data_structures::Matrix<double>& lb_vectors,
+    const data_structures::Matrix<double>& ub_vectors) {
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  retrieve_metric_candidates(candidates, sink, distance_threshold, lb_vectors,
+      ub_vectors);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void GuhaJoinTI<Label, VerificationAlgorithm>::retrieve_metric_candidates(
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold,
+    const data_structures::Matrix<double>& lb_vectors,
+    const data_structures::Matrix<double>& ub_vectors) {
+
+  const std::size_t collection_size = lb_vectors.get_rows();
+  const std::size_t reference_set_size = lb_vectors.get_columns();
+
+  // Order in which the trees are filtered. For the pivot table, the trees are
+  // sorted by their lower bound to the first reference tree. The pairs of a
+  // tree i with trees j later in that order can only pass the metric lower
+  // bound as long as lb(j,0) - ub(i,0) <= distance_threshold, which is a
+  // prefix of the following trees.
+  const bool use_pivot_table = use_pivot_table_ && reference_set_size > 0;
+  std::vector<int> order(collection_size);
+  std::iota(order.begin(), order.end(), 0);
+  if (use_pivot_table) {
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+      return lb_vectors.read_at(a, 0) < lb_vectors.read_at(b, 0);
+    });
+  }
+
+  // Store the vectors column by column in the filter order. The values of
+  // consecutive trees for one reference tree are contiguous, and the metric
+  // lower bounds of a block of pairs are computed in a branch-free loop that
+  // the compiler vectorises.
+  std::vector<double> lb_columns(reference_set_size * collection_size);
+  std::vector<double> ub_columns(reference_set_size * collection_size);
+  for (std::size_t p = 0; p < collection_size; ++p) {
+    for (std::size_t l = 0; l < reference_set_size; ++l) {
+      lb_columns[l * collection_size + p] = lb_vectors.read_at(order[p], l);
+      ub_columns[l * collection_size + p] = ub_vectors.read_at(order[p], l);
     }
   }
+
+  // Every chunk of trees keeps its result pairs and candidates separately,
+  // they are passed on in the chunk order as soon as all earlier chunks are
+  // filtered.
+  parallel::ChunkQueue chunks(collection_size, kMetricChunkSize);
+  parallel::ChunkSequencer sequencer(
+      parallel::kPendingChunksPerThread * number_of_threads_);
+  std::vector<std::vector<join::JoinResultElement>> chunk_results(
+      chunks.get_number_of_chunks());
+  std::vector<std::vector<std::pair<int, int>>> chunk_candidates(
+      chunks.get_number_of_chunks());
+
+  parallel::run_workers(number_of_threads_, [&](const unsigned int) {
+    std::vector<double> block_l_t(kMetricBlockSize);
+
+    sequencer.run(chunks, [&](const std::size_t chunk_id,
+        const std::size_t begin, const std::size_t end) {
+      for (std::size_t p_1 = begin; p_1 < end; ++p_1) {
+        std::size_t last = collection_size;
+        if (use_pivot_table) {
+          const double ub_pivot = ub_columns[p_1];
+          last = std::partition_point(
+              lb_columns.begin() + p_1 + 1, lb_columns.begin() + collection_size,
+              [&](const double lb_pivot) {
+                return lb_pivot - ub_pivot <= distance_threshold;
+              }) - lb_columns.begin();
+        }
+        for (std::size_t block_begin = p_1 + 1; block_begin < last;
+            block_begin += kMetricBlockSize) {
+          const std::size_t block_size =
+              std::min(kMetricBlockSize, last - block_begin);
+          // Metric lower bound of the pairs in the block. Since
+          // lb <= TED <= ub, the gap between the intervals of i and j is the
+          // larger of the two differences, or zero if they overlap.
+          std::fill(block_l_t.begin(), block_l_t.begin() + block_size, 0.0);
+          for (std::size_t l = 0; l < reference_set_size; ++l) {
+            const double lb_i = lb_columns[l * collection_size + p_1];
+            const double ub_i = ub_columns[l * collection_size + p_1];
+            const double* lb_j = &lb_columns[l * collection_size + block_begin];
+            const double* ub_j = &ub_columns[l * collection_size + block_begin];
+            for (std::size_t b = 0; b < block_size; ++b) {
+              block_l_t[b] = std::max(block_l_t[b],
+                  std::max(lb_j[b] - ub_i, lb_i - ub_j[b]));
+            }
+          }
+          // The metric upper bound is computed only for the pairs that pass
+          // the lower bound.
+          for (std::size_t b = 0; b < block_size; ++b) {
+            if (block_l_t[b] > distance_threshold) {
+              continue;
+            }
+            const std::size_t p_2 = block_begin + b;
+            double pair_u_t = std::numeric_limits<double>::infinity();
+            for (std::size_t l = 0; l < reference_set_size; ++l) {
+              pair_u_t = std::min(pair_u_t, ub_columns[l * collection_size + p_1] +
+                  ub_columns[l * collection_size + p_2]);
+            }
+            const int v1_id = std::min(order[p_1], order[p_2]);
+            const int v2_id = std::max(order[p_1], order[p_2]);
+            if (pair_u_t <= distance_threshold) {
+              chunk_results[chunk_id].emplace_back(v1_id, v2_id, pair_u_t);
+            } else {
+              chunk_candidates[chunk_id].push_back({v1_id, v2_id});
+            }
+          }
+        }
+      }
+    }, [&](const std::size_t c) {
+      l_t_candidates_ += chunk_results[c].size() + chunk_candidates[c].size();
+      u_t_result_pairs_ += chunk_results[c].size();
+      join_result.append(chunk_results[c]);
+      candidates.insert(candidates.end(), chunk_candidates[c].begin(),
+          chunk_candidates[c].end());
+      std::vector<join::JoinResultElement>().swap(chunk_results[c]);
+      std::vector<std::pair<int, int>>().swap(chunk_candidates[c]);
+    });
+  });
+  join_result.flush();
 }
 
 template <typename Label, typename VerificationAlgorithm>
 void GuhaJoinTI<Label, VerificationAlgorithm>::retrieve_sc_candidates(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result,
     const double distance_threshold) {
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  retrieve_sc_candidates(indexed_collection, candidates, sink,
+      distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void GuhaJoinTI<Label, VerificationAlgorithm>::retrieve_sc_candidates(
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
   
   // For each ted vector pair, verify the triangle unequality lower bound
   // condition. If the condition is satisfied, add the pair to candidate set.
   using AlgsCostModel = typename VerificationAlgorithm::AlgsCostModel;
-  AlgsCostModel cm(ld_);
-  ted_lb::SEDTreeIndex<AlgsCostModel, node::TreeIndexSCTED> sed_lb(cm);
-  ted_ub::CTEDTreeIndex<AlgsCostModel, node::TreeIndexSCTED> cted_ub(cm);
-  node::TreeIndexSCTED ti_1;
-  node::TreeIndexSCTED ti_2;
+  AlgsCostModel cm(indexed_collection.get_label_dictionary());
+  ted_lb::SEDTreeIndex<AlgsCostModel, JoinTreeIndex> sed_lb(cm);
+  ted_ub::CTEDTreeIndex<AlgsCostModel, JoinTreeIndex> cted_ub(cm);
   double pair_l_t = 0;
   double pair_u_t = 0;
   auto it = candidates.begin();
   while(it != candidates.end()) {
-    node::index_tree(ti_1, trees_collection[it->first], ld_, cm);
-    node::index_tree(ti_2, trees_collection[it->second], ld_, cm);
+    const JoinTreeIndex& ti_1 = indexed_collection[it->first];
+    const JoinTreeIndex& ti_2 = indexed_collection[it->second];
     pair_l_t = sed_lb.ted(ti_1, ti_2);
     if (pair_l_t <= distance_threshold) {
       ++sed_candidates_;
@@ -240,43 +389,53 @@ void GuhaJoinTI<Label, VerificationAlgorithm>::retrieve_sc_candidates(
       candidates.pop_back();
     }
   }
+  join_result.flush();
 }
 
 template <typename Label, typename VerificationAlgorithm>
 void GuhaJoinTI<Label, VerificationAlgorithm>::verify_candidates(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result,
     const double distance_threshold) {
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  verify_candidates(indexed_collection, candidates, sink, distance_threshold);
+}
 
-  typename VerificationAlgorithm::AlgsCostModel cm(ld_);
+template <typename Label, typename VerificationAlgorithm>
+void GuhaJoinTI<Label, VerificationAlgorithm>::verify_candidates(
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
 
   VerificationAlgorithm ted_algorithm(cm);
-  typename VerificationAlgorithm::AlgsTreeIndex ti_1;
-  typename VerificationAlgorithm::AlgsTreeIndex ti_2;
 
   // Verify each pair in the candidate set
   for(const auto& pair: candidates) {
-    node::index_tree(ti_1, trees_collection[pair.first], ld_, cm);
-    node::index_tree(ti_2, trees_collection[pair.second], ld_, cm);
-    double ted_value = ted_algorithm.ted_k(ti_1, ti_2, distance_threshold);
+    double ted_value = ted_algorithm.ted_k(indexed_collection[pair.first],
+        indexed_collection[pair.second], distance_threshold);
     if(ted_value <= distance_threshold)
       join_result.emplace_back(pair.first, pair.second, ted_value);
   }
+  join_result.flush();
 }
 
 template <typename Label, typename VerificationAlgorithm>
 std::vector<int> GuhaJoinTI<Label, VerificationAlgorithm>::get_reference_set(
-  std::vector<node::Node<Label>>& trees_collection,
+  const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
   const double distance_threshold) {
     // Get sample size.
-    // According to Guha, at least O(sqrt(|T|)*log(|T|)), where |T|=trees_collection.size().
+    // According to Guha, at least O(sqrt(|T|)*log(|T|)), where |T|=indexed_collection.size().
     // We use 1*sqrt(|T|)*log(|T|).
-    int collection_size = trees_collection.size();
+    int collection_size = indexed_collection.size();
     int sample_size = static_cast <int> (std::ceil(std::sqrt(collection_size) * std::log10(collection_size)));
     
     // Random generator.
-    std::mt19937 rd(1); // Fix the seed.
+    std::mt19937 rd(random_seed_);
     std::uniform_int_distribution<int> dist;
     
     // Draw the sample.
@@ -287,10 +446,9 @@ std::vector<int> GuhaJoinTI<Label, VerificationAlgorithm>::get_reference_set(
     }
     
     // Cluster the sample.
-    typename VerificationAlgorithm::AlgsCostModel cm(ld_);
-    ted::APTEDTreeIndex<typename VerificationAlgorithm::AlgsCostModel> ted_algorithm(cm);
-    node::TreeIndexAPTED ti_sample_tree;
-    node::TreeIndexAPTED ti_tree_id;
+    using AlgsCostModel = typename VerificationAlgorithm::AlgsCostModel;
+    AlgsCostModel cm(indexed_collection.get_label_dictionary());
+    ted::APTEDTreeIndex<AlgsCostModel, JoinTreeIndex> ted_algorithm(cm);
     std::vector<std::vector<int>> clusters;
     std::vector<int> remaining_sample(sample);
     std::vector<int> temp_remaining_sample;
@@ -300,16 +458,14 @@ std::vector<int> GuhaJoinTI<Label, VerificationAlgorithm>::get_reference_set(
       dist = std::uniform_int_distribution<int>(0, remaining_sample.size()-1);
       sample_tree_id = remaining_sample[dist(rd)];
       std::vector<int> new_cluster;
-      auto& sample_tree = trees_collection[sample_tree_id];
-      node::index_tree(ti_sample_tree, sample_tree, ld_, cm);
+      const JoinTreeIndex& ti_sample_tree = indexed_collection[sample_tree_id];
       for (auto tree_id : remaining_sample) {
         // Skip computing self distance between sample tree and itself.
         // Add the tree to the cluster.
         if (tree_id == sample_tree_id) {
           new_cluster.push_back(tree_id);
         } else {
-          node::index_tree(ti_tree_id, trees_collection[tree_id], ld_, cm);
-          if (ted_algorithm.ted(ti_tree_id, ti_sample_tree) <= std::ceil(distance_threshold / 2.0)) {
+          if (ted_algorithm.ted(indexed_collection[tree_id], ti_sample_tree) <= std::ceil(distance_threshold / 2.0)) {
             new_cluster.push_back(tree_id);
           } else {
             temp_remaining_sample.push_back(tree_id);
@@ -325,7 +481,7 @@ std::vector<int> GuhaJoinTI<Label, VerificationAlgorithm>::get_reference_set(
 
     // FIX for small inputs when too few or to small clusters are found.
     if (clusters.size() <= 2) {
-      return get_random_reference_set(trees_collection, 2);
+      return get_random_reference_set(indexed_collection, 2);
     }
     
     // Sort the clusters by size.
@@ -366,11 +522,11 @@ std::vector<int> GuhaJoinTI<Label, VerificationAlgorithm>::get_reference_set(
 
 template <typename Label, typename VerificationAlgorithm>
 std::vector<int> GuhaJoinTI<Label, VerificationAlgorithm>::get_random_reference_set(
-  std::vector<node::Node<Label>>& trees_collection,
+  const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
   int k) {
     std::vector<int> reference_set;
-    std::mt19937 rd(1); // Fix the seed.
-    std::uniform_int_distribution<int> nodes_dist(0, trees_collection.size()-1);
+    std::mt19937 rd(random_seed_);
+    std::uniform_int_distribution<int> nodes_dist(0, indexed_collection.size()-1);
     for (int i = 0; i < k; ++i) {
       reference_set.push_back(nodes_dist(rd));
     }
@@ -418,6 +574,17 @@ double GuhaJoinTI<Label, VerificationAlgorithm>::l_t(
   return global_maximum;
 }
 
+template <typename Label, typename VerificationAlgorithm>
+void GuhaJoinTI<Label, VerificationAlgorithm>::set_random_seed(
+    const unsigned int seed) {
+  random_seed_ = seed;
+}
+
+template <typename Label, typename VerificationAlgorithm>
+unsigned int GuhaJoinTI<Label, VerificationAlgorithm>::get_random_seed() const {
+  return random_seed_;
+}
+
 template <typename Label, typename VerificationAlgorithm>
 long long int GuhaJoinTI<Label, VerificationAlgorithm>::get_l_t_candidates() const {
   return l_t_candidates_;
@@ -25,6 +25,10 @@
 /// Implements a candidate index that efficiently and effectively returns tree 
 /// pairs that satisfy the label, leaf distance and degree histogram lower bound 
 /// by Kailing et al and Li et al. 
+///
+/// The entries of the inverted lists can be stored in variable-byte encoding
+/// (see data_structures/var_byte_pair_list.h). This takes less memory for
+/// large collections, but the entries are decoded on every lookup.
 
 #pragma once
 
@@ -32,8 +36,9 @@
 #include <climits>
 #include <algorithm>
 #include <vector>
-#include <unordered_map>
 #include "../../node/node.h"
+#include "../../data_structures/histogram_collection.h"
+#include "../../data_structures/pair_inverted_list.h"
 
 namespace histo_candidate_index {
 
@@ -42,6 +47,11 @@ class CandidateIndex {
 public:
   /// Constructor.
   CandidateIndex();
+  /// Constructor.
+  ///
+  /// \param compress_lists True if the entries of the inverted lists are
+  ///                       stored in variable-byte encoding.
+  CandidateIndex(const bool compress_lists);
   /// Returns a set of candidates that satisfy the histogram lower bound. 
   ///
   /// \param label_histogram_collection Collection of all label histograms.
@@ -51,9 +61,9 @@ public:
   /// \param il_size Size of the inverted list.
   /// \param distance_threshold Given similarity threshold.
   void lookup(
-      std::vector<std::pair<int, std::unordered_map<int, int>>>& label_histogram_collection,
-      std::vector<std::pair<int, std::unordered_map<int, int>>>& degree_histogram_collection,
-      std::vector<std::pair<int, std::unordered_map<int, int>>>& leaf_distance_histogram_collection, 
+      const data_structures::HistogramCollection& label_histogram_collection,
+      const data_structures::HistogramCollection& degree_histogram_collection,
+      const data_structures::HistogramCollection& leaf_distance_histogram_collection, 
       std::vector<std::pair<int, int>>& join_candidates,
       const int il_size,
       const double distance_threshold);
@@ -67,12 +77,20 @@ public:
   ///
   /// \return The number of lookups in the inverted list.
   long int get_number_of_il_lookups() const;
+  /// Returns the number of bytes of the inverted lists of the last lookup.
+  ///
+  /// \return The number of bytes of the inverted lists.
+  std::size_t get_number_of_il_bytes() const;
 // Member variables.
 private:
   /// Number of precandidates.
   long int pre_candidates_;
   /// Number of lookups in the inverted list.
   long int il_lookups_;
+  /// True if the entries of the inverted lists are compressed.
+  bool compress_lists_;
+  /// Number of bytes of the inverted lists of the last lookup.
+  std::size_t il_bytes_;
 };
 
 // Implementation details.
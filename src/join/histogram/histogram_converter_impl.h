@@ -33,37 +33,40 @@ Converter<Label>::Converter() {}
 template<typename Label>
 void Converter<Label>::create_histogram(
     const std::vector<node::Node<Label>>& trees_collection,
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& label_histogram_collection,
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& degree_histogram_collection,
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& leaf_distance_histogram_collection) {
+    data_structures::HistogramCollection& label_histogram_collection,
+    data_structures::HistogramCollection& degree_histogram_collection,
+    data_structures::HistogramCollection& leaf_distance_histogram_collection) {
 
+  // stores the label id of every node of the current tree
+  std::vector<int> label_histogram;
+  // stores the leaf distance of every node of the current tree
+  std::vector<int> leaf_dist_histogram;
+  // stores the degree of every node of the current tree
+  std::vector<int> degree_histogram;
   // for each tree in the tree collection
   for (const auto& tree: trees_collection) {
-    // stores the number of nodes per label
-    std::unordered_map<int, int> label_histogram;
-    // stores the number of nodes per leaf distance
-    std::unordered_map<int, int> leaf_dist_histogram;
-    // stores the number of nodes per degree
-    std::unordered_map<int, int> degree_histogram;
+    label_histogram.clear();
+    leaf_dist_histogram.clear();
+    degree_histogram.clear();
     // size of the current tree
     int tree_size = 0;
     // traverse tree and store number of nodes per label
     create_histrograms(tree, label_histogram, degree_histogram, leaf_dist_histogram, tree_size);
     // add label histogram to collection
-    label_histogram_collection.emplace_back(tree_size, label_histogram);
+    label_histogram_collection.add_histogram(tree_size, label_histogram);
     // add degree histogram to collection
-    degree_histogram_collection.emplace_back(tree_size, degree_histogram);
+    degree_histogram_collection.add_histogram(tree_size, degree_histogram);
     // add leaf distance histogram to collection
-    leaf_distance_histogram_collection.emplace_back(tree_size, leaf_dist_histogram);
+    leaf_distance_histogram_collection.add_histogram(tree_size, leaf_dist_histogram);
   }
 }
 
 template<typename Label>
 int Converter<Label>::create_histrograms(
     const node::Node<Label>& tree_node, 
-    std::unordered_map<int, int>& label_histogram, 
-    std::unordered_map<int, int>& degree_histogram, 
-    std::unordered_map<int, int>& leaf_dist_histogram, 
+    std::vector<int>& label_histogram, 
+    std::vector<int>& degree_histogram, 
+    std::vector<int>& leaf_dist_histogram, 
     int& tree_size) {
 
   // count number of children
@@ -82,11 +85,11 @@ int Converter<Label>::create_histrograms(
   // handle leaf distance histogram
   // the leaf distance is the minimum leaf distance of a nodes children + 1
   ++max_child_leaf_dist;
-  // increase leaf distance count for current node
-  ++leaf_dist_histogram[max_child_leaf_dist];
+  // add the leaf distance of the current node, counted by the collection
+  leaf_dist_histogram.push_back(max_child_leaf_dist);
 
   // handle degree histogram - increase degree count for current node
-  ++degree_histogram[number_of_children];
+  degree_histogram.push_back(number_of_children);
 
   // handle label histogram
   Label key = tree_node.label();
@@ -100,8 +103,8 @@ int Converter<Label>::create_histrograms(
     // add label id to map
     label_id_map_[key] = label_id_++;
 
-  // increase label count for current node
-  ++label_histogram[label_id_map_[key]];
+  // add the label of the current node, counted by the collection
+  label_histogram.push_back(label_id_map_[key]);
   // increase tree size
   ++tree_size;
 
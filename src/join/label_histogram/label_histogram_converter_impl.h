@@ -33,25 +33,26 @@ Converter<Label>::Converter() {}
 template<typename Label>
 void Converter<Label>::create_histogram(
     const std::vector<node::Node<Label>>& trees_collection,
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection) {
+    data_structures::HistogramCollection& histogram_collection) {
 
+  // stores the label id of every node of the current tree
+  std::vector<int> label_histogram;
   // for each tree in the tree collection
   for (const auto& tree: trees_collection) {
-    // stores the number of nodes per label
-    std::unordered_map<int, int> label_histogram;
+    label_histogram.clear();
     // stores the number of nodes per label
     int tree_size = 0;
     // traverse tree and store number of nodes per label
     create_label_histrogram(tree, label_histogram, tree_size);
     // add label histogram to collection
-    histogram_collection.emplace_back(tree_size, label_histogram);
+    histogram_collection.add_histogram(tree_size, label_histogram);
   }
 }
 
 template<typename Label>
 void Converter<Label>::create_label_histrogram(
     const node::Node<Label>& tree_node, 
-    std::unordered_map<int, int>& label_histogram, 
+    std::vector<int>& label_histogram, 
     int& tree_size) {
 
   // do recursively for all children
@@ -70,8 +71,8 @@ void Converter<Label>::create_label_histrogram(
     // add label id to map
     label_id_map_[key] = label_id_++;
 
-  // increase label count for current node
-  ++label_histogram[label_id_map_[key]];
+  // add the label of the current node, counted by the collection
+  label_histogram.push_back(label_id_map_[key]);
   // increase tree size
   ++tree_size;
 }
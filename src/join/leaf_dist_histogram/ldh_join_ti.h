@@ -33,7 +33,9 @@
 #include <vector>
 #include <functional>
 #include "../join_result_element.h"
+#include "../../data_structures/result_sink.h"
 #include "../../node/node.h"
+#include "../../node/tree_index_collection.h"
 #include "ldh_candidate_index.h"
 #include "leaf_dist_histogram_converter.h"
 
@@ -51,7 +53,7 @@ public:
   /// remaining candidates are evaluated by Touzets algorithm.
   ///
   /// \param trees_collection A vector holding an input collection of trees.
-  /// \param histogram_collection A vector containing the according 
+  /// \param histogram_collection A collection containing the according 
   ///                             leaf distance histograms of the input 
   ///                             trees in trees_collection.
   /// \param candidates A vector of candidate tree pairs.
@@ -61,22 +63,33 @@ public:
   /// \return A vector with the join result.
   void execute_join(
       std::vector<node::Node<Label>>& trees_collection,
-      std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection,
+      data_structures::HistogramCollection& histogram_collection,
       std::vector<std::pair<int, int>>& candidates,
       std::vector<join::JoinResultElement>& join_result,
       const double distance_threshold);
+  /// Executes the join like execute_join above, but streams the result
+  /// pairs to a sink instead of a vector.
+  ///
+  /// \param join_result A sink receiving the result tree pairs and their TED
+  ///                    value. It is flushed before returning.
+  void execute_join(
+      std::vector<node::Node<Label>>& trees_collection,
+      data_structures::HistogramCollection& histogram_collection,
+      std::vector<std::pair<int, int>>& candidates,
+      data_structures::ResultSink<join::JoinResultElement>& join_result,
+      const double distance_threshold);
   /// A given collection of trees is converted into a collection of leaf distance histograms.
   ///
   /// \param trees_collection A vector holding an input collection of trees.
-  /// \return A vector containing the according leaf distance histograms of the 
+  /// \return A collection containing the according leaf distance histograms of the 
   ///         input trees in trees_collection.
   void convert_trees_to_histograms(
       std::vector<node::Node<Label>>& trees_collection,
-      std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection);
+      data_structures::HistogramCollection& histogram_collection);
   /// Uses the LDHJoin candidate index to retrieve candidates that are further 
   /// verified.
   ///
-  /// \param histogram_collection A vector containing the according 
+  /// \param histogram_collection A collection containing the according 
   ///                             leaf distance histograms of the input 
   ///                             trees in trees_collection.
   /// \param candidates A vector of candidate tree pairs.
@@ -85,22 +98,32 @@ public:
   /// \return A vector containing pairs of trees ids (candidates) that are 
   ///         considered candidates.
   void retrieve_candidates(
-      std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection,
+      data_structures::HistogramCollection& histogram_collection,
       std::vector<std::pair<int, int>>& candidates,
       const double distance_threshold);
   /// Uses the label guided mapping upper bound (lgm) to send candidates to 
   /// the result set without verification.
   ///
-  /// \param trees_collection A vector holding an input collection of trees.
+  /// \param indexed_collection The indexed input collection of trees.
   /// \param candidates A vector of candidate tree pairs.
   /// \param join_result A vector of result tree pairs and their TED value.
   /// \param distance_threshold The maximum number of edit operations that
   ///                           differs two trees in the join's result set.
   void verify_candidates(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result, 
     const double distance_threshold);
+  /// Verifies the candidates like verify_candidates above, but streams the
+  /// result pairs to a sink instead of a vector.
+  ///
+  /// \param join_result A sink receiving the result tree pairs and their TED
+  ///                    value. It is flushed before returning.
+  void verify_candidates(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold);
   /// Returns the number of precandidates.
   ///
   /// \return The number of precandidates.
@@ -114,6 +137,16 @@ public:
   ///
   /// \return The number of inverted list lookups.
   long long int get_number_of_il_lookups() const;
+  /// Returns the number of bytes of the inverted lists of the last candidate
+  /// generation.
+  ///
+  /// \return The number of bytes of the inverted lists.
+  std::size_t get_number_of_il_bytes() const;
+  /// Stores the inverted lists of the candidate index in variable-byte
+  /// encoding. Off by default.
+  ///
+  /// \param compress_lists True to compress the inverted lists.
+  void set_candidate_index_compression(const bool compress_lists);
 // Member variables.
 private:
   /// Inverted list size.
@@ -124,6 +157,10 @@ private:
   long long int sum_subproblem_counter_;
   /// Number of precandidates.
   long long int il_lookups_;
+  /// Number of bytes of the inverted lists of the candidate index.
+  std::size_t il_bytes_;
+  /// True if the inverted lists of the candidate index are compressed.
+  bool compress_candidate_index_;
 };
 
 // Implementation details.
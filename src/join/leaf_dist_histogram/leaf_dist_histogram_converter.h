@@ -28,8 +28,9 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <vector>
 #include "../../node/node.h"
+#include "../../data_structures/histogram_collection.h"
 #include "../../label/string_label.h"
 
 namespace leaf_dist_histogram_converter {
@@ -40,14 +41,14 @@ class Converter {
 public:
   /// Constructor.
   Converter();
-  /// Converts a given tree to a histogram. Each element of the vector contains 
-  /// a value of the histogram.
+  /// Converts the given trees to histograms. Each histogram is appended to the
+  /// collection as an array of (key, count) elements sorted by key.
   ///
   /// \param tree_collection A collection of trees.
   /// \param histogram_collection A collection of histograms.
   void create_histogram(
     const std::vector<node::Node<Label>>& trees_collection,
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection);
+    data_structures::HistogramCollection& histogram_collection);
   /// Returns the maximum leaf distance of a node in a tree collection.
   ///
   /// \return The the maximum leaf distance of a node in a tree collection.
@@ -62,10 +63,10 @@ private:
   /// of the histogram.
   ///
   /// \param tree_node Current node of a tree.
-  /// \param leaf_dist_histogram Vector of histogram values.
+  /// \param leaf_dist_histogram Keys of the nodes visited so far.
   int create_leaf_dist_histrogram(
     const node::Node<Label>& tree_node, 
-    std::unordered_map<int, int>& leaf_dist_histogram, int& tree_size);
+    std::vector<int>& leaf_dist_histogram, int& tree_size);
 };
 
 // Implementation details.
@@ -33,25 +33,26 @@ Converter<Label>::Converter() {}
 template<typename Label>
 void Converter<Label>::create_histogram(
     const std::vector<node::Node<Label>>& trees_collection,
-    std::vector<std::pair<int, std::unordered_map<int, int>>>& histogram_collection) {
+    data_structures::HistogramCollection& histogram_collection) {
 
+  // stores the leaf distance of every node of the current tree
+  std::vector<int> leaf_dist_histogram;
   // for each tree in the tree collection
   for (const auto& tree: trees_collection) {
-    // stores the number of nodes per leaf distance
-    std::unordered_map<int, int> leaf_dist_histogram;
+    leaf_dist_histogram.clear();
     // stores the number of nodes per leaf distance
     int tree_size = 0;
     // traverse tree and store number of nodes per leaf distance
     create_leaf_dist_histrogram(tree, leaf_dist_histogram, tree_size);
     // add leaf distance histogram to collection
-    histogram_collection.emplace_back(tree_size, leaf_dist_histogram);
+    histogram_collection.add_histogram(tree_size, leaf_dist_histogram);
   }
 }
 
 template<typename Label>
 int Converter<Label>::create_leaf_dist_histrogram(
     const node::Node<Label>& tree_node, 
-    std::unordered_map<int, int>& leaf_dist_histogram, int& tree_size) {
+    std::vector<int>& leaf_dist_histogram, int& tree_size) {
 
   // the leaf distance is the minimum leaf distance of a nodes children + 1
   int max_child_leaf_dist = 0;
@@ -63,8 +64,8 @@ int Converter<Label>::create_leaf_dist_histrogram(
   }
   // the leaf distance is the minimum leaf distance of a nodes children + 1
   ++max_child_leaf_dist;
-  // increase leaf distance count for current node
-  ++leaf_dist_histogram[max_child_leaf_dist];
+  // add the leaf distance of the current node, counted by the collection
+  leaf_dist_histogram.push_back(max_child_leaf_dist);
   // store maximum leaf distance of the collection
   if(max_child_leaf_dist > max_leaf_distance_)
     max_leaf_distance_ = max_child_leaf_dist;
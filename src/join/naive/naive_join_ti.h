@@ -21,10 +21,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include "../../node/node.h"
 #include "../../node/tree_indexer.h"
+#include "../../node/tree_index_collection.h"
 #include "../join_result_element.h"
+#include "../../data_structures/result_sink.h"
+#include "../../parallel/parallel_for.h"
 #include <iostream>
 
 namespace join {
@@ -32,13 +36,33 @@ namespace join {
 /**
  * Implements a naive tree similarity join as a nested loop and executing
  * tree edit distance (Zhang and Shasha) for each pair of trees from a
- * collection.
+ * collection. Every tree is indexed once before the nested loop.
+ *
+ * The pairs (i, j), i < j, form the upper triangle of a matrix. For multiple
+ * threads the triangle is cut into tiles. The trees are split into blocks of
+ * consecutive trees with equal sums of tree sizes and a tile holds the pairs
+ * of two blocks. Since the cost of a pair grows with the product of its tree
+ * sizes, all tiles off the diagonal have the same weight. The threads claim
+ * the tiles one at a time. The result is sorted by the tree ids and equals
+ * the result of a single thread.
+ *
+ * The result pairs can be streamed to a ResultSink instead of a vector. A
+ * single thread passes every pair on as soon as it is verified. Multiple
+ * threads pass on the pairs of a block of rows, sorted, once all tiles of
+ * these rows are verified.
  */
 template <typename Label, typename VerificationAlgorithm>
 class NaiveJoinTI {
 
 public:
+  /// Constructor. The join runs in a single thread.
   NaiveJoinTI();
+  /// Constructor.
+  /**
+   * \param number_of_threads Number of threads verifying the pairs. Values
+   *                          smaller than one use all hardware threads.
+   */
+  NaiveJoinTI(const int number_of_threads);
   
   /// Executes the join algorithm.
   /**
@@ -50,6 +74,45 @@ public:
   std::vector<join::JoinResultElement> execute_join(
       std::vector<node::Node<Label>>& trees_collection,
       const double distance_threshold);
+  /// Executes the join algorithm and streams the result pairs to a sink.
+  /**
+   * \param trees_collection A vector holding an input collection of trees.
+   * \param join_result A sink receiving the result pairs in the order of the
+   *                    nested loop. It is flushed at the end.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the join's result set.
+   */
+  void execute_join(
+      std::vector<node::Node<Label>>& trees_collection,
+      data_structures::ResultSink<join::JoinResultElement>& join_result,
+      const double distance_threshold);
+
+  /// Executes the join algorithm on indexed trees, e.g., built by
+  /// parser::BinaryCollection::build_indexes. No Node trees are needed.
+  /**
+   * \param indexed_collection The indexed input collection of trees.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the join's result set.
+   * \return A vector with the join result.
+   */
+  std::vector<join::JoinResultElement> execute_join(
+      const node::TreeIndexCollection<Label,
+          typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const double distance_threshold);
+  /// Executes the join algorithm on indexed trees and streams the result
+  /// pairs to a sink.
+  /**
+   * \param indexed_collection The indexed input collection of trees.
+   * \param join_result A sink receiving the result pairs in the order of the
+   *                    nested loop. It is flushed at the end.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the join's result set.
+   */
+  void execute_join(
+      const node::TreeIndexCollection<Label,
+          typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      data_structures::ResultSink<join::JoinResultElement>& join_result,
+      const double distance_threshold);
   
   /// Returns the summed subproblem count of TED algorithm executions.
   /**
@@ -58,6 +121,24 @@ public:
   long long int get_subproblem_count() const;
 
 private:
+  /// All pairs (i, j) with i in [row_begin, row_end), j in
+  /// [column_begin, column_end), and i < j.
+  struct Tile {
+    std::size_t row_begin;
+    std::size_t row_end;
+    std::size_t column_begin;
+    std::size_t column_end;
+  };
+  /// Cuts the upper triangle of the pairs matrix into tiles.
+  /**
+   * \param tree_sizes The sizes of the trees in the collection.
+   * \return Tiles covering every pair exactly once, in row-major order.
+   */
+  std::vector<Tile> get_tiles(const std::vector<int>& tree_sizes) const;
+  /// Minimum number of tiles per thread to even out their differences.
+  static constexpr std::size_t kTilesPerThread = 8;
+  /// Number of threads verifying the pairs.
+  unsigned int number_of_threads_;
   /// Number of subproblrems encoutered in the verification step.
   long long int sum_subproblem_counter_;
 };
@@ -24,44 +24,172 @@
 #pragma once
 
 template <typename Label, typename VerificationAlgorithm>
-NaiveJoinTI<Label, VerificationAlgorithm>::NaiveJoinTI() {}
+NaiveJoinTI<Label, VerificationAlgorithm>::NaiveJoinTI() : NaiveJoinTI(1) {}
+
+template <typename Label, typename VerificationAlgorithm>
+NaiveJoinTI<Label, VerificationAlgorithm>::NaiveJoinTI(
+    const int number_of_threads) {
+  number_of_threads_ = parallel::get_number_of_threads(number_of_threads);
+  sum_subproblem_counter_ = 0;
+}
 
 template <typename Label, typename VerificationAlgorithm>
 std::vector<join::JoinResultElement> NaiveJoinTI<Label, VerificationAlgorithm>::execute_join(
     std::vector<node::Node<Label>>& trees_collection, 
     const double distance_threshold) {
+  std::vector<join::JoinResultElement> result_set;
+  data_structures::ResultSink<join::JoinResultElement> sink(result_set);
+  execute_join(trees_collection, sink, distance_threshold);
+  return result_set;
+}
 
-  label::LabelDictionary<Label> ld;
-  typename VerificationAlgorithm::AlgsCostModel cm(ld);
+template <typename Label, typename VerificationAlgorithm>
+void NaiveJoinTI<Label, VerificationAlgorithm>::execute_join(
+    std::vector<node::Node<Label>>& trees_collection,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
 
-  VerificationAlgorithm ted_algorithm(cm);
-  typename VerificationAlgorithm::AlgsTreeIndex ti_1;
-  typename VerificationAlgorithm::AlgsTreeIndex ti_2;
+  // Index every tree once.
+  node::TreeIndexCollection<Label,
+      typename VerificationAlgorithm::AlgsTreeIndex> indexed_collection;
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
+  indexed_collection.build(trees_collection, cm);
+  execute_join(indexed_collection, join_result, distance_threshold);
+}
 
+template <typename Label, typename VerificationAlgorithm>
+std::vector<join::JoinResultElement> NaiveJoinTI<Label, VerificationAlgorithm>::execute_join(
+    const node::TreeIndexCollection<Label,
+        typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const double distance_threshold) {
   std::vector<join::JoinResultElement> result_set;
+  data_structures::ResultSink<join::JoinResultElement> sink(result_set);
+  execute_join(indexed_collection, sink, distance_threshold);
+  return result_set;
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void NaiveJoinTI<Label, VerificationAlgorithm>::execute_join(
+    const node::TreeIndexCollection<Label,
+        typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
 
-  double ted_value = std::numeric_limits<double>::infinity();
-  int i = 0;
-  int j = 0;
-  for (auto it_i = trees_collection.begin(); it_i != trees_collection.end(); ++it_i) {
-    ++i;
-    // Not to do symmetric comparisons.
-    j = i;
-    node::index_tree(ti_1, *it_i, ld, cm);
-    // Start the inner loop with the tree just iafter it_i.
-    for (auto it_j = it_i+1; it_j != trees_collection.end(); ++it_j) {
-      ++j;
-      node::index_tree(ti_2, *it_j, ld, cm);
-      ted_value = ted_algorithm.ted_k(ti_1, ti_2, distance_threshold);
-      if (ted_value <= distance_threshold) {
-        result_set.emplace_back(i, j, ted_value);
+  std::vector<int> tree_sizes(indexed_collection.size());
+  for (std::size_t i = 0; i < indexed_collection.size(); ++i) {
+    tree_sizes[i] = indexed_collection[i].tree_size_;
+  }
+  std::vector<Tile> tiles = get_tiles(tree_sizes);
+  // A single tile is verified in the order of the nested loop and its pairs
+  // go to the sink directly.
+  const bool single_tile = tiles.size() == 1;
+
+  // The indexes and the cost model are only read by the threads.
+  parallel::ChunkQueue chunks(tiles.size(), 1);
+  parallel::ChunkSequencer sequencer(
+      parallel::kPendingChunksPerThread * number_of_threads_);
+  std::vector<std::vector<join::JoinResultElement>> tile_results(tiles.size());
+  std::vector<long long int> thread_subproblem_counters(number_of_threads_, 0);
+  // Pairs of the tiles passed on from the current block of rows.
+  std::vector<join::JoinResultElement> block_results;
+
+  parallel::run_workers(number_of_threads_, [&](const unsigned int thread_id) {
+    VerificationAlgorithm ted_algorithm(cm);
+
+    sequencer.run(chunks, [&](const std::size_t tile_id, const std::size_t,
+        const std::size_t) {
+      const Tile& tile = tiles[tile_id];
+      for (std::size_t i = tile.row_begin; i < tile.row_end; ++i) {
+        // Not to do symmetric comparisons. Start the inner loop with the tree
+        // just after the i-th tree.
+        for (std::size_t j = std::max(tile.column_begin, i + 1);
+            j < tile.column_end; ++j) {
+          double ted_value = ted_algorithm.ted_k(indexed_collection[i],
+              indexed_collection[j], distance_threshold);
+          if (ted_value <= distance_threshold) {
+            // Tree ids in the result start at 1.
+            if (single_tile) {
+              join_result.emplace_back(i + 1, j + 1, ted_value);
+            } else {
+              tile_results[tile_id].emplace_back(i + 1, j + 1, ted_value);
+            }
+          }
+          // Sum up all number of subproblems
+          thread_subproblem_counters[thread_id] +=
+              ted_algorithm.get_subproblem_count();
+        }
       }
-      // Sum up all number of subproblems
-      sum_subproblem_counter_ += ted_algorithm.get_subproblem_count();
-    }
+    }, [&](const std::size_t tile_id) {
+      block_results.insert(block_results.end(), tile_results[tile_id].begin(),
+          tile_results[tile_id].end());
+      std::vector<join::JoinResultElement>().swap(tile_results[tile_id]);
+      // The rows of a block are spread over the tiles up to the last column.
+      // Restore the order of the nested loop once the block is complete.
+      if (tiles[tile_id].column_end == tree_sizes.size()) {
+        std::sort(block_results.begin(), block_results.end(),
+            [](const join::JoinResultElement& a,
+               const join::JoinResultElement& b) {
+          return a.tree_id_1 < b.tree_id_1 ||
+              (a.tree_id_1 == b.tree_id_1 && a.tree_id_2 < b.tree_id_2);
+        });
+        join_result.append(block_results);
+        block_results.clear();
+      }
+    });
+  });
+  join_result.flush();
+
+  for (const auto subproblem_counter : thread_subproblem_counters) {
+    sum_subproblem_counter_ += subproblem_counter;
   }
+}
 
-  return result_set;
+template <typename Label, typename VerificationAlgorithm>
+std::vector<typename NaiveJoinTI<Label, VerificationAlgorithm>::Tile>
+    NaiveJoinTI<Label, VerificationAlgorithm>::get_tiles(
+    const std::vector<int>& tree_sizes) const {
+  std::vector<Tile> tiles;
+  if (tree_sizes.empty()) {
+    return tiles;
+  }
+  // A single thread processes the whole triangle as one tile.
+  std::size_t number_of_blocks = 1;
+  if (number_of_threads_ > 1) {
+    // b blocks result in b * (b + 1) / 2 tiles.
+    const std::size_t min_tiles = kTilesPerThread * number_of_threads_;
+    while (number_of_blocks * (number_of_blocks + 1) / 2 < min_tiles) {
+      ++number_of_blocks;
+    }
+    number_of_blocks = std::min(number_of_blocks, tree_sizes.size());
+  }
+  long long int sum_of_sizes = 0;
+  for (const int size : tree_sizes) {
+    sum_of_sizes += size;
+  }
+  // Block boundaries such that every block has a similar sum of tree sizes.
+  std::vector<std::size_t> block_begin = {0};
+  long long int prefix_sum = 0;
+  for (std::size_t i = 0; i < tree_sizes.size(); ++i) {
+    prefix_sum += tree_sizes[i];
+    const std::size_t blocks_so_far = block_begin.size();
+    if (blocks_so_far < number_of_blocks && i + 1 < tree_sizes.size() &&
+        prefix_sum * static_cast<long long int>(number_of_blocks) >=
+        sum_of_sizes * static_cast<long long int>(blocks_so_far)) {
+      block_begin.push_back(i + 1);
+    }
+  }
+  block_begin.push_back(tree_sizes.size());
+  for (std::size_t a = 0; a + 1 < block_begin.size(); ++a) {
+    for (std::size_t b = a; b + 1 < block_begin.size(); ++b) {
+      tiles.push_back({block_begin[a], block_begin[a + 1],
+          block_begin[b], block_begin[b + 1]});
+    }
+  }
+  return tiles;
 }
 
 template <typename Label, typename VerificationAlgorithm>
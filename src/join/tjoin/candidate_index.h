@@ -24,16 +24,35 @@
 /// \details
 /// Implements a candidate index that efficiently and effectively returns tree 
 /// pairs that satisfy the structural filter. 
+///
+/// The sets are probed in the order of the collection, which has to be
+/// sorted by ascending set size. A set probes the inverted lists of its
+/// prefix labels, which contain the prefixes of all preceding sets. With
+/// multiple threads, the inverted lists are first built from the prefixes of
+/// all sets. The lists are then only read, and every thread probes a chunk
+/// of consecutive sets against the entries of the preceding sets, with its
+/// own overlap counters. The candidates of the chunks are merged in the
+/// chunk order, hence every number of threads returns the same candidate
+/// pairs in the same order. A collection that is not sorted by size is
+/// probed by a single thread.
+///
+/// The entries of the inverted lists can be stored in variable-byte encoding
+/// (see data_structures/var_byte_pair_list.h). This takes less memory for
+/// large collections, but the entries are decoded on every probe and the
+/// multi-threaded probing scans the lists from the front instead of
+/// searching the first set that is large enough.
 
 #pragma once
 
 #include <cmath>
 #include <climits>
 #include <algorithm>
+#include <iterator>
 #include <vector>
 #include <unordered_map>
 #include <queue>
 #include "../../node/node.h"
+#include "../../parallel/parallel_for.h"
 #include "inverted_list_element.h"
 #include "set_data.h"
 #include "label_set_element.h"
@@ -43,8 +62,20 @@ namespace candidate_index {
 class CandidateIndex {
 // Member functions.
 public:
-  /// Constructor.
+  /// Constructor. The sets are probed by a single thread.
   CandidateIndex();
+  /// Constructor.
+  ///
+  /// \param number_of_threads Number of threads probing the sets. Values
+  ///                          smaller than one use all hardware threads.
+  CandidateIndex(const int number_of_threads);
+  /// Constructor.
+  ///
+  /// \param number_of_threads Number of threads probing the sets. Values
+  ///                          smaller than one use all hardware threads.
+  /// \param compress_lists True if the entries of the inverted lists are
+  ///                       stored in variable-byte encoding.
+  CandidateIndex(const int number_of_threads, const bool compress_lists);
   /// Returns a set of candidates that satisfy the structural filter. 
   ///
   /// \param sets_collection Collection of all sets.
@@ -57,6 +88,23 @@ public:
       std::vector<std::pair<int, int>>& join_candidates,
       const int number_of_labels, 
       const double distance_threshold);
+  /// Probes the sets in a single thread and calls f(r_id, s_id) for every
+  /// candidate pair as soon as it passes the structural filter, in the order
+  /// of lookup. The candidates are not stored. The probing stops as soon as
+  /// f returns false.
+  ///
+  /// \param sets_collection Collection of all sets.
+  /// \param number_of_labels Number of all different labels in all sets. 
+  ///        Needed to allocate the inverted list index.
+  /// \param distance_threshold Given similarity threshold.
+  /// \param f Callable taking the ids of the two sets of a candidate pair
+  ///          and returning false to stop.
+  template <typename Function>
+  void for_each_candidate(
+      const std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+      const int number_of_labels, 
+      const double distance_threshold,
+      Function f);
   /// Returns the resultset.
   ///
   /// \return Pairs in the resultset.
@@ -75,14 +123,60 @@ public:
   ///
   /// \return The number of lookups in the inverted list.
   long int get_number_of_il_lookups() const;
+  /// Returns the number of bytes of the inverted lists of the last lookup.
+  ///
+  /// \return The number of bytes of the inverted lists.
+  std::size_t get_number_of_il_bytes() const;
 // Member variables.
 private:
+  /// Number of sets probed by a thread in one go.
+  static constexpr std::size_t kProbingChunkSize = 32;
+  /// Number of entries between two skip table entries of a compressed list.
+  static constexpr std::size_t kSkipInterval = 64;
+  /// Number of threads probing the sets.
+  unsigned int number_of_threads_;
+  /// True if the entries of the inverted lists are compressed.
+  bool compress_lists_;
+  /// Number of bytes of the inverted lists of the last lookup.
+  std::size_t il_bytes_;
   /// Number of precandidates.
   long int pre_candidates_;
   /// Number of lookups in the inverted list.
   long int il_lookups_;
 // Member functions.
 private:
+  /// Probes the sets with number_of_threads_ threads, see lookup.
+  void parallel_lookup(
+      const std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+      std::vector<std::pair<int, int>>& join_candidates,
+      const int number_of_labels, 
+      const double distance_threshold);
+  /// Returns the number of bytes of the inverted lists.
+  ///
+  /// \param il_index Uncompressed inverted lists of all labels.
+  /// \param compressed_il_index Compressed inverted lists of all labels.
+  std::size_t get_number_of_bytes(
+      const std::vector<candidate_index::InvertedListElement>& il_index,
+      const std::vector<candidate_index::CompressedInvertedListElement>&
+          compressed_il_index) const;
+  /// Verifies a precandidate pair (r, s) with the structural filter, given
+  /// the overlap found while probing the prefix of r.
+  ///
+  /// \param r Probing set.
+  /// \param r_size Number of elements of r.
+  /// \param r_prefix Prefix length of r.
+  /// \param s Indexed set.
+  /// \param s_size Number of elements of s.
+  /// \param s_prefix Prefix length of s.
+  /// \param overlap Overlap of r and s in the prefixes.
+  /// \param distance_threshold Given similarity threshold.
+  /// \return Returns true if r and s satisfy the structural filter.
+  bool verify_pre_candidate(
+      const std::vector<label_set_converter::LabelSetElement>& r,
+      const int r_size, const int r_prefix,
+      const std::vector<label_set_converter::LabelSetElement>& s,
+      const int s_size, const int s_prefix, const int overlap,
+      const double distance_threshold) const;
   /// Given two sets of nodes, the structural mapping identifies the number of 
   /// tau-valid node pairs.
   ///
@@ -91,9 +185,9 @@ private:
   /// \param distance_threshold Given distance threshold.
   /// \return number of tau-valid node pairs in sv_r and sv_s.
   int structural_mapping(
-    label_set_converter::LabelSetElement& sv_r, 
-    label_set_converter::LabelSetElement& sv_s,
-    const double distance_threshold);
+    const label_set_converter::LabelSetElement& sv_r, 
+    const label_set_converter::LabelSetElement& sv_s,
+    const double distance_threshold) const;
   /// Verify for a given candidate pair r and s if it passes the structural filter.
   ///
   /// \param r First set of the candidate pair.
@@ -104,10 +198,10 @@ private:
   /// \param ps Position after prefix or overlap of s.
   /// \param distance_threshold Given similarity threshold.
   /// \return Returns true if r and s satisfy the structural filter.
-  bool structural_filter(std::vector<label_set_converter::LabelSetElement>& r, 
-      std::vector<label_set_converter::LabelSetElement>& s, 
+  bool structural_filter(const std::vector<label_set_converter::LabelSetElement>& r, 
+      const std::vector<label_set_converter::LabelSetElement>& s, 
       const double t, int olap, int pr, int ps, 
-      int distance_threshold, int maxr, int maxs);
+      int distance_threshold, int maxr, int maxs) const;
 };
 
 // Implementation details.
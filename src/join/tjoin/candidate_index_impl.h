@@ -27,9 +27,18 @@
 
 #pragma once
 
-CandidateIndex::CandidateIndex() {
+CandidateIndex::CandidateIndex() : CandidateIndex(1) {}
+
+inline CandidateIndex::CandidateIndex(const int number_of_threads)
+    : CandidateIndex(number_of_threads, false) {}
+
+inline CandidateIndex::CandidateIndex(const int number_of_threads,
+    const bool compress_lists) {
+  number_of_threads_ = parallel::get_number_of_threads(number_of_threads);
+  compress_lists_ = compress_lists;
   pre_candidates_ = 0;
   il_lookups_ = 0;
+  il_bytes_ = 0;
 }
 
 void CandidateIndex::lookup(
@@ -37,18 +46,43 @@ void CandidateIndex::lookup(
     std::vector<std::pair<int, int>>& join_candidates,
     const int number_of_labels, 
     const double distance_threshold) {
-  // inverted list index.
-  std::vector<candidate_index::InvertedListElement> il_index(number_of_labels);
+  // The parallel lookup relies on the size order of the sets.
+  if (number_of_threads_ > 1 && std::is_sorted(sets_collection.begin(),
+      sets_collection.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+      })) {
+    parallel_lookup(sets_collection, join_candidates, number_of_labels,
+        distance_threshold);
+    return;
+  }
+  for_each_candidate(sets_collection, number_of_labels, distance_threshold,
+      [&join_candidates](const int r_id, const int s_id) {
+        join_candidates.emplace_back(r_id, s_id);
+        return true;
+      });
+}
+
+template <typename Function>
+void CandidateIndex::for_each_candidate(
+    const std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+    const int number_of_labels, 
+    const double distance_threshold,
+    Function f) {
+  // inverted list index, either uncompressed or compressed.
+  std::vector<candidate_index::InvertedListElement> il_index(
+      compress_lists_ ? 0 : number_of_labels);
+  std::vector<candidate_index::CompressedInvertedListElement>
+      compressed_il_index(compress_lists_ ? number_of_labels : 0);
   // containing specific data of a set. (e.g. actual overlap, index prefix)
   std::vector<candidate_index::SetData> set_data(sets_collection.size());
   // position in label set while processing r
   std::size_t p = 0;
 
   // iterate through all sets in the given collection
-  std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>::iterator r_it = sets_collection.begin();
+  std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>::const_iterator r_it = sets_collection.begin();
   for (; r_it != sets_collection.end(); ++r_it) {
-    std::pair<int, std::vector<label_set_converter::LabelSetElement>>& r_pair = *r_it; // dereference iterator to current set once
-    std::vector<label_set_converter::LabelSetElement> r = r_pair.second; // dereference iterator to current set once
+    const std::pair<int, std::vector<label_set_converter::LabelSetElement>>& r_pair = *r_it; // dereference iterator to current set once
+    const std::vector<label_set_converter::LabelSetElement>& r = r_pair.second; // dereference iterator to current set once
     int r_id = r_it - sets_collection.begin(); // identifier for r (line number)
     std::vector<int> M; // holds the set identifiers of the candidate pairs, 
                                  // the overlap is stored in the set_data
@@ -69,17 +103,8 @@ void CandidateIndex::lookup(
     p = 0;
     // until tau + 1 nodes of the probing set are processed
     while(p < r.size()) {
-      // remove all entries in the inverted list index up to the position where 
-      // the size is greater than the lower bound
-      for(std::size_t s = il_index[r[p].id].offset; s < il_index[r[p].id].element_list.size() &&
-          sets_collection[il_index[r[p].id].element_list[s].first].first < r_size - distance_threshold; s++)
-        ++il_index[r[p].id].offset;
-
-      // iterate through all remaining sets for the current token r[p] in the 
-      // inverted list index and add them to the candidates
-      for(std::size_t s = il_index[r[p].id].offset; s < il_index[r[p].id].element_list.size(); s++) {
-        int set = il_index[r[p].id].element_list[s].first;
-        int pos = il_index[r[p].id].element_list[s].second;
+      // add the tau-valid node pairs of an entry to the overlap of its set
+      auto probe = [&](const int set, const int pos) {
         // increase the number of lookups in the inverted list
         ++il_lookups_;
 
@@ -87,7 +112,37 @@ void CandidateIndex::lookup(
         if(tau_valid != 0 && set_data[set].overlap == 0) 
           M.push_back(set); // if not, add it to the candidate set M
         set_data[set].overlap += tau_valid;
-        
+      };
+
+      if (compress_lists_) {
+        candidate_index::CompressedInvertedListElement& list =
+            compressed_il_index[r[p].id];
+        // skip the entries of sets that are too small from now on, and probe
+        // the remaining ones in the same pass
+        data_structures::VarBytePairList::Cursor cursor = list.offset;
+        bool skipping = true;
+        int set = 0;
+        int pos = 0;
+        while (list.element_list.next(cursor, set, pos)) {
+          if (skipping && sets_collection[set].first < r_size - distance_threshold) {
+            list.offset = cursor;
+            continue;
+          }
+          skipping = false;
+          probe(set, pos);
+        }
+      } else {
+        candidate_index::InvertedListElement& list = il_index[r[p].id];
+        // remove all entries in the inverted list index up to the position where 
+        // the size is greater than the lower bound
+        for(std::size_t s = list.offset; s < list.element_list.size() &&
+            sets_collection[list.element_list[s].first].first < r_size - distance_threshold; s++)
+          ++list.offset;
+
+        // iterate through all remaining sets for the current token r[p] in the 
+        // inverted list index and add them to the candidates
+        for(std::size_t s = list.offset; s < list.element_list.size(); s++)
+          probe(list.element_list[s].first, list.element_list[s].second);
       }
       // stop as soon as tau + 1 elements have been discovered
       p++;
@@ -102,55 +157,222 @@ void CandidateIndex::lookup(
     
     // add all elements in the prefix of r in the inverted list
     for(int p = 0; p < set_data[r_id].prefix; p++)
-      il_index[r[p].id].element_list.push_back(std::make_pair(r_id, p));
+      if (compress_lists_)
+        compressed_il_index[r[p].id].element_list.push_back(r_id, p);
+      else
+        il_index[r[p].id].element_list.push_back(std::make_pair(r_id, p));
 
     // *****************************
     // *** Verify pre candidates ***
     // *****************************
     // compute structural filter for each candidate (r, s) in M
     for (int m: M) {
-      std::vector<label_set_converter::LabelSetElement>& s = sets_collection[m].second;
-      // prefix positions for sets r and s in the candidate pair
-      std::size_t pr = 0, ps = 0;
-
-      // check last prefix position; the smaller one starts at prefix position, 
-      // the greater one starts at the overlap
-      if (r[set_data[r_id].prefix-1].id > s[set_data[m].prefix-1].id) {
-        for(; r[pr].weight_so_far < set_data[m].overlap && pr < r.size(); ++pr) {}
-        ++pr;
-        ps = set_data[m].prefix;
+      if (verify_pre_candidate(r, r_size, set_data[r_id].prefix,
+          sets_collection[m].second, sets_collection[m].first,
+          set_data[m].prefix, set_data[m].overlap, distance_threshold) &&
+          !f(r_id, m)) {
+        il_bytes_ = get_number_of_bytes(il_index, compressed_il_index);
+        return;
+      }
+
+      // reset overlap in set_data
+      set_data[m].overlap = 0;
+    }
+  }
+  il_bytes_ = get_number_of_bytes(il_index, compressed_il_index);
+}
+
+void CandidateIndex::parallel_lookup(
+    const std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+    std::vector<std::pair<int, int>>& join_candidates,
+    const int number_of_labels, 
+    const double distance_threshold) {
+  const int number_of_sets = sets_collection.size();
+
+  // The prefix of a set only depends on the set. Build the inverted lists
+  // from the prefixes of all sets; every list is ordered by set id and hence
+  // by set size.
+  std::vector<candidate_index::InvertedListElement> il_index(
+      compress_lists_ ? 0 : number_of_labels);
+  std::vector<candidate_index::CompressedInvertedListElement>
+      compressed_il_index(compress_lists_ ? number_of_labels : 0);
+  std::vector<int> prefixes(number_of_sets, 0);
+  for (int r_id = 0; r_id < number_of_sets; ++r_id) {
+    const std::vector<label_set_converter::LabelSetElement>& r =
+        sets_collection[r_id].second;
+    std::size_t p = 0;
+    while (p < r.size()) {
+      p++;
+      if (r[p-1].weight_so_far > distance_threshold + 1)
+        break;
+    }
+    prefixes[r_id] = p;
+    for (std::size_t q = 0; q < p; ++q)
+      if (compress_lists_) {
+        candidate_index::CompressedInvertedListElement& list =
+            compressed_il_index[r[q].id];
+        if (list.number_of_entries++ % kSkipInterval == 0)
+          list.skips.emplace_back(sets_collection[r_id].first,
+              list.element_list.get_end());
+        list.element_list.push_back(r_id, q);
       } else {
-        pr = set_data[r_id].prefix;
-        for(; s[ps].weight_so_far < set_data[m].overlap && ps < s.size(); ++ps) {}
-        ++ps;
+        il_index[r[q].id].element_list.emplace_back(r_id, q);
       }
+  }
+  il_bytes_ = get_number_of_bytes(il_index, compressed_il_index);
 
-      int maxr = r_size - r[pr-1].weight_so_far + set_data[m].overlap;
-      int maxs = sets_collection[m].first - s[ps-1].weight_so_far + set_data[m].overlap;
+  parallel::ChunkQueue chunks(number_of_sets, kProbingChunkSize);
+  std::vector<std::vector<std::pair<int, int>>> chunk_candidates(
+      chunks.get_number_of_chunks());
+  std::vector<long int> thread_pre_candidates(number_of_threads_, 0);
+  std::vector<long int> thread_il_lookups(number_of_threads_, 0);
 
-      // overlap needed for threshold tau between r and s
-      const double eqoverlap = r_size - distance_threshold;
+  parallel::run_workers(number_of_threads_, [&](const unsigned int thread_id) {
+    // Overlap of every set with the current probing set. Only the entries of
+    // the precandidates are non-zero; they are reset after the verification.
+    std::vector<int> overlap(number_of_sets, 0);
+    std::vector<int> M;
 
-      // verify if r and s belong to the resultset, computed the structural filter
-      if (structural_filter(r, s, eqoverlap, set_data[m].overlap, pr, ps, distance_threshold, maxr, maxs))
-        join_candidates.emplace_back(r_id, m);
+    std::size_t chunk_id = 0;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    while (chunks.next(chunk_id, begin, end)) {
+      for (int r_id = begin; r_id < (int) end; ++r_id) {
+        const std::vector<label_set_converter::LabelSetElement>& r =
+            sets_collection[r_id].second;
+        const int r_size = sets_collection[r_id].first;
+        M.clear();
 
-      // reset overlap in set_data
-      set_data[m].overlap = 0;
+        // add all small trees that does not have to share a common label in
+        // the prefix
+        if (r_size <= distance_threshold)
+          for (int i = 0; i < r_id; ++i) {
+            if (overlap[i] == 0)
+              M.push_back(i);
+            ++overlap[i];
+          }
+
+        for (int p = 0; p < prefixes[r_id]; ++p) {
+          auto probe = [&](const int set, const int pos) {
+            ++thread_il_lookups[thread_id];
+            int tau_valid = structural_mapping(r[p],
+                sets_collection[set].second[pos], distance_threshold);
+            if (tau_valid != 0 && overlap[set] == 0)
+              M.push_back(set);
+            overlap[set] += tau_valid;
+          };
+          if (compress_lists_) {
+            // The lists are shared by the threads. Start at the last skip
+            // table entry of a set that is too small; the sets before it
+            // are too small as well.
+            const candidate_index::CompressedInvertedListElement& list =
+                compressed_il_index[r[p].id];
+            auto skip = std::partition_point(list.skips.begin(),
+                list.skips.end(), [&](const std::pair<int,
+                    data_structures::VarBytePairList::Cursor>& e) {
+                  return e.first < r_size - distance_threshold;
+                });
+            data_structures::VarBytePairList::Cursor cursor;
+            if (skip != list.skips.begin())
+              cursor = std::prev(skip)->second;
+            int set = 0;
+            int pos = 0;
+            while (list.element_list.next(cursor, set, pos) && set < r_id) {
+              if (sets_collection[set].first >= r_size - distance_threshold)
+                probe(set, pos);
+            }
+            continue;
+          }
+          const std::vector<std::pair<int, int>>& list =
+              il_index[r[p].id].element_list;
+          // Skip the sets that are too small, then probe the sets before r.
+          auto it = std::partition_point(list.begin(), list.end(),
+              [&](const std::pair<int, int>& e) {
+                return sets_collection[e.first].first < r_size - distance_threshold;
+              });
+          for (; it != list.end() && it->first < r_id; ++it)
+            probe(it->first, it->second);
+        }
+        thread_pre_candidates[thread_id] += M.size();
+
+        for (int m : M) {
+          if (verify_pre_candidate(r, r_size, prefixes[r_id],
+              sets_collection[m].second, sets_collection[m].first,
+              prefixes[m], overlap[m], distance_threshold))
+            chunk_candidates[chunk_id].emplace_back(r_id, m);
+          overlap[m] = 0;
+        }
+      }
     }
+  });
+
+  for (const auto& candidates : chunk_candidates) {
+    join_candidates.insert(join_candidates.end(), candidates.begin(),
+        candidates.end());
+  }
+  for (unsigned int t = 0; t < number_of_threads_; ++t) {
+    pre_candidates_ += thread_pre_candidates[t];
+    il_lookups_ += thread_il_lookups[t];
+  }
+}
+
+inline std::size_t CandidateIndex::get_number_of_bytes(
+    const std::vector<candidate_index::InvertedListElement>& il_index,
+    const std::vector<candidate_index::CompressedInvertedListElement>&
+        compressed_il_index) const {
+  std::size_t bytes =
+      il_index.size() * sizeof(candidate_index::InvertedListElement) +
+      compressed_il_index.size() *
+      sizeof(candidate_index::CompressedInvertedListElement);
+  for (const auto& list : il_index)
+    bytes += list.element_list.capacity() * sizeof(std::pair<int, int>);
+  for (const auto& list : compressed_il_index)
+    bytes += list.element_list.get_number_of_bytes() + list.skips.capacity() *
+        sizeof(std::pair<int, data_structures::VarBytePairList::Cursor>);
+  return bytes;
+}
+
+bool CandidateIndex::verify_pre_candidate(
+    const std::vector<label_set_converter::LabelSetElement>& r,
+    const int r_size, const int r_prefix,
+    const std::vector<label_set_converter::LabelSetElement>& s,
+    const int s_size, const int s_prefix, const int overlap,
+    const double distance_threshold) const {
+  // prefix positions for sets r and s in the candidate pair
+  std::size_t pr = 0, ps = 0;
+
+  // check last prefix position; the smaller one starts at prefix position, 
+  // the greater one starts at the overlap
+  if (r[r_prefix-1].id > s[s_prefix-1].id) {
+    for(; r[pr].weight_so_far < overlap && pr < r.size(); ++pr) {}
+    ++pr;
+    ps = s_prefix;
+  } else {
+    pr = r_prefix;
+    for(; s[ps].weight_so_far < overlap && ps < s.size(); ++ps) {}
+    ++ps;
   }
+
+  int maxr = r_size - r[pr-1].weight_so_far + overlap;
+  int maxs = s_size - s[ps-1].weight_so_far + overlap;
+
+  // overlap needed for threshold tau between r and s
+  const double eqoverlap = r_size - distance_threshold;
+
+  // verify if r and s belong to the resultset, computed the structural filter
+  return structural_filter(r, s, eqoverlap, overlap, pr, ps, distance_threshold, maxr, maxs);
 }
 
 bool CandidateIndex::structural_filter(
-    std::vector<label_set_converter::LabelSetElement>& r, 
-    std::vector<label_set_converter::LabelSetElement>& s, 
+    const std::vector<label_set_converter::LabelSetElement>& r, 
+    const std::vector<label_set_converter::LabelSetElement>& s, 
     const double t, 
     int olap, 
     int pr, 
     int ps, 
     int distance_threshold, 
     int maxr, 
-    int maxs) {
+    int maxs) const {
 
   // starting from pr and ps, check if the overlap exceeds the threshold
   // stop if the threshold is reached or cannot be reached anymore
@@ -174,9 +396,9 @@ bool CandidateIndex::structural_filter(
 }
 
 int CandidateIndex::structural_mapping(
-    label_set_converter::LabelSetElement& sv_r, 
-    label_set_converter::LabelSetElement& sv_s,
-    const double distance_threshold) {
+    const label_set_converter::LabelSetElement& sv_r, 
+    const label_set_converter::LabelSetElement& sv_s,
+    const double distance_threshold) const {
 
   int tau_valid = 0;
   // check if duplicates exist
@@ -189,15 +411,15 @@ int CandidateIndex::structural_mapping(
       return 1; // one tau-valid node pair
     }
   } else {
-    std::reference_wrapper<label_set_converter::LabelSetElement> se = std::ref(sv_r);
-    std::reference_wrapper<label_set_converter::LabelSetElement> le = std::ref(sv_s);
+    std::reference_wrapper<const label_set_converter::LabelSetElement> se = std::cref(sv_r);
+    std::reference_wrapper<const label_set_converter::LabelSetElement> le = std::cref(sv_s);
     if(sv_s.weight < sv_r.weight) {
-      se = std::ref(sv_s);
-      le = std::ref(sv_r);
+      se = std::cref(sv_s);
+      le = std::cref(sv_r);
     }
     std::size_t pid_lower_bound_start = 0;
     for(int i = 0; i < se.get().weight; ++i) {
-      label_set_converter::StructuralVector& left_hand_duplicate = se.get().struct_vect[i];
+      const label_set_converter::StructuralVector& left_hand_duplicate = se.get().struct_vect[i];
       int left_side_k_window = std::max(0.0, left_hand_duplicate.postorder_id - distance_threshold);
 
       // skip duplicates at the beginning that doesn't satisfy the postorder lower bound
@@ -210,7 +432,7 @@ int CandidateIndex::structural_mapping(
         break;
 
       for(int j = pid_lower_bound_start; j < le.get().weight; ++j) {
-        label_set_converter::StructuralVector& right_hand_duplicate = le.get().struct_vect[j];
+        const label_set_converter::StructuralVector& right_hand_duplicate = le.get().struct_vect[j];
         // postorder id in right hand side duplicates is too large to satisfy the postorder lower bound
         if(right_hand_duplicate.postorder_id > distance_threshold + left_hand_duplicate.postorder_id)
           break;
@@ -239,3 +461,7 @@ void CandidateIndex::set_number_of_pre_candidates(
 long int CandidateIndex::get_number_of_il_lookups() const {
   return il_lookups_;
 }
+
+inline std::size_t CandidateIndex::get_number_of_il_bytes() const {
+  return il_bytes_;
+}
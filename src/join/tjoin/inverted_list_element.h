@@ -26,6 +26,11 @@
 
 #pragma once
 
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "../../data_structures/var_byte_pair_list.h"
+
 namespace candidate_index {
 
 /// This is an element of the join's result set.
@@ -40,4 +45,18 @@ struct InvertedListElement {
 
 candidate_index::InvertedListElement::InvertedListElement() {}
 
+/// Inverted list whose entries, pairs of a set id and a prefix position, are
+/// stored in variable-byte encoding.
+struct CompressedInvertedListElement {
+  /// Position of the first entry that is not skipped.
+  data_structures::VarBytePairList::Cursor offset;
+  /// Set ids and prefix positions of the entries.
+  data_structures::VarBytePairList element_list;
+  /// Set size and position of every k-th entry in list order, the skip table
+  /// of lookups that cannot move offset.
+  std::vector<std::pair<int, data_structures::VarBytePairList::Cursor>> skips;
+  /// Number of entries.
+  std::size_t number_of_entries = 0;
+};
+
 }
@@ -33,6 +33,7 @@
 #include <vector>
 #include <unordered_map>
 #include "../../node/node.h"
+#include "../../node/tree_index_collection.h"
 #include "../../label/string_label.h"
 #include "label_set_element.h"
 
@@ -88,6 +89,18 @@ public:
   void assignFrequencyIdentifiers(
       std::vector<node::Node<Label>>& trees_collection,
       std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection);
+  /// Converts indexed trees to sets. Gives the same sets as the overload
+  /// above for the trees of indexed_collection, but reads the labels and the
+  /// positions from the tree indexes instead of traversing Node trees.
+  ///
+  /// \param indexed_collection A collection of indexed trees. TreeIndex has
+  ///                           to hold the PostLToLabelId, PostLToSize, and
+  ///                           PostLToDepth indexes.
+  /// \param sets_collection A collection of sets.
+  template <typename TreeIndex>
+  void assignFrequencyIdentifiers(
+      const node::TreeIndexCollection<Label, TreeIndex>& indexed_collection,
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection);
   /// Returns the number of different labels in the given tree collection.
   ///
   /// \return The number of different labels in the given tree collection.
@@ -112,6 +125,12 @@ private:
   int create_record(const node::Node<Label>& tree_node, int& postorder_id, int tree_size,
     std::unordered_map<Label, int, labelhash>& token_map,
     std::unordered_map<int, label_set_converter::LabelSetElement>& record_labels);
+  /// Replaces the token ids in the sets by their frequency ids, sorts the
+  /// elements of every set by id, and sums up their weights.
+  ///
+  /// \param sets_collection A collection of sets.
+  void assign_frequency_ids(
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection);
 };
 
 // Implementation details.
@@ -38,8 +38,6 @@ void Converter<Label>::assignFrequencyIdentifiers(
     std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection) {
   // token_map = {(token, tokcnt) -> id}
   typename std::unordered_map<Label, int, labelhash> token_map;
-  // token_list = [(#occurrences, data_nr)]
-  std::vector<std::pair<int, int>> token_count_list;
 
   // for each tree in the tree collection
   for(const auto& tree: trees_collection) {
@@ -67,6 +65,59 @@ void Converter<Label>::assignFrequencyIdentifiers(
     sets_collection.emplace_back(tree_size, record);
   }
 
+  assign_frequency_ids(sets_collection);
+}
+
+template<typename Label>
+template<typename TreeIndex>
+void Converter<Label>::assignFrequencyIdentifiers(
+    const node::TreeIndexCollection<Label, TreeIndex>& indexed_collection,
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection) {
+  // label_to_token[label id] = tokid, tokens are numbered in the order of
+  // their first occurrence like in create_record
+  std::vector<int> label_to_token(
+      indexed_collection.get_label_dictionary().size(), -1);
+
+  for (std::size_t tree_id = 0; tree_id < indexed_collection.size(); ++tree_id) {
+    const TreeIndex& ti = indexed_collection[tree_id];
+    const int tree_size = ti.tree_size_;
+    std::vector<label_set_converter::LabelSetElement> record;
+    // {tokid -> position in record}
+    std::unordered_map<int, std::size_t> record_positions;
+
+    for (int postl = 0; postl < tree_size; ++postl) {
+      int& token = label_to_token[ti.postl_to_label_id_[postl]];
+      if (token == -1) {
+        token = next_token_id_++;
+      }
+      auto position = record_positions.find(token);
+      if (position == record_positions.end()) {
+        position = record_positions.emplace(token, record.size()).first;
+        record.emplace_back(token, 0);
+      }
+      label_set_converter::LabelSetElement& se = record[position->second];
+      ++se.weight;
+      // postorder ids start at 1, (id, weight, left, right, ancestor,
+      // descendant) as in create_record
+      const int subtree_size = ti.postl_to_size_[postl];
+      const int depth = ti.postl_to_depth_[postl];
+      se.struct_vect.emplace_back(postl + 1, postl + 1 - subtree_size,
+          tree_size - (postl + 1 + depth), depth, subtree_size - 1);
+    }
+
+    // add to vector of label sets
+    sets_collection.emplace_back(tree_size, std::move(record));
+  }
+
+  assign_frequency_ids(sets_collection);
+}
+
+template<typename Label>
+void Converter<Label>::assign_frequency_ids(
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection) {
+  // token_list = [(#occurrences, data_nr)]
+  std::vector<std::pair<int, int>> token_count_list;
+
   // token_count_list = [tokenfrequency, tokenid]
   for(int i = 0; i < next_token_id_; ++i)
     token_count_list.emplace_back(0, i);
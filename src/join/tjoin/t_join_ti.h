@@ -26,6 +26,10 @@
 #include "../join_result_element.h"
 #include "../../node/node.h"
 #include "../../ted_ub/lgm_tree_index.h"
+#include "../../parallel/parallel_for.h"
+#include "../../parallel/bounded_queue.h"
+#include "../../data_structures/result_sink.h"
+#include "tree_index_collection.h"
 #include "candidate_index.h"
 #include "label_set_converter.h"
 #include "label_set_element.h"
@@ -44,11 +48,47 @@ namespace join {
  * bound sends candidates to the result set without TED computation. Last,
  * the remaining candidates are verified. Currently best, linear-time Touzet's
  * algorithm should be used.
+ *
+ * Every tree is indexed once with a TreeIndex that serves both the upper
+ * bound and the verification algorithm. The candidate generation (see
+ * CandidateIndex), the upper bound, and the verification steps can be
+ * executed by multiple threads. Each thread uses its own
+ * algorithm instances, shares the read-only indexes, and processes chunks of
+ * the candidates vector. The results of the chunks are
+ * merged in the order of the candidates, such that the output does not
+ * depend on the number of threads.
+ *
+ * The result pairs can be streamed to a ResultSink instead of a vector. A
+ * chunk is passed to the sink as soon as it and all earlier chunks are
+ * verified, so the sink receives the same order as the vector. The consumer
+ * of the sink is then called by the worker threads, one at a time.
+ *
+ * execute_pipelined_join overlaps the steps instead of running them one
+ * after another. One thread generates the candidates and passes them on in
+ * batches through a bounded queue; the other threads apply the upper bound
+ * and verify the remaining pairs of a batch right away. The candidates are
+ * never stored as a whole. The results of a batch are held back only
+ * until the earlier batches are verified, and a worker waits with a batch
+ * that is too far ahead. The result contains the same pairs as
+ * execute_join, ordered by candidate instead of by step.
  */
 template <typename Label, typename VerificationAlgorithm>
 class TJoinTI {
 public:
+  /// TreeIndex with the indexes of VerificationAlgorithm and LGM.
+  typedef node::TreeIndexUnion<typename VerificationAlgorithm::AlgsTreeIndex,
+      node::TreeIndexLGM> JoinTreeIndex;
+  /// Constructor. Candidate generation, upper bound, and verification run
+  /// in a single thread.
   TJoinTI();
+  /// Constructor.
+  /**
+   * \param number_of_threads Number of threads used for the candidate
+   *                          generation, the upper bound, and the
+   *                          verification steps. Values smaller than one use
+   *                          all hardware threads.
+   */
+  TJoinTI(const int number_of_threads);
   /// Executes TJoin algorithm.
   /**
    * TODO: Upper Bound algorithm could be also templated and not fixed to LGM.
@@ -72,6 +112,94 @@ public:
       std::vector<std::pair<int, int>>& candidates,
       std::vector<join::JoinResultElement>& join_result,
       const double distance_threshold);
+  /// Executes TJoin algorithm and streams the result pairs to a sink.
+  /**
+   * \param trees_collection A vector holding an input collection of trees.
+   * \param sets_collection A vector holding the label sets of trees_collection.
+   * \param candidates A vector of candidate tree pairs.
+   * \param join_result Sink receiving the result tree pairs and their TED
+   *                    value. It is flushed before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the join's result set.
+   */
+  void execute_join(
+      std::vector<node::Node<Label>>& trees_collection,
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+      std::vector<std::pair<int, int>>& candidates,
+      data_structures::ResultSink<join::JoinResultElement>& join_result,
+      const double distance_threshold);
+  /// Executes TJoin algorithm on indexed trees.
+  /**
+   * Same as execute_join above, but the trees are given by their indexes,
+   * e.g., built by parser::BinaryCollection::build_indexes, and the label
+   * sets are converted from the indexes. No Node trees are needed.
+   *
+   * \param indexed_collection The indexed input collection of trees.
+   * \param sets_collection A vector holding the label sets of
+   *                        indexed_collection.
+   * \param candidates A vector of candidate tree pairs.
+   * \param join_result A vector of result tree pairs and their TED value.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the join's result set.
+   */
+  void execute_join(
+      const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+      std::vector<std::pair<int, int>>& candidates,
+      std::vector<join::JoinResultElement>& join_result,
+      const double distance_threshold);
+  /// Executes TJoin algorithm on indexed trees and streams the result pairs
+  /// to a sink.
+  /**
+   * \param indexed_collection The indexed input collection of trees.
+   * \param sets_collection A vector holding the label sets of
+   *                        indexed_collection.
+   * \param candidates A vector of candidate tree pairs.
+   * \param join_result Sink receiving the result tree pairs and their TED
+   *                    value. It is flushed before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the join's result set.
+   */
+  void execute_join(
+      const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+      std::vector<std::pair<int, int>>& candidates,
+      data_structures::ResultSink<join::JoinResultElement>& join_result,
+      const double distance_threshold);
+  /// Executes TJoin algorithm with pipelined steps.
+  /**
+   * The trees are converted and indexed first. Then the candidates are
+   * generated by one thread while number_of_threads other threads apply
+   * the upper bound and the verification to batches of candidates. At most
+   * kPipelineBatchesPerThread batches per worker wait in the queue. The
+   * result pairs of a batch are passed on in the order of the batches.
+   *
+   * \param trees_collection A vector holding an input collection of trees.
+   * \param sets_collection A vector holding the label sets of trees_collection.
+   * \param join_result A vector of result tree pairs and their TED value.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the join's result set.
+   */
+  void execute_pipelined_join(
+      std::vector<node::Node<Label>>& trees_collection,
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+      std::vector<join::JoinResultElement>& join_result,
+      const double distance_threshold);
+  /// Executes TJoin algorithm with pipelined steps and streams the result
+  /// pairs to a sink.
+  /**
+   * \param trees_collection A vector holding an input collection of trees.
+   * \param sets_collection A vector holding the label sets of trees_collection.
+   * \param join_result Sink receiving the result tree pairs and their TED
+   *                    value. It is flushed before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the join's result set.
+   */
+  void execute_pipelined_join(
+      std::vector<node::Node<Label>>& trees_collection,
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+      data_structures::ResultSink<join::JoinResultElement>& join_result,
+      const double distance_threshold);
   /// Converts a given collection of trees into a collection of label sets.
   /**
    * \param trees_collection A vector holding an input collection of trees.
@@ -81,6 +209,15 @@ public:
   void convert_trees_to_sets(
       std::vector<node::Node<Label>>& trees_collection,
       std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection);
+  /// Converts a given collection of indexed trees into a collection of label
+  /// sets. The sets equal those of convert_trees_to_sets for the same trees.
+  /**
+   * \param indexed_collection The indexed input collection of trees.
+   * \param sets_collection A vector to append the label sets to.
+   */
+  void convert_indexes_to_sets(
+      const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection);
   /// Retrieves candidate pairs from candidate index.
   /**
    * \param trees_collection A vector holding an input collection of trees.
@@ -96,20 +233,35 @@ public:
       const double distance_threshold);
   /// Verifies candidates using Label Guided Mapping upper bound (LGM).
   /**
-   * \param trees_collection A vector holding an input collection of trees.
+   * \param indexed_collection The indexed input collection of trees.
    * \param candidates A vector of candidate tree pairs.
    * \param join_result A vector of result tree pairs and their TED value.
    * \param distance_threshold The maximum number of edit operations that
    *                           differs two trees in the join's result set.
    */
   void upperbound(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result, 
     const double distance_threshold);
+  /// Verifies candidates using Label Guided Mapping upper bound (LGM) and
+  /// streams the result pairs to a sink.
+  /**
+   * \param indexed_collection The indexed input collection of trees.
+   * \param candidates A vector of candidate tree pairs.
+   * \param join_result Sink receiving the result tree pairs and their TED
+   *                    value. It is flushed before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the join's result set.
+   */
+  void upperbound(
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold);
   /// Verifies each candidate pair with the tree edit distance.
   /**
-   * \param trees_collection A vector holding an input collection of trees.
+   * \param indexed_collection The indexed input collection of trees.
    * \param candidates A vector of candidate tree pairs.
    * \param join_result A vector of result tree pairs and their TED value.
    * \param distance_threshold The maximum number of edit operations that
@@ -117,10 +269,25 @@ public:
    * \return A vector containing the join result.
    */
   void verify_candidates(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result, 
     const double distance_threshold);
+  /// Verifies each candidate pair with the tree edit distance and streams
+  /// the result pairs to a sink.
+  /**
+   * \param indexed_collection The indexed input collection of trees.
+   * \param candidates A vector of candidate tree pairs.
+   * \param join_result Sink receiving the result tree pairs and their TED
+   *                    value. It is flushed before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the join's result set.
+   */
+  void verify_candidates(
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold);
   /// Returns the number of precandidates.
   /**
    * \return pre_candidates_
@@ -136,10 +303,26 @@ public:
    * \return il_lookups_
    */
   long long int get_number_of_il_lookups() const;
+  /// Returns the number of bytes of the inverted lists of the last candidate
+  /// generation.
+  /**
+   * \return il_bytes_
+   */
+  std::size_t get_number_of_il_bytes() const;
+  /// Stores the inverted lists of the candidate index in variable-byte
+  /// encoding (see candidate_index::CandidateIndex). Off by default.
+  /**
+   * \param compress_lists True to compress the inverted lists.
+   */
+  void set_candidate_index_compression(const bool compress_lists);
 
 private:
-  /// LabelDictionary for using with LGMTreeIndex and VerificationAlgorithm.
-  label::LabelDictionary<Label> ld_;
+  /// Number of candidates verified by a thread in one go.
+  static constexpr std::size_t kVerificationChunkSize = 64;
+  /// Number of candidate batches per worker the pipeline queue holds.
+  static constexpr std::size_t kPipelineBatchesPerThread = 4;
+  /// Number of threads for the upper bound and verification steps.
+  unsigned int number_of_threads_;
   /// Number of different labels in the trees.
   long long int number_of_labels_;
   /// Number of precandidates.
@@ -148,6 +331,10 @@ private:
   long long int sum_subproblem_counter_;
   /// Number of precandidates.
   long long int il_lookups_;
+  /// Number of bytes of the inverted lists of the candidate index.
+  std::size_t il_bytes_;
+  /// True if the inverted lists of the candidate index are compressed.
+  bool compress_candidate_index_;
 };
 
 // Implementation details.
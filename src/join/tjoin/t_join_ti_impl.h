@@ -24,12 +24,17 @@
 #pragma once
 
 template <typename Label, typename VerificationAlgorithm>
-TJoinTI<Label, VerificationAlgorithm>::TJoinTI() {
-  ld_ = label::LabelDictionary<Label>();
+TJoinTI<Label, VerificationAlgorithm>::TJoinTI() : TJoinTI(1) {}
+
+template <typename Label, typename VerificationAlgorithm>
+TJoinTI<Label, VerificationAlgorithm>::TJoinTI(const int number_of_threads) {
+  number_of_threads_ = parallel::get_number_of_threads(number_of_threads);
   pre_candidates_ = 0;
   sum_subproblem_counter_ = 0;
   number_of_labels_ = 0;
   il_lookups_ = 0;
+  il_bytes_ = 0;
+  compress_candidate_index_ = false;
 }
 
 template <typename Label, typename VerificationAlgorithm>
@@ -39,6 +44,18 @@ void TJoinTI<Label, VerificationAlgorithm>::execute_join(
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result,
     const double distance_threshold) {
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  execute_join(trees_collection, sets_collection, candidates, sink,
+      distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void TJoinTI<Label, VerificationAlgorithm>::execute_join(
+    std::vector<node::Node<Label>>& trees_collection,
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
 
   // Convert trees to sets and get the result.
   convert_trees_to_sets(trees_collection, sets_collection);
@@ -46,11 +63,171 @@ void TJoinTI<Label, VerificationAlgorithm>::execute_join(
   // Retrieves candidates from the candidate index.
   retrieve_candidates(sets_collection, candidates, distance_threshold);
 
+  // Index every tree once for the upper bound and the verification.
+  node::TreeIndexCollection<Label, JoinTreeIndex> indexed_collection;
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
+  indexed_collection.build(trees_collection, cm);
+
+  // Use the label guided mapping upper bound to send candidates immediately .
+  upperbound(indexed_collection, candidates, join_result, distance_threshold);
+
+  // Verify all computed join candidates and return the join result.
+  verify_candidates(indexed_collection, candidates, join_result, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void TJoinTI<Label, VerificationAlgorithm>::execute_join(
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    std::vector<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  execute_join(indexed_collection, sets_collection, candidates, sink,
+      distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void TJoinTI<Label, VerificationAlgorithm>::execute_join(
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
+
+  // Convert the indexed trees to sets.
+  convert_indexes_to_sets(indexed_collection, sets_collection);
+
+  // Retrieves candidates from the candidate index.
+  retrieve_candidates(sets_collection, candidates, distance_threshold);
+
   // Use the label guided mapping upper bound to send candidates immediately .
-  upperbound(trees_collection, candidates, join_result, distance_threshold);
+  upperbound(indexed_collection, candidates, join_result, distance_threshold);
 
   // Verify all computed join candidates and return the join result.
-  verify_candidates(trees_collection, candidates, join_result, distance_threshold);
+  verify_candidates(indexed_collection, candidates, join_result, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void TJoinTI<Label, VerificationAlgorithm>::execute_pipelined_join(
+    std::vector<node::Node<Label>>& trees_collection,
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+    std::vector<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  execute_pipelined_join(trees_collection, sets_collection, sink,
+      distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void TJoinTI<Label, VerificationAlgorithm>::execute_pipelined_join(
+    std::vector<node::Node<Label>>& trees_collection,
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
+
+  using AlgsCostModel = typename VerificationAlgorithm::AlgsCostModel;
+  // A batch of candidates and its position in the candidate order.
+  using CandidateBatch = std::pair<std::size_t, std::vector<std::pair<int, int>>>;
+
+  // Convert trees to sets and index every tree before the pipeline starts.
+  convert_trees_to_sets(trees_collection, sets_collection);
+  node::TreeIndexCollection<Label, JoinTreeIndex> indexed_collection;
+  AlgsCostModel cm(indexed_collection.get_label_dictionary());
+  indexed_collection.build(trees_collection, cm);
+
+  parallel::BoundedQueue<CandidateBatch> queue(
+      kPipelineBatchesPerThread * number_of_threads_);
+  // The results of a batch are passed on as soon as all earlier batches are
+  // verified. A worker waits with a batch that is too far ahead, hence at
+  // most max_pending_batches results are held back. Batch id is stored at
+  // position id % max_pending_batches.
+  const std::size_t max_pending_batches =
+      parallel::kPendingChunksPerThread * number_of_threads_;
+  parallel::ChunkSequencer sequencer(max_pending_batches);
+  std::vector<std::vector<join::JoinResultElement>> pending_results(
+      max_pending_batches);
+  std::vector<long long int> thread_subproblem_counters(
+      number_of_threads_ + 1, 0);
+
+  // Thread 0 generates the candidates, the others verify them.
+  parallel::run_workers(number_of_threads_ + 1, [&](const unsigned int thread_id) {
+    if (thread_id == 0) {
+      try {
+        candidate_index::CandidateIndex c_index(1, compress_candidate_index_);
+        CandidateBatch batch(0, {});
+        c_index.for_each_candidate(sets_collection, number_of_labels_,
+            distance_threshold, [&](const int r_id, const int s_id) {
+              batch.second.emplace_back(r_id, s_id);
+              if (batch.second.size() == kVerificationChunkSize) {
+                const std::size_t batch_id = batch.first;
+                // The queue is closed if a worker failed.
+                if (!queue.push(std::move(batch))) {
+                  return false;
+                }
+                batch = CandidateBatch(batch_id + 1, {});
+              }
+              return true;
+            });
+        if (!batch.second.empty()) {
+          queue.push(std::move(batch));
+        }
+        pre_candidates_ = c_index.get_number_of_pre_candidates();
+        il_lookups_ = c_index.get_number_of_il_lookups();
+        il_bytes_ = c_index.get_number_of_il_bytes();
+      } catch (...) {
+        queue.close();
+        throw;
+      }
+      queue.close();
+      return;
+    }
+
+    ted_ub::LGMTreeIndex<AlgsCostModel, JoinTreeIndex> lgm_algorithm(cm);
+    VerificationAlgorithm ted_algorithm(cm);
+    try {
+      CandidateBatch batch;
+      // The batches are popped in the order of their ids.
+      while (queue.pop(batch) && sequencer.wait(batch.first)) {
+        std::vector<join::JoinResultElement>& results =
+            pending_results[batch.first % max_pending_batches];
+        for (const std::pair<int, int>& pair : batch.second) {
+          // Use the label guided mapping upper bound first, then verify.
+          double ub_value = lgm_algorithm.ted_k(indexed_collection[pair.first],
+              indexed_collection[pair.second], distance_threshold);
+          if (ub_value <= distance_threshold) {
+            results.emplace_back(pair.first, pair.second, ub_value);
+            continue;
+          }
+          double ted_value = ted_algorithm.ted_k(indexed_collection[pair.first],
+              indexed_collection[pair.second], distance_threshold);
+          if (ted_value <= distance_threshold)
+            results.emplace_back(pair.first, pair.second, ted_value);
+          thread_subproblem_counters[thread_id] += ted_algorithm.get_subproblem_count();
+        }
+
+        // Pass on the results of all batches that are next in order.
+        sequencer.finish(batch.first, [&](const std::size_t id) {
+          std::vector<join::JoinResultElement>& batch_results =
+              pending_results[id % max_pending_batches];
+          join_result.append(batch_results);
+          batch_results.clear();
+        });
+      }
+    } catch (...) {
+      // Release the waiting workers and stop the generation of further
+      // candidates.
+      sequencer.stop();
+      queue.close();
+      throw;
+    }
+  });
+  join_result.flush();
+
+  for (const auto subproblem_counter : thread_subproblem_counters) {
+    sum_subproblem_counter_ += subproblem_counter;
+  }
 }
 
 template <typename Label, typename VerificationAlgorithm>
@@ -64,6 +241,17 @@ void TJoinTI<Label, VerificationAlgorithm>::convert_trees_to_sets(
   number_of_labels_ = lsc.get_number_of_labels();
 }
 
+template <typename Label, typename VerificationAlgorithm>
+void TJoinTI<Label, VerificationAlgorithm>::convert_indexes_to_sets(
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection) {
+
+  // Convert indexed trees to sets and get the result.
+  label_set_converter::Converter<Label> lsc;
+  lsc.assignFrequencyIdentifiers(indexed_collection, sets_collection);
+  number_of_labels_ = lsc.get_number_of_labels();
+}
+
 template <typename Label, typename VerificationAlgorithm>
 void TJoinTI<Label, VerificationAlgorithm>::retrieve_candidates(
     std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>>& sets_collection,
@@ -71,7 +259,8 @@ void TJoinTI<Label, VerificationAlgorithm>::retrieve_candidates(
     const double distance_threshold) {
 
   // Initialize candidate index.
-  candidate_index::CandidateIndex c_index;
+  candidate_index::CandidateIndex c_index(number_of_threads_,
+      compress_candidate_index_);
 
   // Retrieve candidates from the candidate index.
   c_index.lookup(sets_collection, candidates, number_of_labels_, distance_threshold);
@@ -80,60 +269,126 @@ void TJoinTI<Label, VerificationAlgorithm>::retrieve_candidates(
   pre_candidates_ = c_index.get_number_of_pre_candidates();
   // Copy the number of inverted list lookups.
   il_lookups_ = c_index.get_number_of_il_lookups();
+  il_bytes_ = c_index.get_number_of_il_bytes();
 }
 
 template <typename Label, typename VerificationAlgorithm>
 void TJoinTI<Label, VerificationAlgorithm>::upperbound(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result,
     const double distance_threshold) {
-  
-  typename VerificationAlgorithm::AlgsCostModel cm(ld_);
-  ted_ub::LGMTreeIndex<typename VerificationAlgorithm::AlgsCostModel> lgm_algorithm(cm);
-  // TODO: Index trees only once for LGM And Verification using a TreeIndex
-  //       that is a superset of TreeIndexLGM and VerificationAlgorithm::AlgsTreeIndex.
-  node::TreeIndexLGM ti_1;
-  node::TreeIndexLGM ti_2;
-  
-  std::vector<std::pair<int, int>>::iterator it = candidates.begin();
-  while(it != candidates.end()) {
-    node::index_tree(ti_1, trees_collection[it->first], ld_, cm);
-    node::index_tree(ti_2, trees_collection[it->second], ld_, cm);
-    double ub_value = lgm_algorithm.ted_k(ti_1, ti_2, distance_threshold);
-    if(ub_value <= distance_threshold) {
-      join_result.emplace_back(it->first, it->second, ub_value);
-      *it = candidates.back();
-      candidates.pop_back();
-    }
-    else {
-      ++it;
-    }
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  upperbound(indexed_collection, candidates, sink, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void TJoinTI<Label, VerificationAlgorithm>::upperbound(
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
+
+  using AlgsCostModel = typename VerificationAlgorithm::AlgsCostModel;
+
+  // Every chunk of candidates keeps its result pairs and its remaining
+  // candidates separately. The result pairs are passed to the sink in the
+  // chunk order as soon as possible, the remaining candidates are merged in
+  // the chunk order afterwards. The indexes and the cost model are only
+  // read by the threads.
+  AlgsCostModel cm(indexed_collection.get_label_dictionary());
+
+  parallel::ChunkQueue chunks(candidates.size(), kVerificationChunkSize);
+  parallel::ChunkSequencer sequencer(
+      parallel::kPendingChunksPerThread * number_of_threads_);
+  std::vector<std::vector<join::JoinResultElement>> chunk_results(
+      chunks.get_number_of_chunks());
+  std::vector<std::vector<std::pair<int, int>>> chunk_candidates(
+      chunks.get_number_of_chunks());
+
+  parallel::run_workers(number_of_threads_, [&](const unsigned int) {
+    ted_ub::LGMTreeIndex<AlgsCostModel, JoinTreeIndex> lgm_algorithm(cm);
+
+    sequencer.run(chunks, [&](const std::size_t chunk_id,
+        const std::size_t begin, const std::size_t end) {
+      for (std::size_t c = begin; c < end; ++c) {
+        const std::pair<int, int>& pair = candidates[c];
+        double ub_value = lgm_algorithm.ted_k(indexed_collection[pair.first],
+            indexed_collection[pair.second], distance_threshold);
+        if (ub_value <= distance_threshold) {
+          chunk_results[chunk_id].emplace_back(pair.first, pair.second, ub_value);
+        } else {
+          chunk_candidates[chunk_id].push_back(pair);
+        }
+      }
+    }, [&](const std::size_t id) {
+      join_result.append(chunk_results[id]);
+      std::vector<join::JoinResultElement>().swap(chunk_results[id]);
+    });
+  });
+  join_result.flush();
+
+  // Keep only the candidates that have not been sent to the result.
+  candidates.clear();
+  for (const auto& remaining_candidates : chunk_candidates) {
+    candidates.insert(candidates.end(), remaining_candidates.begin(),
+        remaining_candidates.end());
   }
 }
 
 template <typename Label, typename VerificationAlgorithm>
 void TJoinTI<Label, VerificationAlgorithm>::verify_candidates(
-    std::vector<node::Node<Label>>& trees_collection,
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
     std::vector<std::pair<int, int>>& candidates,
     std::vector<join::JoinResultElement>& join_result,
     const double distance_threshold) {
+  data_structures::ResultSink<join::JoinResultElement> sink(join_result);
+  verify_candidates(indexed_collection, candidates, sink, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void TJoinTI<Label, VerificationAlgorithm>::verify_candidates(
+    const node::TreeIndexCollection<Label, JoinTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, int>>& candidates,
+    data_structures::ResultSink<join::JoinResultElement>& join_result,
+    const double distance_threshold) {
 
-  typename VerificationAlgorithm::AlgsCostModel cm(ld_);
-  VerificationAlgorithm ted_algorithm(cm);
-  typename VerificationAlgorithm::AlgsTreeIndex ti_1;
-  typename VerificationAlgorithm::AlgsTreeIndex ti_2;
-
-  // Verify each pair in the candidate set
-  for(const auto& pair: candidates) {
-    node::index_tree(ti_1, trees_collection[pair.first], ld_, cm);
-    node::index_tree(ti_2, trees_collection[pair.second], ld_, cm);
-    double ted_value = ted_algorithm.ted_k(ti_1, ti_2, distance_threshold);
-    if(ted_value <= distance_threshold)
-      join_result.emplace_back(pair.first, pair.second, ted_value);
-    
-    // Sum up all number of subproblems
-    sum_subproblem_counter_ += ted_algorithm.get_subproblem_count();
+  using AlgsCostModel = typename VerificationAlgorithm::AlgsCostModel;
+
+  AlgsCostModel cm(indexed_collection.get_label_dictionary());
+
+  parallel::ChunkQueue chunks(candidates.size(), kVerificationChunkSize);
+  parallel::ChunkSequencer sequencer(
+      parallel::kPendingChunksPerThread * number_of_threads_);
+  std::vector<std::vector<join::JoinResultElement>> chunk_results(
+      chunks.get_number_of_chunks());
+  std::vector<long long int> thread_subproblem_counters(number_of_threads_, 0);
+
+  parallel::run_workers(number_of_threads_, [&](const unsigned int thread_id) {
+    VerificationAlgorithm ted_algorithm(cm);
+
+    sequencer.run(chunks, [&](const std::size_t chunk_id,
+        const std::size_t begin, const std::size_t end) {
+      // Verify each pair in the chunk.
+      for (std::size_t c = begin; c < end; ++c) {
+        const std::pair<int, int>& pair = candidates[c];
+        double ted_value = ted_algorithm.ted_k(indexed_collection[pair.first],
+            indexed_collection[pair.second], distance_threshold);
+        if(ted_value <= distance_threshold)
+          chunk_results[chunk_id].emplace_back(pair.first, pair.second, ted_value);
+
+        // Sum up all number of subproblems
+        thread_subproblem_counters[thread_id] += ted_algorithm.get_subproblem_count();
+      }
+    }, [&](const std::size_t id) {
+      join_result.append(chunk_results[id]);
+      std::vector<join::JoinResultElement>().swap(chunk_results[id]);
+    });
+  });
+  join_result.flush();
+
+  for (const auto subproblem_counter : thread_subproblem_counters) {
+    sum_subproblem_counter_ += subproblem_counter;
   }
 }
 
@@ -153,3 +408,15 @@ long long int
     TJoinTI<Label, VerificationAlgorithm>::get_number_of_il_lookups() const {
   return il_lookups_;
 }
+
+template <typename Label, typename VerificationAlgorithm>
+std::size_t
+    TJoinTI<Label, VerificationAlgorithm>::get_number_of_il_bytes() const {
+  return il_bytes_;
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void TJoinTI<Label, VerificationAlgorithm>::set_candidate_index_compression(
+    const bool compress_lists) {
+  compress_candidate_index_ = compress_lists;
+}
@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include "../data_structures/workspace.h"
+
 namespace json {
 
 /**
@@ -56,6 +58,12 @@ public:
    */
   long long int get_subproblem_count() { return subproblem_counter_; };
   
+  /// Returns the workspace with the allocation counters.
+  /**
+   * \return The workspace the DP matrices of this algorithm are borrowed from.
+   */
+  const data_structures::Workspace& get_workspace() const { return workspace_; };
+  
   /// To initialise VerificationAlgorithm and TreeIndex variables in join algorithms.
   typedef CostModel AlgsCostModel;
   typedef TreeIndex AlgsTreeIndex;
@@ -70,6 +78,9 @@ protected:
    * where both forests are not empty.
    */
   long long int subproblem_counter_;
+  
+  /// Grow-only storage of the DP matrices, reused across JEDI computations.
+  data_structures::Workspace workspace_;
 };
 
 }
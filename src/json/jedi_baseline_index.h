@@ -52,6 +52,7 @@ class JEDIBaselineTreeIndex : public json::JEDIAlgorithm<CostModel, TreeIndex> {
   // Base class members made visible for this class.
   using json::JEDIAlgorithm<CostModel, TreeIndex>::JEDIAlgorithm;
   using json::JEDIAlgorithm<CostModel, TreeIndex>::subproblem_counter_;
+  using json::JEDIAlgorithm<CostModel, TreeIndex>::workspace_;
   using json::JEDIAlgorithm<CostModel, TreeIndex>::jedi;
   using json::JEDIAlgorithm<CostModel, TreeIndex>::jedi_k;
   using json::JEDIAlgorithm<CostModel, TreeIndex>::c_;
@@ -43,17 +43,15 @@ double JEDIBaselineTreeIndex<CostModel, TreeIndex>::jedi(
   int t2_input_size = t2.tree_size_;
   int larger_tree_size = std::max(t1_input_size, t2_input_size);
   
-  // Initialise distance matrices.
-  dt_ = data_structures::Matrix<double>(t1_input_size+1, t2_input_size+1);
-  df_ = data_structures::Matrix<double>(t1_input_size+1, t2_input_size+1);
-  e_ = data_structures::Matrix<double>(t1_input_size+1, t2_input_size+1);
+  // Initialise distance matrices with inf.
+  workspace_.borrow(dt_, t1_input_size+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
+  workspace_.borrow(df_, t1_input_size+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
+  workspace_.borrow(e_, t1_input_size+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
   std::vector<std::vector<double> > hungarian_cm
       (2*larger_tree_size, std::vector<double> (2*larger_tree_size, 0));
-  
-  // Fill the matrices with inf.
-  dt_.fill_with(std::numeric_limits<double>::infinity());
-  df_.fill_with(std::numeric_limits<double>::infinity());
-  e_.fill_with(std::numeric_limits<double>::infinity());
 
   dt_.at(0, 0) = 0;
   df_.at(0, 0) = 0;
@@ -53,27 +53,25 @@ double JOFilterTreeIndex<CostModel, TreeIndex>::jedi_k(const TreeIndex& t1,
   int t1_height = t1.postl_to_height_[t1_input_size-1];
   
   // Create cost matrices.
-  del_t1_subtree_.resize(t1_input_size+1);
-  del_f1_subtree_.resize(t1_input_size+1);
-  ins_t2_subtree_.resize(t2_input_size+1);
-  ins_f2_subtree_.resize(t2_input_size+1);
-  e_init_.resize(t2_input_size+1);
-  dt_ = data_structures::Matrix<double>(t1_height+1, t2_input_size+1);
-  df_ = data_structures::Matrix<double>(t1_height+1, t2_input_size+1);
-  e0_ = data_structures::Matrix<double>(t1_height+1, t2_input_size+1);
-  e_ = data_structures::Matrix<double>(t1_height+1, t2_input_size+1);
-  del_forest_ = data_structures::Matrix<double>(t1_height+1, t2_input_size+1);
-  del_tree_ = data_structures::Matrix<double>(t1_height+1, t2_input_size+1);
-  fav_child_dt_ = data_structures::Matrix<double>(t1_height+1, t2_input_size+1);
-  
-  // Fill the matrices with inf.
-  dt_.fill_with(std::numeric_limits<double>::infinity());
-  df_.fill_with(std::numeric_limits<double>::infinity());
-  e0_.fill_with(std::numeric_limits<double>::infinity());
-  e_.fill_with(std::numeric_limits<double>::infinity());
-  del_forest_.fill_with(std::numeric_limits<double>::infinity());
-  del_tree_.fill_with(std::numeric_limits<double>::infinity());
-  fav_child_dt_.fill_with(std::numeric_limits<double>::infinity());
+  workspace_.borrow(del_t1_subtree_, t1_input_size+1);
+  workspace_.borrow(del_f1_subtree_, t1_input_size+1);
+  workspace_.borrow(ins_t2_subtree_, t2_input_size+1);
+  workspace_.borrow(ins_f2_subtree_, t2_input_size+1);
+  workspace_.borrow(e_init_, t2_input_size+1);
+  workspace_.borrow(dt_, t1_height+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
+  workspace_.borrow(df_, t1_height+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
+  workspace_.borrow(e0_, t1_height+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
+  workspace_.borrow(e_, t1_height+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
+  workspace_.borrow(del_forest_, t1_height+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
+  workspace_.borrow(del_tree_, t1_height+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
+  workspace_.borrow(fav_child_dt_, t1_height+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
 
   // Initialize cost matrices.
   del_t1_subtree_.at(0) = 0;
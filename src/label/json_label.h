@@ -28,6 +28,7 @@
 #pragma once
 
 #include <string>
+#include <utility>
 
 namespace label {
 
@@ -43,6 +44,7 @@ namespace label {
 class JSONLabel {
 public:
   JSONLabel(const std::string& label);
+  JSONLabel(std::string&& label);
 
   /// Operator overloadings.
   /// @{
@@ -26,22 +26,22 @@
 
 #pragma once
 
-JSONLabel::JSONLabel(const std::string& label) {
-  label_ = label;
+JSONLabel::JSONLabel(const std::string& label) : JSONLabel(std::string(label)) {}
 
+JSONLabel::JSONLabel(std::string&& label) : label_(std::move(label)) {
   // Set type to 0 in case of an object. An object is indicated by opening
   // and closing curly braces.
-  if (label.compare("\\{\\}") == 0) {
+  if (label_.compare("\\{\\}") == 0) {
     type_ = 0;
   }
   // Set type to 1 in case of an array. An array is indicated by opening
   // and closing brackets.
-  else if (label.compare("[]") == 0) {
+  else if (label_.compare("[]") == 0) {
     type_ = 1;
   }
   // Set type to 2 in case of an key. A key is indicated by a colon after
   // the key itself.
-  else if (label.length() >= 2 && label[label.length() - 1] == ':') {
+  else if (label_.length() >= 2 && label_[label_.length() - 1] == ':') {
     type_ = 2;
   }
   // Otherwise, set type to 3 in case of a value.
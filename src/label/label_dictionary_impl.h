@@ -60,6 +60,7 @@ const Label& LabelDictionary<Label>::get(const int id) const{
 template<class Label>
 void LabelDictionary<Label>::clear() {
   label_to_id_dictionary_.clear();
+  id_to_label_dictionary_.clear();
   labels_count_ = 0;
 }
 
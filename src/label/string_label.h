@@ -30,6 +30,7 @@
 #pragma once
 
 #include <string>
+#include <utility>
 
 namespace label {
 
@@ -50,6 +51,7 @@ namespace label {
 class StringLabel {
 public:
     StringLabel(const std::string& label);
+    StringLabel(std::string&& label);
 
     /// Operator overloadings.
     /// @{
@@ -28,6 +28,8 @@
 
 StringLabel::StringLabel(const std::string& label) : label_(label) {}
 
+StringLabel::StringLabel(std::string&& label) : label_(std::move(label)) {}
+
 // const std::string& StringLabel::label() const {
 //   return label_;
 // }
@@ -0,0 +1,89 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file lookup/index/batch_lookup.h
+///
+/// \details
+/// Retrieves the candidates of many query trees at once. The prefix nodes of
+/// all queries of a block are sorted, such that equal query nodes (same
+/// label, number of descendants and ancestors, and tree size) traverse the
+/// TwoStageInvertedList only once and queries with the same label look up
+/// the same part of the index one after another. The candidates of a query
+/// are collected in a bitset over the set ids instead of a hash set, which
+/// deduplicates them without hashing and enumerates them in ascending order.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "label_set_element.h"
+#include "two_stage_inverted_list.h"
+#include "sets_collection_view.h"
+#include "size_window.h"
+
+namespace lookup {
+
+/// Maximum number of 64-bit words of the candidate bitsets of a block of
+/// queries. Larger batches are processed in multiple blocks.
+constexpr std::size_t kBatchBitsetWords = std::size_t(1) << 22;
+
+/// Retrieves the candidates of a batch of query trees. The candidates are
+/// the same as the ones of VerificationIndex::execute_lookup for every query.
+///
+/// \param sets Set accessor of the indexed trees, e.g., a
+///             SetsCollectionView or a MappedIndex.
+/// \param index Candidate index built on the sets, e.g., a
+///              TwoStageInvertedList or a MappedIndex.
+/// \param query_tree_ids Set ids of the query trees.
+/// \param distance_threshold Given similarity threshold.
+/// \param candidates Pairs of query tree id and candidate set id, appended in
+///                   the order of query_tree_ids and in ascending candidate
+///                   set id per query.
+template <typename SetCollection, typename CandidateIndex>
+void retrieve_batch_candidates(const SetCollection& sets,
+    const CandidateIndex& index,
+    const std::vector<unsigned int>& query_tree_ids,
+    const double distance_threshold,
+    std::vector<std::pair<unsigned int, long int>>& candidates);
+
+/// Retrieves the candidates of a batch of query trees from a label set
+/// collection and its TwoStageInvertedList.
+///
+/// \param sets_collection Label set collection of the indexed trees.
+/// \param size_setid_map Pairs of tree size and set id in ascending size.
+/// \param index Inverted list index built on sets_collection.
+/// \param query_tree_ids Set ids of the query trees.
+/// \param distance_threshold Given similarity threshold.
+/// \param candidates Pairs of query tree id and candidate set id.
+void retrieve_batch_candidates(
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map,
+    const TwoStageInvertedList& index,
+    const std::vector<unsigned int>& query_tree_ids,
+    const double distance_threshold,
+    std::vector<std::pair<unsigned int, long int>>& candidates);
+
+// Implementation details.
+#include "batch_lookup_impl.h"
+
+}
@@ -0,0 +1,125 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file lookup/index/batch_lookup_impl.h
+///
+/// \details
+/// Contains the implementation of the batched candidate retrieval.
+
+#pragma once
+
+inline void retrieve_batch_candidates(
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map,
+    const TwoStageInvertedList& index,
+    const std::vector<unsigned int>& query_tree_ids,
+    const double distance_threshold,
+    std::vector<std::pair<unsigned int, long int>>& candidates) {
+  retrieve_batch_candidates(SetsCollectionView(sets_collection,
+      size_setid_map), index, query_tree_ids, distance_threshold, candidates);
+}
+
+template <typename SetCollection, typename CandidateIndex>
+void retrieve_batch_candidates(const SetCollection& sets,
+    const CandidateIndex& index,
+    const std::vector<unsigned int>& query_tree_ids,
+    const double distance_threshold,
+    std::vector<std::pair<unsigned int, long int>>& candidates) {
+  const std::size_t words = std::max<std::size_t>(
+      (sets.get_number_of_sets() + 63) / 64, 1);
+  const std::size_t block_size = std::max<std::size_t>(
+      kBatchBitsetWords / words, 1);
+  // Query node: label id, descendants, ancestors, tree size, and the position
+  // of the query in the block.
+  std::vector<std::tuple<long int, long int, long int, int, std::size_t>> probes;
+  std::vector<std::uint64_t> bitsets;
+
+  for (std::size_t block_begin = 0; block_begin < query_tree_ids.size();
+      block_begin += block_size) {
+    const std::size_t block_end = std::min(block_begin + block_size,
+        query_tree_ids.size());
+    bitsets.assign((block_end - block_begin) * words, 0);
+    probes.clear();
+
+    for (std::size_t q = block_begin; q < block_end; ++q) {
+      const int tree_size = sets.get_tree_size(query_tree_ids[q]);
+      const label_set_converter_index::LabelSetElement* elements =
+          sets.get_set_elements(query_tree_ids[q]);
+      std::uint64_t* bits = &bitsets[(q - block_begin) * words];
+      // If the query tree is less than the threshold, the trees of its size
+      // window have to be considered.
+      if (tree_size < distance_threshold + 1) {
+        fill_size_window(sets, index, tree_size, distance_threshold, bits);
+      }
+      // Lookup the index for each element in the prefix of the query tree.
+      long int prefix = std::min(
+          (int) sets.get_set_size(query_tree_ids[q]) - 1,
+          (int) distance_threshold + 1);
+      for (long int pos = 0; pos <= prefix; pos++) {
+        probes.emplace_back(elements[pos].id, elements[pos].descendants,
+            elements[pos].ancestors, tree_size, q - block_begin);
+      }
+    }
+    std::sort(probes.begin(), probes.end());
+
+    for (std::size_t i = 0; i < probes.size();) {
+      // Equal query nodes are adjacent after sorting.
+      std::size_t j = i + 1;
+      while (j < probes.size() &&
+          std::get<0>(probes[j]) == std::get<0>(probes[i]) &&
+          std::get<1>(probes[j]) == std::get<1>(probes[i]) &&
+          std::get<2>(probes[j]) == std::get<2>(probes[i]) &&
+          std::get<3>(probes[j]) == std::get<3>(probes[i])) {
+        ++j;
+      }
+      // The ranges point into the postings, or into the decoded postings if
+      // they are compressed, and are set in the bitsets of all equal query
+      // nodes directly.
+      index.for_each_candidate_range(std::get<0>(probes[i]),
+          std::get<1>(probes[i]), std::get<2>(probes[i]),
+          std::get<3>(probes[i]), distance_threshold,
+          [&bitsets, &probes, words, i, j](const auto begin,
+          const auto end) {
+        for (std::size_t k = i; k < j; ++k) {
+          std::uint64_t* bits = &bitsets[std::get<4>(probes[k]) * words];
+          for (auto it = begin; it != end; ++it) {
+            bits[*it >> 6] |= std::uint64_t(1) << (*it & 63);
+          }
+        }
+      });
+      i = j;
+    }
+
+    // Enumerate the set bits in ascending set id per query.
+    for (std::size_t q = block_begin; q < block_end; ++q) {
+      const std::uint64_t* bits = &bitsets[(q - block_begin) * words];
+      for (std::size_t w = 0; w < words; ++w) {
+        for (std::uint64_t word = bits[w]; word != 0; word &= word - 1) {
+          int bit = 0;
+          while (((word >> bit) & 1) == 0) {
+            ++bit;
+          }
+          candidates.emplace_back(query_tree_ids[q], w * 64 + bit);
+        }
+      }
+    }
+  }
+}
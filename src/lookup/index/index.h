@@ -21,43 +21,194 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <vector>
 #include <map>
 #include "../../node/node.h"
 #include "../../node/tree_indexer.h"
+#include "../../node/tree_index_collection.h"
+#include "../../cost_model/unit_cost_model.h"
 #include "label_set_element.h"
 #include "../lookup_result_element.h"
+#include "../top_k_results.h"
 #include "two_stage_inverted_list.h"
+#include "sets_collection_view.h"
+#include "batch_lookup.h"
+#include "size_window.h"
+#include "../../parallel/parallel_for.h"
+#include "../../data_structures/result_sink.h"
 
 namespace lookup {
 
 /**
  * Implements a index lookup algorithm for a given verification and upper bound 
  * algorithm.
+ *
+ * The lookups read the label sets through a set accessor, e.g., a
+ * SetsCollectionView or a MappedIndex, and the candidates from a candidate
+ * index with for_each_candidate_range, lookup, and is_removed, e.g., a
+ * TwoStageInvertedList or a MappedIndex.
  */
 template <typename Label, typename VerificationAlgorithm, typename UpperBound>
 class VerificationUBkIndex {
 
 public:
+  /// Constructor. Batched lookups are verified in a single thread.
   VerificationUBkIndex();
+  /// Constructor.
+  /**
+   * \param number_of_threads Number of threads verifying the candidates of
+   *                          batched lookups. Values smaller than one use all
+   *                          hardware threads.
+   */
+  VerificationUBkIndex(const int number_of_threads);
   
   /// Executes the lookup algorithm.
   /**
-   * \param trees_collection A vector holding an input collection of trees.
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
    * \param distance_threshold The maximum number of edit operations that
    *                           differs two trees in the lookup's result set.
    * \return A vector with the lookup result.
    */
+  template <typename SetCollection, typename CandidateIndex>
   std::vector<lookup::LookupResultElement> execute_lookup(
-      std::vector<node::Node<Label>>& trees_collection,
-      std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
-      std::vector<std::pair<int, int>>& size_setid_map, lookup::TwoStageInvertedList& index,
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const SetCollection& sets, const CandidateIndex& index,
       unsigned int query_tree_id, const double distance_threshold);
+  /// Same as above for a label set collection and its inverted list.
+  std::vector<lookup::LookupResultElement> execute_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+      unsigned int query_tree_id, const double distance_threshold);
+  /// Executes the lookup algorithm and streams the results to a sink.
+  /**
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param result_set Sink receiving the lookup results. It is flushed
+   *                   before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the lookup's result set.
+   */
+  template <typename SetCollection, typename CandidateIndex>
+  void execute_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const SetCollection& sets, const CandidateIndex& index,
+      unsigned int query_tree_id,
+      data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+      const double distance_threshold);
+  /// Same as above for a label set collection and its inverted list.
+  void execute_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+      unsigned int query_tree_id,
+      data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+      const double distance_threshold);
+  
+  /// Executes the lookup algorithm for a batch of query trees.
+  /**
+   * The candidates of all queries are retrieved with
+   * retrieve_batch_candidates. The resulting (query, candidate) pairs are
+   * verified by the threads given in the constructor, each with its own
+   * algorithm instances, in chunks of consecutive pairs. The result is
+   * ordered by the position of the query in query_tree_ids and by the
+   * candidate tree id, independent of the number of threads.
+   *
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param query_tree_ids Ids of the query trees.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the lookup's result set.
+   * \return A vector with the lookup results of all queries.
+   */
+  template <typename SetCollection, typename CandidateIndex>
+  std::vector<lookup::LookupResultElement> execute_lookup_batch(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const SetCollection& sets, const CandidateIndex& index,
+      const std::vector<unsigned int>& query_tree_ids, const double distance_threshold);
+  /// Same as above for a label set collection and its inverted list.
+  std::vector<lookup::LookupResultElement> execute_lookup_batch(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+      const std::vector<unsigned int>& query_tree_ids, const double distance_threshold);
+  /// Executes the lookup algorithm for a batch of query trees and streams
+  /// the results to a sink.
+  /**
+   * The sink receives the results in the order of execute_lookup_batch. A
+   * chunk of verified pairs is passed on as soon as all earlier chunks are
+   * verified, i.e., the consumer of the sink is called by the verifying
+   * threads, one at a time.
+   *
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param query_tree_ids Ids of the query trees.
+   * \param result_set Sink receiving the lookup results of all queries. It
+   *                   is flushed before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the lookup's result set.
+   */
+  template <typename SetCollection, typename CandidateIndex>
+  void execute_lookup_batch(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const SetCollection& sets, const CandidateIndex& index,
+      const std::vector<unsigned int>& query_tree_ids,
+      data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+      const double distance_threshold);
+  /// Same as above for a label set collection and its inverted list.
+  void execute_lookup_batch(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+      const std::vector<unsigned int>& query_tree_ids,
+      data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+      const double distance_threshold);
+  
+  /// Executes a top-k lookup.
+  /**
+   * Returns the k trees with the smallest distance to the query tree, ties
+   * are broken by the smaller tree id. First, the k trees closest in size to
+   * the query are verified. The distance of the k-th best of them is the
+   * threshold of a lookup in the inverted list; all k nearest trees are
+   * among its candidates. The candidates are verified in ascending node
+   * intersection lower bound. The k-th best distance so far is the
+   * threshold of the upper bound and the verification; an upper bound equal
+   * to the lower bound is exact and saves the verification. The lookup stops
+   * once the lower bound exceeds the threshold.
+   *
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param query_tree_id Id of the query tree.
+   * \param k Number of results.
+   * \return A vector with the k nearest trees in ascending distance.
+   *
+   * Requires a unit cost model, see cost_model::is_unit_cost_model.
+   */
+  template <typename SetCollection, typename CandidateIndex>
+  std::vector<lookup::LookupResultElement> execute_top_k_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const SetCollection& sets, const CandidateIndex& index,
+      unsigned int query_tree_id, const unsigned int k);
+  /// Same as above for a label set collection and its inverted list.
+  std::vector<lookup::LookupResultElement> execute_top_k_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+      unsigned int query_tree_id, const unsigned int k);
   
-  double node_lower_bound(std::vector<label_set_converter_index::LabelSetElement>& r, 
-      std::vector<label_set_converter_index::LabelSetElement>& s, 
-      double olap, int pr, int ps);
+  double node_lower_bound(const std::vector<label_set_converter_index::LabelSetElement>& r, 
+      const std::vector<label_set_converter_index::LabelSetElement>& s, 
+      double olap, int pr, int ps) const;
+  double node_lower_bound(const label_set_converter_index::LabelSetElement* r,
+      const std::size_t size_r,
+      const label_set_converter_index::LabelSetElement* s,
+      const std::size_t size_s, double olap, std::size_t pr,
+      std::size_t ps) const;
 
   /// Returns the summed subproblem count of JEDI algorithm executions.
   /**
@@ -92,33 +243,176 @@ private:
   long long int pre_candidates_;
   /// Number of candidates.
   long long int candidates_;
+  /// Number of threads verifying batched lookups.
+  unsigned int number_of_threads_;
+  /// Number of candidate pairs a thread claims at once.
+  static constexpr std::size_t kVerificationChunkSize = 64;
 };
 
 /**
  * Implements a index lookup algorithm for a given verification.
+ *
+ * The lookups read the label sets through a set accessor, e.g., a
+ * SetsCollectionView or a MappedIndex, and the candidates from a candidate
+ * index with for_each_candidate_range, lookup, and is_removed, e.g., a
+ * TwoStageInvertedList or a MappedIndex.
  */
 template <typename Label, typename VerificationAlgorithm>
 class VerificationIndex {
 
 public:
+  /// Constructor. Batched lookups are verified in a single thread.
   VerificationIndex();
+  /// Constructor.
+  /**
+   * \param number_of_threads Number of threads verifying the candidates of
+   *                          batched lookups. Values smaller than one use all
+   *                          hardware threads.
+   */
+  VerificationIndex(const int number_of_threads);
   
   /// Executes the lookup algorithm.
   /**
-   * \param trees_collection A vector holding an input collection of trees.
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
    * \param distance_threshold The maximum number of edit operations that
    *                           differs two trees in the lookup's result set.
    * \return A vector with the lookup result.
    */
+  template <typename SetCollection, typename CandidateIndex>
   std::vector<lookup::LookupResultElement> execute_lookup(
-      std::vector<node::Node<Label>>& trees_collection,
-      std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
-      std::vector<std::pair<int, int>>& size_setid_map, lookup::TwoStageInvertedList& index,
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const SetCollection& sets, const CandidateIndex& index,
       unsigned int query_tree_id, const double distance_threshold);
+  /// Same as above for a label set collection and its inverted list.
+  std::vector<lookup::LookupResultElement> execute_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+      unsigned int query_tree_id, const double distance_threshold);
+  /// Executes the lookup algorithm and streams the results to a sink.
+  /**
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param result_set Sink receiving the lookup results. It is flushed
+   *                   before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the lookup's result set.
+   */
+  template <typename SetCollection, typename CandidateIndex>
+  void execute_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const SetCollection& sets, const CandidateIndex& index,
+      unsigned int query_tree_id,
+      data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+      const double distance_threshold);
+  /// Same as above for a label set collection and its inverted list.
+  void execute_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+      unsigned int query_tree_id,
+      data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+      const double distance_threshold);
+  
+  /// Executes the lookup algorithm for a batch of query trees.
+  /**
+   * The candidates of all queries are retrieved with
+   * retrieve_batch_candidates. The resulting (query, candidate) pairs are
+   * verified by the threads given in the constructor, each with its own
+   * algorithm instances, in chunks of consecutive pairs. The result is
+   * ordered by the position of the query in query_tree_ids and by the
+   * candidate tree id, independent of the number of threads.
+   *
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param query_tree_ids Ids of the query trees.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the lookup's result set.
+   * \return A vector with the lookup results of all queries.
+   */
+  template <typename SetCollection, typename CandidateIndex>
+  std::vector<lookup::LookupResultElement> execute_lookup_batch(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const SetCollection& sets, const CandidateIndex& index,
+      const std::vector<unsigned int>& query_tree_ids, const double distance_threshold);
+  /// Same as above for a label set collection and its inverted list.
+  std::vector<lookup::LookupResultElement> execute_lookup_batch(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+      const std::vector<unsigned int>& query_tree_ids, const double distance_threshold);
+  /// Executes the lookup algorithm for a batch of query trees and streams
+  /// the results to a sink.
+  /**
+   * The sink receives the results in the order of execute_lookup_batch. A
+   * chunk of verified pairs is passed on as soon as all earlier chunks are
+   * verified, i.e., the consumer of the sink is called by the verifying
+   * threads, one at a time.
+   *
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param query_tree_ids Ids of the query trees.
+   * \param result_set Sink receiving the lookup results of all queries. It
+   *                   is flushed before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the lookup's result set.
+   */
+  template <typename SetCollection, typename CandidateIndex>
+  void execute_lookup_batch(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const SetCollection& sets, const CandidateIndex& index,
+      const std::vector<unsigned int>& query_tree_ids,
+      data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+      const double distance_threshold);
+  /// Same as above for a label set collection and its inverted list.
+  void execute_lookup_batch(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+      const std::vector<unsigned int>& query_tree_ids,
+      data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+      const double distance_threshold);
+  
+  /// Executes a top-k lookup.
+  /**
+   * Returns the k trees with the smallest distance to the query tree, ties
+   * are broken by the smaller tree id. First, the k trees closest in size to
+   * the query are verified. The distance of the k-th best of them is the
+   * threshold of a lookup in the inverted list; all k nearest trees are
+   * among its candidates. The candidates are verified in ascending node
+   * intersection lower bound. The k-th best distance so far is the
+   * threshold of the verification. The lookup stops once the lower bound
+   * exceeds the threshold.
+   *
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param query_tree_id Id of the query tree.
+   * \param k Number of results.
+   * \return A vector with the k nearest trees in ascending distance.
+   *
+   * Requires a unit cost model, see cost_model::is_unit_cost_model.
+   */
+  template <typename SetCollection, typename CandidateIndex>
+  std::vector<lookup::LookupResultElement> execute_top_k_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const SetCollection& sets, const CandidateIndex& index,
+      unsigned int query_tree_id, const unsigned int k);
+  /// Same as above for a label set collection and its inverted list.
+  std::vector<lookup::LookupResultElement> execute_top_k_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+      unsigned int query_tree_id, const unsigned int k);
   
-  double node_lower_bound(std::vector<label_set_converter_index::LabelSetElement>& r, 
-      std::vector<label_set_converter_index::LabelSetElement>& s, 
-      double olap, int pr, int ps);
+  double node_lower_bound(const std::vector<label_set_converter_index::LabelSetElement>& r, 
+      const std::vector<label_set_converter_index::LabelSetElement>& s, 
+      double olap, int pr, int ps) const;
+  double node_lower_bound(const label_set_converter_index::LabelSetElement* r,
+      const std::size_t size_r,
+      const label_set_converter_index::LabelSetElement* s,
+      const std::size_t size_s, double olap, std::size_t pr,
+      std::size_t ps) const;
 
   /// Returns the summed subproblem count of JEDI algorithm executions.
   /**
@@ -153,6 +447,10 @@ private:
   long long int pre_candidates_;
   /// Number of candidates.
   long long int candidates_;
+  /// Number of threads verifying batched lookups.
+  unsigned int number_of_threads_;
+  /// Number of candidate pairs a thread claims at once.
+  static constexpr std::size_t kVerificationChunkSize = 64;
 };
 
 // Implementation details.
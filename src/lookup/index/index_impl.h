@@ -25,60 +25,77 @@
 
 template <typename Label, typename VerificationAlgorithm, typename UpperBound>
 VerificationUBkIndex<Label, VerificationAlgorithm, 
-    UpperBound>::VerificationUBkIndex() {
+    UpperBound>::VerificationUBkIndex() : VerificationUBkIndex(1) {}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+VerificationUBkIndex<Label, VerificationAlgorithm, 
+    UpperBound>::VerificationUBkIndex(const int number_of_threads) {
+  number_of_threads_ = parallel::get_number_of_threads(number_of_threads);
   verfications_ = 0;
+  sum_subproblem_counter_ = 0;
   candidates_ = 0;
   pre_candidates_ = 0;
 }
 
 template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+template <typename SetCollection, typename CandidateIndex>
 std::vector<lookup::LookupResultElement> 
     VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>::execute_lookup(
-    std::vector<node::Node<Label>>& trees_collection, 
-    std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
-    std::vector<std::pair<int, int>>& size_setid_map, lookup::TwoStageInvertedList& index,
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const SetCollection& sets, const CandidateIndex& index,
     unsigned int query_tree_id, const double distance_threshold) {
+  std::vector<lookup::LookupResultElement> result_set;
+  data_structures::ResultSink<lookup::LookupResultElement> sink(result_set);
+  execute_lookup(indexed_collection, sets, index,
+      query_tree_id, sink, distance_threshold);
+  return result_set;
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+template <typename SetCollection, typename CandidateIndex>
+void VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>::execute_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const SetCollection& sets, const CandidateIndex& index,
+    unsigned int query_tree_id,
+    data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+    const double distance_threshold) {
 
-  label::LabelDictionary<Label> ld;
-  typename VerificationAlgorithm::AlgsCostModel cm(ld);
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
 
   VerificationAlgorithm verification_algorithm(cm);
   UpperBound upper_bound_algorithm(cm);
-  typename VerificationAlgorithm::AlgsTreeIndex tq;
-  typename VerificationAlgorithm::AlgsTreeIndex tc;
 
-  // Stores the result set.
-  std::vector<lookup::LookupResultElement> result_set;
   // Used to store the computed distance value.
   double distance = std::numeric_limits<double>::infinity();
   double intersection = std::numeric_limits<double>::infinity();
   double lower_bound = std::numeric_limits<double>::infinity();
   double upper_bound = std::numeric_limits<double>::infinity();
 
-  // Index query tree.
-  node::index_tree(tq, trees_collection[query_tree_id], ld, cm);
+  // Indexed query tree.
+  const typename VerificationAlgorithm::AlgsTreeIndex& tq =
+      indexed_collection[query_tree_id];
 
   // Get candidates from index.
   std::unordered_set<long int> candidates;
 
-  // If the query tree is less than the threshold, all trees from 
-  // size 0 up to threshold + 1 have to be considered.
+  // If the query tree is less than the threshold, the trees of its size
+  // window have to be considered. The trees of the inverted list are in the
+  // size window (see size_window.h).
   if (tq.tree_size_ < distance_threshold + 1) {
-    for (auto const& set : size_setid_map) {
-      if (set.first > tq.tree_size_ + distance_threshold + 1) {
-        break;
-      }
-      candidates.insert(set.second);
-    }
+    lookup::for_each_size_window_set(sets, index, tq.tree_size_,
+        distance_threshold, [&candidates](const int set_id) {
+      candidates.insert(set_id);
+    });
   }
 
   // Lookup the index for each element in the prefix of the query tree.
-  long int prefix = std::min((int) sets_collection[query_tree_id].second.size() - 1, (int) distance_threshold + 1);
+  const label_set_converter_index::LabelSetElement* q_elements =
+      sets.get_set_elements(query_tree_id);
+  long int prefix = std::min((int) sets.get_set_size(query_tree_id) - 1, (int) distance_threshold + 1);
   for (long int pos = 0; pos <= prefix; pos++) {
-    index.lookup(sets_collection[query_tree_id].second[pos].id, 
-        sets_collection[query_tree_id].second[pos].descendants, 
-        sets_collection[query_tree_id].second[pos].ancestors, 
-        sets_collection[query_tree_id].first,
+    index.lookup(q_elements[pos].id, q_elements[pos].descendants, 
+        q_elements[pos].ancestors, sets.get_tree_size(query_tree_id),
         candidates, distance_threshold);
   }
   pre_candidates_ = candidates.size();
@@ -86,17 +103,19 @@ std::vector<lookup::LookupResultElement>
 
   // Verify which candidate trees are part of the result set.
   for (long int const& candidate_tree_id: candidates) {
-    // Index candidate tree.
-    node::index_tree(tc, trees_collection[candidate_tree_id], ld, cm);
+    // Indexed candidate tree.
+    const typename VerificationAlgorithm::AlgsTreeIndex& tc =
+        indexed_collection[candidate_tree_id];
 
     // Compute the lower bound between the query and candidate tree.
     // If the lower bound exceeds the threshold, put the pair immediately
     // to the result set without verification.
-    intersection = node_lower_bound(sets_collection[query_tree_id].second, 
-        sets_collection[candidate_tree_id].second, 0, 0, 0);
+    intersection = node_lower_bound(sets.get_set_elements(query_tree_id),
+        sets.get_set_size(query_tree_id), sets.get_set_elements(candidate_tree_id),
+        sets.get_set_size(candidate_tree_id), 0, 0, 0);
     // Node intersection LB: DPJED >= max(T1, T2) - T1 intersection T2.
-    lower_bound = std::max(sets_collection[query_tree_id].first, 
-        sets_collection[candidate_tree_id].first) - intersection;
+    lower_bound = std::max(sets.get_tree_size(query_tree_id),
+        sets.get_tree_size(candidate_tree_id)) - intersection;
     // Prune candidate if the lower bound exceeds the threshold.
     if (lower_bound > distance_threshold) {
       candidates_--;
@@ -120,16 +139,311 @@ std::vector<lookup::LookupResultElement>
     }
   }
 
+  result_set.flush();
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+template <typename SetCollection, typename CandidateIndex>
+std::vector<lookup::LookupResultElement> 
+    VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>::execute_lookup_batch(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const SetCollection& sets, const CandidateIndex& index,
+    const std::vector<unsigned int>& query_tree_ids, const double distance_threshold) {
+  std::vector<lookup::LookupResultElement> result_set;
+  data_structures::ResultSink<lookup::LookupResultElement> sink(result_set);
+  execute_lookup_batch(indexed_collection, sets, index,
+      query_tree_ids, sink, distance_threshold);
   return result_set;
 }
 
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+template <typename SetCollection, typename CandidateIndex>
+void VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>::execute_lookup_batch(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const SetCollection& sets, const CandidateIndex& index,
+    const std::vector<unsigned int>& query_tree_ids,
+    data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+    const double distance_threshold) {
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
+
+  // Get the candidates of all queries from the index.
+  std::vector<std::pair<unsigned int, long int>> candidates;
+  lookup::retrieve_batch_candidates(sets, index,
+      query_tree_ids, distance_threshold, candidates);
+  pre_candidates_ = candidates.size();
+  candidates_ = pre_candidates_;
+
+  // The results of a chunk are passed to the sink as soon as all earlier
+  // chunks are verified.
+  parallel::ChunkQueue chunks(candidates.size(), kVerificationChunkSize);
+  parallel::ChunkSequencer sequencer(
+      parallel::kPendingChunksPerThread * number_of_threads_);
+  std::vector<std::vector<lookup::LookupResultElement>> chunk_results(
+      chunks.get_number_of_chunks());
+  std::vector<long long int> thread_pruned(number_of_threads_, 0);
+  std::vector<long long int> thread_verifications(number_of_threads_, 0);
+  std::vector<long long int> thread_subproblem_counters(number_of_threads_, 0);
+
+  parallel::run_workers(number_of_threads_, [&](const unsigned int thread_id) {
+    VerificationAlgorithm verification_algorithm(cm);
+    UpperBound upper_bound_algorithm(cm);
+
+    sequencer.run(chunks, [&](const std::size_t chunk_id,
+        const std::size_t begin, const std::size_t end) {
+      // Verify each pair in the chunk.
+      for (std::size_t c = begin; c < end; ++c) {
+        const unsigned int query_tree_id = candidates[c].first;
+        const long int candidate_tree_id = candidates[c].second;
+        const typename VerificationAlgorithm::AlgsTreeIndex& tq =
+            indexed_collection[query_tree_id];
+        const typename VerificationAlgorithm::AlgsTreeIndex& tc =
+            indexed_collection[candidate_tree_id];
+
+        // Node intersection LB: DPJED >= max(T1, T2) - T1 intersection T2.
+        double intersection = node_lower_bound(sets.get_set_elements(query_tree_id),
+            sets.get_set_size(query_tree_id), sets.get_set_elements(candidate_tree_id),
+            sets.get_set_size(candidate_tree_id), 0, 0, 0);
+        double lower_bound = std::max(sets.get_tree_size(query_tree_id),
+            sets.get_tree_size(candidate_tree_id)) - intersection;
+        // Prune candidate if the lower bound exceeds the threshold.
+        if (lower_bound > distance_threshold) {
+          thread_pruned[thread_id]++;
+          continue;
+        }
+        // If the upper bound is already less than the threshold, the pair is 
+        // certainly in the result set.
+        double upper_bound = upper_bound_algorithm.jedi_k(tq, tc,
+            distance_threshold);
+        if (upper_bound <= distance_threshold) {
+          chunk_results[chunk_id].emplace_back(query_tree_id,
+              candidate_tree_id, lower_bound, upper_bound, -1);
+        } else {
+          thread_verifications[thread_id]++;
+          // Verify the candidate pair in case that the bounds do not apply.
+          double distance = verification_algorithm.jedi(tq, tc);
+          if (distance <= distance_threshold) {
+            chunk_results[chunk_id].emplace_back(query_tree_id,
+                candidate_tree_id, lower_bound, upper_bound, distance);
+          }
+        }
+        // Sum up all number of subproblems
+        thread_subproblem_counters[thread_id] +=
+            verification_algorithm.get_subproblem_count();
+      }
+    }, [&](const std::size_t id) {
+      result_set.append(chunk_results[id]);
+      std::vector<lookup::LookupResultElement>().swap(chunk_results[id]);
+    });
+  });
+
+  for (unsigned int t = 0; t < number_of_threads_; ++t) {
+    candidates_ -= thread_pruned[t];
+    verfications_ += thread_verifications[t];
+    sum_subproblem_counter_ += thread_subproblem_counters[t];
+  }
+
+  result_set.flush();
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+template <typename SetCollection, typename CandidateIndex>
+std::vector<lookup::LookupResultElement> 
+    VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>::execute_top_k_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const SetCollection& sets, const CandidateIndex& index,
+    unsigned int query_tree_id, const unsigned int k) {
+
+  // The lower bounds and the threshold cap below hold for unit costs only.
+  static_assert(cost_model::is_unit_cost_model<
+      typename VerificationAlgorithm::AlgsCostModel>::value,
+      "Top-k lookups require a unit cost model.");
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
+
+  VerificationAlgorithm verification_algorithm(cm);
+  UpperBound upper_bound_algorithm(cm);
+
+  // Stores the k best results.
+  lookup::TopKResults top_k(k);
+
+  // Indexed query tree.
+  const typename VerificationAlgorithm::AlgsTreeIndex& tq =
+      indexed_collection[query_tree_id];
+
+  // Verifies a tree with the current threshold.
+  auto verify = [&](const long int candidate_tree_id,
+      const double lower_bound) {
+    // Indexed candidate tree.
+    const typename VerificationAlgorithm::AlgsTreeIndex& tc =
+        indexed_collection[candidate_tree_id];
+    // With unit costs, no distance exceeds the sum of the tree sizes.
+    double threshold = std::min(top_k.get_threshold(),
+        (double) tq.tree_size_ + tc.tree_size_);
+    double distance = std::numeric_limits<double>::infinity();
+    // Compute the upper bound between the query and candidate tree.
+    double upper_bound = upper_bound_algorithm.jedi_k(tq, tc, threshold);
+    if (upper_bound <= lower_bound) {
+      // The upper bound meets the lower bound, hence it is the distance.
+      distance = upper_bound;
+    } else {
+      verfications_++;
+      // The distance does not exceed the upper bound.
+      distance = verification_algorithm.jedi_k(tq, tc,
+          std::min(threshold, upper_bound));
+      // Sum up all number of subproblems
+      sum_subproblem_counter_ += verification_algorithm.get_subproblem_count();
+    }
+    if (distance <= threshold) {
+      top_k.insert(lookup::LookupResultElement(query_tree_id,
+          candidate_tree_id, lower_bound, upper_bound, distance));
+    }
+  };
+
+  // Seed the threshold with the k trees closest in size to the query. The
+  // size difference is a lower bound of the distance. Removed trees stay in
+  // the size_setid_map.
+  std::vector<bool> verified(sets.get_number_of_sets(), false);
+  std::vector<std::pair<int, long int>> seeds;
+  for (std::size_t pos = 0; pos < sets.get_number_of_size_entries(); ++pos) {
+    const std::pair<int, int> entry = sets.get_size_entry(pos);
+    if (!index.is_removed(entry.second)) {
+      seeds.emplace_back(std::abs(sets.get_tree_size(query_tree_id) -
+          entry.first), entry.second);
+    }
+  }
+  const std::size_t nr_of_seeds = std::min<std::size_t>(k, seeds.size());
+  std::partial_sort(seeds.begin(), seeds.begin() + nr_of_seeds, seeds.end());
+  for (std::size_t i = 0; i < nr_of_seeds; ++i) {
+    verified[seeds[i].second] = true;
+    verify(seeds[i].second, seeds[i].first);
+  }
+  // Less than k trees are all verified.
+  const double seed_threshold = top_k.get_threshold();
+  if (nr_of_seeds < k || k == 0) {
+    pre_candidates_ = nr_of_seeds;
+    candidates_ = nr_of_seeds;
+    return top_k.get_sorted_results();
+  }
+
+  // The k nearest trees have a distance of at most seed_threshold, hence
+  // they are candidates of the index lookup with that threshold.
+  std::vector<std::pair<unsigned int, long int>> index_candidates;
+  lookup::retrieve_batch_candidates(sets, index,
+      {query_tree_id}, seed_threshold, index_candidates);
+  pre_candidates_ = index_candidates.size();
+
+  // Order the remaining candidates by the node intersection lower bound.
+  std::vector<std::pair<double, long int>> candidates;
+  for (const auto& candidate : index_candidates) {
+    const long int candidate_tree_id = candidate.second;
+    if (verified[candidate_tree_id]) {
+      continue;
+    }
+    double intersection = node_lower_bound(sets.get_set_elements(query_tree_id),
+        sets.get_set_size(query_tree_id), sets.get_set_elements(candidate_tree_id),
+        sets.get_set_size(candidate_tree_id), 0, 0, 0);
+    // Node intersection LB: DPJED >= max(T1, T2) - T1 intersection T2.
+    double lower_bound = std::max(sets.get_tree_size(query_tree_id),
+        sets.get_tree_size(candidate_tree_id)) - intersection;
+    if (lower_bound <= seed_threshold) {
+      candidates.emplace_back(lower_bound, candidate_tree_id);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+  candidates_ = nr_of_seeds + candidates.size();
+
+  for (const auto& candidate : candidates) {
+    // All remaining candidates have a lower bound that exceeds the threshold.
+    if (candidate.first > top_k.get_threshold()) {
+      break;
+    }
+    verify(candidate.second, candidate.first);
+  }
+
+  return top_k.get_sorted_results();
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+std::vector<lookup::LookupResultElement> 
+    VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>::execute_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+    unsigned int query_tree_id, const double distance_threshold) {
+  return execute_lookup(indexed_collection,
+      SetsCollectionView(sets_collection, size_setid_map), index,
+      query_tree_id, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+void VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>::execute_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+    unsigned int query_tree_id,
+    data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+    const double distance_threshold) {
+  execute_lookup(indexed_collection,
+      SetsCollectionView(sets_collection, size_setid_map), index,
+      query_tree_id, result_set, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+std::vector<lookup::LookupResultElement> 
+    VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>::execute_lookup_batch(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+    const std::vector<unsigned int>& query_tree_ids, const double distance_threshold) {
+  return execute_lookup_batch(indexed_collection,
+      SetsCollectionView(sets_collection, size_setid_map), index,
+      query_tree_ids, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+void VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>::execute_lookup_batch(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+    const std::vector<unsigned int>& query_tree_ids,
+    data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+    const double distance_threshold) {
+  execute_lookup_batch(indexed_collection,
+      SetsCollectionView(sets_collection, size_setid_map), index,
+      query_tree_ids, result_set, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+std::vector<lookup::LookupResultElement> 
+    VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>::execute_top_k_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+    unsigned int query_tree_id, const unsigned int k) {
+  return execute_top_k_lookup(indexed_collection,
+      SetsCollectionView(sets_collection, size_setid_map), index,
+      query_tree_id, k);
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+double VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>::node_lower_bound(
+    const std::vector<label_set_converter_index::LabelSetElement>& r, 
+    const std::vector<label_set_converter_index::LabelSetElement>& s, 
+    double olap, int pr, int ps) const {
+  return node_lower_bound(r.data(), r.size(), s.data(), s.size(),
+      olap, pr, ps);
+}
+
 template <typename Label, typename VerificationAlgorithm, typename UpperBound>
 double VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>::node_lower_bound(
-    std::vector<label_set_converter_index::LabelSetElement>& r, 
-    std::vector<label_set_converter_index::LabelSetElement>& s, 
-    double olap, int pr, int ps) {
-  int size_r = r.size();
-  int size_s = s.size();
+    const label_set_converter_index::LabelSetElement* r,
+    const std::size_t size_r,
+    const label_set_converter_index::LabelSetElement* s,
+    const std::size_t size_s, double olap, std::size_t pr,
+    std::size_t ps) const {
   while (pr < size_r && ps < size_s) {
     if (r[pr].id == s[ps].id) {
       olap += 1;
@@ -171,58 +485,76 @@ long long int VerificationUBkIndex<Label,
 // ****** Without given upper bound.
 
 template <typename Label, typename VerificationAlgorithm>
-VerificationIndex<Label, VerificationAlgorithm>::VerificationIndex() {
+VerificationIndex<Label, VerificationAlgorithm>::VerificationIndex()
+    : VerificationIndex(1) {}
+
+template <typename Label, typename VerificationAlgorithm>
+VerificationIndex<Label, VerificationAlgorithm>::VerificationIndex(
+    const int number_of_threads) {
+  number_of_threads_ = parallel::get_number_of_threads(number_of_threads);
   verfications_ = 0;
+  sum_subproblem_counter_ = 0;
   candidates_ = 0;
   pre_candidates_ = 0;
 }
 
 template <typename Label, typename VerificationAlgorithm>
+template <typename SetCollection, typename CandidateIndex>
 std::vector<lookup::LookupResultElement> 
     VerificationIndex<Label, VerificationAlgorithm>::execute_lookup(
-    std::vector<node::Node<Label>>& trees_collection, 
-    std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
-    std::vector<std::pair<int, int>>& size_setid_map, lookup::TwoStageInvertedList& index,
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const SetCollection& sets, const CandidateIndex& index,
     unsigned int query_tree_id, const double distance_threshold) {
+  std::vector<lookup::LookupResultElement> result_set;
+  data_structures::ResultSink<lookup::LookupResultElement> sink(result_set);
+  execute_lookup(indexed_collection, sets, index,
+      query_tree_id, sink, distance_threshold);
+  return result_set;
+}
 
-  label::LabelDictionary<Label> ld;
-  typename VerificationAlgorithm::AlgsCostModel cm(ld);
+template <typename Label, typename VerificationAlgorithm>
+template <typename SetCollection, typename CandidateIndex>
+void VerificationIndex<Label, VerificationAlgorithm>::execute_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const SetCollection& sets, const CandidateIndex& index,
+    unsigned int query_tree_id,
+    data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+    const double distance_threshold) {
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
 
   VerificationAlgorithm verification_algorithm(cm);
-  typename VerificationAlgorithm::AlgsTreeIndex tq;
-  typename VerificationAlgorithm::AlgsTreeIndex tc;
 
-  // Stores the result set.
-  std::vector<lookup::LookupResultElement> result_set;
   // Used to store the computed distance value.
   double distance = std::numeric_limits<double>::infinity();
   double intersection = std::numeric_limits<double>::infinity();
   double lower_bound = std::numeric_limits<double>::infinity();
 
-  // Index query tree.
-  node::index_tree(tq, trees_collection[query_tree_id], ld, cm);
+  // Indexed query tree.
+  const typename VerificationAlgorithm::AlgsTreeIndex& tq =
+      indexed_collection[query_tree_id];
 
   // Get candidates from index.
   std::unordered_set<long int> candidates;
 
-  // If the query tree is less than the threshold, all trees from 
-  // size 0 up to threshold + 1 have to be considered.
+  // If the query tree is less than the threshold, the trees of its size
+  // window have to be considered. The trees of the inverted list are in the
+  // size window (see size_window.h).
   if (tq.tree_size_ < distance_threshold + 1) {
-    for (auto const& set : size_setid_map) {
-      if (set.first > tq.tree_size_ + distance_threshold + 1) {
-        break;
-      }
-      candidates.insert(set.second);
-    }
+    lookup::for_each_size_window_set(sets, index, tq.tree_size_,
+        distance_threshold, [&candidates](const int set_id) {
+      candidates.insert(set_id);
+    });
   }
 
   // Lookup the index for each element in the prefix of the query tree.
-  long int prefix = std::min((int) sets_collection[query_tree_id].second.size() - 1, (int) distance_threshold + 1);
+  const label_set_converter_index::LabelSetElement* q_elements =
+      sets.get_set_elements(query_tree_id);
+  long int prefix = std::min((int) sets.get_set_size(query_tree_id) - 1, (int) distance_threshold + 1);
   for (long int pos = 0; pos <= prefix; pos++) {
-    index.lookup(sets_collection[query_tree_id].second[pos].id, 
-        sets_collection[query_tree_id].second[pos].descendants, 
-        sets_collection[query_tree_id].second[pos].ancestors, 
-        sets_collection[query_tree_id].first,
+    index.lookup(q_elements[pos].id, q_elements[pos].descendants, 
+        q_elements[pos].ancestors, sets.get_tree_size(query_tree_id),
         candidates, distance_threshold);
   }
   pre_candidates_ = candidates.size();
@@ -230,17 +562,19 @@ std::vector<lookup::LookupResultElement>
 
   // Verify which candidate trees are part of the result set.
   for (long int const& candidate_tree_id: candidates) {
-    // Index candidate tree.
-    node::index_tree(tc, trees_collection[candidate_tree_id], ld, cm);
+    // Indexed candidate tree.
+    const typename VerificationAlgorithm::AlgsTreeIndex& tc =
+        indexed_collection[candidate_tree_id];
 
     // Compute the lower bound between the query and candidate tree.
     // If the lower bound exceeds the threshold, put the pair immediately
     // to the result set without verification.
-    intersection = node_lower_bound(sets_collection[query_tree_id].second, 
-        sets_collection[candidate_tree_id].second, 0, 0, 0);
+    intersection = node_lower_bound(sets.get_set_elements(query_tree_id),
+        sets.get_set_size(query_tree_id), sets.get_set_elements(candidate_tree_id),
+        sets.get_set_size(candidate_tree_id), 0, 0, 0);
     // Node intersection LB: DPJED >= max(T1, T2) - T1 intersection T2.
-    lower_bound = std::max(sets_collection[query_tree_id].first, 
-        sets_collection[candidate_tree_id].first) - intersection;
+    lower_bound = std::max(sets.get_tree_size(query_tree_id),
+        sets.get_tree_size(candidate_tree_id)) - intersection;
     // Prune candidate if the lower bound exceeds the threshold.
     if (lower_bound > distance_threshold) {
       candidates_--;
@@ -256,16 +590,291 @@ std::vector<lookup::LookupResultElement>
     sum_subproblem_counter_ += verification_algorithm.get_subproblem_count();
   }
 
+  result_set.flush();
+}
+
+template <typename Label, typename VerificationAlgorithm>
+template <typename SetCollection, typename CandidateIndex>
+std::vector<lookup::LookupResultElement> 
+    VerificationIndex<Label, VerificationAlgorithm>::execute_lookup_batch(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const SetCollection& sets, const CandidateIndex& index,
+    const std::vector<unsigned int>& query_tree_ids, const double distance_threshold) {
+  std::vector<lookup::LookupResultElement> result_set;
+  data_structures::ResultSink<lookup::LookupResultElement> sink(result_set);
+  execute_lookup_batch(indexed_collection, sets, index,
+      query_tree_ids, sink, distance_threshold);
   return result_set;
 }
 
+template <typename Label, typename VerificationAlgorithm>
+template <typename SetCollection, typename CandidateIndex>
+void VerificationIndex<Label, VerificationAlgorithm>::execute_lookup_batch(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const SetCollection& sets, const CandidateIndex& index,
+    const std::vector<unsigned int>& query_tree_ids,
+    data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+    const double distance_threshold) {
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
+
+  // Get the candidates of all queries from the index.
+  std::vector<std::pair<unsigned int, long int>> candidates;
+  lookup::retrieve_batch_candidates(sets, index,
+      query_tree_ids, distance_threshold, candidates);
+  pre_candidates_ = candidates.size();
+  candidates_ = pre_candidates_;
+
+  // The results of a chunk are passed to the sink as soon as all earlier
+  // chunks are verified.
+  parallel::ChunkQueue chunks(candidates.size(), kVerificationChunkSize);
+  parallel::ChunkSequencer sequencer(
+      parallel::kPendingChunksPerThread * number_of_threads_);
+  std::vector<std::vector<lookup::LookupResultElement>> chunk_results(
+      chunks.get_number_of_chunks());
+  std::vector<long long int> thread_pruned(number_of_threads_, 0);
+  std::vector<long long int> thread_verifications(number_of_threads_, 0);
+  std::vector<long long int> thread_subproblem_counters(number_of_threads_, 0);
+
+  parallel::run_workers(number_of_threads_, [&](const unsigned int thread_id) {
+    VerificationAlgorithm verification_algorithm(cm);
+
+    sequencer.run(chunks, [&](const std::size_t chunk_id,
+        const std::size_t begin, const std::size_t end) {
+      // Verify each pair in the chunk.
+      for (std::size_t c = begin; c < end; ++c) {
+        const unsigned int query_tree_id = candidates[c].first;
+        const long int candidate_tree_id = candidates[c].second;
+        const typename VerificationAlgorithm::AlgsTreeIndex& tq =
+            indexed_collection[query_tree_id];
+        const typename VerificationAlgorithm::AlgsTreeIndex& tc =
+            indexed_collection[candidate_tree_id];
+
+        // Node intersection LB: DPJED >= max(T1, T2) - T1 intersection T2.
+        double intersection = node_lower_bound(sets.get_set_elements(query_tree_id),
+            sets.get_set_size(query_tree_id), sets.get_set_elements(candidate_tree_id),
+            sets.get_set_size(candidate_tree_id), 0, 0, 0);
+        double lower_bound = std::max(sets.get_tree_size(query_tree_id),
+            sets.get_tree_size(candidate_tree_id)) - intersection;
+        // Prune candidate if the lower bound exceeds the threshold.
+        if (lower_bound > distance_threshold) {
+          thread_pruned[thread_id]++;
+          continue;
+        }
+        thread_verifications[thread_id]++;
+        // Compute the distance between the query and candidate tree.
+        double distance = verification_algorithm.jedi(tq, tc);
+        if (distance <= distance_threshold) {
+          chunk_results[chunk_id].emplace_back(query_tree_id,
+              candidate_tree_id, lower_bound, -1, distance);
+        }
+        // Sum up all number of subproblems
+        thread_subproblem_counters[thread_id] +=
+            verification_algorithm.get_subproblem_count();
+      }
+    }, [&](const std::size_t id) {
+      result_set.append(chunk_results[id]);
+      std::vector<lookup::LookupResultElement>().swap(chunk_results[id]);
+    });
+  });
+
+  for (unsigned int t = 0; t < number_of_threads_; ++t) {
+    candidates_ -= thread_pruned[t];
+    verfications_ += thread_verifications[t];
+    sum_subproblem_counter_ += thread_subproblem_counters[t];
+  }
+
+  result_set.flush();
+}
+
+template <typename Label, typename VerificationAlgorithm>
+template <typename SetCollection, typename CandidateIndex>
+std::vector<lookup::LookupResultElement> 
+    VerificationIndex<Label, VerificationAlgorithm>::execute_top_k_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const SetCollection& sets, const CandidateIndex& index,
+    unsigned int query_tree_id, const unsigned int k) {
+
+  // The lower bounds and the threshold cap below hold for unit costs only.
+  static_assert(cost_model::is_unit_cost_model<
+      typename VerificationAlgorithm::AlgsCostModel>::value,
+      "Top-k lookups require a unit cost model.");
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
+
+  VerificationAlgorithm verification_algorithm(cm);
+
+  // Stores the k best results.
+  lookup::TopKResults top_k(k);
+
+  // Indexed query tree.
+  const typename VerificationAlgorithm::AlgsTreeIndex& tq =
+      indexed_collection[query_tree_id];
+
+  // Verifies a tree with the current threshold.
+  auto verify = [&](const long int candidate_tree_id,
+      const double lower_bound) {
+    // Indexed candidate tree.
+    const typename VerificationAlgorithm::AlgsTreeIndex& tc =
+        indexed_collection[candidate_tree_id];
+    // With unit costs, no distance exceeds the sum of the tree sizes.
+    double threshold = std::min(top_k.get_threshold(),
+        (double) tq.tree_size_ + tc.tree_size_);
+    // Compute the distance between the query and candidate tree.
+    verfications_++;
+    double distance = verification_algorithm.jedi_k(tq, tc, threshold);
+    // Sum up all number of subproblems
+    sum_subproblem_counter_ += verification_algorithm.get_subproblem_count();
+    if (distance <= threshold) {
+      top_k.insert(lookup::LookupResultElement(query_tree_id,
+          candidate_tree_id, lower_bound, -1, distance));
+    }
+  };
+
+  // Seed the threshold with the k trees closest in size to the query. The
+  // size difference is a lower bound of the distance. Removed trees stay in
+  // the size_setid_map.
+  std::vector<bool> verified(sets.get_number_of_sets(), false);
+  std::vector<std::pair<int, long int>> seeds;
+  for (std::size_t pos = 0; pos < sets.get_number_of_size_entries(); ++pos) {
+    const std::pair<int, int> entry = sets.get_size_entry(pos);
+    if (!index.is_removed(entry.second)) {
+      seeds.emplace_back(std::abs(sets.get_tree_size(query_tree_id) -
+          entry.first), entry.second);
+    }
+  }
+  const std::size_t nr_of_seeds = std::min<std::size_t>(k, seeds.size());
+  std::partial_sort(seeds.begin(), seeds.begin() + nr_of_seeds, seeds.end());
+  for (std::size_t i = 0; i < nr_of_seeds; ++i) {
+    verified[seeds[i].second] = true;
+    verify(seeds[i].second, seeds[i].first);
+  }
+  // Less than k trees are all verified.
+  const double seed_threshold = top_k.get_threshold();
+  if (nr_of_seeds < k || k == 0) {
+    pre_candidates_ = nr_of_seeds;
+    candidates_ = nr_of_seeds;
+    return top_k.get_sorted_results();
+  }
+
+  // The k nearest trees have a distance of at most seed_threshold, hence
+  // they are candidates of the index lookup with that threshold.
+  std::vector<std::pair<unsigned int, long int>> index_candidates;
+  lookup::retrieve_batch_candidates(sets, index,
+      {query_tree_id}, seed_threshold, index_candidates);
+  pre_candidates_ = index_candidates.size();
+
+  // Order the remaining candidates by the node intersection lower bound.
+  std::vector<std::pair<double, long int>> candidates;
+  for (const auto& candidate : index_candidates) {
+    const long int candidate_tree_id = candidate.second;
+    if (verified[candidate_tree_id]) {
+      continue;
+    }
+    double intersection = node_lower_bound(sets.get_set_elements(query_tree_id),
+        sets.get_set_size(query_tree_id), sets.get_set_elements(candidate_tree_id),
+        sets.get_set_size(candidate_tree_id), 0, 0, 0);
+    // Node intersection LB: DPJED >= max(T1, T2) - T1 intersection T2.
+    double lower_bound = std::max(sets.get_tree_size(query_tree_id),
+        sets.get_tree_size(candidate_tree_id)) - intersection;
+    if (lower_bound <= seed_threshold) {
+      candidates.emplace_back(lower_bound, candidate_tree_id);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+  candidates_ = nr_of_seeds + candidates.size();
+
+  for (const auto& candidate : candidates) {
+    // All remaining candidates have a lower bound that exceeds the threshold.
+    if (candidate.first > top_k.get_threshold()) {
+      break;
+    }
+    verify(candidate.second, candidate.first);
+  }
+
+  return top_k.get_sorted_results();
+}
+
+template <typename Label, typename VerificationAlgorithm>
+std::vector<lookup::LookupResultElement> 
+    VerificationIndex<Label, VerificationAlgorithm>::execute_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+    unsigned int query_tree_id, const double distance_threshold) {
+  return execute_lookup(indexed_collection,
+      SetsCollectionView(sets_collection, size_setid_map), index,
+      query_tree_id, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void VerificationIndex<Label, VerificationAlgorithm>::execute_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+    unsigned int query_tree_id,
+    data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+    const double distance_threshold) {
+  execute_lookup(indexed_collection,
+      SetsCollectionView(sets_collection, size_setid_map), index,
+      query_tree_id, result_set, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+std::vector<lookup::LookupResultElement> 
+    VerificationIndex<Label, VerificationAlgorithm>::execute_lookup_batch(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+    const std::vector<unsigned int>& query_tree_ids, const double distance_threshold) {
+  return execute_lookup_batch(indexed_collection,
+      SetsCollectionView(sets_collection, size_setid_map), index,
+      query_tree_ids, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+void VerificationIndex<Label, VerificationAlgorithm>::execute_lookup_batch(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+    const std::vector<unsigned int>& query_tree_ids,
+    data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+    const double distance_threshold) {
+  execute_lookup_batch(indexed_collection,
+      SetsCollectionView(sets_collection, size_setid_map), index,
+      query_tree_ids, result_set, distance_threshold);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+std::vector<lookup::LookupResultElement> 
+    VerificationIndex<Label, VerificationAlgorithm>::execute_top_k_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map, const lookup::TwoStageInvertedList& index,
+    unsigned int query_tree_id, const unsigned int k) {
+  return execute_top_k_lookup(indexed_collection,
+      SetsCollectionView(sets_collection, size_setid_map), index,
+      query_tree_id, k);
+}
+
+template <typename Label, typename VerificationAlgorithm>
+double VerificationIndex<Label, VerificationAlgorithm>::node_lower_bound(
+    const std::vector<label_set_converter_index::LabelSetElement>& r, 
+    const std::vector<label_set_converter_index::LabelSetElement>& s, 
+    double olap, int pr, int ps) const {
+  return node_lower_bound(r.data(), r.size(), s.data(), s.size(),
+      olap, pr, ps);
+}
+
 template <typename Label, typename VerificationAlgorithm>
 double VerificationIndex<Label, VerificationAlgorithm>::node_lower_bound(
-    std::vector<label_set_converter_index::LabelSetElement>& r, 
-    std::vector<label_set_converter_index::LabelSetElement>& s, 
-    double olap, int pr, int ps) {
-  int size_r = r.size();
-  int size_s = s.size();
+    const label_set_converter_index::LabelSetElement* r,
+    const std::size_t size_r,
+    const label_set_converter_index::LabelSetElement* s,
+    const std::size_t size_s, double olap, std::size_t pr,
+    std::size_t ps) const {
   while (pr < size_r && ps < size_s) {
     if (r[pr].id == s[ps].id) {
       olap += 1;
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <unordered_map>
 #include "../../node/node.h"
@@ -85,10 +86,22 @@ public:
   ///
   /// \param tree_collection A collection of trees.
   /// \param sets_collection A collection of sets.
+  /// \param size_setid_map Pairs of tree size and set id, sorted by tree
+  ///                       size.
   void assignFrequencyIdentifiers(
       std::vector<node::Node<Label>>& trees_collection,
       std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
       std::vector<std::pair<int, int>>& size_setid_map);
+  /// Converts a tree that is not part of the collection given to
+  /// assignFrequencyIdentifiers into a set with the same label ids. Labels
+  /// that are not known yet get new ids after all known ones, i.e., they are
+  /// ordered as the most frequent labels. The resulting set can be inserted
+  /// into an existing TwoStageInvertedList.
+  ///
+  /// \param tree A tree.
+  /// \param set Pair of tree size and label set of the tree.
+  void convert_tree(const node::Node<Label>& tree,
+      std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>& set);
   /// Returns the number of different labels in the given tree collection.
   ///
   /// \return The number of different labels in the given tree collection.
@@ -97,6 +110,8 @@ public:
 private:
   /// Counter to give unique IDs to the tokens.
   long int next_token_id_ = 0;
+  /// Label ids in the frequency order, {label -> id}.
+  std::unordered_map<Label, int, labelhash> label_ids_;
   /// Counter to give unique IDs to the tokens.
   int actual_depth_ = 0;
   /// Counter to give unique IDs to the tokens.
@@ -73,6 +73,8 @@ void Converter<Label>::assignFrequencyIdentifiers(
     // increase id
     set_id++;
   }
+  // The lookups find the trees of a size window by binary search.
+  std::sort(size_setid_map.begin(), size_setid_map.end());
 
   // token_count_list = [tokenfrequency, tokenid]
   for(int i = 0; i < next_token_id_; ++i)
@@ -91,6 +93,11 @@ void Converter<Label>::assignFrequencyIdentifiers(
   for(std::size_t i = 0; i < token_count_list.size(); ++i)
     tokenmaplist[token_count_list[i].second] = i;
 
+  // keep the frequencyIDs for the conversion of further trees
+  label_ids_.clear();
+  for(const auto& token: token_map)
+    label_ids_.emplace(token.first, tokenmaplist[token.second]);
+
   // substitute the tokenIDs with frequencyIDs
   for(auto& record: sets_collection) {
     for(std::size_t i = 0; i < record.second.size(); ++i) {
@@ -114,6 +121,40 @@ void Converter<Label>::assignFrequencyIdentifiers(
   // std::sort(sets_collection.begin(), sets_collection.end(), vectorComparator);
 }
 
+template<typename Label>
+void Converter<Label>::convert_tree(const node::Node<Label>& tree,
+    std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>& set) {
+  // {tokid -> 1}
+  std::unordered_multimap<int, label_set_converter_index::LabelSetElement> record_labels;
+  // number of nodes of the tree
+  int tree_size = tree.get_tree_size();
+  // postorder id for recursive postorder traversal
+  int postorder_id = 0;
+
+  // unknown labels get the next token ids and are added to label_ids_
+  create_record(tree, postorder_id, tree_size, label_ids_, record_labels);
+
+  // reset variables that are needed for positional evaluation
+  actual_pre_order_number_ = 0;
+  actual_depth_ = 0;
+
+  set.first = tree_size;
+  set.second.clear();
+  for (const auto& it : record_labels) {
+    set.second.emplace_back(it.second);
+  }
+
+  // sort integers of a record ascending
+  std::sort(set.second.begin(), set.second.end(), LabelSetElementComparator);
+
+  // weight of an element in the set up to its position
+  int weight_sum = 0;
+  for(std::size_t i = 0; i < set.second.size(); ++i) {
+    weight_sum += set.second[i].weight;
+    set.second[i].weight_so_far = weight_sum;
+  }
+}
+
 template<typename Label>
 int Converter<Label>::create_record(
     const node::Node<Label>& tree_node, int& postorder_id, int tree_size,
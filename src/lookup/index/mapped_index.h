@@ -0,0 +1,237 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file lookup/index/mapped_index.h
+///
+/// \details
+/// On-disk format of a built candidate index. A TwoStageInvertedList, the
+/// label set collection it was built on, and the size_setid_map of the
+/// Converter are written to a single file. Later runs map the file into
+/// memory and look up candidates in place, without converting the trees and
+/// building the index again.
+///
+/// The file consists of a header followed by twelve sections. Each section
+/// starts at a multiple of 8 bytes. All numbers are stored in the byte order
+/// of the writing machine, which is verified when loading.
+///
+/// header               MappedIndexHeader
+/// label offsets        uint64[number_of_labels + 1]
+/// descendants keys     int32[number_of_descendants_keys]
+/// descendants offsets  uint64[number_of_descendants_keys + 1]
+/// ancestors keys       int32[number_of_ancestors_keys]
+/// ancestors offsets    uint64[number_of_ancestors_keys + 1]
+/// right-left keys      int32[number_of_right_left_keys]
+/// right-left offsets   uint64[number_of_right_left_keys + 1]
+/// postings             int32[number_of_postings], set ids
+/// tree sizes           int32[number_of_sets]
+/// set offsets          uint64[number_of_sets + 1], first element of a set
+/// elements             LabelSetElement[number_of_elements]
+/// size_setid_map       int32[2 * number_of_size_entries], size and set id
+///
+/// The first seven sections are the sorted arrays of TwoStageInvertedList.
+/// Label set elements are stored as their in-memory representation, whose
+/// size is recorded in the header.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+#include "../../data_structures/mapped_file.h"
+#include "label_set_element.h"
+#include "two_stage_inverted_list.h"
+#include "size_window.h"
+
+namespace lookup {
+
+/// Header at the beginning of a mapped index file.
+struct MappedIndexHeader {
+  /// File type identifier, kMappedIndexMagic.
+  char magic[8];
+  /// Format version, kMappedIndexVersion.
+  std::uint32_t version;
+  /// kMappedIndexByteOrder written in the byte order of the writer.
+  std::uint32_t byte_order;
+  /// sizeof(LabelSetElement) of the writer.
+  std::uint64_t element_bytes;
+  /// Number of labels of the index.
+  std::uint64_t number_of_labels;
+  /// Number of keys of every level of the index.
+  std::uint64_t number_of_descendants_keys;
+  std::uint64_t number_of_ancestors_keys;
+  std::uint64_t number_of_right_left_keys;
+  /// Number of postings of the index.
+  std::uint64_t number_of_postings;
+  /// Number of label sets.
+  std::uint64_t number_of_sets;
+  /// Number of label set elements of all sets.
+  std::uint64_t number_of_elements;
+  /// Number of entries of the size_setid_map.
+  std::uint64_t number_of_size_entries;
+};
+
+const char kMappedIndexMagic[8] = {'T', 'S', 'I', 'D', 'X', '\0', '\0', '\0'};
+const std::uint32_t kMappedIndexVersion = 1;
+const std::uint32_t kMappedIndexByteOrder = 0x01020304;
+
+/// \class MappedIndex
+///
+/// \details
+/// Read-only view of a mapped index file. Lookups traverse the sorted arrays
+/// in the mapping with the same code as TwoStageInvertedList, hence they
+/// return the same candidates as the index that was written. Only the pages
+/// that a lookup touches are read from disk.
+///
+/// A MappedIndex is both the set accessor and the candidate index of
+/// VerificationIndex, VerificationUBkIndex, and SharedIndex. The lower bounds
+/// read the label sets in place.
+///
+/// Query trees have to be in the written collection. New trees cannot be
+/// converted into label sets since the label ids of the Converter are not
+/// stored.
+class MappedIndex {
+// Member functions.
+public:
+  /// Writes an index, the label set collection it was built on, and the
+  /// size_setid_map to file_path. Unmerged updates of the index are merged
+  /// and compressed postings are decompressed in a copy first. Sets removed
+  /// from the index keep their label sets but are left out of the
+  /// size_setid_map.
+  ///
+  /// \param index Inverted list index built on sets_collection.
+  /// \param sets_collection Label set collection of the indexed trees.
+  /// \param size_setid_map Pairs of tree size and set id in ascending size.
+  /// \param file_path Path of the output file.
+  /// \throws std::runtime_error if the file cannot be written.
+  static void write(const TwoStageInvertedList& index,
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map,
+      const std::string& file_path);
+  /// Maps the index file at file_path and checks its header and that all
+  /// sections lie within the file. Only the header and the end offsets of
+  /// the sections are read; the offsets, set ids, and label ids inside the
+  /// sections are checked by validate.
+  ///
+  /// \param file_path Path to a file written by write.
+  /// \throws std::runtime_error if the file cannot be mapped or is not a
+  ///         valid index file of this version.
+  MappedIndex(const std::string& file_path);
+  /// Checks that the offsets inside the sections do not decrease and that
+  /// the stored set ids and label ids are in range. Reads the whole file
+  /// once. Lookups on a file that fails the check are undefined, hence files
+  /// from untrusted sources should be validated before the first lookup.
+  ///
+  /// \throws std::runtime_error if the file is not a valid index file.
+  void validate() const;
+  /// Returns the number of labels of the index.
+  long int get_number_of_labels() const;
+  /// Returns the number of label sets.
+  std::size_t get_number_of_sets() const;
+  /// Returns the tree size of a label set.
+  ///
+  /// \param set_id Id of the set.
+  int get_tree_size(const std::size_t set_id) const;
+  /// Returns the number of elements of a label set.
+  ///
+  /// \param set_id Id of the set.
+  std::size_t get_set_size(const std::size_t set_id) const;
+  /// Returns the elements of a label set. The array has
+  /// get_set_size(set_id) elements and points into the mapped file.
+  ///
+  /// \param set_id Id of the set.
+  const label_set_converter_index::LabelSetElement* get_set_elements(
+      const std::size_t set_id) const;
+  /// Returns the number of entries of the size_setid_map.
+  std::size_t get_number_of_size_entries() const;
+  /// Returns an entry of the size_setid_map.
+  ///
+  /// \param position Position of the entry in the map.
+  /// \return Pair of tree size and set id.
+  std::pair<int, int> get_size_entry(const std::size_t position) const;
+  /// Calls f(begin, end) for every range of set ids that are candidates of a
+  /// query node, see TwoStageInvertedList::for_each_candidate_range.
+  ///
+  /// \param q_label_id Label id of the query node.
+  /// \param descendants Number of descendants of the query node.
+  /// \param ancestors Number of ancestors of the query node.
+  /// \param q_tree_size Size of the query tree.
+  /// \param distance_threshold Given similarity threshold.
+  /// \param f Callable taking two pointers to set ids.
+  template <typename Function>
+  void for_each_candidate_range(const long int q_label_id,
+      const long int descendants, const long int ancestors,
+      const int q_tree_size, const double distance_threshold,
+      Function f) const;
+  /// Returns a set of candidates (set IDs) that have a common element in the 
+  /// prefix, see TwoStageInvertedList::lookup.
+  ///
+  /// \param q_label_id Label id of the query node.
+  /// \param descendants Number of descendants of the query node.
+  /// \param ancestors Number of ancestors of the query node.
+  /// \param q_tree_size Size of the query tree.
+  /// \param candidates Set to insert the candidates into.
+  /// \param distance_threshold Given similarity threshold.
+  void lookup(const long int q_label_id, const long int descendants,
+      const long int ancestors, const int q_tree_size,
+      std::unordered_set<long int>& candidates,
+      const double distance_threshold) const;
+  /// Returns false, the mapped index has no removed sets. Lets the lookups
+  /// use a MappedIndex as candidate index, see TwoStageInvertedList::is_removed.
+  ///
+  /// \param set_id Id of the set.
+  bool is_removed(const std::size_t set_id) const;
+  /// Retrieves the candidates of a query tree as
+  /// VerificationIndex::execute_lookup does before the verification.
+  ///
+  /// \param query_tree_id Set id of the query tree.
+  /// \param distance_threshold Given similarity threshold.
+  /// \param candidates Set to insert the candidates into.
+  void retrieve_candidates(const std::size_t query_tree_id,
+      const double distance_threshold,
+      std::unordered_set<long int>& candidates) const;
+// Member functions.
+private:
+  /// Returns bytes rounded up to the next multiple of 8.
+  static std::size_t align(const std::size_t bytes);
+// Member variables.
+private:
+  /// Mapping of the whole file.
+  data_structures::MappedFile file_;
+  /// Header at the beginning of the mapping.
+  MappedIndexHeader header_;
+  /// Sorted arrays of the index in the mapping.
+  TwoStageInvertedList::SortedArrays arrays_;
+  /// Section pointers of the label set collection into the mapping.
+  const std::int32_t* tree_sizes_;
+  const std::uint64_t* set_offsets_;
+  const label_set_converter_index::LabelSetElement* elements_;
+  const std::int32_t* size_setid_map_;
+};
+
+// Implementation details.
+#include "mapped_index_impl.h"
+
+}
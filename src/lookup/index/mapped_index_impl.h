@@ -0,0 +1,365 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file lookup/index/mapped_index_impl.h
+///
+/// \details
+/// Contains the implementation of the MappedIndex class.
+
+#pragma once
+
+// The offsets of the mapping are read as the std::size_t offsets of
+// TwoStageInvertedList::SortedArrays, and label set elements are copied
+// bytewise.
+static_assert(sizeof(std::size_t) == sizeof(std::uint64_t),
+    "MappedIndex requires 64-bit offsets.");
+static_assert(std::is_trivially_copyable<
+    label_set_converter_index::LabelSetElement>::value,
+    "MappedIndex stores LabelSetElement bytewise.");
+static_assert(sizeof(label_set_converter_index::LabelSetElement) % 8 == 0,
+    "MappedIndex requires 8-byte aligned label set elements.");
+
+inline std::size_t MappedIndex::align(const std::size_t bytes) {
+  return (bytes + 7) & ~static_cast<std::size_t>(7);
+}
+
+inline void MappedIndex::write(const TwoStageInvertedList& index,
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map,
+    const std::string& file_path) {
+  // The file holds the uncompressed sorted arrays only.
+  const TwoStageInvertedList* merged = &index;
+  TwoStageInvertedList merged_copy(0);
+  if (index.get_number_of_unmerged_postings() > 0 ||
+      index.get_posting_compression()) {
+    merged_copy = index;
+    merged_copy.merge();
+    merged_copy.set_posting_compression(false);
+    merged = &merged_copy;
+  }
+  const TwoStageInvertedList::SortedArrays arrays = merged->get_sorted_arrays();
+  // An index that was never built has no end offsets on its levels.
+  auto end_of = [](const std::size_t* offsets, const std::size_t count) {
+    return offsets == nullptr ? 0 : offsets[count];
+  };
+  MappedIndexHeader header;
+  std::memcpy(header.magic, kMappedIndexMagic, sizeof(header.magic));
+  header.version = kMappedIndexVersion;
+  header.byte_order = kMappedIndexByteOrder;
+  header.element_bytes = sizeof(label_set_converter_index::LabelSetElement);
+  header.number_of_labels = arrays.nr_of_labels;
+  header.number_of_descendants_keys = arrays.label_offsets[arrays.nr_of_labels];
+  header.number_of_ancestors_keys = end_of(arrays.descendants_offsets,
+      header.number_of_descendants_keys);
+  header.number_of_right_left_keys = end_of(arrays.ancestors_offsets,
+      header.number_of_ancestors_keys);
+  header.number_of_postings = end_of(arrays.right_left_offsets,
+      header.number_of_right_left_keys);
+  header.number_of_sets = sets_collection.size();
+  header.number_of_elements = 0;
+  std::vector<std::int32_t> tree_sizes;
+  std::vector<std::uint64_t> set_offsets(1, 0);
+  for (const auto& set : sets_collection) {
+    tree_sizes.push_back(set.first);
+    header.number_of_elements += set.second.size();
+    set_offsets.push_back(header.number_of_elements);
+  }
+  // Removed sets are left out of the size_setid_map, their postings are
+  // dropped by the merge.
+  std::vector<std::int32_t> size_entries;
+  for (const auto& entry : size_setid_map) {
+    if (!index.is_removed(entry.second)) {
+      size_entries.push_back(entry.first);
+      size_entries.push_back(entry.second);
+    }
+  }
+  header.number_of_size_entries = size_entries.size() / 2;
+
+  std::ofstream output(file_path, std::ios::binary | std::ios::trunc);
+  if (!output.is_open()) {
+    throw std::runtime_error("ERROR: Problem with opening the file '" +
+        file_path + "' in MappedIndex::write.");
+  }
+  // Writes a section and pads it to a multiple of 8 bytes.
+  const char padding[8] = {};
+  auto write_section = [&output, &padding](const void* data,
+      const std::size_t bytes) {
+    output.write(static_cast<const char*>(data), bytes);
+    output.write(padding, align(bytes) - bytes);
+  };
+  // Writes count + 1 offsets, zeros for a level without offsets.
+  auto write_offsets = [&output, &write_section](const std::size_t* offsets,
+      const std::size_t count) {
+    if (offsets == nullptr) {
+      const std::vector<std::uint64_t> zeros(count + 1, 0);
+      write_section(zeros.data(), zeros.size() * sizeof(std::uint64_t));
+    } else {
+      write_section(offsets, (count + 1) * sizeof(std::uint64_t));
+    }
+  };
+  write_section(&header, sizeof(header));
+  write_offsets(arrays.label_offsets, header.number_of_labels);
+  write_section(arrays.descendants_keys,
+      header.number_of_descendants_keys * sizeof(std::int32_t));
+  write_offsets(arrays.descendants_offsets, header.number_of_descendants_keys);
+  write_section(arrays.ancestors_keys,
+      header.number_of_ancestors_keys * sizeof(std::int32_t));
+  write_offsets(arrays.ancestors_offsets, header.number_of_ancestors_keys);
+  write_section(arrays.right_left_keys,
+      header.number_of_right_left_keys * sizeof(std::int32_t));
+  write_offsets(arrays.right_left_offsets, header.number_of_right_left_keys);
+  write_section(arrays.postings,
+      header.number_of_postings * sizeof(std::int32_t));
+  write_section(tree_sizes.data(), tree_sizes.size() * sizeof(std::int32_t));
+  write_section(set_offsets.data(),
+      set_offsets.size() * sizeof(std::uint64_t));
+  // The elements of all sets form one section. Its size is a multiple of 8
+  // bytes.
+  for (const auto& set : sets_collection) {
+    output.write(reinterpret_cast<const char*>(set.second.data()),
+        set.second.size() * sizeof(label_set_converter_index::LabelSetElement));
+  }
+  write_section(size_entries.data(),
+      size_entries.size() * sizeof(std::int32_t));
+  output.close();
+  if (!output) {
+    throw std::runtime_error("ERROR: Problem with writing the file '" +
+        file_path + "' in MappedIndex::write.");
+  }
+}
+
+inline MappedIndex::MappedIndex(const std::string& file_path)
+    : file_(file_path) {
+  const std::string error = "ERROR: The file '" + file_path +
+      "' is not a valid mapped index";
+  if (file_.size() < sizeof(header_)) {
+    throw std::runtime_error(error + " (too short).");
+  }
+  std::memcpy(&header_, file_.data(), sizeof(header_));
+  if (std::memcmp(header_.magic, kMappedIndexMagic,
+      sizeof(header_.magic)) != 0) {
+    throw std::runtime_error(error + " (wrong file type).");
+  }
+  if (header_.version != kMappedIndexVersion) {
+    throw std::runtime_error(error + " (unsupported version " +
+        std::to_string(header_.version) + ").");
+  }
+  if (header_.byte_order != kMappedIndexByteOrder) {
+    throw std::runtime_error(error + " (written with another byte order).");
+  }
+  if (header_.element_bytes !=
+      sizeof(label_set_converter_index::LabelSetElement)) {
+    throw std::runtime_error(error + " (other label set element layout).");
+  }
+  // Bounds that keep the section sizes below from overflowing.
+  const std::uint64_t kMaxCount = static_cast<std::uint64_t>(1) << 40;
+  if (header_.number_of_labels > kMaxCount ||
+      header_.number_of_descendants_keys > kMaxCount ||
+      header_.number_of_ancestors_keys > kMaxCount ||
+      header_.number_of_right_left_keys > kMaxCount ||
+      header_.number_of_postings > kMaxCount ||
+      header_.number_of_sets > kMaxCount ||
+      header_.number_of_elements > kMaxCount ||
+      header_.number_of_size_entries > kMaxCount) {
+    throw std::runtime_error(error + " (corrupt header).");
+  }
+
+  // Section positions. The mapping is page-aligned and every section starts
+  // at a multiple of 8 bytes, so the arrays can be read in place.
+  const char* data = file_.data();
+  std::size_t position = align(sizeof(header_));
+  auto section = [&position, data](const std::size_t bytes) {
+    const char* begin = data + position;
+    position += align(bytes);
+    return begin;
+  };
+  auto offsets_section = [&section](const std::uint64_t count) {
+    return reinterpret_cast<const std::size_t*>(
+        section((count + 1) * sizeof(std::uint64_t)));
+  };
+  auto int_section = [&section](const std::uint64_t count) {
+    return reinterpret_cast<const std::int32_t*>(
+        section(count * sizeof(std::int32_t)));
+  };
+  arrays_.nr_of_labels = header_.number_of_labels;
+  arrays_.label_offsets = offsets_section(header_.number_of_labels);
+  arrays_.descendants_keys = int_section(header_.number_of_descendants_keys);
+  arrays_.descendants_offsets =
+      offsets_section(header_.number_of_descendants_keys);
+  arrays_.ancestors_keys = int_section(header_.number_of_ancestors_keys);
+  arrays_.ancestors_offsets = offsets_section(header_.number_of_ancestors_keys);
+  arrays_.right_left_keys = int_section(header_.number_of_right_left_keys);
+  arrays_.right_left_offsets =
+      offsets_section(header_.number_of_right_left_keys);
+  arrays_.postings = int_section(header_.number_of_postings);
+  tree_sizes_ = int_section(header_.number_of_sets);
+  set_offsets_ = reinterpret_cast<const std::uint64_t*>(
+      offsets_section(header_.number_of_sets));
+  elements_ = reinterpret_cast<const label_set_converter_index::LabelSetElement*>(
+      section(header_.number_of_elements * header_.element_bytes));
+  size_setid_map_ = int_section(2 * header_.number_of_size_entries);
+  if (file_.size() < position) {
+    throw std::runtime_error(error + " (truncated).");
+  }
+  if (arrays_.label_offsets[header_.number_of_labels] !=
+      header_.number_of_descendants_keys ||
+      arrays_.descendants_offsets[header_.number_of_descendants_keys] !=
+      header_.number_of_ancestors_keys ||
+      arrays_.ancestors_offsets[header_.number_of_ancestors_keys] !=
+      header_.number_of_right_left_keys ||
+      arrays_.right_left_offsets[header_.number_of_right_left_keys] !=
+      header_.number_of_postings ||
+      set_offsets_[header_.number_of_sets] != header_.number_of_elements) {
+    throw std::runtime_error(error + " (inconsistent offsets).");
+  }
+  // Lookups jump between the sections instead of reading the file from the
+  // beginning to the end.
+  file_.advise_random();
+}
+
+inline void MappedIndex::validate() const {
+  const std::string error = "ERROR: The mapped index is not valid";
+  // Every offset array starts at zero and does not decrease. With the end
+  // offsets checked by the constructor, every range lies within the next
+  // section.
+  auto ascending = [](const std::size_t* offsets, const std::uint64_t count) {
+    if (offsets[0] != 0) {
+      return false;
+    }
+    for (std::uint64_t i = 0; i < count; ++i) {
+      if (offsets[i] > offsets[i + 1]) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (!ascending(arrays_.label_offsets, header_.number_of_labels) ||
+      !ascending(arrays_.descendants_offsets,
+          header_.number_of_descendants_keys) ||
+      !ascending(arrays_.ancestors_offsets,
+          header_.number_of_ancestors_keys) ||
+      !ascending(arrays_.right_left_offsets,
+          header_.number_of_right_left_keys) ||
+      !ascending(reinterpret_cast<const std::size_t*>(set_offsets_),
+          header_.number_of_sets)) {
+    throw std::runtime_error(error + " (inconsistent offsets).");
+  }
+  // Set ids and label ids are used as array positions.
+  auto valid_set_id = [this](const std::int32_t set_id) {
+    return set_id >= 0 &&
+        static_cast<std::uint64_t>(set_id) < header_.number_of_sets;
+  };
+  for (std::uint64_t i = 0; i < header_.number_of_postings; ++i) {
+    if (!valid_set_id(arrays_.postings[i])) {
+      throw std::runtime_error(error + " (set id out of range).");
+    }
+  }
+  for (std::uint64_t i = 0; i < header_.number_of_size_entries; ++i) {
+    if (!valid_set_id(size_setid_map_[2 * i + 1])) {
+      throw std::runtime_error(error + " (set id out of range).");
+    }
+  }
+  for (std::uint64_t i = 0; i < header_.number_of_elements; ++i) {
+    if (elements_[i].id < 0 || static_cast<std::uint64_t>(elements_[i].id) >=
+        header_.number_of_labels) {
+      throw std::runtime_error(error + " (label id out of range).");
+    }
+  }
+}
+
+inline long int MappedIndex::get_number_of_labels() const {
+  return arrays_.nr_of_labels;
+}
+
+inline std::size_t MappedIndex::get_number_of_sets() const {
+  return header_.number_of_sets;
+}
+
+inline int MappedIndex::get_tree_size(const std::size_t set_id) const {
+  return tree_sizes_[set_id];
+}
+
+inline std::size_t MappedIndex::get_set_size(const std::size_t set_id) const {
+  return set_offsets_[set_id + 1] - set_offsets_[set_id];
+}
+
+inline const label_set_converter_index::LabelSetElement*
+MappedIndex::get_set_elements(const std::size_t set_id) const {
+  return elements_ + set_offsets_[set_id];
+}
+
+inline std::size_t MappedIndex::get_number_of_size_entries() const {
+  return header_.number_of_size_entries;
+}
+
+inline std::pair<int, int> MappedIndex::get_size_entry(
+    const std::size_t position) const {
+  return {size_setid_map_[2 * position], size_setid_map_[2 * position + 1]};
+}
+
+template <typename Function>
+void MappedIndex::for_each_candidate_range(const long int q_label_id,
+    const long int descendants, const long int ancestors,
+    const int q_tree_size, const double distance_threshold,
+    Function f) const {
+  TwoStageInvertedList::for_each_sorted_range(arrays_, q_label_id,
+      descendants, ancestors, q_tree_size, distance_threshold,
+      [this, &f](const std::size_t begin, const std::size_t end) {
+    f(arrays_.postings + begin, arrays_.postings + end);
+  });
+}
+
+inline void MappedIndex::lookup(const long int q_label_id,
+    const long int descendants, const long int ancestors,
+    const int q_tree_size, std::unordered_set<long int>& candidates,
+    const double distance_threshold) const {
+  for_each_candidate_range(q_label_id, descendants, ancestors, q_tree_size,
+      distance_threshold, [&candidates](const int* begin, const int* end) {
+    candidates.insert(begin, end);
+  });
+}
+
+inline bool MappedIndex::is_removed(const std::size_t) const {
+  return false;
+}
+
+inline void MappedIndex::retrieve_candidates(const std::size_t query_tree_id,
+    const double distance_threshold,
+    std::unordered_set<long int>& candidates) const {
+  const int q_tree_size = get_tree_size(query_tree_id);
+  // If the query tree is less than the threshold, the trees of its size
+  // window have to be considered. The entries are sorted by tree size.
+  if (q_tree_size < distance_threshold + 1) {
+    lookup::for_each_size_window_set(*this, *this, q_tree_size,
+        distance_threshold, [&candidates](const int set_id) {
+      candidates.insert(set_id);
+    });
+  }
+  // Lookup the index for each element in the prefix of the query tree.
+  const label_set_converter_index::LabelSetElement* elements =
+      get_set_elements(query_tree_id);
+  long int prefix = std::min((int) get_set_size(query_tree_id) - 1,
+      (int) distance_threshold + 1);
+  for (long int pos = 0; pos <= prefix; pos++) {
+    lookup(elements[pos].id, elements[pos].descendants,
+        elements[pos].ancestors, q_tree_size, candidates, distance_threshold);
+  }
+}
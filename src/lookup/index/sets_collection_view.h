@@ -0,0 +1,113 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file lookup/index/sets_collection_view.h
+///
+/// \details
+/// Set accessor of the index lookups. VerificationIndex,
+/// VerificationUBkIndex, SharedIndex, and retrieve_batch_candidates read the
+/// label sets and the size_setid_map of the indexed trees through the member
+/// functions of this class only. MappedIndex has the same member functions
+/// and serves the sets from its mapped file instead.
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "label_set_element.h"
+
+namespace lookup {
+
+class SetsCollectionView {
+// Member functions.
+public:
+  /// Constructor. The view keeps references to both arguments.
+  ///
+  /// \param sets_collection Label set collection of the indexed trees.
+  /// \param size_setid_map Pairs of tree size and set id in ascending size.
+  SetsCollectionView(
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map);
+  /// Returns the number of label sets.
+  std::size_t get_number_of_sets() const;
+  /// Returns the tree size of a label set.
+  ///
+  /// \param set_id Id of the set.
+  int get_tree_size(const std::size_t set_id) const;
+  /// Returns the number of elements of a label set.
+  ///
+  /// \param set_id Id of the set.
+  std::size_t get_set_size(const std::size_t set_id) const;
+  /// Returns the elements of a label set. The array has
+  /// get_set_size(set_id) elements.
+  ///
+  /// \param set_id Id of the set.
+  const label_set_converter_index::LabelSetElement* get_set_elements(
+      const std::size_t set_id) const;
+  /// Returns the number of entries of the size_setid_map.
+  std::size_t get_number_of_size_entries() const;
+  /// Returns an entry of the size_setid_map.
+  ///
+  /// \param position Position of the entry in the map.
+  /// \return Pair of tree size and set id.
+  std::pair<int, int> get_size_entry(const std::size_t position) const;
+// Member variables.
+private:
+  /// Label set collection of the indexed trees.
+  const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>* sets_collection_;
+  /// Pairs of tree size and set id.
+  const std::vector<std::pair<int, int>>* size_setid_map_;
+};
+
+inline SetsCollectionView::SetsCollectionView(
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map)
+    : sets_collection_(&sets_collection), size_setid_map_(&size_setid_map) {}
+
+inline std::size_t SetsCollectionView::get_number_of_sets() const {
+  return sets_collection_->size();
+}
+
+inline int SetsCollectionView::get_tree_size(const std::size_t set_id) const {
+  return (*sets_collection_)[set_id].first;
+}
+
+inline std::size_t SetsCollectionView::get_set_size(
+    const std::size_t set_id) const {
+  return (*sets_collection_)[set_id].second.size();
+}
+
+inline const label_set_converter_index::LabelSetElement*
+SetsCollectionView::get_set_elements(const std::size_t set_id) const {
+  return (*sets_collection_)[set_id].second.data();
+}
+
+inline std::size_t SetsCollectionView::get_number_of_size_entries() const {
+  return size_setid_map_->size();
+}
+
+inline std::pair<int, int> SetsCollectionView::get_size_entry(
+    const std::size_t position) const {
+  return (*size_setid_map_)[position];
+}
+
+}
@@ -0,0 +1,155 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file lookup/index/shared_index.h
+///
+/// \details
+/// Read-only handle of a built candidate index that many query threads use
+/// at once. The handle refers to the indexed collection, the label sets, the
+/// size_setid_map, and the candidate index, e.g., a TwoStageInvertedList or a
+/// MappedIndex, and only calls their const member functions. Every query constructs its own algorithm instances and
+/// writes its counters to a LookupStatistics object of the caller, hence
+/// concurrent queries share no mutable state and need no locks.
+///
+/// The referenced objects must not be modified (e.g., by
+/// TwoStageInvertedList::insert) while queries run.
+
+#pragma once
+
+#include <type_traits>
+#include <vector>
+#include "../../node/tree_index_collection.h"
+#include "../lookup_result_element.h"
+#include "../../data_structures/result_sink.h"
+#include "label_set_element.h"
+#include "two_stage_inverted_list.h"
+#include "sets_collection_view.h"
+#include "index.h"
+
+namespace lookup {
+
+/// Counters of the lookups that a caller of SharedIndex collected.
+struct LookupStatistics {
+  /// Number of candidates retrieved from the inverted list.
+  long long int pre_candidates = 0;
+  /// Number of candidates not pruned by the node intersection lower bound.
+  long long int candidates = 0;
+  /// Number of verifications.
+  long long int verifications = 0;
+  /// Number of subproblems of the verifications.
+  long long int subproblems = 0;
+  /// Adds the counters of other.
+  void add(const LookupStatistics& other);
+};
+
+/**
+ * Read-only index handle for a given verification and upper bound algorithm.
+ * The lookups are the ones of VerificationUBkIndex. SetCollection and
+ * CandidateIndex are the set accessor and the candidate index of the
+ * lookups, see VerificationUBkIndex.
+ */
+template <typename Label, typename VerificationAlgorithm, typename UpperBound,
+    typename SetCollection = SetsCollectionView,
+    typename CandidateIndex = TwoStageInvertedList>
+class SharedIndex {
+
+public:
+  /// Constructor. The handle keeps references to all arguments.
+  /**
+   * \param indexed_collection The indexed input collection of trees.
+   * \param sets Set accessor of the indexed trees, e.g., a MappedIndex.
+   * \param index Candidate index built on the sets, e.g., a MappedIndex.
+   */
+  SharedIndex(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const SetCollection& sets, const CandidateIndex& index);
+  /// Constructor for a label set collection and its inverted list. The
+  /// handle keeps references to all arguments.
+  /**
+   * \param indexed_collection The indexed input collection of trees.
+   * \param sets_collection Label set collection of the indexed trees.
+   * \param size_setid_map Pairs of tree size and set id in ascending size.
+   * \param index Inverted list index built on sets_collection.
+   */
+  SharedIndex(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+      const std::vector<std::pair<int, int>>& size_setid_map,
+      const lookup::TwoStageInvertedList& index);
+  
+  /// Executes the lookup algorithm. Can be called concurrently.
+  /**
+   * \param query_tree_id Id of the query tree.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the lookup's result set.
+   * \param statistics Counters of the caller the lookup adds to.
+   * \return A vector with the lookup result.
+   */
+  std::vector<lookup::LookupResultElement> execute_lookup(
+      unsigned int query_tree_id, const double distance_threshold,
+      LookupStatistics& statistics) const;
+  
+  /// Executes the lookup algorithm and streams the results to a sink. Can be
+  /// called concurrently with a sink per caller.
+  /**
+   * \param query_tree_id Id of the query tree.
+   * \param result_set Sink receiving the lookup results. It is flushed
+   *                   before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the lookup's result set.
+   * \param statistics Counters of the caller the lookup adds to.
+   */
+  void execute_lookup(unsigned int query_tree_id,
+      data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+      const double distance_threshold, LookupStatistics& statistics) const;
+  
+  /// Executes a top-k lookup, see VerificationUBkIndex::execute_top_k_lookup.
+  /// Can be called concurrently.
+  /**
+   * \param query_tree_id Id of the query tree.
+   * \param k Number of results.
+   * \param statistics Counters of the caller the lookup adds to.
+   * \return A vector with the k nearest trees in ascending distance.
+   */
+  std::vector<lookup::LookupResultElement> execute_top_k_lookup(
+      unsigned int query_tree_id, const unsigned int k,
+      LookupStatistics& statistics) const;
+
+private:
+  /// Adds the counters of a finished lookup to statistics.
+  static void add_counters(
+      const VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>& lookup,
+      LookupStatistics& statistics);
+  /// The indexed input collection of trees.
+  const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection_;
+  /// Set accessor of the indexed trees. A SetsCollectionView is held by
+  /// value, other set accessors by reference.
+  typename std::conditional<
+      std::is_same<SetCollection, SetsCollectionView>::value,
+      const SetsCollectionView, const SetCollection&>::type sets_;
+  /// Candidate index built on sets_.
+  const CandidateIndex& index_;
+};
+
+// Implementation details.
+#include "shared_index_impl.h"
+
+}
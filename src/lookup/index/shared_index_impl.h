@@ -0,0 +1,111 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file lookup/index/shared_index_impl.h
+///
+/// \details
+/// Contains the implementation of the SharedIndex class.
+
+#pragma once
+
+inline void LookupStatistics::add(const LookupStatistics& other) {
+  pre_candidates += other.pre_candidates;
+  candidates += other.candidates;
+  verifications += other.verifications;
+  subproblems += other.subproblems;
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound,
+    typename SetCollection, typename CandidateIndex>
+SharedIndex<Label, VerificationAlgorithm, UpperBound, SetCollection,
+    CandidateIndex>::SharedIndex(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const SetCollection& sets, const CandidateIndex& index)
+    : indexed_collection_(indexed_collection),
+      sets_(sets),
+      index_(index) {}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound,
+    typename SetCollection, typename CandidateIndex>
+SharedIndex<Label, VerificationAlgorithm, UpperBound, SetCollection,
+    CandidateIndex>::SharedIndex(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    const std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    const std::vector<std::pair<int, int>>& size_setid_map,
+    const lookup::TwoStageInvertedList& index)
+    : indexed_collection_(indexed_collection),
+      sets_(SetsCollectionView(sets_collection, size_setid_map)),
+      index_(index) {}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound,
+    typename SetCollection, typename CandidateIndex>
+std::vector<lookup::LookupResultElement>
+    SharedIndex<Label, VerificationAlgorithm, UpperBound, SetCollection,
+    CandidateIndex>::execute_lookup(
+    unsigned int query_tree_id, const double distance_threshold,
+    LookupStatistics& statistics) const {
+  // The lookup object only holds the counters of this query.
+  VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound> lookup;
+  std::vector<lookup::LookupResultElement> result_set = lookup.execute_lookup(
+      indexed_collection_, sets_, index_, query_tree_id, distance_threshold);
+  add_counters(lookup, statistics);
+  return result_set;
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound,
+    typename SetCollection, typename CandidateIndex>
+void SharedIndex<Label, VerificationAlgorithm, UpperBound, SetCollection,
+    CandidateIndex>::execute_lookup(
+    unsigned int query_tree_id,
+    data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+    const double distance_threshold, LookupStatistics& statistics) const {
+  VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound> lookup;
+  lookup.execute_lookup(indexed_collection_, sets_, index_, query_tree_id,
+      result_set, distance_threshold);
+  add_counters(lookup, statistics);
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound,
+    typename SetCollection, typename CandidateIndex>
+std::vector<lookup::LookupResultElement>
+    SharedIndex<Label, VerificationAlgorithm, UpperBound, SetCollection,
+    CandidateIndex>::execute_top_k_lookup(
+    unsigned int query_tree_id, const unsigned int k,
+    LookupStatistics& statistics) const {
+  VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound> lookup;
+  std::vector<lookup::LookupResultElement> result_set =
+      lookup.execute_top_k_lookup(indexed_collection_, sets_, index_,
+      query_tree_id, k);
+  add_counters(lookup, statistics);
+  return result_set;
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound,
+    typename SetCollection, typename CandidateIndex>
+void SharedIndex<Label, VerificationAlgorithm, UpperBound, SetCollection,
+    CandidateIndex>::add_counters(
+    const VerificationUBkIndex<Label, VerificationAlgorithm, UpperBound>& lookup,
+    LookupStatistics& statistics) {
+  statistics.pre_candidates += lookup.get_pre_candidates_count();
+  statistics.candidates += lookup.get_candidates_count();
+  statistics.verifications += lookup.get_verification_count();
+  statistics.subproblems += lookup.get_subproblem_count();
+}
@@ -0,0 +1,162 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file lookup/index/size_window.h
+///
+/// \details
+/// Restricts the candidates of a lookup to the trees whose size is close to
+/// the size of the query. Every edit operation changes the size of a tree by
+/// at most one, hence two trees whose sizes differ by more than the distance
+/// threshold cannot be in the result set. The size_setid_map of the
+/// Converter is sorted by tree size; the trees of a size window are a range
+/// of it that is found by binary search.
+///
+/// The candidates of the inverted list are in the size window already: the
+/// differences of the descendants, the ancestors, and the nodes right and
+/// left of two nodes add up to at least the difference of the tree sizes.
+/// The size window replaces the scan of all small trees for queries that are
+/// smaller than the threshold, where no node has to match.
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace lookup {
+
+/// Returns the positions of the entries of a size map whose tree size
+/// differs by at most distance_threshold from q_tree_size. The window is
+/// found by binary search, the map may be stored in any layout, e.g., in a
+/// MappedIndex.
+///
+/// \param number_of_entries Number of entries of the size map.
+/// \param size_at Callable returning the tree size of the entry at a
+///                position. The sizes are ascending in the position.
+/// \param q_tree_size Size of the query tree.
+/// \param distance_threshold Given similarity threshold.
+/// \return First position and one past the last position of the window.
+template <typename SizeAt>
+std::pair<std::size_t, std::size_t> get_size_window(
+    const std::size_t number_of_entries, SizeAt size_at,
+    const int q_tree_size, const double distance_threshold);
+
+/// Returns the positions of the entries of size_setid_map whose tree size
+/// differs by at most distance_threshold from q_tree_size.
+///
+/// \param size_setid_map Pairs of tree size and set id in ascending size.
+/// \param q_tree_size Size of the query tree.
+/// \param distance_threshold Given similarity threshold.
+/// \return First position and one past the last position of the window.
+std::pair<std::size_t, std::size_t> get_size_window(
+    const std::vector<std::pair<int, int>>& size_setid_map,
+    const int q_tree_size, const double distance_threshold);
+
+/// Calls f(set_id) for every set in the size window of a query that is not
+/// removed from the index.
+///
+/// \param sets Set accessor, e.g., a SetsCollectionView or a MappedIndex.
+/// \param index Candidate index whose removed sets are skipped.
+/// \param q_tree_size Size of the query tree.
+/// \param distance_threshold Given similarity threshold.
+/// \param f Callable taking a set id.
+template <typename SetCollection, typename CandidateIndex, typename Function>
+void for_each_size_window_set(const SetCollection& sets,
+    const CandidateIndex& index, const int q_tree_size,
+    const double distance_threshold, Function f);
+
+/// Sets the bit of every set id in the size window of a query, e.g., in the
+/// candidate bitsets of retrieve_batch_candidates. Sets removed from the
+/// index are skipped and other bits are not changed.
+///
+/// \param sets Set accessor, e.g., a SetsCollectionView or a MappedIndex.
+/// \param index Candidate index whose removed sets are skipped.
+/// \param q_tree_size Size of the query tree.
+/// \param distance_threshold Given similarity threshold.
+/// \param bits Bitmap over the set ids, bit i of word i / 64 is set id i.
+template <typename SetCollection, typename CandidateIndex>
+void fill_size_window(const SetCollection& sets, const CandidateIndex& index,
+    const int q_tree_size, const double distance_threshold,
+    std::uint64_t* bits);
+
+template <typename SizeAt>
+std::pair<std::size_t, std::size_t> get_size_window(
+    const std::size_t number_of_entries, SizeAt size_at,
+    const int q_tree_size, const double distance_threshold) {
+  // Returns the first position in [begin, end) whose size is not in front
+  // of the window. The sizes in front of it are a prefix.
+  auto partition_point = [&size_at](std::size_t begin, std::size_t end,
+      const auto& in_front) {
+    while (begin < end) {
+      const std::size_t middle = begin + (end - begin) / 2;
+      if (in_front(size_at(middle))) {
+        begin = middle + 1;
+      } else {
+        end = middle;
+      }
+    }
+    return begin;
+  };
+  // Compared as doubles such that an infinite threshold selects all trees.
+  const std::size_t begin = partition_point(0, number_of_entries,
+      [&](const int size) { return size < q_tree_size - distance_threshold; });
+  const std::size_t end = partition_point(begin, number_of_entries,
+      [&](const int size) { return size <= q_tree_size + distance_threshold; });
+  return {begin, end};
+}
+
+inline std::pair<std::size_t, std::size_t> get_size_window(
+    const std::vector<std::pair<int, int>>& size_setid_map,
+    const int q_tree_size, const double distance_threshold) {
+  return get_size_window(size_setid_map.size(),
+      [&size_setid_map](const std::size_t position) {
+    return size_setid_map[position].first;
+  }, q_tree_size, distance_threshold);
+}
+
+template <typename SetCollection, typename CandidateIndex, typename Function>
+void for_each_size_window_set(const SetCollection& sets,
+    const CandidateIndex& index, const int q_tree_size,
+    const double distance_threshold, Function f) {
+  const std::pair<std::size_t, std::size_t> window = get_size_window(
+      sets.get_number_of_size_entries(), [&sets](const std::size_t position) {
+    return sets.get_size_entry(position).first;
+  }, q_tree_size, distance_threshold);
+  for (std::size_t i = window.first; i < window.second; ++i) {
+    const int set_id = sets.get_size_entry(i).second;
+    // Removed trees stay in the size_setid_map.
+    if (!index.is_removed(set_id)) {
+      f(set_id);
+    }
+  }
+}
+
+template <typename SetCollection, typename CandidateIndex>
+void fill_size_window(const SetCollection& sets, const CandidateIndex& index,
+    const int q_tree_size, const double distance_threshold,
+    std::uint64_t* bits) {
+  for_each_size_window_set(sets, index, q_tree_size, distance_threshold,
+      [bits](const int set_id) {
+    bits[set_id >> 6] |= std::uint64_t(1) << (set_id & 63);
+  });
+}
+
+}
@@ -19,50 +19,189 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-/// \file lookup/index/two_stage_inv_list.h
+/// \file lookup/index/two_stage_inverted_list.h
 ///
 /// \details
 /// Implements a two-stage candidate index. Level 1 is the label of a node, 
 /// level 2 is the position in the global token frequency order for a certain 
 /// tree.
+///
+/// The postings of a label are grouped by the number of descendants, then by
+/// the number of ancestors, then by the number of nodes right and left of the
+/// node. All levels are stored in flat sorted arrays (compressed sparse rows):
+/// every level holds the sorted keys of all groups and the range of each group
+/// in the next level. A lookup searches the first key in range per level and
+/// scans consecutive memory.
+///
+/// Trees can be inserted and removed after the build. Inserted postings are
+/// appended to small per-label delta lists that a lookup scans next to the
+/// sorted arrays; removed trees are marked and skipped. Every set id has a
+/// generation that a removal increments and that the delta postings carry,
+/// hence a removed id can be inserted again, e.g., to update a tree, without
+/// its old postings becoming visible. Once the delta lists or the removed
+/// postings exceed a fraction of the sorted arrays, both are merged into new
+/// sorted arrays. The merge is linear in the index size and
+/// happens after a linear number of inserted or removed postings, hence
+/// inserting a new set or removing a set costs amortized time proportional to
+/// the tree size.
+///
+/// The set ids of the postings can be compressed (see
+/// data_structures/var_byte.h). The set ids of a right-left group are
+/// ascending; they are stored as variable-byte encoded differences and
+/// decoded by a lookup into a buffer. This trades lookup time for memory.
 
 #pragma once
 
 #include <cmath>
 #include <climits>
+#include <cstdlib>
 #include <algorithm>
+#include <tuple>
 #include <vector>
-#include <map>
 #include <unordered_set>
-#include <queue>
+#include <cstdint>
 #include "../../node/node.h"
-#include "inverted_list_element.h"
+#include "../../data_structures/var_byte.h"
 #include "label_set_element.h"
 
 namespace lookup {
 
 class TwoStageInvertedList {
+// Member structs.
+public:
+  /// Read-only view of the sorted arrays. MappedIndex points it into a
+  /// mapped file and shares the traversal of the sorted arrays.
+  struct SortedArrays {
+    /// Number of labels, label_offsets has one element more.
+    long int nr_of_labels = 0;
+    const std::size_t* label_offsets = nullptr;
+    const int* descendants_keys = nullptr;
+    const std::size_t* descendants_offsets = nullptr;
+    const int* ancestors_keys = nullptr;
+    const std::size_t* ancestors_offsets = nullptr;
+    const int* right_left_keys = nullptr;
+    const std::size_t* right_left_offsets = nullptr;
+    /// Set ids of the postings. nullptr if the postings are compressed.
+    const int* postings = nullptr;
+    /// Compressed set ids of the postings, nullptr if the postings are not
+    /// compressed. The right-left offsets are byte offsets then.
+    const std::uint8_t* compressed_postings = nullptr;
+  };
 // Member functions.
 public:
-  /// Constructor.
+  /// Constructor. The postings are not compressed.
   TwoStageInvertedList(long int labels);
+  /// Constructor.
+  ///
+  /// \param labels Number of labels.
+  /// \param compress_postings True if the set ids of the postings are
+  ///                          compressed.
+  TwoStageInvertedList(long int labels, const bool compress_postings);
   /// Builds an inverted list index on the labels and the positions of a given 
-  /// label set collection. 
+  /// label set collection. Previous postings are discarded.
   ///
   /// \param sets_collection Label set collection.
-  /// \param join_candidates Resultset that contains all join candidates.
-  /// \param distance_threshold Given similarity threshold.
   void build(std::vector<std::pair<int, 
       std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection);
+  /// Inserts the postings of a label set. Labels beyond the current number of
+  /// labels extend the index. A removed set id can be inserted again; the
+  /// postings of its earlier insertions stay hidden.
+  ///
+  /// \param set_id Id of the set. Must not be in the index.
+  /// \param set Tree size and label set elements of the set.
+  void insert(const long int set_id, const std::pair<int,
+      std::vector<label_set_converter_index::LabelSetElement>>& set);
+  /// Removes the postings of a label set. Lookups do not return set_id
+  /// anymore. Ids that are not in the index are ignored.
+  ///
+  /// \param set_id Id of the set.
+  void remove(const long int set_id);
+  /// Returns true if a set was removed and not inserted again. Lookups that
+  /// add sets without the inverted list, e.g., the trees of a size window,
+  /// skip these sets.
+  ///
+  /// \param set_id Id of the set.
+  bool is_removed(const long int set_id) const;
+  /// Merges the inserted postings into the sorted arrays and drops the
+  /// postings of removed sets. Called by insert and remove when needed;
+  /// calling it explicitly only affects the lookup performance.
+  void merge();
+  /// Compresses or decompresses the set ids of the postings. Later builds
+  /// and merges keep the setting.
+  ///
+  /// \param compress True if the set ids are compressed.
+  void set_posting_compression(const bool compress);
+  /// Returns true if the set ids of the postings are compressed.
+  bool get_posting_compression() const;
+  /// Returns the number of bytes of the sorted arrays and the delta lists.
+  ///
+  /// \return The number of bytes of the index data.
+  std::size_t get_memory_usage() const;
+  /// Returns the number of labels the index accepts in lookups.
+  ///
+  /// \return The number of labels.
+  long int get_number_of_labels() const;
   /// Returns a set of candidates (set IDs) that have a common element in the 
   /// prefix. 
   ///
-  /// \param label_id ID of the current node.
-  /// \param postorder_id Postorder ID of the current node.
+  /// \param q_label_id Label id of the query node.
+  /// \param descendants Number of descendants of the query node.
+  /// \param ancestors Number of ancestors of the query node.
+  /// \param q_tree_size Size of the query tree.
+  /// \param candidates Set to insert the candidates into.
   /// \param distance_threshold Given similarity threshold.
-  void lookup(long int& q_label_id, long int descendants, long int ancestors, 
-    int& q_tree_size, std::unordered_set<long int>& candidates, 
-    const double distance_threshold);
+  void lookup(const long int q_label_id, const long int descendants,
+    const long int ancestors, const int q_tree_size,
+    std::unordered_set<long int>& candidates,
+    const double distance_threshold) const;
+  /// Calls f(begin, end) for every range of set ids that are candidates of a
+  /// query node. The ranges may contain a set id more than once and contain
+  /// no removed sets. lookup inserts the ranges into a set; batched lookups use them to
+  /// share one traversal between equal query nodes. The iterators are valid
+  /// during the call of f only, compressed postings are decoded into a
+  /// buffer.
+  ///
+  /// \param q_label_id Label id of the query node.
+  /// \param descendants Number of descendants of the query node.
+  /// \param ancestors Number of ancestors of the query node.
+  /// \param q_tree_size Size of the query tree.
+  /// \param distance_threshold Given similarity threshold.
+  /// \param f Callable taking two iterators of std::vector<int>.
+  template <typename Function>
+  void for_each_candidate_range(const long int q_label_id,
+      const long int descendants, const long int ancestors,
+      const int q_tree_size, const double distance_threshold,
+      Function f) const;
+  /// Calls f(begin, end) for every range of positions in the postings of
+  /// the sorted arrays whose set ids are candidates of a query node. Removed
+  /// sets are not skipped and delta lists are not scanned. The positions are
+  /// byte positions in compressed_postings if the postings are compressed.
+  ///
+  /// \param arrays Sorted arrays to traverse.
+  /// \param q_label_id Label id of the query node.
+  /// \param descendants Number of descendants of the query node.
+  /// \param ancestors Number of ancestors of the query node.
+  /// \param q_tree_size Size of the query tree.
+  /// \param distance_threshold Given similarity threshold.
+  /// \param f Callable taking two positions in the postings.
+  template <typename Function>
+  static void for_each_sorted_range(const SortedArrays& arrays,
+      const long int q_label_id, const long int descendants,
+      const long int ancestors, const int q_tree_size,
+      const double distance_threshold, Function&& f);
+  /// Returns a view of the sorted arrays. The view is invalidated by build,
+  /// insert, remove, and merge.
+  ///
+  /// \return The sorted arrays.
+  SortedArrays get_sorted_arrays() const;
+  /// Returns the number of inserted postings that are not in the sorted
+  /// arrays plus the number of postings of removed sets that still are.
+  ///
+  /// \return Zero if the sorted arrays hold exactly the indexed sets.
+  std::size_t get_number_of_unmerged_postings() const;
+  /// Returns the number of precandidates.
+  ///
+  /// \return The number of precandidates.
   long int get_number_of_pre_candidates() const;
   /// Sets the number of precandidates.
   void set_number_of_pre_candidates(const long int pc);
@@ -72,6 +211,51 @@ public:
   long int get_number_of_il_lookups() const;
   /// Sets the number of index lookups.
   void set_number_of_il_lookups(const long int il);
+// Member functions.
+private:
+  /// Returns the first position in [begin, end) of keys whose key is not
+  /// less than value. Probes positions begin, begin + 1, begin + 3, ... and
+  /// binary searches the last step, which is fast for the short lists and the
+  /// small search values of a lookup.
+  ///
+  /// \param keys Sorted keys of a level.
+  /// \param begin First position of the range.
+  /// \param end One past the last position of the range.
+  /// \param value Search value.
+  static std::size_t gallop_lower_bound(const int* keys,
+      std::size_t begin, const std::size_t end, const long int value);
+  /// Replaces the sorted arrays by the given postings.
+  ///
+  /// \param postings Sorted tuples of label, descendants, ancestors,
+  ///                 right-left, and set id.
+  void fill_levels(
+      const std::vector<std::tuple<int, int, int, int, int>>& postings);
+  /// Replaces postings_ by compressed_postings_ and the right-left offsets
+  /// by byte offsets.
+  void compress_postings();
+  /// Replaces compressed_postings_ by postings_ and the right-left offsets
+  /// by positions in postings_.
+  void decompress_postings();
+  /// Extends the index to at least labels labels.
+  ///
+  /// \param labels Number of labels.
+  void grow_labels(const long int labels);
+  /// Calls f(begin, end) for the runs of postings of the sorted arrays in
+  /// [begin, end) whose sets are not removed.
+  template <typename Function>
+  void for_each_live_range(std::vector<int>::const_iterator begin,
+      const std::vector<int>::const_iterator end, Function& f) const;
+// Member structs.
+private:
+  /// Postings of a label inserted since the last merge, in insertion order.
+  /// A posting is live if its generation is the one of its set.
+  struct DeltaList {
+    std::vector<int> descendants;
+    std::vector<int> ancestors;
+    std::vector<int> right_left;
+    std::vector<int> set_ids;
+    std::vector<int> generations;
+  };
 // Member variables.
 private:
   /// Number of precandidates.
@@ -80,8 +264,40 @@ private:
   long int il_lookups_;
   /// Number of different labels.
   long int nr_of_labels_;
-  /// Inverted list index.
-  std::vector<InvertedListElement> il_index_;
+  /// Range of every label in the descendants level, label_offsets_[label] to
+  /// label_offsets_[label + 1].
+  std::vector<std::size_t> label_offsets_;
+  /// Descendants level: keys and ranges in the ancestors level.
+  std::vector<int> descendants_keys_;
+  std::vector<std::size_t> descendants_offsets_;
+  /// Ancestors level: keys and ranges in the right-left level.
+  std::vector<int> ancestors_keys_;
+  std::vector<std::size_t> ancestors_offsets_;
+  /// Right-left level: keys and ranges in the postings.
+  std::vector<int> right_left_keys_;
+  std::vector<std::size_t> right_left_offsets_;
+  /// Set ids of all postings. Empty if the postings are compressed.
+  std::vector<int> postings_;
+  /// True if the set ids of the postings are compressed.
+  bool compress_postings_;
+  /// Variable-byte encoded set ids of every right-left group.
+  std::vector<std::uint8_t> compressed_postings_;
+  /// Inserted postings per label that are not yet in the sorted arrays.
+  std::vector<DeltaList> delta_lists_;
+  /// Number of postings in delta_lists_.
+  std::size_t nr_of_delta_postings_;
+  /// Number of live postings of every set id in the index.
+  std::vector<int> set_postings_;
+  /// Marks the removed set ids that were not inserted again.
+  std::vector<bool> removed_;
+  /// Marks the set ids whose postings in the sorted arrays were removed.
+  std::vector<bool> stale_;
+  /// Generation of every set id, incremented by every removal.
+  std::vector<int> generations_;
+  /// Number of postings of removed sets that are still in the index.
+  std::size_t nr_of_removed_postings_;
+  /// Minimum number of delta or removed postings that triggers a merge.
+  static constexpr std::size_t kMinMergePostings = 1024;
 };
 
 // Implementation details.
@@ -19,41 +19,380 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-/// \file lookup/index/two_stage_inv_list_impl.h
+/// \file lookup/index/two_stage_inverted_list_impl.h
+///
+/// \details
+/// Contains the implementation of the TwoStageInvertedList class.
 
 #pragma once
 
-TwoStageInvertedList::TwoStageInvertedList(long int labels) {
+inline TwoStageInvertedList::TwoStageInvertedList(long int labels)
+    : TwoStageInvertedList(labels, false) {}
+
+inline TwoStageInvertedList::TwoStageInvertedList(long int labels,
+    const bool compress_postings) {
   pre_candidates_ = 0;
   il_lookups_ = 0;
-  nr_of_labels_ = labels;
-  il_index_.resize(nr_of_labels_);
+  nr_of_labels_ = 0;
+  nr_of_delta_postings_ = 0;
+  nr_of_removed_postings_ = 0;
+  compress_postings_ = compress_postings;
+  label_offsets_.assign(1, 0);
+  grow_labels(labels);
 }
 
-void TwoStageInvertedList::build(std::vector<std::pair<int, 
+inline void TwoStageInvertedList::build(std::vector<std::pair<int, 
     std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection) {
-  long int label_id;
-  long int descendants;
-  long int ancestors;
-  long int right_left;
-
-  // Iterate through all sets in a given collection.
+  // Collect the postings as (label, descendants, ancestors, right-left, set
+  // id) and sort them. The order is the order of the nested groups, and the
+  // set ids of a group are ascending.
+  std::vector<std::tuple<int, int, int, int, int>> postings;
+  long int labels = nr_of_labels_;
+  set_postings_.assign(sets_collection.size(), 0);
   for (unsigned int s = 0; s < sets_collection.size(); s++) {
-    // Iterate through elements of a given set.
-    for (unsigned int e = 0; e < sets_collection[s].second.size(); e++) {
-      label_id = sets_collection[s].second[e].id;
-      descendants = sets_collection[s].second[e].descendants;
-      ancestors = sets_collection[s].second[e].ancestors;
-      right_left = sets_collection[s].first - descendants - ancestors - 1;
-      il_index_[label_id].element_list[descendants][ancestors][right_left].push_back(s);
+    for (auto& element : sets_collection[s].second) {
+      long int right_left = sets_collection[s].first - element.descendants -
+          element.ancestors - 1;
+      postings.emplace_back(element.id, element.descendants, element.ancestors,
+          right_left, s);
+      // Labels beyond the constructor's number of labels extend the index.
+      labels = std::max(labels, element.id + 1);
+    }
+    set_postings_[s] = sets_collection[s].second.size();
+  }
+  std::sort(postings.begin(), postings.end());
+
+  for (auto& delta : delta_lists_) {
+    delta = DeltaList();
+  }
+  nr_of_delta_postings_ = 0;
+  removed_.assign(sets_collection.size(), false);
+  stale_.assign(sets_collection.size(), false);
+  generations_.assign(sets_collection.size(), 0);
+  nr_of_removed_postings_ = 0;
+  grow_labels(labels);
+  fill_levels(postings);
+}
+
+inline void TwoStageInvertedList::insert(const long int set_id,
+    const std::pair<int,
+    std::vector<label_set_converter_index::LabelSetElement>>& set) {
+  if (set_id >= (long int) set_postings_.size()) {
+    set_postings_.resize(set_id + 1, 0);
+    removed_.resize(set_id + 1, false);
+    stale_.resize(set_id + 1, false);
+    generations_.resize(set_id + 1, 0);
+  }
+  // The postings of earlier insertions stay hidden by the stale mark and
+  // their generation.
+  removed_[set_id] = false;
+  for (auto& element : set.second) {
+    if (element.id >= nr_of_labels_) {
+      grow_labels(element.id + 1);
     }
+    DeltaList& delta = delta_lists_[element.id];
+    delta.descendants.push_back(element.descendants);
+    delta.ancestors.push_back(element.ancestors);
+    delta.right_left.push_back(set.first - element.descendants -
+        element.ancestors - 1);
+    delta.set_ids.push_back(set_id);
+    delta.generations.push_back(generations_[set_id]);
+  }
+  set_postings_[set_id] += set.second.size();
+  nr_of_delta_postings_ += set.second.size();
+  if (nr_of_delta_postings_ >= std::max(kMinMergePostings,
+      postings_.size() / 8)) {
+    merge();
   }
 }
 
-void TwoStageInvertedList::lookup(long int& q_label_id,
-    long int descendants, long int ancestors, int& q_tree_size, 
-    std::unordered_set<long int>& candidates,
-    const double distance_threshold) {
+inline void TwoStageInvertedList::remove(const long int set_id) {
+  if (set_id < 0 || set_id >= (long int) set_postings_.size() ||
+      removed_[set_id] || set_postings_[set_id] == 0) {
+    return;
+  }
+  removed_[set_id] = true;
+  stale_[set_id] = true;
+  ++generations_[set_id];
+  nr_of_removed_postings_ += set_postings_[set_id];
+  set_postings_[set_id] = 0;
+  if (nr_of_removed_postings_ >= std::max(kMinMergePostings,
+      postings_.size() / 4)) {
+    merge();
+  }
+}
+
+inline void TwoStageInvertedList::merge() {
+  // fill_levels compresses the merged postings again.
+  if (compress_postings_) {
+    decompress_postings();
+  }
+  // The postings of the sorted arrays are already sorted.
+  std::vector<std::tuple<int, int, int, int, int>> postings;
+  postings.reserve(postings_.size() + nr_of_delta_postings_);
+  for (long int label = 0; label < nr_of_labels_; ++label) {
+    for (std::size_t d = label_offsets_[label];
+        d < label_offsets_[label + 1]; ++d) {
+      for (std::size_t a = descendants_offsets_[d];
+          a < descendants_offsets_[d + 1]; ++a) {
+        for (std::size_t r = ancestors_offsets_[a];
+            r < ancestors_offsets_[a + 1]; ++r) {
+          for (std::size_t p = right_left_offsets_[r];
+              p < right_left_offsets_[r + 1]; ++p) {
+            if (!stale_[postings_[p]]) {
+              postings.emplace_back(label, descendants_keys_[d],
+                  ancestors_keys_[a], right_left_keys_[r], postings_[p]);
+            }
+          }
+        }
+      }
+    }
+  }
+  // Sort the delta postings and merge them with the sorted ones.
+  const std::size_t nr_of_sorted = postings.size();
+  for (long int label = 0; label < nr_of_labels_; ++label) {
+    DeltaList& delta = delta_lists_[label];
+    for (std::size_t i = 0; i < delta.set_ids.size(); ++i) {
+      if (delta.generations[i] == generations_[delta.set_ids[i]]) {
+        postings.emplace_back(label, delta.descendants[i], delta.ancestors[i],
+            delta.right_left[i], delta.set_ids[i]);
+      }
+    }
+    delta = DeltaList();
+  }
+  std::sort(postings.begin() + nr_of_sorted, postings.end());
+  std::inplace_merge(postings.begin(), postings.begin() + nr_of_sorted,
+      postings.end());
+  nr_of_delta_postings_ = 0;
+
+  // Only live postings are left.
+  std::fill(stale_.begin(), stale_.end(), false);
+  nr_of_removed_postings_ = 0;
+  fill_levels(postings);
+}
+
+inline void TwoStageInvertedList::set_posting_compression(
+    const bool compress) {
+  if (compress == compress_postings_) {
+    return;
+  }
+  if (compress) {
+    compress_postings();
+  } else {
+    decompress_postings();
+  }
+  compress_postings_ = compress;
+}
+
+inline bool TwoStageInvertedList::get_posting_compression() const {
+  return compress_postings_;
+}
+
+inline std::size_t TwoStageInvertedList::get_memory_usage() const {
+  std::size_t bytes = (label_offsets_.size() + descendants_offsets_.size() +
+      ancestors_offsets_.size() + right_left_offsets_.size()) *
+      sizeof(std::size_t);
+  bytes += (descendants_keys_.size() + ancestors_keys_.size() +
+      right_left_keys_.size() + postings_.size() + set_postings_.size()) *
+      sizeof(int);
+  bytes += generations_.size() * sizeof(int);
+  bytes += compressed_postings_.size() + (removed_.size() + stale_.size()) / 8;
+  for (const auto& delta : delta_lists_) {
+    bytes += (delta.descendants.size() + delta.ancestors.size() +
+        delta.right_left.size() + delta.set_ids.size() +
+        delta.generations.size()) * sizeof(int);
+  }
+  return bytes;
+}
+
+inline void TwoStageInvertedList::compress_postings() {
+  compressed_postings_.clear();
+  for (std::size_t r = 0; r + 1 < right_left_offsets_.size(); ++r) {
+    const std::size_t begin = right_left_offsets_[r];
+    right_left_offsets_[r] = compressed_postings_.size();
+    data_structures::var_byte_encode_deltas(postings_.data() + begin,
+        postings_.data() + right_left_offsets_[r + 1], compressed_postings_);
+  }
+  if (!right_left_offsets_.empty()) {
+    right_left_offsets_.back() = compressed_postings_.size();
+  }
+  compressed_postings_.shrink_to_fit();
+  std::vector<int>().swap(postings_);
+}
+
+inline void TwoStageInvertedList::decompress_postings() {
+  postings_.clear();
+  for (std::size_t r = 0; r + 1 < right_left_offsets_.size(); ++r) {
+    const std::size_t begin = right_left_offsets_[r];
+    right_left_offsets_[r] = postings_.size();
+    data_structures::var_byte_decode_deltas(
+        compressed_postings_.data() + begin,
+        compressed_postings_.data() + right_left_offsets_[r + 1], postings_);
+  }
+  if (!right_left_offsets_.empty()) {
+    right_left_offsets_.back() = postings_.size();
+  }
+  std::vector<std::uint8_t>().swap(compressed_postings_);
+}
+
+inline long int TwoStageInvertedList::get_number_of_labels() const {
+  return nr_of_labels_;
+}
+
+inline void TwoStageInvertedList::grow_labels(const long int labels) {
+  if (labels <= nr_of_labels_) {
+    return;
+  }
+  // New labels have empty ranges at the end of the descendants level.
+  label_offsets_.resize(labels + 1, label_offsets_.back());
+  delta_lists_.resize(labels);
+  nr_of_labels_ = labels;
+}
+
+inline void TwoStageInvertedList::fill_levels(
+    const std::vector<std::tuple<int, int, int, int, int>>& postings) {
+  std::fill(label_offsets_.begin(), label_offsets_.end(), 0);
+  descendants_keys_.clear();
+  descendants_offsets_.clear();
+  ancestors_keys_.clear();
+  ancestors_offsets_.clear();
+  right_left_keys_.clear();
+  right_left_offsets_.clear();
+  postings_.clear();
+  postings_.reserve(postings.size());
+  compressed_postings_.clear();
+
+  // A new group starts on a level if its key or the key of a level above
+  // differs from the previous posting.
+  for (std::size_t i = 0; i < postings.size(); ++i) {
+    const auto& p = postings[i];
+    const bool new_label = i == 0 ||
+        std::get<0>(p) != std::get<0>(postings[i - 1]);
+    const bool new_descendants = new_label ||
+        std::get<1>(p) != std::get<1>(postings[i - 1]);
+    const bool new_ancestors = new_descendants ||
+        std::get<2>(p) != std::get<2>(postings[i - 1]);
+    const bool new_right_left = new_ancestors ||
+        std::get<3>(p) != std::get<3>(postings[i - 1]);
+    if (new_descendants) {
+      // Count the groups of the label. The counts are summed up below.
+      ++label_offsets_[std::get<0>(p) + 1];
+      descendants_keys_.push_back(std::get<1>(p));
+      descendants_offsets_.push_back(ancestors_keys_.size());
+    }
+    if (new_ancestors) {
+      ancestors_keys_.push_back(std::get<2>(p));
+      ancestors_offsets_.push_back(right_left_keys_.size());
+    }
+    if (new_right_left) {
+      right_left_keys_.push_back(std::get<3>(p));
+      right_left_offsets_.push_back(postings_.size());
+    }
+    postings_.push_back(std::get<4>(p));
+  }
+  // Every level ends with the end of the last range.
+  descendants_offsets_.push_back(ancestors_keys_.size());
+  ancestors_offsets_.push_back(right_left_keys_.size());
+  right_left_offsets_.push_back(postings_.size());
+  for (long int label = 0; label < nr_of_labels_; ++label) {
+    label_offsets_[label + 1] += label_offsets_[label];
+  }
+  if (compress_postings_) {
+    compress_postings();
+  }
+}
+
+inline std::size_t TwoStageInvertedList::gallop_lower_bound(
+    const int* keys, std::size_t begin, const std::size_t end,
+    const long int value) {
+  if (begin == end || keys[begin] >= value) {
+    return begin;
+  }
+  // Invariant: keys[begin] < value.
+  std::size_t step = 1;
+  std::size_t probe = begin + 1;
+  while (probe < end && keys[probe] < value) {
+    begin = probe;
+    step *= 2;
+    probe = begin + step;
+  }
+  return std::lower_bound(keys + begin + 1,
+      keys + std::min(probe, end), value) - keys;
+}
+
+inline void TwoStageInvertedList::lookup(const long int q_label_id,
+    const long int descendants, const long int ancestors,
+    const int q_tree_size, std::unordered_set<long int>& candidates,
+    const double distance_threshold) const {
+  for_each_candidate_range(q_label_id, descendants, ancestors, q_tree_size,
+      distance_threshold, [&candidates](std::vector<int>::const_iterator begin,
+      std::vector<int>::const_iterator end) {
+    // Add all to candidates.
+    candidates.insert(begin, end);
+  });
+}
+
+template <typename Function>
+void TwoStageInvertedList::for_each_candidate_range(const long int q_label_id,
+    const long int descendants, const long int ancestors,
+    const int q_tree_size, const double distance_threshold,
+    Function f) const {
+  if (q_label_id < 0 || q_label_id >= nr_of_labels_) {
+    return;
+  }
+  if (compress_postings_) {
+    // The set ids of a group are decoded into a buffer of this call, such
+    // that concurrent lookups do not share it.
+    std::vector<int> buffer;
+    for_each_sorted_range(get_sorted_arrays(), q_label_id, descendants,
+        ancestors, q_tree_size, distance_threshold,
+        [this, &f, &buffer](const std::size_t begin, const std::size_t end) {
+      buffer.clear();
+      data_structures::var_byte_decode_deltas(
+          compressed_postings_.data() + begin,
+          compressed_postings_.data() + end, buffer);
+      for_each_live_range(buffer.cbegin(), buffer.cend(), f);
+    });
+  } else {
+    for_each_sorted_range(get_sorted_arrays(), q_label_id, descendants,
+        ancestors, q_tree_size, distance_threshold,
+        [this, &f](const std::size_t begin, const std::size_t end) {
+      for_each_live_range(postings_.cbegin() + begin,
+          postings_.cbegin() + end, f);
+    });
+  }
+  const long int right_left = q_tree_size - descendants - ancestors - 1;
+  long int threshold_stage1;
+  long int threshold_stage2;
+  long int threshold_stage3;
+  // Inserted postings that are not yet merged. The lower bounds are the same
+  // as in for_each_sorted_range, hence the candidates do not depend on
+  // merges.
+  const DeltaList& delta = delta_lists_[q_label_id];
+  for (std::size_t i = 0; i < delta.set_ids.size(); ++i) {
+    threshold_stage1 = distance_threshold -
+        std::abs(descendants - delta.descendants[i]);
+    if (threshold_stage1 < 0) continue;
+    threshold_stage2 = threshold_stage1 -
+        std::abs(ancestors - delta.ancestors[i]);
+    if (threshold_stage2 < 0) continue;
+    threshold_stage3 = threshold_stage2 -
+        std::abs(right_left - delta.right_left[i]);
+    if (threshold_stage3 < 0) continue;
+    if (delta.generations[i] == generations_[delta.set_ids[i]]) {
+      f(delta.set_ids.cbegin() + i, delta.set_ids.cbegin() + i + 1);
+    }
+  }
+}
+
+template <typename Function>
+void TwoStageInvertedList::for_each_sorted_range(const SortedArrays& arrays,
+    const long int q_label_id, const long int descendants,
+    const long int ancestors, const int q_tree_size,
+    const double distance_threshold, Function&& f) {
+  if (q_label_id < 0 || q_label_id >= arrays.nr_of_labels) {
+    return;
+  }
   // All nodes except the current node, its descendants, and ancestors.
   long int right_left = q_tree_size - descendants - ancestors - 1;
   // Range for descendants stage.
@@ -67,65 +406,117 @@ void TwoStageInvertedList::lookup(long int& q_label_id,
   long int threshold_stage1;
   long int threshold_stage2;
   long int threshold_stage3;
-  // Binary search to first relevant element (threshold range) in 
-  // the descandants index layer.
-  auto iter_desc = il_index_[q_label_id].element_list.lower_bound(start_desc_range);
-  while (iter_desc != il_index_[q_label_id].element_list.end()) {
+  // On every level, the keys are sorted. Once a key greater than the query
+  // value exceeds the threshold, all following keys exceed it as well.
+  const std::size_t desc_end = arrays.label_offsets[q_label_id + 1];
+  for (std::size_t d = gallop_lower_bound(arrays.descendants_keys,
+      arrays.label_offsets[q_label_id], desc_end, start_desc_range);
+      d < desc_end; ++d) {
     // Incrementally improving the threshold.
-    threshold_stage1 = distance_threshold - std::abs(descendants - iter_desc->first);
+    threshold_stage1 = distance_threshold -
+        std::abs(descendants - arrays.descendants_keys[d]);
     // Descendants lower bound exceeds the threshold.
     if (threshold_stage1 < 0) {
-      ++iter_desc;
+      if (arrays.descendants_keys[d] > descendants) break;
       continue;
     }
-    // Binary search to first relevant element (threshold range) in 
-    // the ancestor index layer.
     start_anc_range = ancestors - threshold_stage1;
     if (start_anc_range < 0) start_anc_range = 0;
-    auto iter_anc = iter_desc->second.lower_bound(start_anc_range);
-    while (iter_anc != iter_desc->second.end()) {
-      threshold_stage2 = threshold_stage1 - std::abs(ancestors - iter_anc->first);
+    const std::size_t anc_end = arrays.descendants_offsets[d + 1];
+    for (std::size_t a = gallop_lower_bound(arrays.ancestors_keys,
+        arrays.descendants_offsets[d], anc_end, start_anc_range);
+        a < anc_end; ++a) {
+      threshold_stage2 = threshold_stage1 -
+          std::abs(ancestors - arrays.ancestors_keys[a]);
       // Descendants and ancestor lower bound exceeds the threshold.
       if (threshold_stage2 < 0) {
-        ++iter_anc;
+        if (arrays.ancestors_keys[a] > ancestors) break;
         continue;
       }
-      // Binary search to first relevant element (threshold range) in 
-      // the right-left index layer.
       start_rl_range = right_left - threshold_stage2;
       if (start_rl_range < 0) start_rl_range = 0;
-      auto iter_rl = iter_anc->second.lower_bound(start_rl_range);
-      while (iter_rl != iter_anc->second.end()) {
-        threshold_stage3 = threshold_stage2 - std::abs(right_left - iter_rl->first);
-        // Descendants, ancestor, and right-left lower bound exceeds the threshold.
+      const std::size_t rl_end = arrays.ancestors_offsets[a + 1];
+      for (std::size_t r = gallop_lower_bound(arrays.right_left_keys,
+          arrays.ancestors_offsets[a], rl_end, start_rl_range);
+          r < rl_end; ++r) {
+        threshold_stage3 = threshold_stage2 -
+            std::abs(right_left - arrays.right_left_keys[r]);
+        // Descendants, ancestor, and right-left lower bound exceeds the
+        // threshold.
         if (threshold_stage3 < 0) {
-          ++iter_rl;
+          if (arrays.right_left_keys[r] > right_left) break;
           continue;
         }
-        // Add all to candidates.
-        for (auto& tree_id : iter_rl->second) {
-          candidates.insert(tree_id);
-        }
-        ++iter_rl;
+        f(arrays.right_left_offsets[r], arrays.right_left_offsets[r + 1]);
       }
-      ++iter_anc;
     }
-    ++iter_desc;
   }
 }
 
-long int TwoStageInvertedList::get_number_of_pre_candidates() const {
+template <typename Function>
+void TwoStageInvertedList::for_each_live_range(
+    std::vector<int>::const_iterator begin,
+    const std::vector<int>::const_iterator end, Function& f) const {
+  if (nr_of_removed_postings_ == 0) {
+    f(begin, end);
+    return;
+  }
+  while (begin != end) {
+    while (begin != end && stale_[*begin]) {
+      ++begin;
+    }
+    auto run_end = begin;
+    while (run_end != end && !stale_[*run_end]) {
+      ++run_end;
+    }
+    if (begin != run_end) {
+      f(begin, run_end);
+    }
+    begin = run_end;
+  }
+}
+
+inline bool TwoStageInvertedList::is_removed(const long int set_id) const {
+  return set_id >= 0 && set_id < (long int) removed_.size() &&
+      removed_[set_id];
+}
+
+inline TwoStageInvertedList::SortedArrays
+TwoStageInvertedList::get_sorted_arrays() const {
+  SortedArrays arrays;
+  arrays.nr_of_labels = nr_of_labels_;
+  arrays.label_offsets = label_offsets_.data();
+  arrays.descendants_keys = descendants_keys_.data();
+  arrays.descendants_offsets = descendants_offsets_.data();
+  arrays.ancestors_keys = ancestors_keys_.data();
+  arrays.ancestors_offsets = ancestors_offsets_.data();
+  arrays.right_left_keys = right_left_keys_.data();
+  arrays.right_left_offsets = right_left_offsets_.data();
+  if (compress_postings_) {
+    arrays.compressed_postings = compressed_postings_.data();
+  } else {
+    arrays.postings = postings_.data();
+  }
+  return arrays;
+}
+
+inline std::size_t TwoStageInvertedList::get_number_of_unmerged_postings()
+    const {
+  return nr_of_delta_postings_ + nr_of_removed_postings_;
+}
+
+inline long int TwoStageInvertedList::get_number_of_pre_candidates() const {
   return pre_candidates_;
 }
 
-void TwoStageInvertedList::set_number_of_pre_candidates(const long int pc) {
+inline void TwoStageInvertedList::set_number_of_pre_candidates(const long int pc) {
   pre_candidates_ = pc;
 }
 
-long int TwoStageInvertedList::get_number_of_il_lookups() const {
+inline long int TwoStageInvertedList::get_number_of_il_lookups() const {
   return il_lookups_;
 }
 
-void TwoStageInvertedList::set_number_of_il_lookups(const long int il) {
+inline void TwoStageInvertedList::set_number_of_il_lookups(const long int il) {
   il_lookups_ = il;
 }
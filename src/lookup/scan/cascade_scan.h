@@ -0,0 +1,153 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file lookup/scan/cascade_scan.h
+///
+/// \details
+/// Implements a scan lookup that partitions the collection across threads and
+/// applies a cascade of filters to every tree, from cheap to expensive: the
+/// size difference, the label intersection, the upper bound, and the
+/// verification. A tree leaves the cascade at the first stage that decides
+/// it. The number of trees every stage prunes or accepts is counted.
+///
+/// The string edit distance of the traversals (ted_lb::SEDTreeIndex) is not
+/// part of the cascade. It is a lower bound of the ordered tree edit
+/// distance only; the unordered object members of JSON trees let the JSON
+/// edit distance be smaller.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "../../node/node.h"
+#include "../../node/tree_indexer.h"
+#include "../../node/tree_index_collection.h"
+#include "../../parallel/parallel_for.h"
+#include "../../data_structures/result_sink.h"
+#include "../lookup_result_element.h"
+
+namespace lookup {
+
+/// Number of trees the stages of a CascadeScan handled.
+struct CascadeStatistics {
+  /// Number of trees that entered the cascade.
+  long long int candidates = 0;
+  /// Number of trees pruned by the size difference.
+  long long int size_pruned = 0;
+  /// Number of trees pruned by the label intersection.
+  long long int label_intersection_pruned = 0;
+  /// Number of trees accepted by the upper bound.
+  long long int upper_bound_accepted = 0;
+  /// Number of verified trees.
+  long long int verifications = 0;
+  /// Number of verified trees in the result.
+  long long int verification_accepted = 0;
+  /// Adds the counters of other.
+  void add(const CascadeStatistics& other);
+};
+
+/**
+ * Implements a parallel scan lookup with a filter cascade for a given
+ * verification and upper bound algorithm.
+ *
+ * The tree index has to contain the label ids in postorder and the inverted
+ * list of label ids (e.g., node::TreeIndexJSON). The lower bounds assume unit
+ * costs.
+ */
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+class CascadeScan {
+
+public:
+  /// Constructor. The scan runs in a single thread.
+  CascadeScan();
+  /// Constructor.
+  /**
+   * \param number_of_threads Number of threads scanning the collection.
+   *                          Values smaller than one use all hardware
+   *                          threads.
+   */
+  CascadeScan(const int number_of_threads);
+  
+  /// Executes the lookup algorithm.
+  /**
+   * Each thread uses its own algorithm instances and claims chunks of
+   * consecutive trees. The result is in ascending tree id, independent of
+   * the number of threads.
+   *
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param query_tree_id Id of the query tree.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the lookup's result set.
+   * \return A vector with the lookup result.
+   */
+  std::vector<lookup::LookupResultElement> execute_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      unsigned int query_tree_id, const double distance_threshold);
+  /// Executes the lookup algorithm and streams the results to a sink.
+  /**
+   * The sink receives the results in the order of execute_lookup. A chunk of
+   * trees is passed on as soon as all earlier chunks are scanned, i.e., the
+   * consumer of the sink is called by the scanning threads, one at a time.
+   *
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param query_tree_id Id of the query tree.
+   * \param result_set Sink receiving the lookup results. It is flushed
+   *                   before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the lookup's result set.
+   */
+  void execute_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      unsigned int query_tree_id,
+      data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+      const double distance_threshold);
+  
+  /// Returns the summed subproblem count of JEDI algorithm executions.
+  /**
+   * \return sum_subproblem_counter_
+   */
+  long long int get_subproblem_count() const;
+  
+  /// Returns the number of trees every stage handled, summed over all
+  /// lookups.
+  /**
+   * \return statistics_
+   */
+  const CascadeStatistics& get_statistics() const;
+
+private:
+  /// Number of subproblrems encoutered in the verification step.
+  long long int sum_subproblem_counter_;
+  /// Counters of the cascade stages.
+  CascadeStatistics statistics_;
+  /// Number of threads scanning the collection.
+  unsigned int number_of_threads_;
+  /// Number of trees a thread claims at once.
+  static constexpr std::size_t kScanChunkSize = 64;
+};
+
+// Implementation details.
+#include "cascade_scan_impl.h"
+
+}
@@ -0,0 +1,174 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file lookup/scan/cascade_scan_impl.h
+///
+/// \details
+/// Contains the implementation of the CascadeScan class.
+
+#pragma once
+
+inline void CascadeStatistics::add(const CascadeStatistics& other) {
+  candidates += other.candidates;
+  size_pruned += other.size_pruned;
+  label_intersection_pruned += other.label_intersection_pruned;
+  upper_bound_accepted += other.upper_bound_accepted;
+  verifications += other.verifications;
+  verification_accepted += other.verification_accepted;
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+CascadeScan<Label, VerificationAlgorithm, UpperBound>::CascadeScan()
+    : CascadeScan(1) {}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+CascadeScan<Label, VerificationAlgorithm, UpperBound>::CascadeScan(
+    const int number_of_threads) {
+  number_of_threads_ = parallel::get_number_of_threads(number_of_threads);
+  sum_subproblem_counter_ = 0;
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+std::vector<lookup::LookupResultElement> 
+    CascadeScan<Label, VerificationAlgorithm, UpperBound>::execute_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    unsigned int query_tree_id, const double distance_threshold) {
+  std::vector<lookup::LookupResultElement> result_set;
+  data_structures::ResultSink<lookup::LookupResultElement> sink(result_set);
+  execute_lookup(indexed_collection, query_tree_id, sink, distance_threshold);
+  return result_set;
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+void CascadeScan<Label, VerificationAlgorithm, UpperBound>::execute_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    unsigned int query_tree_id,
+    data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+    const double distance_threshold) {
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
+
+  // Indexed query tree.
+  const typename VerificationAlgorithm::AlgsTreeIndex& tq =
+      indexed_collection[query_tree_id];
+
+  // Label histogram of the query tree, indexed by label id. A candidate
+  // looks up the counts of its labels without hashing.
+  std::vector<int> query_label_counts(
+      indexed_collection.get_label_dictionary().size(), 0);
+  for (int i = 0; i < tq.tree_size_; ++i) {
+    ++query_label_counts[tq.postl_to_label_id_[i]];
+  }
+
+  // The results of a chunk are passed to the sink as soon as all earlier
+  // chunks are scanned.
+  parallel::ChunkQueue chunks(indexed_collection.size(), kScanChunkSize);
+  parallel::ChunkSequencer sequencer(
+      parallel::kPendingChunksPerThread * number_of_threads_);
+  std::vector<std::vector<lookup::LookupResultElement>> chunk_results(
+      chunks.get_number_of_chunks());
+  std::vector<CascadeStatistics> thread_statistics(number_of_threads_);
+  std::vector<long long int> thread_subproblem_counters(number_of_threads_, 0);
+
+  parallel::run_workers(number_of_threads_, [&](const unsigned int thread_id) {
+    VerificationAlgorithm verification_algorithm(cm);
+    UpperBound upper_bound_algorithm(cm);
+    CascadeStatistics& statistics = thread_statistics[thread_id];
+
+    sequencer.run(chunks, [&](const std::size_t chunk_id,
+        const std::size_t begin, const std::size_t end) {
+      for (std::size_t candidate_tree_id = begin; candidate_tree_id < end;
+          ++candidate_tree_id) {
+        // Indexed candidate tree.
+        const typename VerificationAlgorithm::AlgsTreeIndex& tc =
+            indexed_collection[candidate_tree_id];
+        ++statistics.candidates;
+
+        // Stage 1: Size difference.
+        if (std::abs(tq.tree_size_ - tc.tree_size_) > distance_threshold) {
+          ++statistics.size_pruned;
+          continue;
+        }
+
+        // Stage 2: Label intersection, the size of the larger tree minus the
+        // number of nodes in common.
+        int label_intersection = 0;
+        for (const auto& label_nodes : tc.inverted_list_label_id_to_postl_) {
+          if (label_nodes.first < (int) query_label_counts.size()) {
+            label_intersection += std::min(
+                query_label_counts[label_nodes.first],
+                (int) label_nodes.second.size());
+          }
+        }
+        double lower_bound = std::max(tq.tree_size_, tc.tree_size_) -
+            label_intersection;
+        if (lower_bound > distance_threshold) {
+          ++statistics.label_intersection_pruned;
+          continue;
+        }
+
+        // Stage 3: Upper bound.
+        double upper_bound = upper_bound_algorithm.jedi_k(tq, tc,
+            distance_threshold);
+        if (upper_bound <= distance_threshold) {
+          ++statistics.upper_bound_accepted;
+          chunk_results[chunk_id].emplace_back(query_tree_id,
+              candidate_tree_id, lower_bound, upper_bound, -1);
+          continue;
+        }
+
+        // Stage 4: Verification.
+        ++statistics.verifications;
+        double distance = verification_algorithm.jedi_k(tq, tc,
+            distance_threshold);
+        thread_subproblem_counters[thread_id] +=
+            verification_algorithm.get_subproblem_count();
+        if (distance <= distance_threshold) {
+          ++statistics.verification_accepted;
+          chunk_results[chunk_id].emplace_back(query_tree_id,
+              candidate_tree_id, lower_bound, upper_bound, distance);
+        }
+      }
+    }, [&](const std::size_t id) {
+      result_set.append(chunk_results[id]);
+      std::vector<lookup::LookupResultElement>().swap(chunk_results[id]);
+    });
+  });
+  result_set.flush();
+
+  for (unsigned int t = 0; t < number_of_threads_; ++t) {
+    statistics_.add(thread_statistics[t]);
+    sum_subproblem_counter_ += thread_subproblem_counters[t];
+  }
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+long long int CascadeScan<Label,
+    VerificationAlgorithm, UpperBound>::get_subproblem_count() const {
+  return sum_subproblem_counter_;
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+const CascadeStatistics& CascadeScan<Label,
+    VerificationAlgorithm, UpperBound>::get_statistics() const {
+  return statistics_;
+}
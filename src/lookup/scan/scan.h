@@ -21,10 +21,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
 #include <vector>
 #include "../../node/node.h"
 #include "../../node/tree_indexer.h"
+#include "../../node/tree_index_collection.h"
+#include "../../cost_model/unit_cost_model.h"
+#include "../../data_structures/result_sink.h"
 #include "../lookup_result_element.h"
+#include "../top_k_results.h"
 #include <iostream>
 
 namespace lookup {
@@ -41,14 +48,52 @@ public:
   
   /// Executes the lookup algorithm.
   /**
-   * \param trees_collection A vector holding an input collection of trees.
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
    * \param distance_threshold The maximum number of edit operations that
    *                           differs two trees in the lookup's result set.
    * \return A vector with the lookup result.
    */
   std::vector<lookup::LookupResultElement> execute_lookup(
-      std::vector<node::Node<Label>>& trees_collection,
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
       unsigned int query_tree_id, const double distance_threshold);
+  /// Executes the lookup algorithm and streams the results to a sink.
+  /**
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param query_tree_id Id of the query tree.
+   * \param result_set Sink receiving the lookup results. It is flushed
+   *                   before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the lookup's result set.
+   */
+  void execute_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      unsigned int query_tree_id,
+      data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+      const double distance_threshold);
+  
+  /// Executes a top-k lookup.
+  /**
+   * Returns the k trees with the smallest distance to the query tree, ties
+   * are broken by the smaller tree id. The trees are verified in ascending
+   * difference of their size to the query size, a lower bound of the
+   * distance with unit costs. The k-th best distance so far is the threshold
+   * of the upper bound and the verification; an upper bound equal to the lower
+   * bound is exact and saves the verification. The scan stops once the lower
+   * bound exceeds the threshold.
+   *
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param query_tree_id Id of the query tree.
+   * \param k Number of results.
+   * \return A vector with the k nearest trees in ascending distance.
+   *
+   * Requires a unit cost model, see cost_model::is_unit_cost_model.
+   */
+  std::vector<lookup::LookupResultElement> execute_top_k_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      unsigned int query_tree_id, const unsigned int k);
   
   /// Returns the summed subproblem count of JEDI algorithm executions.
   /**
@@ -80,14 +125,51 @@ public:
   
   /// Executes the lookup algorithm.
   /**
-   * \param trees_collection A vector holding an input collection of trees.
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
    * \param distance_threshold The maximum number of edit operations that
    *                           differs two trees in the lookup's result set.
    * \return A vector with the lookup result.
    */
   std::vector<lookup::LookupResultElement> execute_lookup(
-      std::vector<node::Node<Label>>& trees_collection,
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
       unsigned int query_tree_id, const double distance_threshold);
+  /// Executes the lookup algorithm and streams the results to a sink.
+  /**
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param query_tree_id Id of the query tree.
+   * \param result_set Sink receiving the lookup results. It is flushed
+   *                   before returning.
+   * \param distance_threshold The maximum number of edit operations that
+   *                           differs two trees in the lookup's result set.
+   */
+  void execute_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      unsigned int query_tree_id,
+      data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+      const double distance_threshold);
+  
+  /// Executes a top-k lookup.
+  /**
+   * Returns the k trees with the smallest distance to the query tree, ties
+   * are broken by the smaller tree id. The trees are verified in ascending
+   * difference of their size to the query size, a lower bound of the
+   * distance with unit costs. The k-th best distance so far is the threshold
+   * of the verification. The scan stops once the lower bound exceeds the
+   * threshold.
+   *
+   * \param indexed_collection The indexed input collection of trees. The
+   *                           indexes are reused by all lookups.
+   * \param query_tree_id Id of the query tree.
+   * \param k Number of results.
+   * \return A vector with the k nearest trees in ascending distance.
+   *
+   * Requires a unit cost model, see cost_model::is_unit_cost_model.
+   */
+  std::vector<lookup::LookupResultElement> execute_top_k_lookup(
+      const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+      unsigned int query_tree_id, const unsigned int k);
   
   /// Returns the summed subproblem count of JEDI algorithm executions.
   /**
@@ -26,36 +26,48 @@
 template <typename Label, typename VerificationAlgorithm, typename UpperBound>
 VerificationUBkScan<Label, VerificationAlgorithm, 
     UpperBound>::VerificationUBkScan() {
-  verfications_ = 0;}
+  verfications_ = 0;
+  sum_subproblem_counter_ = 0;
+}
 
 template <typename Label, typename VerificationAlgorithm, typename UpperBound>
 std::vector<lookup::LookupResultElement> 
     VerificationUBkScan<Label, VerificationAlgorithm, UpperBound>::execute_lookup(
-    std::vector<node::Node<Label>>& trees_collection, 
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
     unsigned int query_tree_id, const double distance_threshold) {
+  std::vector<lookup::LookupResultElement> result_set;
+  data_structures::ResultSink<lookup::LookupResultElement> sink(result_set);
+  execute_lookup(indexed_collection, query_tree_id, sink, distance_threshold);
+  return result_set;
+}
 
-  label::LabelDictionary<Label> ld;
-  typename VerificationAlgorithm::AlgsCostModel cm(ld);
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+void VerificationUBkScan<Label, VerificationAlgorithm, UpperBound>::execute_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    unsigned int query_tree_id,
+    data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+    const double distance_threshold) {
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
 
   VerificationAlgorithm verification_algorithm(cm);
   UpperBound upper_bound_algorithm(cm);
-  typename VerificationAlgorithm::AlgsTreeIndex tq;
-  typename VerificationAlgorithm::AlgsTreeIndex tc;
 
-  // Stores the result set.
-  std::vector<lookup::LookupResultElement> result_set;
   // Used to store the computed distance value.
   double distance = std::numeric_limits<double>::infinity();
   double upper_bound = std::numeric_limits<double>::infinity();
 
-  // Index query tree.
-  node::index_tree(tq, trees_collection[query_tree_id], ld, cm);
+  // Indexed query tree.
+  const typename VerificationAlgorithm::AlgsTreeIndex& tq =
+      indexed_collection[query_tree_id];
 
   // Verify which candidate trees are part of the result set.
   for (unsigned int candidate_tree_id = 0; 
-      candidate_tree_id < trees_collection.size(); candidate_tree_id++) {
-    // Index candidate tree.
-    node::index_tree(tc, trees_collection[candidate_tree_id], ld, cm);
+      candidate_tree_id < indexed_collection.size(); candidate_tree_id++) {
+    // Indexed candidate tree.
+    const typename VerificationAlgorithm::AlgsTreeIndex& tc =
+        indexed_collection[candidate_tree_id];
 
     // Compute the upper bound between the query and candidate tree.
     upper_bound = upper_bound_algorithm.jedi_k(tq, tc, distance_threshold);
@@ -73,7 +85,78 @@ std::vector<lookup::LookupResultElement>
     sum_subproblem_counter_ += verification_algorithm.get_subproblem_count();
   }
 
-  return result_set;
+  result_set.flush();
+}
+
+template <typename Label, typename VerificationAlgorithm, typename UpperBound>
+std::vector<lookup::LookupResultElement> 
+    VerificationUBkScan<Label, VerificationAlgorithm, UpperBound>::execute_top_k_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    unsigned int query_tree_id, const unsigned int k) {
+
+  // The size lower bound and the threshold cap below hold for unit costs only.
+  static_assert(cost_model::is_unit_cost_model<
+      typename VerificationAlgorithm::AlgsCostModel>::value,
+      "Top-k lookups require a unit cost model.");
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
+
+  VerificationAlgorithm verification_algorithm(cm);
+  UpperBound upper_bound_algorithm(cm);
+
+  // Stores the k best results.
+  lookup::TopKResults top_k(k);
+  // Used to store the computed distance value.
+  double distance = std::numeric_limits<double>::infinity();
+  double upper_bound = std::numeric_limits<double>::infinity();
+
+  // Indexed query tree.
+  const typename VerificationAlgorithm::AlgsTreeIndex& tq =
+      indexed_collection[query_tree_id];
+
+  // Order the trees by the size lower bound.
+  std::vector<std::pair<int, unsigned int>> candidates;
+  candidates.reserve(indexed_collection.size());
+  for (unsigned int candidate_tree_id = 0; 
+      candidate_tree_id < indexed_collection.size(); candidate_tree_id++) {
+    candidates.emplace_back(std::abs(tq.tree_size_ -
+        indexed_collection[candidate_tree_id].tree_size_), candidate_tree_id);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  for (const auto& candidate : candidates) {
+    double threshold = top_k.get_threshold();
+    // All remaining trees have a lower bound that exceeds the threshold.
+    if (candidate.first > threshold) {
+      break;
+    }
+    // Indexed candidate tree.
+    const typename VerificationAlgorithm::AlgsTreeIndex& tc =
+        indexed_collection[candidate.second];
+
+    // With unit costs, no distance exceeds the sum of the tree sizes.
+    threshold = std::min(threshold, (double) tq.tree_size_ + tc.tree_size_);
+    // Compute the upper bound between the query and candidate tree.
+    upper_bound = upper_bound_algorithm.jedi_k(tq, tc, threshold);
+    if (upper_bound <= candidate.first) {
+      // The upper bound meets the lower bound, hence it is the distance.
+      distance = upper_bound;
+    } else {
+      verfications_++;
+      // The distance does not exceed the upper bound.
+      distance = verification_algorithm.jedi_k(tq, tc,
+          std::min(threshold, upper_bound));
+      // Sum up all number of subproblems
+      sum_subproblem_counter_ += verification_algorithm.get_subproblem_count();
+    }
+    if (distance <= threshold) {
+      top_k.insert(lookup::LookupResultElement(query_tree_id,
+          candidate.second, candidate.first, upper_bound, distance));
+    }
+  }
+
+  return top_k.get_sorted_results();
 }
 
 template <typename Label, typename VerificationAlgorithm, typename UpperBound>
@@ -93,34 +176,45 @@ long long int VerificationUBkScan<Label,
 template <typename Label, typename VerificationAlgorithm>
 VerificationScan<Label, VerificationAlgorithm>::VerificationScan() {
   verfications_ = 0;
+  sum_subproblem_counter_ = 0;
 }
 
 template <typename Label, typename VerificationAlgorithm>
 std::vector<lookup::LookupResultElement> 
     VerificationScan<Label, VerificationAlgorithm>::execute_lookup(
-    std::vector<node::Node<Label>>& trees_collection, 
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
     unsigned int query_tree_id, const double distance_threshold) {
+  std::vector<lookup::LookupResultElement> result_set;
+  data_structures::ResultSink<lookup::LookupResultElement> sink(result_set);
+  execute_lookup(indexed_collection, query_tree_id, sink, distance_threshold);
+  return result_set;
+}
 
-  label::LabelDictionary<Label> ld;
-  typename VerificationAlgorithm::AlgsCostModel cm(ld);
+template <typename Label, typename VerificationAlgorithm>
+void VerificationScan<Label, VerificationAlgorithm>::execute_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    unsigned int query_tree_id,
+    data_structures::ResultSink<lookup::LookupResultElement>& result_set,
+    const double distance_threshold) {
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
 
   VerificationAlgorithm verification_algorithm(cm);
-  typename VerificationAlgorithm::AlgsTreeIndex tq;
-  typename VerificationAlgorithm::AlgsTreeIndex tc;
 
-  // Stores the result set.
-  std::vector<lookup::LookupResultElement> result_set;
   // Used to store the computed distance value.
   double distance = std::numeric_limits<double>::infinity();
 
-  // Index query tree.
-  node::index_tree(tq, trees_collection[query_tree_id], ld, cm);
+  // Indexed query tree.
+  const typename VerificationAlgorithm::AlgsTreeIndex& tq =
+      indexed_collection[query_tree_id];
 
   // Verify which candidate trees are part of the result set.
   for (unsigned int candidate_tree_id = 0; 
-      candidate_tree_id < trees_collection.size(); candidate_tree_id++) {
-    // Index candidate tree.
-    node::index_tree(tc, trees_collection[candidate_tree_id], ld, cm);
+      candidate_tree_id < indexed_collection.size(); candidate_tree_id++) {
+    // Indexed candidate tree.
+    const typename VerificationAlgorithm::AlgsTreeIndex& tc =
+        indexed_collection[candidate_tree_id];
 
     // Compute the distance between the query and candidate tree.
     verfications_++;
@@ -132,7 +226,68 @@ std::vector<lookup::LookupResultElement>
     sum_subproblem_counter_ += verification_algorithm.get_subproblem_count();
   }
 
-  return result_set;
+  result_set.flush();
+}
+
+template <typename Label, typename VerificationAlgorithm>
+std::vector<lookup::LookupResultElement> 
+    VerificationScan<Label, VerificationAlgorithm>::execute_top_k_lookup(
+    const node::TreeIndexCollection<Label, typename VerificationAlgorithm::AlgsTreeIndex>& indexed_collection,
+    unsigned int query_tree_id, const unsigned int k) {
+
+  // The size lower bound and the threshold cap below hold for unit costs only.
+  static_assert(cost_model::is_unit_cost_model<
+      typename VerificationAlgorithm::AlgsCostModel>::value,
+      "Top-k lookups require a unit cost model.");
+
+  typename VerificationAlgorithm::AlgsCostModel cm(
+      indexed_collection.get_label_dictionary());
+
+  VerificationAlgorithm verification_algorithm(cm);
+
+  // Stores the k best results.
+  lookup::TopKResults top_k(k);
+  // Used to store the computed distance value.
+  double distance = std::numeric_limits<double>::infinity();
+
+  // Indexed query tree.
+  const typename VerificationAlgorithm::AlgsTreeIndex& tq =
+      indexed_collection[query_tree_id];
+
+  // Order the trees by the size lower bound.
+  std::vector<std::pair<int, unsigned int>> candidates;
+  candidates.reserve(indexed_collection.size());
+  for (unsigned int candidate_tree_id = 0; 
+      candidate_tree_id < indexed_collection.size(); candidate_tree_id++) {
+    candidates.emplace_back(std::abs(tq.tree_size_ -
+        indexed_collection[candidate_tree_id].tree_size_), candidate_tree_id);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  for (const auto& candidate : candidates) {
+    double threshold = top_k.get_threshold();
+    // All remaining trees have a lower bound that exceeds the threshold.
+    if (candidate.first > threshold) {
+      break;
+    }
+    // Indexed candidate tree.
+    const typename VerificationAlgorithm::AlgsTreeIndex& tc =
+        indexed_collection[candidate.second];
+
+    // With unit costs, no distance exceeds the sum of the tree sizes.
+    threshold = std::min(threshold, (double) tq.tree_size_ + tc.tree_size_);
+    // Compute the distance between the query and candidate tree.
+    verfications_++;
+    distance = verification_algorithm.jedi_k(tq, tc, threshold);
+    if (distance <= threshold) {
+      top_k.insert(lookup::LookupResultElement(query_tree_id,
+          candidate.second, candidate.first, -1, distance));
+    }
+    // Sum up all number of subproblems
+    sum_subproblem_counter_ += verification_algorithm.get_subproblem_count();
+  }
+
+  return top_k.get_sorted_results();
 }
 
 template <typename Label, typename VerificationAlgorithm>
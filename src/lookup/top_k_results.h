@@ -0,0 +1,76 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file lookup/top_k_results.h
+///
+/// \details
+/// Keeps the k best results of a top-k lookup. The distance of the k-th best
+/// result is the threshold a further tree has to meet. It shrinks with every
+/// better result and is passed to the lower bounds, the upper bound, and the
+/// verification of the remaining candidates.
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "lookup_result_element.h"
+
+namespace lookup {
+
+class TopKResults {
+// Member functions.
+public:
+  /// Constructor.
+  ///
+  /// \param k Number of results to keep.
+  TopKResults(const std::size_t k);
+  /// Returns the largest distance a tree may have to become one of the k best
+  /// results. Infinity until k results are known.
+  ///
+  /// \return The current threshold.
+  double get_threshold() const;
+  /// Adds a verified result. It replaces the k-th best result if it has a
+  /// smaller distance, or the same distance and a smaller tree id.
+  ///
+  /// \param result Result with the distance in jedi_value.
+  void insert(const LookupResultElement& result);
+  /// Returns the results in ascending distance and tree id.
+  ///
+  /// \return The k best results, fewer if less trees were inserted.
+  std::vector<LookupResultElement> get_sorted_results() const;
+// Member functions.
+private:
+  /// Orders results by distance, then by the id of the result tree.
+  static bool is_better(const LookupResultElement& a,
+      const LookupResultElement& b);
+// Member variables.
+private:
+  /// Number of results to keep.
+  std::size_t k_;
+  /// Max-heap of the best results, the k-th best result on top.
+  std::vector<LookupResultElement> heap_;
+};
+
+// Implementation details.
+#include "top_k_results_impl.h"
+
+}
@@ -0,0 +1,66 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file lookup/top_k_results_impl.h
+///
+/// \details
+/// Contains the implementation of the TopKResults class.
+
+#pragma once
+
+inline TopKResults::TopKResults(const std::size_t k) : k_(k) {
+  heap_.reserve(k_);
+}
+
+inline double TopKResults::get_threshold() const {
+  if (k_ == 0) {
+    return -std::numeric_limits<double>::infinity();
+  }
+  if (heap_.size() < k_) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return heap_.front().jedi_value;
+}
+
+inline void TopKResults::insert(const LookupResultElement& result) {
+  if (heap_.size() < k_) {
+    heap_.push_back(result);
+    std::push_heap(heap_.begin(), heap_.end(), is_better);
+  } else if (k_ > 0 && is_better(result, heap_.front())) {
+    std::pop_heap(heap_.begin(), heap_.end(), is_better);
+    heap_.back() = result;
+    std::push_heap(heap_.begin(), heap_.end(), is_better);
+  }
+}
+
+inline std::vector<LookupResultElement> TopKResults::get_sorted_results() const {
+  std::vector<LookupResultElement> results = heap_;
+  std::sort_heap(results.begin(), results.end(), is_better);
+  return results;
+}
+
+inline bool TopKResults::is_better(const LookupResultElement& a,
+    const LookupResultElement& b) {
+  if (a.jedi_value != b.jedi_value) {
+    return a.jedi_value < b.jedi_value;
+  }
+  return a.tree_id_2 < b.tree_id_2;
+}
@@ -0,0 +1,108 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file node/compact_tree_impl.h
+///
+/// \details
+/// Contains the implementation of the CompactTree class.
+
+#pragma once
+
+inline CompactTree::CompactTree() {}
+
+template <class Label>
+CompactTree::CompactTree(const Node<Label>& root,
+    label::LabelDictionary<Label>& ld) {
+  // Every stack entry holds a node, the position of its next child to visit,
+  // its label id, and the postorder id of the first node of its subtree.
+  struct Entry {
+    const Node<Label>* node;
+    std::size_t next_child;
+    int label_id;
+    int first_postl;
+  };
+  std::vector<Entry> stack;
+  stack.push_back({&root, 0, ld.insert(root.label()), 0});
+  while (!stack.empty()) {
+    Entry& current = stack.back();
+    const auto& children = current.node->get_children();
+    if (current.next_child < children.size()) {
+      const Node<Label>& child = children[current.next_child++];
+      stack.push_back({&child, 0, ld.insert(child.label()), get_tree_size()});
+    } else {
+      add_node(current.label_id, get_tree_size() - current.first_postl + 1);
+      stack.pop_back();
+    }
+  }
+}
+
+inline int CompactTree::add_node(const int label_id, const int subtree_size) {
+  const int postl = static_cast<int>(postl_to_label_id_.size());
+  postl_to_label_id_.push_back(label_id);
+  postl_to_parent_.push_back(-1);
+  postl_to_size_.push_back(subtree_size);
+  // Walk the children from the rightmost to the leftmost one.
+  for (int child = postl - 1; child > postl - subtree_size;
+      child -= postl_to_size_[child]) {
+    postl_to_parent_[child] = postl;
+  }
+  return postl;
+}
+
+inline void CompactTree::reserve(const int tree_size) {
+  postl_to_label_id_.reserve(tree_size);
+  postl_to_parent_.reserve(tree_size);
+  postl_to_size_.reserve(tree_size);
+}
+
+inline void CompactTree::clear() {
+  postl_to_label_id_.clear();
+  postl_to_parent_.clear();
+  postl_to_size_.clear();
+}
+
+inline int CompactTree::get_tree_size() const {
+  return static_cast<int>(postl_to_label_id_.size());
+}
+
+inline int CompactTree::get_label_id(const int postl) const {
+  return postl_to_label_id_[postl];
+}
+
+inline int CompactTree::get_parent(const int postl) const {
+  return postl_to_parent_[postl];
+}
+
+inline int CompactTree::get_subtree_size(const int postl) const {
+  return postl_to_size_[postl];
+}
+
+inline const std::vector<int>& CompactTree::get_postl_to_label_id() const {
+  return postl_to_label_id_;
+}
+
+inline const std::vector<int>& CompactTree::get_postl_to_parent() const {
+  return postl_to_parent_;
+}
+
+inline const std::vector<int>& CompactTree::get_postl_to_size() const {
+  return postl_to_size_;
+}
@@ -28,6 +28,8 @@
 
 #include <vector>
 #include <string>
+#include <iterator>
+#include <utility>
 
 namespace node {
 
@@ -62,6 +64,14 @@ public:
 // Member functions
 public:
   Node(ConstReference label);
+  Node(Label&& label);
+  Node(const Node<Label>& other) = default;
+  Node(Node<Label>&& other) = default;
+  Node<Label>& operator=(const Node<Label>& other) = default;
+  Node<Label>& operator=(Node<Label>&& other) = default;
+  /// Destructor. Releases the descendants with an explicit stack, such that
+  /// destroying a very deep tree does not overflow the call stack.
+  ~Node();
 
   /// Returns the number of children of this node.
   ///
@@ -73,10 +83,8 @@ public:
   /// \return The label of this node.
   ConstReference label() const;
 
-  /// Adds a child at last position.
-  /// TODO: Verify this definition. Can we improve it with & or &&? It is
-  ///       used to build the tree in a parser.
-  /// TODO: Verify if child is copied or moved.
+  /// Adds a child at last position. The child is moved into children_, so
+  /// passing an rvalue (as the parser does) copies no nodes.
   ///
   /// \param Node to be added.
   Node<Label>& add_child(Node<Label> child);
@@ -87,16 +95,16 @@ public:
   const std::vector<Node<Label>>& get_children() const;
 
   /// Calculates the size (number of nodes) in tree rooted at this. It traverses
-  /// the entire subtree recursively.
+  /// the entire subtree with an explicit stack.
   ///
   /// \return Size of subtree rooted at this.
   int get_tree_size() const;
 
-  /// Traverses the tree and collects string representations of all labels.
+  /// Traverses the tree in preorder and collects string representations of
+  /// all labels.
   ///
   /// \return Vector with labels of all nodes.
   const std::vector<std::string> get_all_labels() const;
-  void get_all_labels_recursion(std::vector<std::string>& labels) const;
 
   /// Verifies if this node is a leaf.
   ///
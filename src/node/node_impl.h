@@ -29,6 +29,27 @@
 template<class Label>
 Node<Label>::Node(ConstReference label) : label_(label) {}
 
+template<class Label>
+Node<Label>::Node(Label&& label) : label_(std::move(label)) {}
+
+template<class Label>
+Node<Label>::~Node() {
+  if (children_.empty()) {
+    return;
+  }
+  // Move the descendants level by level into a local stack. Every node is
+  // destroyed after its children have been moved out, so the destructor
+  // calls do not nest.
+  std::vector<Node<Label>> descendants = std::move(children_);
+  while (!descendants.empty()) {
+    Node<Label> current = std::move(descendants.back());
+    descendants.pop_back();
+    std::move(current.children_.begin(), current.children_.end(),
+        std::back_inserter(descendants));
+    current.children_.clear();
+  }
+}
+
 template<class Label>
 const typename Node<Label>::SizeType Node<Label>::children_count() const {
   return children_.size();
@@ -41,7 +62,7 @@ typename Node<Label>::ConstReference Node<Label>::label() const {
 
 template<class Label>
 Node<Label>& Node<Label>::add_child(Node<Label> child) {
-  children_.push_back(child);
+  children_.push_back(std::move(child));
   return children_.back();
 }
 
@@ -52,9 +73,15 @@ const std::vector<Node<Label>>& Node<Label>::get_children() const {
 
 template<class Label>
 int Node<Label>::get_tree_size() const {
-  int size = 1;
-  for (const auto& child : children_) {
-    size += child.get_tree_size();
+  int size = 0;
+  std::vector<const Node<Label>*> stack = {this};
+  while (!stack.empty()) {
+    const Node<Label>* current = stack.back();
+    stack.pop_back();
+    ++size;
+    for (const auto& child : current->children_) {
+      stack.push_back(&child);
+    }
   }
   return size;
 }
@@ -62,15 +89,21 @@ int Node<Label>::get_tree_size() const {
 template<class Label>
 const std::vector<std::string> Node<Label>::get_all_labels() const {
   std::vector<std::string> labels;
-  get_all_labels_recursion(labels);
-  return labels;
-}
-template<class Label>
-void Node<Label>::get_all_labels_recursion(std::vector<std::string>& labels) const {
   labels.push_back(label_.to_string());
-  for (const auto& child : children_) {
-    child.get_all_labels_recursion(labels);
+  // Every stack entry holds a node and the position of its next child to
+  // visit. A node's label is collected when it is put on the stack.
+  std::vector<std::pair<const Node<Label>*, SizeType>> stack = {{this, 0}};
+  while (!stack.empty()) {
+    const Node<Label>* current = stack.back().first;
+    if (stack.back().second < current->children_.size()) {
+      const Node<Label>& child = current->children_[stack.back().second++];
+      labels.push_back(child.label_.to_string());
+      stack.emplace_back(&child, 0);
+    } else {
+      stack.pop_back();
+    }
   }
+  return labels;
 }
 
 template<class Label>
@@ -0,0 +1,192 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file node/tree_index_arena.h
+///
+/// \details
+/// Storage of the per-node indexes of a TreeIndex. All per-node arrays of a
+/// TreeIndex are slices of one contiguous buffer (an arena) that is sized
+/// from the tree size. The buffer is reused when the same TreeIndex object
+/// indexes another tree that fits in it.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace node {
+
+/// Array of values of a per-node index.
+/**
+ * The values are not owned by the array but by the IndexArena of the
+ * TreeIndex. The interface is the subset of std::vector that is used by the
+ * algorithms.
+ */
+template <typename T>
+class IndexArray {
+public:
+  typedef T value_type;
+  /// Constructor. Creates an empty array.
+  IndexArray() : data_(nullptr), size_(0) {}
+  /// Points the array to size values starting at data.
+  void reset(T* data, const std::size_t size) {
+    data_ = data;
+    size_ = size;
+  }
+  T& operator[](const std::size_t i) { return data_[i]; }
+  const T& operator[](const std::size_t i) const { return data_[i]; }
+  /// Bounds-checked access.
+  const T& at(const std::size_t i) const {
+    if (i >= size_) {
+      throw std::out_of_range("IndexArray::at: index out of range");
+    }
+    return data_[i];
+  }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  T* data() { return data_; }
+  const T* data() const { return data_; }
+  T* begin() { return data_; }
+  T* end() { return data_ + size_; }
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+private:
+  /// First value.
+  T* data_;
+  /// Number of values.
+  std::size_t size_;
+};
+
+/// Per-node lists of values stored in compressed sparse row (CSR) layout.
+/**
+ * The list of node i consists of values_[offsets_[i]] to
+ * values_[offsets_[i+1]-1]. Used for, e.g., the children of every node.
+ */
+template <typename T>
+class IndexListArray {
+public:
+  typedef T value_type;
+  /// Read-only view of the list of one node.
+  class List {
+  public:
+    List(const T* begin, const T* end) : begin_(begin), end_(end) {}
+    const T& operator[](const std::size_t i) const { return begin_[i]; }
+    std::size_t size() const { return end_ - begin_; }
+    bool empty() const { return begin_ == end_; }
+    const T* begin() const { return begin_; }
+    const T* end() const { return end_; }
+  private:
+    const T* begin_;
+    const T* end_;
+  };
+  /// Returns the list of node i.
+  List operator[](const std::size_t i) const {
+    return List(values_.data() + offsets_[i], values_.data() + offsets_[i + 1]);
+  }
+  /// Returns the number of nodes.
+  std::size_t size() const {
+    return offsets_.empty() ? 0 : offsets_.size() - 1;
+  }
+  /// Positions of the first value of every node's list. Has one more element
+  /// than the number of nodes.
+  IndexArray<int> offsets_;
+  /// Values of all lists.
+  IndexArray<T> values_;
+};
+
+/// Contiguous buffer holding all per-node arrays of a TreeIndex.
+/**
+ * The arena is not copyable because the IndexArray objects of the TreeIndex
+ * point into its buffer. Moving keeps the buffer and thus the arrays valid.
+ * The moved-from arena is empty and allocates a new buffer on its next
+ * reset.
+ */
+class IndexArena {
+public:
+  /// Constructor. Creates an empty arena.
+  IndexArena() : capacity_(0), used_(0) {}
+  IndexArena(const IndexArena&) = delete;
+  IndexArena& operator=(const IndexArena&) = delete;
+  /// Move constructor. Leaves other empty.
+  IndexArena(IndexArena&& other) noexcept
+      : buffer_(std::move(other.buffer_)), capacity_(other.capacity_),
+        used_(other.used_) {
+    other.capacity_ = 0;
+    other.used_ = 0;
+  }
+  /// Move assignment. Leaves other empty.
+  IndexArena& operator=(IndexArena&& other) noexcept {
+    if (this != &other) {
+      buffer_ = std::move(other.buffer_);
+      capacity_ = other.capacity_;
+      used_ = other.used_;
+      other.capacity_ = 0;
+      other.used_ = 0;
+    }
+    return *this;
+  }
+  /// Returns the number of bytes occupied by an array of size values of type
+  /// T in the arena.
+  template <typename T>
+  static std::size_t get_slice_size(const std::size_t size) {
+    return (size * sizeof(T) + kAlignment - 1) / kAlignment * kAlignment;
+  }
+  /// Discards all slices and makes sure that the buffer has at least
+  /// size bytes. The buffer only grows.
+  void reset(const std::size_t size) {
+    if (size > capacity_) {
+      buffer_.reset(new unsigned char[size]);
+      capacity_ = size;
+    }
+    used_ = 0;
+  }
+  /// Points array to the next size value-initialised values of the buffer.
+  template <typename T>
+  void assign(IndexArray<T>& array, const std::size_t size) {
+    static_assert(std::is_trivially_destructible<T>::value,
+        "IndexArena stores only trivially destructible values.");
+    const std::size_t slice_size = get_slice_size<T>(size);
+    if (used_ + slice_size > capacity_) {
+      throw std::length_error("IndexArena::assign: arena is too small");
+    }
+    T* data = reinterpret_cast<T*>(buffer_.get() + used_);
+    std::uninitialized_fill_n(data, size, T());
+    array.reset(data, size);
+    used_ += slice_size;
+  }
+  /// Returns the number of bytes of the buffer.
+  std::size_t get_capacity() const { return capacity_; }
+private:
+  /// Alignment of every slice. Sufficient for all fundamental types.
+  static constexpr std::size_t kAlignment = alignof(std::max_align_t);
+  /// The buffer.
+  std::unique_ptr<unsigned char[]> buffer_;
+  /// Number of bytes of the buffer.
+  std::size_t capacity_;
+  /// Number of bytes assigned to arrays.
+  std::size_t used_;
+};
+
+}
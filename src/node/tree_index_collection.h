@@ -0,0 +1,112 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file node/tree_index_collection.h
+///
+/// \details
+/// Stores a TreeIndex for every tree of a collection. Every tree is indexed
+/// once and its index is reused by all algorithm executions that involve the
+/// tree, e.g., by the verification of all candidate pairs in a join.
+
+#pragma once
+
+#include <vector>
+#include "node.h"
+#include "compact_tree.h"
+#include "tree_indexer.h"
+#include "../label/label_dictionary.h"
+
+namespace node {
+
+/// \class TreeIndexCollection
+///
+/// \details
+/// A collection of indexed trees. The tree ids are the positions of the trees
+/// in the input collection.
+///
+/// The collection owns the LabelDictionary that assigns the label ids of all
+/// indexed trees. Cost models used with the indexes must be constructed with
+/// this dictionary (see get_label_dictionary).
+///
+/// To index a tree for multiple algorithms, use a TreeIndexUnion.
+///
+/// \tparam Label Label type of the trees.
+/// \tparam TreeIndex Type of the index stored for every tree.
+template <typename Label, typename TreeIndex>
+class TreeIndexCollection {
+// Member functions.
+public:
+  /// Constructor. Creates an empty collection.
+  TreeIndexCollection();
+  /// Indexes all trees in trees_collection. Previous indexes are discarded.
+  ///
+  /// \param trees_collection A vector holding an input collection of trees.
+  /// \param cm Cost model constructed with get_label_dictionary().
+  template <typename CostModel>
+  void build(const std::vector<node::Node<Label>>& trees_collection,
+      const CostModel& cm);
+  /// Indexes all trees in trees_collection. Previous indexes are discarded.
+  ///
+  /// \param trees_collection A vector of trees whose label ids have been
+  ///                         assigned by get_label_dictionary(), e.g., by
+  ///                         parsing them with this dictionary.
+  /// \param cm Cost model constructed with get_label_dictionary().
+  template <typename CostModel>
+  void build(const std::vector<node::CompactTree>& trees_collection,
+      const CostModel& cm);
+  /// Indexes number_of_trees trees that are produced one at a time by
+  /// get_tree, e.g., read from a file. Previous indexes are discarded. Only
+  /// one tree is kept in memory at a time.
+  ///
+  /// \param number_of_trees Number of trees.
+  /// \param get_tree Callable returning the tree (a node::Node<Label> or a
+  ///                 node::CompactTree with label ids of
+  ///                 get_label_dictionary()) at a position.
+  /// \param cm Cost model constructed with get_label_dictionary().
+  template <typename TreeFunction, typename CostModel>
+  void build(const std::size_t number_of_trees, TreeFunction get_tree,
+      const CostModel& cm);
+  /// Returns the index of a tree.
+  ///
+  /// \param tree_id Position of the tree in the indexed collection.
+  /// \return TreeIndex of the tree.
+  const TreeIndex& operator[](const std::size_t tree_id) const;
+  /// Returns the number of indexed trees.
+  ///
+  /// \return The number of indexed trees.
+  std::size_t size() const;
+  /// Returns the LabelDictionary that assigns the label ids in the indexes.
+  ///
+  /// \return The LabelDictionary of this collection.
+  label::LabelDictionary<Label>& get_label_dictionary();
+  const label::LabelDictionary<Label>& get_label_dictionary() const;
+// Member variables.
+private:
+  /// LabelDictionary shared by all indexed trees.
+  label::LabelDictionary<Label> ld_;
+  /// TreeIndex of every tree in the collection.
+  std::vector<TreeIndex> tree_indexes_;
+};
+
+// Implementation details.
+#include "tree_index_collection_impl.h"
+
+}
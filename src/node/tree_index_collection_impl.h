@@ -0,0 +1,89 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file node/tree_index_collection_impl.h
+///
+/// \details
+/// Contains the implementation of the TreeIndexCollection class.
+
+#pragma once
+
+template <typename Label, typename TreeIndex>
+TreeIndexCollection<Label, TreeIndex>::TreeIndexCollection() {}
+
+template <typename Label, typename TreeIndex>
+template <typename CostModel>
+void TreeIndexCollection<Label, TreeIndex>::build(
+    const std::vector<node::Node<Label>>& trees_collection,
+    const CostModel& cm) {
+  tree_indexes_.clear();
+  tree_indexes_.resize(trees_collection.size());
+  for (std::size_t tree_id = 0; tree_id < trees_collection.size(); ++tree_id) {
+    node::index_tree(tree_indexes_[tree_id], trees_collection[tree_id], ld_, cm);
+  }
+}
+
+template <typename Label, typename TreeIndex>
+template <typename CostModel>
+void TreeIndexCollection<Label, TreeIndex>::build(
+    const std::vector<node::CompactTree>& trees_collection,
+    const CostModel& cm) {
+  tree_indexes_.clear();
+  tree_indexes_.resize(trees_collection.size());
+  for (std::size_t tree_id = 0; tree_id < trees_collection.size(); ++tree_id) {
+    node::index_tree(tree_indexes_[tree_id], trees_collection[tree_id], ld_, cm);
+  }
+}
+
+template <typename Label, typename TreeIndex>
+template <typename TreeFunction, typename CostModel>
+void TreeIndexCollection<Label, TreeIndex>::build(
+    const std::size_t number_of_trees, TreeFunction get_tree,
+    const CostModel& cm) {
+  tree_indexes_.clear();
+  tree_indexes_.resize(number_of_trees);
+  for (std::size_t tree_id = 0; tree_id < number_of_trees; ++tree_id) {
+    node::index_tree(tree_indexes_[tree_id], get_tree(tree_id), ld_, cm);
+  }
+}
+
+template <typename Label, typename TreeIndex>
+const TreeIndex& TreeIndexCollection<Label, TreeIndex>::operator[](
+    const std::size_t tree_id) const {
+  return tree_indexes_[tree_id];
+}
+
+template <typename Label, typename TreeIndex>
+std::size_t TreeIndexCollection<Label, TreeIndex>::size() const {
+  return tree_indexes_.size();
+}
+
+template <typename Label, typename TreeIndex>
+label::LabelDictionary<Label>&
+    TreeIndexCollection<Label, TreeIndex>::get_label_dictionary() {
+  return ld_;
+}
+
+template <typename Label, typename TreeIndex>
+const label::LabelDictionary<Label>&
+    TreeIndexCollection<Label, TreeIndex>::get_label_dictionary() const {
+  return ld_;
+}
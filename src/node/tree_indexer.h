@@ -28,16 +28,23 @@
 #include <string>
 #include <type_traits>
 #include <algorithm>
+#include "tree_index_arena.h"
+#include "compact_tree.h"
 #include "../label/label_dictionary.h"
 #include "../cost_model/unit_cost_model.h"
 
 namespace node {
 
 /// Stores the size of the indexed tree.
+/**
+ * Holds also the arena with the values of all per-node indexes. Every
+ * TreeIndex is derived from Constants.
+ */
 class Constants {
   public: int tree_size_;
   public: int tree_degree_;
   public: int tree_height_;
+  public: IndexArena index_arena_;
 };
 
 /// Stores label id of each node in a tree.
@@ -47,7 +54,7 @@ class Constants {
  * Indexed in left-to-right preorder.
  */
 class PreLToLabelId {
-  public: std::vector<int> prel_to_label_id_;
+  public: IndexArray<int> prel_to_label_id_;
 };
 
 /// Stores label id of each node in a tree.
@@ -57,7 +64,7 @@ class PreLToLabelId {
  * Indexed in left-to-right postorder.
  */
 class PostLToLabelId {
-  public: std::vector<int> postl_to_label_id_;
+  public: IndexArray<int> postl_to_label_id_;
 };
 
 /// Stores the type of each node in a tree.
@@ -65,7 +72,7 @@ class PostLToLabelId {
  * Indexed in left-to-right postorder.
  */
 class PostLToType {
-  public: std::vector<int> postl_to_type_;
+  public: IndexArray<int> postl_to_type_;
 };
 
 /// Stores label id of each node in a tree.
@@ -75,7 +82,7 @@ class PostLToType {
  * Indexed in right-to-left postorder.
  */
 class PostRToLabelId {
-  public: std::vector<int> postr_to_label_id_;
+  public: IndexArray<int> postr_to_label_id_;
 };
 
 /// Stores subtree size of each node in a tree.
@@ -83,7 +90,7 @@ class PostRToLabelId {
  * Indexed in left-to-right postorder.
  */
 class PostLToSize {
-  public: std::vector<int> postl_to_size_;
+  public: IndexArray<int> postl_to_size_;
 };
 
 /// Stores subtree size of each node in a tree.
@@ -91,7 +98,7 @@ class PostLToSize {
  * Indexed in left-to-right preorder.
  */
 class PreLToSize {
-  public: std::vector<int> prel_to_size_;
+  public: IndexArray<int> prel_to_size_;
 };
 
 /// Stores left-to-right postorder id of the parent node.
@@ -100,7 +107,7 @@ class PreLToSize {
  * `-1` represents no parent.
  */
 class PostLToParent {
-  public: std::vector<int> postl_to_parent_;
+  public: IndexArray<int> postl_to_parent_;
 };
 
 /// Stores left-to-right preorder id of the parent node.
@@ -109,7 +116,7 @@ class PostLToParent {
  * `-1` represents no parent.
  */
 class PreLToParent {
-  public: std::vector<int> prel_to_parent_;
+  public: IndexArray<int> prel_to_parent_;
 };
 
 /// Stores left-to-right postorder id of the leftmost leaf descendant of a node.
@@ -117,7 +124,7 @@ class PreLToParent {
  * Indexed in left-to-right postorder.
  */
 class PostLToLLD {
-  public: std::vector<int> postl_to_lld_;
+  public: IndexArray<int> postl_to_lld_;
 };
 
 /// Stores left-to-right preorder id of the leftmost leaf descendant of a node.
@@ -125,7 +132,7 @@ class PostLToLLD {
  * Indexed in left-to-right preorder.
  */
 class PreLToLLD {
-  public: std::vector<int> prel_to_lld_;
+  public: IndexArray<int> prel_to_lld_;
 };
 
 /// Stores left-to-right preorder id of the rightmost leaf descendant of a node.
@@ -133,7 +140,7 @@ class PreLToLLD {
  * Indexed in left-to-right preorder.
  */
 class PreLToRLD {
-  public: std::vector<int> prel_to_rld_;
+  public: IndexArray<int> prel_to_rld_;
 };
 
 /// Stores right-to-left postorder id of the rightmost leaf descendant of a node.
@@ -142,7 +149,7 @@ class PreLToRLD {
  * Depends on: PreLToSize, PostRToPreL, PreLToPostR, PreLToChildren.
  */
 class PostRToRLD {
-  public: std::vector<int> postr_to_rld_;
+  public: IndexArray<int> postr_to_rld_;
 };
 
 /// Stores left-to-right preorder id of each node.
@@ -150,7 +157,7 @@ class PostRToRLD {
  * Indexed in left-to-right postorder.
  */
 class PostLToPreL {
-  public: std::vector<int> postl_to_prel_;
+  public: IndexArray<int> postl_to_prel_;
 };
 
 /// Stores left-to-right postorder id of each node.
@@ -158,7 +165,7 @@ class PostLToPreL {
  * Indexed in left-to-right preorder.
  */
 class PreLToPostL {
-  public: std::vector<int> prel_to_postl_;
+  public: IndexArray<int> prel_to_postl_;
 };
 
 /// Stores right-to-left preorder id of each node.
@@ -166,7 +173,7 @@ class PreLToPostL {
  * Indexed in left-to-right preorder.
  */
 class PreLToPreR {
-  public: std::vector<int> prel_to_prer_;
+  public: IndexArray<int> prel_to_prer_;
 };
 
 /// Stores left-to-right preorder id of each node.
@@ -174,7 +181,7 @@ class PreLToPreR {
  * Indexed in right-to-left preorder.
  */
 class PreRToPreL {
-  public: std::vector<int> prer_to_prel_;
+  public: IndexArray<int> prer_to_prel_;
 };
 
 /// Stores right-to-left postorder id of each node.
@@ -182,7 +189,7 @@ class PreRToPreL {
  * Indexed in left-to-right preorder.
  */
 class PreLToPostR {
-  public: std::vector<int> prel_to_postr_;
+  public: IndexArray<int> prel_to_postr_;
 };
 
 /// Stores left-to-right preorder id of each node.
@@ -190,7 +197,7 @@ class PreLToPostR {
  * Indexed in right-to-left postorder.
  */
 class PostRToPreL {
-  public: std::vector<int> postr_to_prel_;
+  public: IndexArray<int> postr_to_prel_;
 };
 
 /// Stores left-to-right postorder ids of each node's children.
@@ -198,7 +205,7 @@ class PostRToPreL {
  * Indexed in left-to-right postorder.
  */
 class PostLToChildren {
-  public: std::vector<std::vector<int>> postl_to_children_;
+  public: IndexListArray<int> postl_to_children_;
 };
 
 /// Stores left-to-right preorder ids of each node's children.
@@ -206,7 +213,7 @@ class PostLToChildren {
  * Indexed in left-to-right preorder.
  */
 class PreLToChildren {
-  public: std::vector<std::vector<int>> prel_to_children_;
+  public: IndexListArray<int> prel_to_children_;
 };
 
 /// Stores depth of every node in the tree.
@@ -215,7 +222,7 @@ class PreLToChildren {
  * Depth of the root node is 0.
  */
 class PostLToDepth {
-  public: std::vector<int> postl_to_depth_;
+  public: IndexArray<int> postl_to_depth_;
 };
 
 /// Stores left-to-right postorder id of the leftmost (first) child for each node.
@@ -224,7 +231,7 @@ class PostLToDepth {
  * '-1' represents no child.
  */
 class PostLToLCh {
-  public: std::vector<int> postl_to_lch_;
+  public: IndexArray<int> postl_to_lch_;
 };
 
 /// Stores the maximum depth for each subtree.
@@ -233,7 +240,7 @@ class PostLToLCh {
  * Depth of the root node is 0.
  */
 class PostLToSubtreeMaxDepth {
-  public: std::vector<int> postl_to_subtree_max_depth_;
+  public: IndexArray<int> postl_to_subtree_max_depth_;
 };
 
 /// Stores the left-to-right postorder id of the nearest keyroot ancestor.
@@ -243,7 +250,7 @@ class PostLToSubtreeMaxDepth {
  * Depends on: PostLToLCh, ListKR.
  */
 class PostLToKRAncestor {
-  public: std::vector<int> postl_to_kr_ancestor_;
+  public: IndexArray<int> postl_to_kr_ancestor_;
 };
 
 // Stores preorder id of the first leaf node to the left/right.
@@ -254,8 +261,8 @@ class PostLToKRAncestor {
  * Depends on: PreLToSize, PreRToPreL.
  */
 class PreToLn {
-  public: std::vector<int> prel_to_ln_;
-  public: std::vector<int> prer_to_ln_;
+  public: IndexArray<int> prel_to_ln_;
+  public: IndexArray<int> prer_to_ln_;
 };
 
 // Stores true if a node is leftmost child of its parent.
@@ -263,7 +270,7 @@ class PreToLn {
  * Indexed in left-to-right preorder.
  */
 class PreLToTypeLeft {
-  public: std::vector<bool> prel_to_type_left_;
+  public: IndexArray<bool> prel_to_type_left_;
 };
 
 // Stores true if a node is rightmost child of its parent.
@@ -271,7 +278,7 @@ class PreLToTypeLeft {
  * Indexed in left-to-right preorder.
  */
 class PreLToTypeRight {
-  public: std::vector<bool> prel_to_type_right_;
+  public: IndexArray<bool> prel_to_type_right_;
 };
 
 // Stores cost of a single-path function for each node [1, Section 5.2].
@@ -282,9 +289,9 @@ class PreLToTypeRight {
  * Indexed in left-to-right preorder.
  */
 class PreLToSpfCost {
-  public: std::vector<long long int> prel_to_cost_all_;
-  public: std::vector<long long int> prel_to_cost_left_;
-  public: std::vector<long long int> prel_to_cost_right_;
+  public: IndexArray<long long int> prel_to_cost_all_;
+  public: IndexArray<long long int> prel_to_cost_left_;
+  public: IndexArray<long long int> prel_to_cost_right_;
 };
 
 // Stores cost of deleting/inserting entire subtree for each node.
@@ -294,8 +301,8 @@ class PreLToSpfCost {
  * Indexed in left-to-right preorder.
  */
 class PreLToSubtreeCost {
-  public: std::vector<double> prel_to_subtree_del_cost_;
-  public: std::vector<double> prel_to_subtree_ins_cost_;
+  public: IndexArray<double> prel_to_subtree_del_cost_;
+  public: IndexArray<double> prel_to_subtree_ins_cost_;
 };
 
 /// Stores postorder ids of the keyroot nodes in the tree.
@@ -333,8 +340,8 @@ class InvertedListLabelIdToPostL {
  * Indexed in left-to-right postorder.
  */
 class PostLToFavChild {
-  public: std::vector<int> postl_to_fav_child_;
-  public: std::vector<int> postl_to_left_fav_child_;
+  public: IndexArray<int> postl_to_fav_child_;
+  public: IndexArray<int> postl_to_left_fav_child_;
 };
 
 /// Stores the height of each node in a tree.
@@ -342,7 +349,7 @@ class PostLToFavChild {
  * Indexed in left-to-right postorder.
  */
 class PostLToHeight {
-  public: std::vector<int> postl_to_height_;
+  public: IndexArray<int> postl_to_height_;
 };
 
 /// Stores the subtree sizes of all children in ascending order.
@@ -350,7 +357,7 @@ class PostLToHeight {
  * Indexed in left-to-right postorder.
  */
 class PostLToOrderedChildSize {
-  public: std::vector<std::vector<int>> postl_to_ordered_child_size_;
+  public: IndexListArray<int> postl_to_ordered_child_size_;
 };
 
 /// Stores postorder to favorable child order.
@@ -358,7 +365,7 @@ class PostLToOrderedChildSize {
  * Indexed in left-to-right postorder.
  */
 class PostLToFavorableChildOrder {
-  public: std::vector<int> postl_to_favorder_;
+  public: IndexArray<int> postl_to_favorder_;
 };
 
 /// Stores postorder to left sibling.
@@ -366,7 +373,7 @@ class PostLToFavorableChildOrder {
  * Indexed in left-to-right postorder.
  */
 class PostLToLeftSibling {
-  public: std::vector<int> postl_to_left_sibling_;
+  public: IndexArray<int> postl_to_left_sibling_;
 };
 
 /// Tree index for Zhangh and Shasha algorithm.
@@ -554,10 +561,96 @@ class TreeIndexAll :
   public PostLToLeftSibling
 {};
 
+/// Placeholder for an index that TreeIndexUnion does not add.
+/**
+ * TreeIndex is a part of the type only to keep the placeholders of nested
+ * TreeIndexUnion classes distinct.
+ */
+template <typename Index, typename TreeIndex>
+class NoIndex {};
+
+/// Selects Index if OtherTreeIndex has it and TreeIndex does not.
+/**
+ * Otherwise, selects an empty placeholder.
+ */
+template <typename Index, typename TreeIndex, typename OtherTreeIndex>
+using UnionIndex = typename std::conditional<
+    std::is_base_of<Index, OtherTreeIndex>::value &&
+    !std::is_base_of<Index, TreeIndex>::value,
+    Index, NoIndex<Index, TreeIndex>>::type;
+
+/// Tree index with all indexes of TreeIndex and OtherTreeIndex.
+/**
+ * It is derived from TreeIndex. Hence, it can be passed to an algorithm that
+ * takes TreeIndex (e.g., VerificationAlgorithm::AlgsTreeIndex) and used as the
+ * TreeIndex parameter of an algorithm that requires a superset of
+ * OtherTreeIndex (e.g., ted_ub::LGMTreeIndex). A tree has to be indexed only
+ * once for both algorithms.
+ *
+ * Union of more than two tree indexes can be created by nesting, e.g.,
+ * TreeIndexUnion<TreeIndexUnion<A, B>, C>.
+ */
+template <typename TreeIndex, typename OtherTreeIndex>
+class TreeIndexUnion :
+  public TreeIndex,
+  public UnionIndex<Constants, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToLabelId, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToType, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToLabelId, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostRToLabelId, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToSize, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToSize, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToPreL, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToPostL, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToPreR, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreRToPreL, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToPostR, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostRToPreL, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToChildren, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToChildren, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToLLD, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToLLD, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToRLD, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostRToRLD, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToParent, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToParent, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToDepth, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToLCh, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToSubtreeMaxDepth, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToKRAncestor, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreToLn, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToTypeLeft, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToTypeRight, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToSpfCost, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PreLToSubtreeCost, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<ListKR, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<InvertedListDepthToPostL, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<InvertedListLabelIdToPostL, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToFavChild, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToHeight, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToOrderedChildSize, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToFavorableChildOrder, TreeIndex, OtherTreeIndex>,
+  public UnionIndex<PostLToLeftSibling, TreeIndex, OtherTreeIndex>
+{};
+
+/// Calls f(array, size) for every per-node array of the indexes in ti.
+/**
+ * The arrays of an IndexListArray are passed separately. size is the number
+ * of values of the array for a tree with tree_size nodes.
+ *
+ * \param ti Tree index.
+ * \param tree_size Number of nodes of the tree.
+ * \param f Function called for every array.
+ */
+template <typename TreeIndex, typename Function>
+void for_each_index_array(TreeIndex& ti, const int tree_size, Function f);
+
 /// Main method to index a tree.
 /**
- * It executes further recursive tree traversal. It also resets the indexes
- * and sets their length.
+ * It converts the tree to a CompactTree and indexes it (see the CompactTree
+ * variant), so the traversal uses no recursion. It also resets the indexes
+ * and sets their length. All per-node arrays are placed in the arena of ti
+ * (see Constants), which is allocated only if it is too small for the tree.
  *
  * \param ti Tree index.
  * \param n Root node of the input tree.
@@ -567,29 +660,40 @@ template <typename TreeIndex, typename Label, typename CostModel>
 void index_tree(TreeIndex& ti, const node::Node<Label>& n,
     label::LabelDictionary<Label>& ld, const CostModel& cm);
 
-/// Recursive tree traversal method that indexes a tree.
+/// Indexes a CompactTree.
 /**
- * Based on TreeIndex class, only index members of TreeIndex are filled in.
+ * Fills the same indexes with the same values as index_tree for the
+ * equivalent Node tree. The tree is traversed in a loop over postorder, so
+ * the tree depth is not limited by the call stack.
+ *
+ * The label ids of t are used as they are. They must have been assigned by
+ * ld, e.g., by parsing t with ld.
  *
  * \param ti Tree index.
- * \param n Root node of the input tree.
- * \param ld LabelDictionary to collect node labels and assign their ids.
+ * \param t Input tree.
+ * \param ld LabelDictionary that assigned the label ids of t.
  * \param cm CostModel - used for PreLToSubtreeCost indexes.
- * \param start_preorder Variable to hold current preorder id; modified during the recursion.
- * \param start_postorder Variable to hold current postorder id; modified during the recursion.
- * \param start_depth Variable to hold current depth of a node.
- * \param subtree_max_depth Variable to hold current maximum depth of a subtree; modified during the recursion.
- * \param parent_preorder The left-to-right preorder id of a parent node.
- * \param is_rightmost_child Is true if the node is the rightmost child of its parent.
- * \return Subtree size rooted at node n.
  */
 template <typename TreeIndex, typename Label, typename CostModel>
-int index_tree_recursion(TreeIndex& ti, const node::Node<Label>& n,
-    label::LabelDictionary<Label>& ld, const CostModel& cm,
-    int& start_preorder, int& start_postorder,
-    int start_depth, int& subtree_max_depth,
-    int start_height, int& height,
-    int parent_preorder, bool is_rightmost_child);
+void index_tree(TreeIndex& ti, const node::CompactTree& t,
+    const label::LabelDictionary<Label>& ld, const CostModel& cm);
+
+/// Resets the indexes of ti and sets their length for a tree of tree_size
+/// nodes. Used by all index_tree variants before the traversal.
+/**
+ * \param ti Tree index.
+ * \param tree_size Number of nodes of the tree.
+ */
+template <typename TreeIndex>
+void init_tree_index(TreeIndex& ti, const int tree_size);
+
+/// Fills the indexes that are derived from other indexes after the
+/// traversal. Used by all index_tree variants.
+/**
+ * \param ti Tree index.
+ */
+template <typename TreeIndex>
+void fill_derived_indexes(TreeIndex& ti);
 
 // TODO: Combine fill_kr_ancestors, fill_ln, and fill_rld into a single
 //       function. Check the base type inside.
@@ -598,31 +702,35 @@ int index_tree_recursion(TreeIndex& ti, const node::Node<Label>& n,
 /**
  * See description of the class PostLToKRAncestor.
  */
-void fill_kr_ancestors(std::vector<int>& kr_ancestors,
-    const std::vector<int>& postl_to_lch, const std::vector<int>& list_kr);
+void fill_kr_ancestors(IndexArray<int>& kr_ancestors,
+    const IndexArray<int>& postl_to_lch, const std::vector<int>& list_kr);
 
 /// Fills in the PreToLn indexes.
 /**
  * See description of the classes PreToLn.
  */
-void fill_ln(std::vector<int>& prel_to_ln,
-    std::vector<int>& prer_to_ln,
-    const std::vector<int>& prel_to_size,
-    const std::vector<int>& prer_to_prel);
+void fill_ln(IndexArray<int>& prel_to_ln,
+    IndexArray<int>& prer_to_ln,
+    const IndexArray<int>& prel_to_size,
+    const IndexArray<int>& prer_to_prel);
 
 /// Fills in the PostRToRLD indexes.
 /**
  * See description of the classes PostRToRLD.
  */
-void fill_rld(std::vector<int>& postr_to_rld,
-    const std::vector<int>& prel_to_size,
-    const std::vector<int>& postr_to_prel,
-    const std::vector<int>& prel_to_postr,
-    const std::vector<std::vector<int>>& prel_to_children);
+void fill_rld(IndexArray<int>& postr_to_rld,
+    const IndexArray<int>& prel_to_size,
+    const IndexArray<int>& postr_to_prel,
+    const IndexArray<int>& prel_to_postr,
+    const IndexListArray<int>& prel_to_children);
 
+/// Fills in the PostLToFavorableChildOrder index.
+/**
+ * Visits the nodes in postorder, but processes the favorable child of every
+ * node before its other children. Uses an explicit stack.
+ */
 template <typename TreeIndex>
-void fav_child_processing_order(TreeIndex& ti, int& postorder, 
-    int& favorder);
+void fav_child_processing_order(TreeIndex& ti);
 
 // Implementation details
 #include "tree_indexer_impl.h"
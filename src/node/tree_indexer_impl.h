@@ -24,114 +24,313 @@
 template <typename TreeIndex, typename Label, typename CostModel>
 void index_tree(TreeIndex& ti, const node::Node<Label>& n,
     label::LabelDictionary<Label>& ld, const CostModel& cm) {
-  
-  int tree_size = n.get_tree_size();
-  ti.tree_size_ = tree_size;
-  
-  // Resize and clear the indexes.
-  // TODO: Resizing is not enough for some vectors in case the same TreeIndex
-  //       object is used for multiple trees. Old incorrect values may remain
-  //       in the vectors.
-  if constexpr (std::is_base_of<PostLToSize, TreeIndex>::value) {
-    ti.postl_to_size_.resize(tree_size);
+  // The conversion inserts the labels in preorder and the CompactTree is
+  // indexed in one loop over its nodes. Neither recurses.
+  index_tree(ti, CompactTree(n, ld), ld, cm);
+}
+
+template <typename TreeIndex, typename Label, typename CostModel>
+void index_tree(TreeIndex& ti, const node::CompactTree& t,
+    const label::LabelDictionary<Label>& ld, const CostModel& cm) {
+
+  const int tree_size = t.get_tree_size();
+  init_tree_index(ti, tree_size);
+  if (tree_size == 0) {
+    return;
+  }
+
+  const std::vector<int>& postl_to_label_id = t.get_postl_to_label_id();
+  const std::vector<int>& postl_to_parent = t.get_postl_to_parent();
+  const std::vector<int>& postl_to_size = t.get_postl_to_size();
+
+  // Depth and left-to-right preorder id of every node. The reverse postorder
+  // visits every parent before its children. In preorder, a node is preceded
+  // by its ancestors and by the nodes left of its subtree, which are the
+  // nodes before its leftmost leaf descendant in postorder.
+  std::vector<int> postl_to_depth(tree_size);
+  std::vector<int> postl_to_prel(tree_size);
+  for (int postl = tree_size - 1; postl >= 0; --postl) {
+    const int parent = postl_to_parent[postl];
+    postl_to_depth[postl] = parent == -1 ? 0 : postl_to_depth[parent] + 1;
+    postl_to_prel[postl] = postl_to_depth[postl] + postl -
+        postl_to_size[postl] + 1;
+  }
+
+  // Position of every node among its siblings. A node is the leftmost child
+  // if its subtree starts where the subtree of its parent starts. Otherwise,
+  // its left sibling directly precedes its subtree.
+  std::vector<int> postl_to_child_position(tree_size);
+  auto is_first_child = [&](const int postl, const int parent) {
+    return postl - postl_to_size[postl] == parent - postl_to_size[parent];
+  };
+  for (int postl = 0; postl < tree_size - 1; ++postl) {
+    const int parent = postl_to_parent[postl];
+    if (!is_first_child(postl, parent)) {
+      postl_to_child_position[postl] =
+          postl_to_child_position[postl - postl_to_size[postl]] + 1;
+    }
+    // Count the children of the parent in the list offsets. The offsets are
+    // summed up below.
+    if constexpr (std::is_base_of<PostLToChildren, TreeIndex>::value) {
+      ++ti.postl_to_children_.offsets_[parent + 1];
+    }
+    if constexpr (std::is_base_of<PreLToChildren, TreeIndex>::value) {
+      ++ti.prel_to_children_.offsets_[postl_to_prel[parent] + 1];
+    }
   }
-  if constexpr (std::is_base_of<PreLToSize, TreeIndex>::value) {
-    ti.prel_to_size_.resize(tree_size);
+  for (int i = 0; i < tree_size; ++i) {
+    if constexpr (std::is_base_of<PostLToChildren, TreeIndex>::value) {
+      ti.postl_to_children_.offsets_[i + 1] += ti.postl_to_children_.offsets_[i];
+    }
+    if constexpr (std::is_base_of<PreLToChildren, TreeIndex>::value) {
+      ti.prel_to_children_.offsets_[i + 1] += ti.prel_to_children_.offsets_[i];
+    }
+  }
+
+  if constexpr (std::is_base_of<PostLToFavChild, TreeIndex>::value) {
+    std::fill(ti.postl_to_fav_child_.begin(), ti.postl_to_fav_child_.end(), -1);
+    std::fill(ti.postl_to_left_fav_child_.begin(),
+        ti.postl_to_left_fav_child_.end(), -1);
   }
+
+  // Subtree sizes of the children of a node.
+  std::vector<int> children_sorted_subtree_size;
+
+  // Visit the nodes in postorder. Every node is visited after its children,
+  // so the values that a node derives from its children (e.g., height or
+  // subtree costs) are accumulated in the parent's entries.
+  for (int postl = 0; postl < tree_size; ++postl) {
+    const int label_id = postl_to_label_id[postl];
+    const int size = postl_to_size[postl];
+    const int parent = postl_to_parent[postl];
+    const int prel = postl_to_prel[postl];
+    const int depth = postl_to_depth[postl];
+    const int parent_prel = parent == -1 ? -1 : postl_to_prel[parent];
+    const bool is_leaf = size == 1;
+    const bool is_leftmost_child = parent != -1 &&
+        is_first_child(postl, parent);
+    const bool is_rightmost_child = parent != -1 && postl == parent - 1;
+    // Left sibling, -1 for leftmost children.
+    const int left_sibling = is_leftmost_child ? -1 : postl - size;
+    const int preorder_r = tree_size - 1 - postl;
+    const int postorder_r = tree_size - 1 - prel;
+
+    if constexpr (std::is_base_of<PostLToSize, TreeIndex>::value) {
+      ti.postl_to_size_[postl] = size;
+    }
+    if constexpr (std::is_base_of<PreLToSize, TreeIndex>::value) {
+      ti.prel_to_size_[prel] = size;
+    }
+    if constexpr (std::is_base_of<PostLToParent, TreeIndex>::value) {
+      ti.postl_to_parent_[postl] = parent;
+    }
+    if constexpr (std::is_base_of<PreLToParent, TreeIndex>::value) {
+      ti.prel_to_parent_[prel] = parent_prel;
+    }
+    if constexpr (std::is_base_of<PostLToPreL, TreeIndex>::value) {
+      ti.postl_to_prel_[postl] = prel;
+    }
+    if constexpr (std::is_base_of<PreLToPostL, TreeIndex>::value) {
+      ti.prel_to_postl_[prel] = postl;
+    }
+    if constexpr (std::is_base_of<PreLToPreR, TreeIndex>::value) {
+      ti.prel_to_prer_[prel] = preorder_r;
+    }
+    if constexpr (std::is_base_of<PreRToPreL, TreeIndex>::value) {
+      ti.prer_to_prel_[preorder_r] = prel;
+    }
+    if constexpr (std::is_base_of<PreLToPostR, TreeIndex>::value) {
+      ti.prel_to_postr_[prel] = postorder_r;
+    }
+    if constexpr (std::is_base_of<PostRToPreL, TreeIndex>::value) {
+      ti.postr_to_prel_[postorder_r] = prel;
+    }
+    if constexpr (std::is_base_of<PostLToChildren, TreeIndex>::value) {
+      if (parent != -1) {
+        ti.postl_to_children_.values_[ti.postl_to_children_.offsets_[parent] +
+            postl_to_child_position[postl]] = postl;
+      }
+    }
+    if constexpr (std::is_base_of<PreLToChildren, TreeIndex>::value) {
+      if (parent != -1) {
+        ti.prel_to_children_.values_[ti.prel_to_children_.offsets_[parent_prel] +
+            postl_to_child_position[postl]] = prel;
+      }
+    }
+    if constexpr (std::is_base_of<PreLToLabelId, TreeIndex>::value) {
+      ti.prel_to_label_id_[prel] = label_id;
+    }
+    if constexpr (std::is_base_of<PostLToLabelId, TreeIndex>::value) {
+      ti.postl_to_label_id_[postl] = label_id;
+    }
+    if constexpr (std::is_base_of<PostLToType, TreeIndex>::value) {
+      ti.postl_to_type_[postl] = ld.get(label_id).get_type();
+    }
+    if constexpr (std::is_base_of<InvertedListLabelIdToPostL, TreeIndex>::value) {
+      ti.inverted_list_label_id_to_postl_[label_id].push_back(postl);
+    }
+    if constexpr (std::is_base_of<PostRToLabelId, TreeIndex>::value) {
+      ti.postr_to_label_id_[postorder_r] = label_id;
+    }
+    if constexpr (std::is_base_of<PostLToDepth, TreeIndex>::value) {
+      ti.postl_to_depth_[postl] = depth;
+    }
+    if constexpr (std::is_base_of<InvertedListDepthToPostL, TreeIndex>::value) {
+      if (static_cast<int>(ti.inverted_list_depth_to_postl_.size()) < depth + 1) {
+        ti.inverted_list_depth_to_postl_.resize(depth + 1);
+      }
+      ti.inverted_list_depth_to_postl_[depth].push_back(postl);
+    }
+    if constexpr (std::is_base_of<PostLToSubtreeMaxDepth, TreeIndex>::value) {
+      // The entry of an inner node holds the maximum of its children.
+      if (is_leaf) {
+        ti.postl_to_subtree_max_depth_[postl] = depth;
+      }
+      if (parent != -1) {
+        ti.postl_to_subtree_max_depth_[parent] = std::max(
+            ti.postl_to_subtree_max_depth_[parent],
+            ti.postl_to_subtree_max_depth_[postl]);
+      }
+    }
+    if constexpr (std::is_base_of<PostLToHeight, TreeIndex>::value) {
+      // The entry of an inner node holds the maximum of its children plus 1.
+      if (parent != -1) {
+        ti.postl_to_height_[parent] = std::max(ti.postl_to_height_[parent],
+            ti.postl_to_height_[postl] + 1);
+      }
+    }
+    if constexpr (std::is_base_of<PostLToLCh, TreeIndex>::value) {
+      if (is_leaf) {
+        ti.postl_to_lch_[postl] = -1;
+      }
+      if (is_leftmost_child) {
+        ti.postl_to_lch_[parent] = postl;
+      }
+    }
+    if constexpr (std::is_base_of<PostLToLLD, TreeIndex>::value) {
+      ti.postl_to_lld_[postl] = postl - size + 1;
+    }
+    if constexpr (std::is_base_of<PreLToLLD, TreeIndex>::value) {
+      ti.prel_to_lld_[prel] = postl_to_prel[postl - size + 1];
+    }
+    if constexpr (std::is_base_of<PreLToRLD, TreeIndex>::value) {
+      ti.prel_to_rld_[prel] = prel + size - 1;
+    }
+    if constexpr (std::is_base_of<PreLToTypeLeft, TreeIndex>::value) {
+      if (is_leftmost_child) {
+        ti.prel_to_type_left_[prel] = true;
+      }
+    }
+    if constexpr (std::is_base_of<PreLToTypeRight, TreeIndex>::value) {
+      if (is_rightmost_child) {
+        ti.prel_to_type_right_[prel] = true;
+      }
+    }
+    // The subtree of a node contributes to the costs of its parent before
+    // the node's own costs are finalized.
+    if constexpr (std::is_base_of<PreLToSpfCost, TreeIndex>::value) {
+      ti.prel_to_cost_all_[prel] += size;
+      if (parent != -1) {
+        ti.prel_to_cost_all_[parent_prel] += ti.prel_to_cost_all_[prel];
+        ti.prel_to_cost_left_[parent_prel] += ti.prel_to_cost_left_[prel];
+        ti.prel_to_cost_right_[parent_prel] += ti.prel_to_cost_right_[prel];
+        if (!is_leftmost_child) {
+          ti.prel_to_cost_left_[parent_prel] += size;
+        }
+        if (!is_rightmost_child) {
+          ti.prel_to_cost_right_[parent_prel] += size;
+        }
+      }
+      ti.prel_to_cost_all_[prel] =
+          size * (size + 3) / 2 - ti.prel_to_cost_all_[prel];
+      ti.prel_to_cost_left_[prel] += size;
+      ti.prel_to_cost_right_[prel] += size;
+    }
+    if constexpr (std::is_base_of<PreLToSubtreeCost, TreeIndex>::value) {
+      ti.prel_to_subtree_del_cost_[prel] += cm.del(label_id);
+      ti.prel_to_subtree_ins_cost_[prel] += cm.ins(label_id);
+      if (parent != -1) {
+        ti.prel_to_subtree_del_cost_[parent_prel] +=
+            ti.prel_to_subtree_del_cost_[prel];
+        ti.prel_to_subtree_ins_cost_[parent_prel] +=
+            ti.prel_to_subtree_ins_cost_[prel];
+      }
+    }
+    if constexpr (std::is_base_of<PostLToFavChild, TreeIndex>::value) {
+      // The leftmost child with the largest subtree.
+      if (parent != -1) {
+        const int favorable_child = ti.postl_to_fav_child_[parent];
+        if (favorable_child == -1 || size > postl_to_size[favorable_child]) {
+          ti.postl_to_fav_child_[parent] = postl;
+          ti.postl_to_left_fav_child_[parent] = left_sibling;
+        }
+      }
+    }
+    if constexpr (std::is_base_of<PostLToLeftSibling, TreeIndex>::value) {
+      if (parent != -1) {
+        ti.postl_to_left_sibling_[postl] = left_sibling;
+      }
+    }
+    if constexpr (std::is_base_of<PostLToOrderedChildSize, TreeIndex>::value) {
+      // Prefix sums of the children's subtree sizes in ascending order.
+      children_sorted_subtree_size.clear();
+      for (int child = postl - 1; child > postl - size;
+          child -= postl_to_size[child]) {
+        children_sorted_subtree_size.push_back(postl_to_size[child]);
+      }
+      std::sort(children_sorted_subtree_size.begin(),
+          children_sorted_subtree_size.end());
+      int* offsets = ti.postl_to_ordered_child_size_.offsets_.data();
+      int* values = ti.postl_to_ordered_child_size_.values_.data() +
+          offsets[postl];
+      int sum = 0;
+      for (const int child_size : children_sorted_subtree_size) {
+        sum += child_size;
+        *values++ = sum;
+      }
+      offsets[postl + 1] = offsets[postl] +
+          children_sorted_subtree_size.size();
+    }
+    if constexpr (std::is_base_of<ListKR, TreeIndex>::value) {
+      // Every node but the leftmost children is a key root. The root is added
+      // last.
+      if (parent != -1 && !is_leftmost_child) {
+        ti.list_kr_.push_back(postl);
+      }
+    }
+  }
+
+  if constexpr (std::is_base_of<ListKR, TreeIndex>::value) {
+    ti.list_kr_.push_back(tree_size - 1);
+  }
+
+  fill_derived_indexes(ti);
+}
+
+template <typename TreeIndex>
+void init_tree_index(TreeIndex& ti, const int tree_size) {
+  ti.tree_size_ = tree_size;
+  
+  // Place all per-node arrays in the arena of ti. The arena grows only, such
+  // that indexing many trees with the same TreeIndex object allocates only
+  // for the largest tree. The arrays are value-initialised.
+  std::size_t arena_size = 0;
+  for_each_index_array(ti, tree_size, [&arena_size](auto& array, const int size) {
+    using T = typename std::decay<decltype(array)>::type::value_type;
+    arena_size += IndexArena::get_slice_size<T>(size);
+  });
+  ti.index_arena_.reset(arena_size);
+  for_each_index_array(ti, tree_size, [&ti](auto& array, const int size) {
+    ti.index_arena_.assign(array, size);
+  });
+
+  // Initialise the indexes that do not default to zero.
   if constexpr (std::is_base_of<PostLToParent, TreeIndex>::value) {
-    ti.postl_to_parent_.resize(tree_size);
     std::fill(ti.postl_to_parent_.begin(), ti.postl_to_parent_.end(), -1);
   }
   if constexpr (std::is_base_of<PreLToParent, TreeIndex>::value) {
-    ti.prel_to_parent_.resize(tree_size);
     std::fill(ti.prel_to_parent_.begin(), ti.prel_to_parent_.end(), -1);
   }
-  if constexpr (std::is_base_of<PostLToPreL, TreeIndex>::value) {
-    ti.postl_to_prel_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PreLToPostL, TreeIndex>::value) {
-    ti.prel_to_postl_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PreLToPreR, TreeIndex>::value) {
-    ti.prel_to_prer_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PreRToPreL, TreeIndex>::value) {
-    ti.prer_to_prel_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PreLToPostR, TreeIndex>::value) {
-    ti.prel_to_postr_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostRToPreL, TreeIndex>::value) {
-    ti.postr_to_prel_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToChildren, TreeIndex>::value) {
-    ti.postl_to_children_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PreLToChildren, TreeIndex>::value) {
-    ti.prel_to_children_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PreLToLabelId, TreeIndex>::value) {
-    ti.prel_to_label_id_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToLabelId, TreeIndex>::value) {
-    ti.postl_to_label_id_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToType, TreeIndex>::value) {
-    ti.postl_to_type_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostRToLabelId, TreeIndex>::value) {
-    ti.postr_to_label_id_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToLLD, TreeIndex>::value) {
-    ti.postl_to_lld_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PreLToLLD, TreeIndex>::value) {
-    ti.prel_to_lld_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PreLToRLD, TreeIndex>::value) {
-    ti.prel_to_rld_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostRToRLD, TreeIndex>::value) {
-    ti.postr_to_rld_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToDepth, TreeIndex>::value) {
-    ti.postl_to_depth_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToLCh, TreeIndex>::value) {
-    ti.postl_to_lch_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToSubtreeMaxDepth, TreeIndex>::value) {
-    ti.postl_to_subtree_max_depth_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToKRAncestor, TreeIndex>::value) {
-    ti.postl_to_kr_ancestor_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PreToLn, TreeIndex>::value) {
-    ti.prel_to_ln_.resize(tree_size);
-    ti.prer_to_ln_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PreLToTypeLeft, TreeIndex>::value) {
-    ti.prel_to_type_left_.resize(tree_size);
-    std::fill(ti.prel_to_type_left_.begin(), ti.prel_to_type_left_.end(), false);
-  }
-  if constexpr (std::is_base_of<PreLToTypeRight, TreeIndex>::value) {
-    ti.prel_to_type_right_.resize(tree_size);
-    std::fill(ti.prel_to_type_right_.begin(), ti.prel_to_type_right_.end(), false);
-  }
-  if constexpr (std::is_base_of<PreLToSpfCost, TreeIndex>::value) {
-    ti.prel_to_cost_all_.resize(tree_size);
-    std::fill(ti.prel_to_cost_all_.begin(), ti.prel_to_cost_all_.end(), 0);
-    ti.prel_to_cost_left_.resize(tree_size);
-    std::fill(ti.prel_to_cost_left_.begin(), ti.prel_to_cost_left_.end(), 0);
-    ti.prel_to_cost_right_.resize(tree_size);
-    std::fill(ti.prel_to_cost_right_.begin(), ti.prel_to_cost_right_.end(), 0);
-  }
-  if constexpr (std::is_base_of<PreLToSubtreeCost, TreeIndex>::value) {
-    ti.prel_to_subtree_del_cost_.resize(tree_size);
-    std::fill(ti.prel_to_subtree_del_cost_.begin(), ti.prel_to_subtree_del_cost_.end(), 0.0);
-    ti.prel_to_subtree_ins_cost_.resize(tree_size);
-    std::fill(ti.prel_to_subtree_ins_cost_.begin(), ti.prel_to_subtree_ins_cost_.end(), 0.0);
-  }
   if constexpr (std::is_base_of<ListKR, TreeIndex>::value) {
     ti.list_kr_.clear();
   }
@@ -141,48 +340,13 @@ void index_tree(TreeIndex& ti, const node::Node<Label>& n,
   if constexpr (std::is_base_of<InvertedListLabelIdToPostL, TreeIndex>::value) {
     ti.inverted_list_label_id_to_postl_.clear();
   }
-  if constexpr (std::is_base_of<PostLToFavChild, TreeIndex>::value) {
-    ti.postl_to_fav_child_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToFavChild, TreeIndex>::value) {
-    ti.postl_to_left_fav_child_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToHeight, TreeIndex>::value) {
-    ti.postl_to_height_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToOrderedChildSize, TreeIndex>::value) {
-    ti.postl_to_ordered_child_size_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToFavorableChildOrder, TreeIndex>::value) {
-    ti.postl_to_favorder_.resize(tree_size);
-  }
-  if constexpr (std::is_base_of<PostLToLeftSibling, TreeIndex>::value) {
-    ti.postl_to_left_sibling_.resize(tree_size);
-  }
-
-  // Orders start with '0'. Are modified by the recursive traversal.
-  int start_preorder = 0;
-  int start_postorder = 0;
-  int start_depth = 0;
-  int start_height = 0;
+}
 
-  // Maximum input tree depth - the first reference passed to recursion.
-  int subtree_max_depth = 0;
-  // Initial height.
-  int height = 0;
-  index_tree_recursion(ti, n, ld, cm, start_preorder, start_postorder,
-      start_depth, subtree_max_depth, start_height, height, -1, false);
-  
+template <typename TreeIndex>
+void fill_derived_indexes(TreeIndex& ti) {
   if constexpr (std::is_base_of<PostLToFavorableChildOrder, TreeIndex>::value) {
     // Compute favorable child order.
-    int ts = tree_size - 1;
-    int fid = 0;
-    fav_child_processing_order(ti, ts, fid);
-  }
-
-  if constexpr (std::is_base_of<ListKR, TreeIndex>::value) {
-    // Add root to kr - not added in the recursion.
-    ti.list_kr_.push_back(start_postorder-1);
+    fav_child_processing_order(ti);
   }
 
   if constexpr (std::is_base_of<PostLToKRAncestor, TreeIndex>::value) {
@@ -199,463 +363,200 @@ void index_tree(TreeIndex& ti, const node::Node<Label>& n,
   }
 }
 
-template <typename TreeIndex, typename Label, typename CostModel>
-int index_tree_recursion(TreeIndex& ti, const node::Node<Label>& n,
-    label::LabelDictionary<Label>& ld, const CostModel& cm,
-    int& start_preorder, int& start_postorder,
-    int start_depth, int& subtree_max_depth,
-    int start_height, int& height,
-    int parent_preorder, bool is_rightmost_child) {
-  
-  // Stores number of descendants of this node. Incrementally computed while
-  // traversing the children.
-  int desc_sum = 0;
-
-  // Stores the current node's label id.
-  int label_id = ld.insert(n.label());
-
-  // Stores the current node's type.
-  int type = n.label().get_type();
-
-  // Here, start_preorder holds this node's preorder id.
-  
-  int preorder_r = 0;
-  int postorder_r = 0;
-
-  // This node's preorder id.
-  int this_nodes_preorder = start_preorder;
-
-  // Increment start_preorder to hold the correct id of the consecutive node
-  // in preorder.
-  ++start_preorder;
-  
-  // To store postorder ids of this node's children.
-  std::vector<int> children_postorders;
-  // To store preorder ids of this node's children.
-  std::vector<int> children_preorders;
-  // Store the height of all children.
-  std::vector<int> children_sorted_subtree_size;
-
-  // InvertedListDepthToPostL index
-  if constexpr (std::is_base_of<InvertedListDepthToPostL, TreeIndex>::value) {
-    // Add a vector for depth=start_depth in depth inverted list.
-    // NOTE: `inverted_list_depth_to_postl_.size()`` returns an `unsigned int`.
-    //       If `inverted_list_depth_to_postl_.size = 0`, then
-    //       substracting 1 causes incorrect validation of the condition.
-    if (static_cast<int>(ti.inverted_list_depth_to_postl_.size()) < (start_depth + 1)) {
-      ti.inverted_list_depth_to_postl_.push_back(std::vector<int>());
+void fill_kr_ancestors(IndexArray<int>& postl_to_kr_ancestor,
+    const IndexArray<int>& postl_to_lch, const std::vector<int>& list_kr) {
+  for (auto i : list_kr) {
+    int l = i;
+    while (l >= 0) {
+      postl_to_kr_ancestor[l] = i;
+      l = postl_to_lch[l];
     }
   }
-  
-  // This node's subtree max depth.
-  int this_subtree_max_depth = 0;
-  // This node's height.
-  int this_height = 0;
-
-  // To store if the current child in the loop is rightmost.
-  bool is_current_child_rightmost = false;
-
-  // Treat the first child separately (non-key-root, updates parent's lld).
-  int first_child_postorder = -1;
-  // Number of nodes of children subtrees.
-  int subtree_size_child = -1;
-  // Number of nodes of the child with the largest subtree.
-  int largest_subtree_size_child = -1;
-  // Postorder number of the favorable child.
-  int favorable_child = -1;
-  // Postorder number of the left sibling of the favorable child.
-  int left_fav_child = -1;
-  // Postorder number of the previous child.
-  int previous_child_po = -1;
-  // Count number of children.
-  int num_children = 0;
-  // Recursions to childen nodes.
-  auto children_start_it = std::begin(n.get_children());
-  auto children_end_it = std::end(n.get_children());
-
-  while (children_start_it != children_end_it) {
-    // Add the preoder of the current child to children_preorders.
-    children_preorders.push_back(start_preorder);
-
-    // Check if this child is rightmost.
-    if(std::next(children_start_it) == children_end_it) {
-      is_current_child_rightmost = true;
-    }
-
-    // PreLToParent index
-    if constexpr (std::is_base_of<PreLToParent, TreeIndex>::value) {
-      ti.prel_to_parent_[start_preorder] = this_nodes_preorder;
-    }
-    
-    subtree_size_child = index_tree_recursion(ti, *children_start_it, ld, cm,
-        start_preorder, start_postorder, start_depth + 1,
-        this_subtree_max_depth, start_height, height,
-        this_nodes_preorder, is_current_child_rightmost);
-    desc_sum += subtree_size_child;
-    
-    // Add the postorder of the current child to children_postorders.
-    children_postorders.push_back(start_postorder-1);
-    
-    // PostLToFavChild index
-    if constexpr (std::is_base_of<PostLToFavChild, TreeIndex>::value) {
-      if (subtree_size_child > largest_subtree_size_child) {
-        largest_subtree_size_child = subtree_size_child;
-        left_fav_child = previous_child_po;
-        favorable_child = start_postorder-1;
-      }
-    }
-
-    // PostLToHeight index
-    if constexpr (std::is_base_of<PostLToHeight, TreeIndex>::value) {
-      if (height > this_height) {
-        this_height = height;
-      }
-    }
+}
 
-    // PostLToLeftSibling index
-    if constexpr (std::is_base_of<PostLToLeftSibling, TreeIndex>::value) {
-      ti.postl_to_left_sibling_[start_postorder-1] = previous_child_po;
+void fill_ln(IndexArray<int>& prel_to_ln,
+    IndexArray<int>& prer_to_ln,
+    const IndexArray<int>& prel_to_size,
+    const IndexArray<int>& prer_to_prel) {
+  int current_leaf_prel = -1;
+  int current_leaf_prer = -1;
+  for(int i = 0; i < prel_to_size[0]; ++i) {
+    prel_to_ln[i] = current_leaf_prel;
+    if(prel_to_size[i] == 1) {
+      current_leaf_prel = i;
     }
-    
-    if constexpr (std::is_base_of<PostLToHeight, TreeIndex>::value) {
-      children_sorted_subtree_size.push_back(subtree_size_child);
+    prer_to_ln[i] = current_leaf_prer;
+    if(prel_to_size[prer_to_prel[i]] == 1) {
+      current_leaf_prer = i;
     }
+  }
+}
 
-    // Treat the first child separately.
-    if (children_start_it == n.get_children().begin()) {
-      // Here, start_postorder-1 is the postorder of the current child.
-      // Set this node's lld to its first child's lld.
-      first_child_postorder = start_postorder-1;
+void fill_rld(IndexArray<int>& postr_to_rld,
+    const IndexArray<int>& prel_to_size,
+    const IndexArray<int>& postr_to_prel,
+    const IndexArray<int>& prel_to_postr,
+    const IndexListArray<int>& prel_to_children) {
+  // The loop iterates over right-to-left postorder.
+  int preorder = 0;
+  for(int i = 0; i < prel_to_size[0]; ++i) {
+    preorder = postr_to_prel[i];
+    if (prel_to_size[preorder] == 1) {
+      postr_to_rld[i] = i;
     } else {
-      if constexpr (std::is_base_of<ListKR, TreeIndex>::value) {
-        // Add current child to kr.
-        ti.list_kr_.push_back(start_postorder-1);
-      }
+      postr_to_rld[i] = postr_to_rld[prel_to_postr[prel_to_children[preorder][prel_to_children[preorder].size()-1]]];
     }
-    
-    ++num_children;
-
-    previous_child_po = start_postorder-1;
-    
-    // Continue to consecutive children.
-    ++children_start_it;
   }
+}
 
-  // Here, start_postorder holds this node's postorder id.
-  
-  // Calculate right-to-left preorder.
-  preorder_r = ti.tree_size_ - 1 - start_postorder;
-  
-  // Calculate right-to-left postorder.
-  postorder_r = ti.tree_size_ - 1 - this_nodes_preorder;
-  
-  // PostLToFavChild index
-  if constexpr (std::is_base_of<PostLToFavChild, TreeIndex>::value) {
-    ti.postl_to_fav_child_[start_postorder] = favorable_child;
-    ti.postl_to_left_fav_child_[start_postorder] = left_fav_child;
-  }
-
-  // PostLToOrderedChildSize
-  if constexpr (std::is_base_of<PostLToOrderedChildSize, TreeIndex>::value) {
-    // Sort all children by subtree size.
-    std::sort (children_sorted_subtree_size.begin(), children_sorted_subtree_size.end());
-
-    // Removing subtree costs sorted ascending.
-    std::vector<int> children_subtree_deletion_costs;
-    // Iterate over all children and sum up the costs.
-    int current_child = 0;
-    for (std::vector<int>::iterator it=children_sorted_subtree_size.begin(); it!=children_sorted_subtree_size.end(); ++it) {
-      current_child = children_subtree_deletion_costs.size();
-      if (current_child == 0) {
-        children_subtree_deletion_costs.push_back(*it);
-      } else {
-        children_subtree_deletion_costs.push_back(children_subtree_deletion_costs[current_child-1] + *it);
+template <typename TreeIndex>
+void fav_child_processing_order(TreeIndex& ti) {
+  // Every stack entry holds a node and the position of its next child to
+  // process. Position -1 means that the favorable child is processed next.
+  std::vector<std::pair<int, int>> stack = {{ti.tree_size_ - 1, -1}};
+  int favorder = 0;
+  while (!stack.empty()) {
+    const int postorder = stack.back().first;
+    const auto children = ti.postl_to_children_[postorder];
+    const int favorable_child = ti.postl_to_fav_child_[postorder];
+    int& position = stack.back().second;
+    // First process the favorable child.
+    if (position == -1) {
+      position = 0;
+      if (children.size() != 0) {
+        stack.emplace_back(favorable_child, -1);
       }
+      continue;
     }
-    ti.postl_to_ordered_child_size_[start_postorder] = children_subtree_deletion_costs;
-  }
-
-  // PostLToHeight index
-  if constexpr (std::is_base_of<PostLToHeight, TreeIndex>::value) {
-    height = this_height + 1;
-    ti.postl_to_height_[start_postorder] = height;
+    // Next, process all other children in left to right order. The
+    // favorable child was processed before.
+    while (position < static_cast<int>(children.size()) &&
+        children[position] == favorable_child) {
+      ++position;
+    }
+    if (position < static_cast<int>(children.size())) {
+      const int child = children[position++];
+      stack.emplace_back(child, -1);
+      continue;
+    }
+    // Assign favorder to postorder after all children.
+    ti.postl_to_favorder_[favorder++] = postorder;
+    stack.pop_back();
   }
+}
 
-  // PostLToSize index
+template <typename TreeIndex, typename Function>
+void for_each_index_array(TreeIndex& ti, const int tree_size, Function f) {
+  // Number of values of lists with an element for every non-root node.
+  const int non_root_nodes = std::max(tree_size - 1, 0);
   if constexpr (std::is_base_of<PostLToSize, TreeIndex>::value) {
-    ti.postl_to_size_[start_postorder] = desc_sum + 1;
+    f(ti.postl_to_size_, tree_size);
   }
-  
-  // PreLToSize index
   if constexpr (std::is_base_of<PreLToSize, TreeIndex>::value) {
-    ti.prel_to_size_[this_nodes_preorder] = desc_sum + 1;
+    f(ti.prel_to_size_, tree_size);
   }
-  
-  // PostLToParent index
   if constexpr (std::is_base_of<PostLToParent, TreeIndex>::value) {
-    for (const auto& child_id : children_postorders) {
-      ti.postl_to_parent_[child_id] = start_postorder;
-    }
+    f(ti.postl_to_parent_, tree_size);
+  }
+  if constexpr (std::is_base_of<PreLToParent, TreeIndex>::value) {
+    f(ti.prel_to_parent_, tree_size);
   }
-  
-  // PostLToPreL index
   if constexpr (std::is_base_of<PostLToPreL, TreeIndex>::value) {
-    ti.postl_to_prel_[start_postorder] = this_nodes_preorder;
+    f(ti.postl_to_prel_, tree_size);
   }
-  
-  // PreLToPostL index
   if constexpr (std::is_base_of<PreLToPostL, TreeIndex>::value) {
-    ti.prel_to_postl_[this_nodes_preorder] = start_postorder;
+    f(ti.prel_to_postl_, tree_size);
   }
-  
-  // PreLToPreR index
   if constexpr (std::is_base_of<PreLToPreR, TreeIndex>::value) {
-    ti.prel_to_prer_[this_nodes_preorder] = preorder_r;
+    f(ti.prel_to_prer_, tree_size);
   }
-  
-  // PreRToPreL index
   if constexpr (std::is_base_of<PreRToPreL, TreeIndex>::value) {
-    ti.prer_to_prel_[preorder_r] = this_nodes_preorder;
+    f(ti.prer_to_prel_, tree_size);
   }
-  
-  // PreLToPostR index
   if constexpr (std::is_base_of<PreLToPostR, TreeIndex>::value) {
-    ti.prel_to_postr_[this_nodes_preorder] = postorder_r;
+    f(ti.prel_to_postr_, tree_size);
   }
-  
-  // PostRToPreL index
   if constexpr (std::is_base_of<PostRToPreL, TreeIndex>::value) {
-    ti.postr_to_prel_[postorder_r] = this_nodes_preorder;
+    f(ti.postr_to_prel_, tree_size);
   }
-  
-  // PostLToChildren index
   if constexpr (std::is_base_of<PostLToChildren, TreeIndex>::value) {
-    ti.postl_to_children_[start_postorder] = children_postorders;
+    f(ti.postl_to_children_.offsets_, tree_size + 1);
+    f(ti.postl_to_children_.values_, non_root_nodes);
   }
-  
-  // PreLToChildren index
   if constexpr (std::is_base_of<PreLToChildren, TreeIndex>::value) {
-    ti.prel_to_children_[this_nodes_preorder] = children_preorders;
+    f(ti.prel_to_children_.offsets_, tree_size + 1);
+    f(ti.prel_to_children_.values_, non_root_nodes);
   }
-  
-  // PreLToLabelId index
   if constexpr (std::is_base_of<PreLToLabelId, TreeIndex>::value) {
-    ti.prel_to_label_id_[this_nodes_preorder] = label_id;
+    f(ti.prel_to_label_id_, tree_size);
   }
-  
-  // PostLToLabelId index
   if constexpr (std::is_base_of<PostLToLabelId, TreeIndex>::value) {
-    ti.postl_to_label_id_[start_postorder] = label_id;
+    f(ti.postl_to_label_id_, tree_size);
   }
-  
-  // PostLToType index
   if constexpr (std::is_base_of<PostLToType, TreeIndex>::value) {
-    ti.postl_to_type_[start_postorder] = type;
+    f(ti.postl_to_type_, tree_size);
   }
-  
-  // InvertedListLabelIdToPostL index
-  if constexpr (std::is_base_of<InvertedListLabelIdToPostL, TreeIndex>::value) {
-    ti.inverted_list_label_id_to_postl_[label_id].push_back(start_postorder);
-  }
-  
-  // PostRToLabelId index
   if constexpr (std::is_base_of<PostRToLabelId, TreeIndex>::value) {
-    ti.postr_to_label_id_[postorder_r] = label_id;
+    f(ti.postr_to_label_id_, tree_size);
   }
-  
-  // PostLToDepth index
-  if constexpr (std::is_base_of<PostLToDepth, TreeIndex>::value) {
-    ti.postl_to_depth_[start_postorder] = start_depth;
+  if constexpr (std::is_base_of<PostLToLLD, TreeIndex>::value) {
+    f(ti.postl_to_lld_, tree_size);
   }
-  
-  // InvertedListDepthToPostL index
-  if constexpr (std::is_base_of<InvertedListDepthToPostL, TreeIndex>::value) {
-    ti.inverted_list_depth_to_postl_.at(start_depth).push_back(start_postorder);
+  if constexpr (std::is_base_of<PreLToLLD, TreeIndex>::value) {
+    f(ti.prel_to_lld_, tree_size);
   }
-
-  // PostLToSubtreeMaxDepth index
-  if constexpr (std::is_base_of<PostLToSubtreeMaxDepth, TreeIndex>::value) {
-    if (n.is_leaf()) {
-      // If this node has no children, set the max depth to this node's depth.
-      this_subtree_max_depth = start_depth;
-    }
-    ti.postl_to_subtree_max_depth_[start_postorder] = this_subtree_max_depth;
-    // Update parent subtree's max depth.
-    subtree_max_depth = std::max(subtree_max_depth, this_subtree_max_depth);
+  if constexpr (std::is_base_of<PreLToRLD, TreeIndex>::value) {
+    f(ti.prel_to_rld_, tree_size);
   }
-  
-  // PostLToHeight index
-  if constexpr (std::is_base_of<PostLToHeight, TreeIndex>::value) {
-    if (n.is_leaf()) {
-      // If this node has no children, set the max depth to this node's depth.
-      this_height = start_height;
-    }
-    ti.postl_to_height_[start_postorder] = this_height;
-    // Update parent subtree's max depth.
-    height = std::max(height, this_height);
+  if constexpr (std::is_base_of<PostRToRLD, TreeIndex>::value) {
+    f(ti.postr_to_rld_, tree_size);
+  }
+  if constexpr (std::is_base_of<PostLToDepth, TreeIndex>::value) {
+    f(ti.postl_to_depth_, tree_size);
   }
-  
-  // PostLToLCh index
   if constexpr (std::is_base_of<PostLToLCh, TreeIndex>::value) {
-    ti.postl_to_lch_[start_postorder] = first_child_postorder;
+    f(ti.postl_to_lch_, tree_size);
   }
-  
-  // PostLToLLD index
-  if constexpr (std::is_base_of<PostLToLLD, TreeIndex>::value) {
-    if (n.is_leaf()) {
-      // Set lld of this node to this node's postorer.
-      ti.postl_to_lld_[start_postorder] = start_postorder;
-    } else {
-      // This node's lld must be pushed after its childrens llds.
-      // lld is indexed starting with 0, thus first_child_postorder-1.
-      ti.postl_to_lld_[start_postorder] = ti.postl_to_lld_[first_child_postorder];
-    }
+  if constexpr (std::is_base_of<PostLToSubtreeMaxDepth, TreeIndex>::value) {
+    f(ti.postl_to_subtree_max_depth_, tree_size);
   }
-
-  // PreLToLLD index
-  if constexpr (std::is_base_of<PreLToLLD, TreeIndex>::value) {
-    if (n.is_leaf()) {
-      // Set lld of this node to this node's preorder.
-      ti.prel_to_lld_[this_nodes_preorder] = this_nodes_preorder;
-    } else {
-      // Push this node's lld to its first child (this_nodes_preorder + 1).
-      ti.prel_to_lld_[this_nodes_preorder] = ti.prel_to_lld_[this_nodes_preorder + 1];
-    }
+  if constexpr (std::is_base_of<PostLToKRAncestor, TreeIndex>::value) {
+    f(ti.postl_to_kr_ancestor_, tree_size);
   }
-
-  // PreLToRLD index
-  if constexpr (std::is_base_of<PreLToRLD, TreeIndex>::value) {
-    // RLD of a node n is: pre(n)+size(n)-1; size(n)=desc_sum+1
-    ti.prel_to_rld_[this_nodes_preorder] = this_nodes_preorder + desc_sum;
+  if constexpr (std::is_base_of<PreToLn, TreeIndex>::value) {
+    f(ti.prel_to_ln_, tree_size);
+    f(ti.prer_to_ln_, tree_size);
   }
-
-  // PreLToTypeLeft index
   if constexpr (std::is_base_of<PreLToTypeLeft, TreeIndex>::value) {
-    if (num_children > 0) {
-      ti.prel_to_type_left_[children_preorders[0]] = true;
-    }
+    f(ti.prel_to_type_left_, tree_size);
   }
-
-  // PreLToTypeRight index
   if constexpr (std::is_base_of<PreLToTypeRight, TreeIndex>::value) {
-    if (num_children > 0) {
-      ti.prel_to_type_right_[children_preorders[num_children-1]] = true;
-    }
+    f(ti.prel_to_type_right_, tree_size);
   }
-
-  // PreLToSpfCost indexes
-  // TODO: Indexes store long long int, but desc_sum is an
-  //       int. Verify if there is no weird conversion.
   if constexpr (std::is_base_of<PreLToSpfCost, TreeIndex>::value) {
-    // Add this node's subtree size to this node's sum.
-    ti.prel_to_cost_all_[this_nodes_preorder] += desc_sum + 1;
-    // If this node has a parent.
-    if (parent_preorder != -1) {
-      // Update the parent with this node's sum.
-      ti.prel_to_cost_all_[parent_preorder] += ti.prel_to_cost_all_[this_nodes_preorder];
-      ti.prel_to_cost_left_[parent_preorder] += ti.prel_to_cost_left_[this_nodes_preorder];
-      ti.prel_to_cost_right_[parent_preorder] += ti.prel_to_cost_right_[this_nodes_preorder];
-      // Check if this node is leftmost child of its parent.
-      if (this_nodes_preorder != parent_preorder + 1) {
-        ti.prel_to_cost_left_[parent_preorder] += desc_sum + 1;
-      }
-      // Check if this node is rightmost child of its parent.
-      if (!is_rightmost_child) {
-        ti.prel_to_cost_right_[parent_preorder] += desc_sum + 1;
-      }
-    }
-    // Calculate the cost and store.
-    ti.prel_to_cost_all_[this_nodes_preorder] =
-        (desc_sum + 1) * (desc_sum + 1 + 3) / 2 - ti.prel_to_cost_all_[this_nodes_preorder];
-    // Add this node's subtree size to this node's sum.
-    ti.prel_to_cost_left_[this_nodes_preorder] += desc_sum + 1;
-    ti.prel_to_cost_right_[this_nodes_preorder] += desc_sum + 1;
+    f(ti.prel_to_cost_all_, tree_size);
+    f(ti.prel_to_cost_left_, tree_size);
+    f(ti.prel_to_cost_right_, tree_size);
   }
-
-  // PreLToSubtreeCost indexes
   if constexpr (std::is_base_of<PreLToSubtreeCost, TreeIndex>::value) {
-    // Add the cost of this node's subtree.
-    ti.prel_to_subtree_del_cost_[this_nodes_preorder] += cm.del(label_id);
-    ti.prel_to_subtree_ins_cost_[this_nodes_preorder] += cm.ins(label_id);
-    // If this node has a parent.
-    if (parent_preorder != -1) {
-      // Update the cost of the parent node subtree.
-      ti.prel_to_subtree_del_cost_[parent_preorder] += ti.prel_to_subtree_del_cost_[this_nodes_preorder];
-      ti.prel_to_subtree_ins_cost_[parent_preorder] += ti.prel_to_subtree_ins_cost_[this_nodes_preorder];
-    }
+    f(ti.prel_to_subtree_del_cost_, tree_size);
+    f(ti.prel_to_subtree_ins_cost_, tree_size);
   }
-
-  // Increment start_postorder for the consecutive node in postorder to have the
-  // correct id.
-  ++start_postorder;
-
-  // Return the number of nodes in the subtree rooted at this node.
-  return desc_sum + 1;
-  
-}
-
-void fill_kr_ancestors(std::vector<int>& postl_to_kr_ancestor,
-    const std::vector<int>& postl_to_lch, const std::vector<int>& list_kr) {
-  for (auto i : list_kr) {
-    int l = i;
-    while (l >= 0) {
-      postl_to_kr_ancestor[l] = i;
-      l = postl_to_lch[l];
-    }
+  if constexpr (std::is_base_of<PostLToFavChild, TreeIndex>::value) {
+    f(ti.postl_to_fav_child_, tree_size);
+    f(ti.postl_to_left_fav_child_, tree_size);
   }
-}
-
-void fill_ln(std::vector<int>& prel_to_ln,
-    std::vector<int>& prer_to_ln,
-    const std::vector<int>& prel_to_size,
-    const std::vector<int>& prer_to_prel) {
-  int current_leaf_prel = -1;
-  int current_leaf_prer = -1;
-  for(int i = 0; i < prel_to_size[0]; ++i) {
-    prel_to_ln[i] = current_leaf_prel;
-    if(prel_to_size[i] == 1) {
-      current_leaf_prel = i;
-    }
-    prer_to_ln[i] = current_leaf_prer;
-    if(prel_to_size[prer_to_prel[i]] == 1) {
-      current_leaf_prer = i;
-    }
+  if constexpr (std::is_base_of<PostLToHeight, TreeIndex>::value) {
+    f(ti.postl_to_height_, tree_size);
   }
-}
-
-void fill_rld(std::vector<int>& postr_to_rld,
-    const std::vector<int>& prel_to_size,
-    const std::vector<int>& postr_to_prel,
-    const std::vector<int>& prel_to_postr,
-    const std::vector<std::vector<int>>& prel_to_children) {
-  // The loop iterates over right-to-left postorder.
-  int preorder = 0;
-  for(int i = 0; i < prel_to_size[0]; ++i) {
-    preorder = postr_to_prel[i];
-    if (prel_to_size[preorder] == 1) {
-      postr_to_rld[i] = i;
-    } else {
-      postr_to_rld[i] = postr_to_rld[prel_to_postr[prel_to_children[preorder][prel_to_children[preorder].size()-1]]];
-    }
+  if constexpr (std::is_base_of<PostLToOrderedChildSize, TreeIndex>::value) {
+    f(ti.postl_to_ordered_child_size_.offsets_, tree_size + 1);
+    f(ti.postl_to_ordered_child_size_.values_, non_root_nodes);
   }
-}
-
-template <typename TreeIndex>
-void fav_child_processing_order(TreeIndex& ti, int& postorder, int& favorder) {
-  // Perform recursively for children.
-  if (ti.postl_to_children_[postorder].size() != 0) {
-    // First process the favorable child.
-    fav_child_processing_order(ti, ti.postl_to_fav_child_[postorder], favorder);
-    // Next, process all other children.
-    for (unsigned int t = 0; t < ti.postl_to_children_[postorder].size(); ++t) {
-      // Favorable child was processed before.
-      if (ti.postl_to_children_[postorder][t] == ti.postl_to_fav_child_[postorder]) {
-        continue;
-      }
-      // Process other children in left to right order.
-      fav_child_processing_order(ti, ti.postl_to_children_[postorder][t], favorder);
-    }
+  if constexpr (std::is_base_of<PostLToFavorableChildOrder, TreeIndex>::value) {
+    f(ti.postl_to_favorder_, tree_size);
   }
-  // Assign favorder to postorder.
-  ti.postl_to_favorder_[favorder++] = postorder;
-}
\ No newline at end of file
+  if constexpr (std::is_base_of<PostLToLeftSibling, TreeIndex>::value) {
+    f(ti.postl_to_left_sibling_, tree_size);
+  }
+}
@@ -0,0 +1,85 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file parallel/bounded_queue.h
+///
+/// \details
+/// A queue of limited capacity between producer and consumer threads. A
+/// producer blocks while the queue is full, so a fast producer cannot build
+/// up more than capacity items that wait for the consumers. A consumer
+/// blocks while the queue is empty. Closing the queue ends the stream: the
+/// consumers take the remaining items and then stop, further pushes fail.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace parallel {
+
+template <typename Item>
+class BoundedQueue {
+// Member functions.
+public:
+  /// Constructor.
+  ///
+  /// \param capacity Maximum number of items in the queue. Values smaller
+  ///                 than one are treated as one.
+  BoundedQueue(const std::size_t capacity);
+  /// Appends an item. Blocks while the queue is full.
+  ///
+  /// \param item Item to append.
+  /// \return False if the queue has been closed; the item is dropped then.
+  bool push(Item item);
+  /// Removes the first item. Blocks while the queue is empty and open.
+  ///
+  /// \param item Receives the removed item.
+  /// \return False if the queue is closed and empty.
+  bool pop(Item& item);
+  /// Closes the queue and wakes up all blocked threads.
+  void close();
+  /// Returns the maximum number of items in the queue.
+  ///
+  /// \return The capacity.
+  std::size_t get_capacity() const;
+// Member variables.
+private:
+  /// Maximum number of items in the queue.
+  std::size_t capacity_;
+  /// Items in the order of push.
+  std::deque<Item> items_;
+  /// True after close.
+  bool closed_;
+  /// Guards items_ and closed_.
+  std::mutex mutex_;
+  /// Signalled when an item has been removed or the queue has been closed.
+  std::condition_variable not_full_;
+  /// Signalled when an item has been added or the queue has been closed.
+  std::condition_variable not_empty_;
+};
+
+// Implementation details.
+#include "bounded_queue_impl.h"
+
+}
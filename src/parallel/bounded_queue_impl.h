@@ -0,0 +1,77 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file parallel/bounded_queue_impl.h
+///
+/// \details
+/// Contains the implementation of the BoundedQueue class.
+
+#pragma once
+
+template <typename Item>
+BoundedQueue<Item>::BoundedQueue(const std::size_t capacity)
+    : capacity_(capacity > 0 ? capacity : 1), closed_(false) {}
+
+template <typename Item>
+bool BoundedQueue<Item>::push(Item item) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_full_.wait(lock, [this]() {
+    return closed_ || items_.size() < capacity_;
+  });
+  if (closed_) {
+    return false;
+  }
+  items_.push_back(std::move(item));
+  lock.unlock();
+  not_empty_.notify_one();
+  return true;
+}
+
+template <typename Item>
+bool BoundedQueue<Item>::pop(Item& item) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this]() {
+    return closed_ || !items_.empty();
+  });
+  if (items_.empty()) {
+    return false;
+  }
+  item = std::move(items_.front());
+  items_.pop_front();
+  lock.unlock();
+  not_full_.notify_one();
+  return true;
+}
+
+template <typename Item>
+void BoundedQueue<Item>::close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+  }
+  not_full_.notify_all();
+  not_empty_.notify_all();
+}
+
+template <typename Item>
+std::size_t BoundedQueue<Item>::get_capacity() const {
+  return capacity_;
+}
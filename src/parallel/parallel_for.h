@@ -0,0 +1,172 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file parallel/parallel_for.h
+///
+/// \details
+/// Tools to spread independent work items over multiple threads. The items
+/// are split into consecutive chunks that the workers claim one at a time.
+/// A thread that finishes early keeps claiming chunks, so slow chunks (e.g.,
+/// candidate pairs of large trees) do not leave other threads idle. Chunk ids
+/// follow the input order, which lets the callers merge per-chunk results
+/// deterministically.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+/// Hands out consecutive chunks [begin, end) of the range [0, size).
+class ChunkQueue {
+// Member functions.
+public:
+  /// Constructor.
+  ///
+  /// \param size Number of items to process.
+  /// \param chunk_size Maximum number of items in a chunk.
+  ChunkQueue(const std::size_t size, const std::size_t chunk_size);
+  /// Claims the next unprocessed chunk. Can be called concurrently.
+  ///
+  /// \param chunk_id Id of the claimed chunk, in the input order.
+  /// \param begin First item of the claimed chunk.
+  /// \param end One past the last item of the claimed chunk.
+  /// \return False if all chunks have already been claimed.
+  bool next(std::size_t& chunk_id, std::size_t& begin, std::size_t& end);
+  /// Returns the number of chunks.
+  ///
+  /// \return The number of chunks.
+  std::size_t get_number_of_chunks() const;
+// Member variables.
+private:
+  /// Number of items.
+  std::size_t size_;
+  /// Maximum number of items in a chunk.
+  std::size_t chunk_size_;
+  /// Number of chunks.
+  std::size_t number_of_chunks_;
+  /// Id of the next chunk to hand out.
+  std::atomic<std::size_t> next_chunk_;
+};
+
+/// Number of finished chunks per thread that a ChunkSequencer holds back by
+/// default.
+constexpr std::size_t kPendingChunksPerThread = 4;
+
+/// Passes finished chunks on in the chunk order. A chunk that finishes
+/// before an earlier one is held back until all earlier chunks have
+/// finished. This lets workers stream per-chunk results to a single
+/// consumer while the output stays independent of the number of threads.
+///
+/// At most max_pending_chunks chunks are processed or held back at a time:
+/// a worker waits with a chunk that is that far ahead of the next chunk to
+/// pass on. A slow chunk thus does not let the held-back results grow with
+/// the input. Only the state of these chunks is kept, hence the number of
+/// chunks does not have to be known in advance, e.g., for batches that a
+/// producer thread generates on the fly. Chunk ids start at 0 and every id
+/// has to be finished once.
+class ChunkSequencer {
+// Member functions.
+public:
+  /// Constructor.
+  ///
+  /// \param max_pending_chunks Maximum number of chunks between the next
+  ///                           chunk to pass on and the last chunk started.
+  ///                           Values smaller than one are treated as one.
+  ChunkSequencer(const std::size_t max_pending_chunks);
+  /// Worker loop. Claims the chunks from chunks, waits until a chunk is
+  /// within max_pending_chunks of the next chunk to pass on, calls
+  /// process(chunk_id, begin, end), and then finish(chunk_id, emit). Is
+  /// called by every worker with the same chunks and emit. If process or
+  /// emit throws, the sequencer stops all workers and the exception is
+  /// rethrown.
+  ///
+  /// \param chunks Queue of the chunks.
+  /// \param process Callable taking a chunk id and the chunk's item range.
+  /// \param emit Callable taking a chunk id.
+  template <typename Process, typename Function>
+  void run(ChunkQueue& chunks, Process process, Function emit);
+  /// Marks a chunk as finished and calls emit(id) for every chunk id that
+  /// is now next in the order, ascending. Can be called concurrently. The
+  /// calls of emit are serialised but run without holding the lock, so a
+  /// slow emit does not block the workers that finish other chunks.
+  ///
+  /// \param chunk_id Id of the finished chunk.
+  /// \param emit Callable taking a chunk id.
+  template <typename Function>
+  void finish(const std::size_t chunk_id, Function emit);
+  /// Waits until chunk_id is within max_pending_chunks of the next chunk to
+  /// pass on. A worker has to wait before it starts a chunk. Chunks that are
+  /// handed out in ascending order cannot deadlock: the next chunk to pass
+  /// on has been handed out before any later chunk and never waits.
+  ///
+  /// \param chunk_id Id of a claimed chunk.
+  /// \return False if the sequencer has been stopped.
+  bool wait(const std::size_t chunk_id);
+  /// Stops the sequencer. Waiting workers return and no further chunks are
+  /// passed on.
+  void stop();
+// Member variables.
+private:
+  /// Guards the members below.
+  std::mutex mutex_;
+  /// Signals that next_chunk_ has advanced or the sequencer has stopped.
+  std::condition_variable next_chunk_advanced_;
+  /// Maximum number of chunks between next_chunk_ and a started chunk.
+  std::size_t max_pending_chunks_;
+  /// True for every finished chunk that has not been passed on. Chunk id
+  /// is stored at position id % max_pending_chunks_.
+  std::vector<bool> finished_;
+  /// Id of the next chunk to pass on.
+  std::size_t next_chunk_;
+  /// True while a thread calls emit.
+  bool emitting_;
+  /// True if the sequencer has been stopped.
+  bool stopped_;
+};
+
+/// Translates a user-given number of threads into the number of workers.
+///
+/// \param number_of_threads Requested number of threads. Values smaller than
+///                          one select the number of hardware threads.
+/// \return Number of worker threads, at least one.
+unsigned int get_number_of_threads(const int number_of_threads);
+
+/// Executes worker(thread_id) on number_of_threads threads and waits for all
+/// of them. A single worker is executed in the calling thread. If a worker
+/// throws, the first exception is rethrown after all threads have finished.
+///
+/// \param number_of_threads Number of worker threads.
+/// \param worker Callable taking the thread id in [0, number_of_threads).
+template <typename Worker>
+void run_workers(const unsigned int number_of_threads, Worker worker);
+
+// Implementation details.
+#include "parallel_for_impl.h"
+
+}
@@ -0,0 +1,164 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file parallel/parallel_for_impl.h
+///
+/// \details
+/// Contains the implementation of the ChunkQueue and ChunkSequencer classes
+/// and run_workers.
+
+#pragma once
+
+inline ChunkQueue::ChunkQueue(const std::size_t size, const std::size_t chunk_size)
+    : size_(size), chunk_size_(chunk_size > 0 ? chunk_size : 1),
+      next_chunk_(0) {
+  number_of_chunks_ = (size_ + chunk_size_ - 1) / chunk_size_;
+}
+
+inline bool ChunkQueue::next(std::size_t& chunk_id, std::size_t& begin,
+    std::size_t& end) {
+  chunk_id = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+  if (chunk_id >= number_of_chunks_) {
+    return false;
+  }
+  begin = chunk_id * chunk_size_;
+  end = std::min(begin + chunk_size_, size_);
+  return true;
+}
+
+inline std::size_t ChunkQueue::get_number_of_chunks() const {
+  return number_of_chunks_;
+}
+
+inline ChunkSequencer::ChunkSequencer(const std::size_t max_pending_chunks)
+    : max_pending_chunks_(max_pending_chunks > 0 ? max_pending_chunks : 1),
+      finished_(max_pending_chunks_, false), next_chunk_(0), emitting_(false),
+      stopped_(false) {}
+
+template <typename Process, typename Function>
+void ChunkSequencer::run(ChunkQueue& chunks, Process process, Function emit) {
+  std::size_t chunk_id = 0;
+  std::size_t begin = 0;
+  std::size_t end = 0;
+  try {
+    // Chunks are claimed in ascending order, so the chunk next_chunk_ is
+    // always claimed by a worker that does not wait.
+    while (chunks.next(chunk_id, begin, end) && wait(chunk_id)) {
+      process(chunk_id, begin, end);
+      finish(chunk_id, emit);
+    }
+  } catch (...) {
+    // The chunk of this worker never finishes; release the other workers.
+    stop();
+    throw;
+  }
+}
+
+template <typename Function>
+void ChunkSequencer::finish(const std::size_t chunk_id, Function emit) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  finished_[chunk_id % max_pending_chunks_] = true;
+  // Only one thread emits at a time. It also passes on the chunks that
+  // finish while it emits.
+  if (emitting_ || stopped_) {
+    return;
+  }
+  emitting_ = true;
+  while (!stopped_ && finished_[next_chunk_ % max_pending_chunks_]) {
+    // Take the ready chunks. Their positions are reused only after
+    // next_chunk_ has advanced past them.
+    const std::size_t first_ready = next_chunk_;
+    std::size_t last_ready = next_chunk_;
+    while (last_ready < first_ready + max_pending_chunks_ &&
+        finished_[last_ready % max_pending_chunks_]) {
+      finished_[last_ready % max_pending_chunks_] = false;
+      ++last_ready;
+    }
+    lock.unlock();
+    try {
+      for (std::size_t id = first_ready; id < last_ready; ++id) {
+        emit(id);
+      }
+    } catch (...) {
+      lock.lock();
+      emitting_ = false;
+      stopped_ = true;
+      next_chunk_advanced_.notify_all();
+      throw;
+    }
+    lock.lock();
+    next_chunk_ = last_ready;
+    next_chunk_advanced_.notify_all();
+  }
+  emitting_ = false;
+}
+
+inline bool ChunkSequencer::wait(const std::size_t chunk_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  next_chunk_advanced_.wait(lock, [&]() {
+    return stopped_ || chunk_id < next_chunk_ + max_pending_chunks_;
+  });
+  return !stopped_;
+}
+
+inline void ChunkSequencer::stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stopped_ = true;
+  next_chunk_advanced_.notify_all();
+}
+
+inline unsigned int get_number_of_threads(const int number_of_threads) {
+  if (number_of_threads > 0) {
+    return number_of_threads;
+  }
+  // hardware_concurrency() may return 0 if the value is not computable.
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+template <typename Worker>
+void run_workers(const unsigned int number_of_threads, Worker worker) {
+  if (number_of_threads <= 1) {
+    worker(0);
+    return;
+  }
+  std::exception_ptr first_exception;
+  std::mutex exception_mutex;
+  std::vector<std::thread> threads;
+  threads.reserve(number_of_threads);
+  for (unsigned int thread_id = 0; thread_id < number_of_threads; ++thread_id) {
+    threads.emplace_back([&, thread_id]() {
+      try {
+        worker(thread_id);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(exception_mutex);
+        if (!first_exception) {
+          first_exception = std::current_exception();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (first_exception) {
+    std::rethrow_exception(first_exception);
+  }
+}
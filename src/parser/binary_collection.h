@@ -0,0 +1,214 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file parser/binary_collection.h
+///
+/// \details
+/// Binary on-disk format of a tree collection. A bracket-notation collection
+/// is parsed once and written in this format. Later runs map the file into
+/// memory and read the label dictionary and the trees without parsing.
+///
+/// The file consists of a header followed by five sections. Each section
+/// starts at a multiple of 8 bytes. All numbers are stored in the byte order
+/// of the writing machine, which is verified when loading.
+///
+/// header           BinaryCollectionHeader
+/// label offsets    uint64[number_of_labels + 1], begin of every label
+/// label bytes      char[label_bytes], labels by label id (to_string())
+/// tree offsets     uint64[number_of_trees + 1], first node of every tree
+/// label ids        int32[number_of_nodes], label id of every node
+/// parents          int32[number_of_nodes], parent of every node (-1: root)
+///
+/// Nodes are stored tree after tree in left-to-right postorder. Label ids and
+/// parents are postorder ids local to their tree. Label ids are assigned in
+/// the order of first occurrence.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../node/node.h"
+#include "../node/compact_tree.h"
+#include "../node/tree_index_collection.h"
+#include "../label/label_dictionary.h"
+#include "../data_structures/mapped_file.h"
+
+namespace parser {
+
+/// Header at the beginning of a binary collection file.
+struct BinaryCollectionHeader {
+  /// File type identifier, kBinaryCollectionMagic.
+  char magic[8];
+  /// Format version, kBinaryCollectionVersion.
+  std::uint32_t version;
+  /// kBinaryCollectionByteOrder written in the byte order of the writer.
+  std::uint32_t byte_order;
+  /// Number of distinct labels.
+  std::uint64_t number_of_labels;
+  /// Number of trees.
+  std::uint64_t number_of_trees;
+  /// Number of nodes of all trees.
+  std::uint64_t number_of_nodes;
+  /// Number of bytes of all labels.
+  std::uint64_t label_bytes;
+};
+
+const char kBinaryCollectionMagic[8] = {'T', 'S', 'B', 'C', 'O', 'L', '\0', '\0'};
+const std::uint32_t kBinaryCollectionVersion = 1;
+const std::uint32_t kBinaryCollectionByteOrder = 0x01020304;
+
+/// \class BinaryCollection
+///
+/// \details
+/// Read-only view of a binary collection file. The file is mapped into memory
+/// and all arrays are read in place. Trees are materialized as CompactTree or
+/// Node objects on request only.
+///
+/// \tparam Label Label type of the trees. It has to be constructible from the
+///               string returned by its to_string().
+template <class Label>
+class BinaryCollection {
+// Member functions.
+public:
+  /// Writes trees_collection to file_path in the binary collection format.
+  ///
+  /// \param trees_collection A vector holding an input collection of trees.
+  /// \param file_path Path of the output file.
+  /// \throws std::runtime_error if the file cannot be written.
+  static void write(const std::vector<node::Node<Label>>& trees_collection,
+      const std::string& file_path);
+  /// Maps the binary collection file at file_path and validates it: the
+  /// header, the section sizes, the offsets, the label ids, and the parents
+  /// of all nodes. All other member functions rely on a validated file.
+  ///
+  /// \param file_path Path to a file written by write.
+  /// \throws std::runtime_error if the file cannot be mapped or is not a
+  ///         valid binary collection of this version.
+  BinaryCollection(const std::string& file_path);
+  /// Returns the number of trees.
+  std::size_t get_number_of_trees() const;
+  /// Returns the number of distinct labels.
+  std::size_t get_number_of_labels() const;
+  /// Returns the number of nodes of all trees.
+  std::size_t get_number_of_nodes() const;
+  /// Returns the string of a label.
+  ///
+  /// \param label_id Id of the label.
+  /// \return The label's to_string() at the time of writing.
+  std::string get_label_string(const int label_id) const;
+  /// Returns the number of nodes of a tree.
+  ///
+  /// \param tree_id Position of the tree in the collection.
+  int get_tree_size(const std::size_t tree_id) const;
+  /// Returns the label ids of the nodes of a tree in postorder. The array
+  /// has get_tree_size(tree_id) elements and points into the mapped file.
+  ///
+  /// \param tree_id Position of the tree in the collection.
+  const std::int32_t* get_postl_to_label_id(const std::size_t tree_id) const;
+  /// Returns the postorder ids of the parents of the nodes of a tree in
+  /// postorder. The root's parent is -1. The array has
+  /// get_tree_size(tree_id) elements and points into the mapped file.
+  ///
+  /// \param tree_id Position of the tree in the collection.
+  const std::int32_t* get_postl_to_parent(const std::size_t tree_id) const;
+  /// Clears ld and inserts all labels such that every label gets its stored
+  /// label id.
+  ///
+  /// \param ld LabelDictionary to fill.
+  /// \throws std::runtime_error if two stored labels are equal.
+  void fill_label_dictionary(label::LabelDictionary<Label>& ld) const;
+  /// Builds the Node structure of a tree.
+  ///
+  /// \param tree_id Position of the tree in the collection.
+  /// \return Root of the tree.
+  node::Node<Label> get_tree(const std::size_t tree_id) const;
+  /// Builds the Node structure of a tree with the labels of a dictionary
+  /// filled by fill_label_dictionary. Avoids constructing every label from
+  /// its string.
+  ///
+  /// \param tree_id Position of the tree in the collection.
+  /// \param ld LabelDictionary filled by fill_label_dictionary.
+  /// \return Root of the tree.
+  node::Node<Label> get_tree(const std::size_t tree_id,
+      const label::LabelDictionary<Label>& ld) const;
+  /// Copies a tree into a CompactTree. Its label ids are the stored label
+  /// ids, see fill_label_dictionary.
+  ///
+  /// \param tree_id Position of the tree in the collection.
+  /// \return The tree.
+  node::CompactTree get_compact_tree(const std::size_t tree_id) const;
+  /// Builds the Node structures of all trees and appends them to
+  /// trees_collection.
+  ///
+  /// \param trees_collection A vector to append the trees to.
+  void get_trees(std::vector<node::Node<Label>>& trees_collection) const;
+  /// Indexes all trees. Previous indexes in indexes are discarded. The
+  /// LabelDictionary of indexes is refilled with the stored labels, so the
+  /// label ids in the indexes equal the stored label ids.
+  /// TJoinTI and NaiveJoinTI join the indexes without Node trees.
+  ///
+  /// \param indexes The collection of tree indexes to build.
+  /// \param cm Cost model constructed with indexes.get_label_dictionary().
+  template <typename TreeIndex, typename CostModel>
+  void build_indexes(node::TreeIndexCollection<Label, TreeIndex>& indexes,
+      const CostModel& cm) const;
+// Member functions.
+private:
+  /// Returns bytes rounded up to the next multiple of 8.
+  static std::size_t align(const std::size_t bytes);
+  /// Checks the offsets, the label ids, and the parents of the mapped
+  /// sections. Every tree has to be non-empty and its parents have to
+  /// describe a single tree in postorder.
+  ///
+  /// \param error Beginning of the exception message.
+  /// \throws std::runtime_error if a check fails.
+  void validate_sections(const std::string& error) const;
+  /// Builds the Node structure of a tree from its postorder arrays.
+  ///
+  /// \param tree_id Position of the tree in the collection.
+  /// \param get_label Returns the Label of a label id.
+  /// \return Root of the tree.
+  template <typename LabelFunction>
+  node::Node<Label> build_tree(const std::size_t tree_id,
+      LabelFunction get_label) const;
+// Member variables.
+private:
+  /// Mapping of the whole file.
+  data_structures::MappedFile file_;
+  /// Header at the beginning of the mapping.
+  BinaryCollectionHeader header_;
+  /// Section pointers into the mapping.
+  const std::uint64_t* label_offsets_;
+  const char* label_bytes_;
+  const std::uint64_t* tree_offsets_;
+  const std::int32_t* postl_to_label_id_;
+  const std::int32_t* postl_to_parent_;
+};
+
+// Implementation details.
+#include "binary_collection_impl.h"
+
+}
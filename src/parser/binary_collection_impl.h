@@ -0,0 +1,392 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file parser/binary_collection_impl.h
+///
+/// \details
+/// Contains the implementation of the BinaryCollection class.
+
+#pragma once
+
+template <class Label>
+std::size_t BinaryCollection<Label>::align(const std::size_t bytes) {
+  return (bytes + 7) & ~static_cast<std::size_t>(7);
+}
+
+template <class Label>
+void BinaryCollection<Label>::write(
+    const std::vector<node::Node<Label>>& trees_collection,
+    const std::string& file_path) {
+  label::LabelDictionary<Label> ld;
+  std::vector<std::uint64_t> tree_offsets(1, 0);
+  std::vector<std::int32_t> postl_to_label_id;
+  std::vector<std::int32_t> postl_to_parent;
+
+  // Left-to-right postorder traversal with an explicit stack such that deep
+  // trees do not overflow the call stack. Every stack entry holds a node and
+  // the position of its next child to visit.
+  std::vector<std::pair<const node::Node<Label>*, std::size_t>> stack;
+  // Postorder ids of visited nodes whose parents are not visited yet.
+  std::vector<std::int32_t> pending;
+  // For every node on the stack, the position in pending of its first child.
+  std::vector<std::size_t> first_pending;
+  for (const auto& tree : trees_collection) {
+    const std::size_t tree_begin = postl_to_label_id.size();
+    stack.emplace_back(&tree, 0);
+    first_pending.push_back(0);
+    while (!stack.empty()) {
+      const node::Node<Label>* current = stack.back().first;
+      const auto& children = current->get_children();
+      if (stack.back().second < children.size()) {
+        stack.emplace_back(&children[stack.back().second++], 0);
+        first_pending.push_back(pending.size());
+        continue;
+      }
+      // All children of current are visited. They are the pending nodes
+      // pushed after current was put on the stack.
+      const std::int32_t postl = static_cast<std::int32_t>(
+          postl_to_label_id.size() - tree_begin);
+      postl_to_label_id.push_back(ld.insert(current->label()));
+      postl_to_parent.push_back(-1);
+      for (std::size_t i = first_pending.back(); i < pending.size(); ++i) {
+        postl_to_parent[tree_begin + pending[i]] = postl;
+      }
+      pending.resize(first_pending.back());
+      pending.push_back(postl);
+      stack.pop_back();
+      first_pending.pop_back();
+    }
+    pending.clear();
+    tree_offsets.push_back(postl_to_label_id.size());
+  }
+
+  std::vector<std::uint64_t> label_offsets(1, 0);
+  std::string label_bytes;
+  for (int label_id = 0; label_id < ld.size(); ++label_id) {
+    label_bytes += ld.get(label_id).to_string();
+    label_offsets.push_back(label_bytes.size());
+  }
+
+  BinaryCollectionHeader header;
+  std::memcpy(header.magic, kBinaryCollectionMagic, sizeof(header.magic));
+  header.version = kBinaryCollectionVersion;
+  header.byte_order = kBinaryCollectionByteOrder;
+  header.number_of_labels = label_offsets.size() - 1;
+  header.number_of_trees = trees_collection.size();
+  header.number_of_nodes = postl_to_label_id.size();
+  header.label_bytes = label_bytes.size();
+
+  std::ofstream output(file_path, std::ios::binary | std::ios::trunc);
+  if (!output.is_open()) {
+    throw std::runtime_error("ERROR: Problem with opening the file '" +
+        file_path + "' in BinaryCollection::write.");
+  }
+  // Writes a section and pads it to a multiple of 8 bytes.
+  const char padding[8] = {};
+  auto write_section = [&output, &padding](const void* data,
+      const std::size_t bytes) {
+    output.write(static_cast<const char*>(data), bytes);
+    output.write(padding, align(bytes) - bytes);
+  };
+  write_section(&header, sizeof(header));
+  write_section(label_offsets.data(),
+      label_offsets.size() * sizeof(std::uint64_t));
+  write_section(label_bytes.data(), label_bytes.size());
+  write_section(tree_offsets.data(),
+      tree_offsets.size() * sizeof(std::uint64_t));
+  write_section(postl_to_label_id.data(),
+      postl_to_label_id.size() * sizeof(std::int32_t));
+  write_section(postl_to_parent.data(),
+      postl_to_parent.size() * sizeof(std::int32_t));
+  output.close();
+  if (!output) {
+    throw std::runtime_error("ERROR: Problem with writing the file '" +
+        file_path + "' in BinaryCollection::write.");
+  }
+}
+
+template <class Label>
+BinaryCollection<Label>::BinaryCollection(const std::string& file_path)
+    : file_(file_path) {
+  const std::string error = "ERROR: The file '" + file_path +
+      "' is not a valid binary collection";
+  if (file_.size() < sizeof(header_)) {
+    throw std::runtime_error(error + " (too short).");
+  }
+  std::memcpy(&header_, file_.data(), sizeof(header_));
+  if (std::memcmp(header_.magic, kBinaryCollectionMagic,
+      sizeof(header_.magic)) != 0) {
+    throw std::runtime_error(error + " (wrong file type).");
+  }
+  if (header_.version != kBinaryCollectionVersion) {
+    throw std::runtime_error(error + " (unsupported version " +
+        std::to_string(header_.version) + ").");
+  }
+  if (header_.byte_order != kBinaryCollectionByteOrder) {
+    throw std::runtime_error(error + " (written with another byte order).");
+  }
+  // Bounds that keep the section sizes below from overflowing.
+  const std::uint64_t kMaxCount = static_cast<std::uint64_t>(1) << 40;
+  if (header_.number_of_labels > kMaxCount ||
+      header_.number_of_trees > kMaxCount ||
+      header_.number_of_nodes > kMaxCount || header_.label_bytes > kMaxCount) {
+    throw std::runtime_error(error + " (corrupt header).");
+  }
+
+  // Section positions. The mapping is page-aligned and every section starts
+  // at a multiple of 8 bytes, so the arrays can be read in place.
+  std::size_t position = align(sizeof(header_));
+  const std::size_t label_offsets_position = position;
+  position += align((header_.number_of_labels + 1) * sizeof(std::uint64_t));
+  const std::size_t label_bytes_position = position;
+  position += align(header_.label_bytes);
+  const std::size_t tree_offsets_position = position;
+  position += align((header_.number_of_trees + 1) * sizeof(std::uint64_t));
+  const std::size_t postl_to_label_id_position = position;
+  position += align(header_.number_of_nodes * sizeof(std::int32_t));
+  const std::size_t postl_to_parent_position = position;
+  position += align(header_.number_of_nodes * sizeof(std::int32_t));
+  if (file_.size() < position) {
+    throw std::runtime_error(error + " (truncated).");
+  }
+  label_offsets_ = reinterpret_cast<const std::uint64_t*>(
+      file_.data() + label_offsets_position);
+  label_bytes_ = file_.data() + label_bytes_position;
+  tree_offsets_ = reinterpret_cast<const std::uint64_t*>(
+      file_.data() + tree_offsets_position);
+  postl_to_label_id_ = reinterpret_cast<const std::int32_t*>(
+      file_.data() + postl_to_label_id_position);
+  postl_to_parent_ = reinterpret_cast<const std::int32_t*>(
+      file_.data() + postl_to_parent_position);
+  validate_sections(error);
+}
+
+template <class Label>
+void BinaryCollection<Label>::validate_sections(
+    const std::string& error) const {
+  // Label offsets ascend from 0 to label_bytes.
+  if (label_offsets_[0] != 0 ||
+      label_offsets_[header_.number_of_labels] != header_.label_bytes) {
+    throw std::runtime_error(error + " (inconsistent label offsets).");
+  }
+  for (std::size_t label_id = 0; label_id < header_.number_of_labels;
+      ++label_id) {
+    if (label_offsets_[label_id] > label_offsets_[label_id + 1]) {
+      throw std::runtime_error(error + " (inconsistent label offsets).");
+    }
+  }
+  // Tree offsets strictly ascend from 0 to number_of_nodes, every tree has
+  // at least one node and fits into an int.
+  if (tree_offsets_[0] != 0 ||
+      tree_offsets_[header_.number_of_trees] != header_.number_of_nodes) {
+    throw std::runtime_error(error + " (inconsistent tree offsets).");
+  }
+  const std::uint64_t kMaxTreeSize = std::numeric_limits<std::int32_t>::max();
+  for (std::size_t tree_id = 0; tree_id < header_.number_of_trees; ++tree_id) {
+    if (tree_offsets_[tree_id] >= tree_offsets_[tree_id + 1] ||
+        tree_offsets_[tree_id + 1] - tree_offsets_[tree_id] > kMaxTreeSize) {
+      throw std::runtime_error(error + " (inconsistent tree offsets).");
+    }
+  }
+  for (std::size_t node = 0; node < header_.number_of_nodes; ++node) {
+    if (postl_to_label_id_[node] < 0 ||
+        static_cast<std::uint64_t>(postl_to_label_id_[node]) >=
+        header_.number_of_labels) {
+      throw std::runtime_error(error + " (label id out of range).");
+    }
+  }
+  // Replays the construction of build_tree. A node's parent follows it in
+  // postorder, only the last node is a root, and the children of a node are
+  // the last subtrees built before it. Exactly the root remains.
+  std::vector<std::int32_t> subtree_postl;
+  for (std::size_t tree_id = 0; tree_id < header_.number_of_trees; ++tree_id) {
+    const int tree_size = get_tree_size(tree_id);
+    const std::int32_t* postl_to_parent = get_postl_to_parent(tree_id);
+    subtree_postl.clear();
+    for (int postl = 0; postl < tree_size; ++postl) {
+      const std::int32_t parent = postl_to_parent[postl];
+      if (postl == tree_size - 1 ? parent != -1 :
+          parent <= postl || parent >= tree_size) {
+        throw std::runtime_error(error + " (invalid parent in tree " +
+            std::to_string(tree_id) + ").");
+      }
+      while (!subtree_postl.empty() &&
+          postl_to_parent[subtree_postl.back()] == postl) {
+        subtree_postl.pop_back();
+      }
+      subtree_postl.push_back(postl);
+    }
+    if (subtree_postl.size() != 1) {
+      throw std::runtime_error(error + " (invalid parent in tree " +
+          std::to_string(tree_id) + ").");
+    }
+  }
+}
+
+template <class Label>
+std::size_t BinaryCollection<Label>::get_number_of_trees() const {
+  return header_.number_of_trees;
+}
+
+template <class Label>
+std::size_t BinaryCollection<Label>::get_number_of_labels() const {
+  return header_.number_of_labels;
+}
+
+template <class Label>
+std::size_t BinaryCollection<Label>::get_number_of_nodes() const {
+  return header_.number_of_nodes;
+}
+
+template <class Label>
+std::string BinaryCollection<Label>::get_label_string(const int label_id) const {
+  return std::string(label_bytes_ + label_offsets_[label_id],
+      label_offsets_[label_id + 1] - label_offsets_[label_id]);
+}
+
+template <class Label>
+int BinaryCollection<Label>::get_tree_size(const std::size_t tree_id) const {
+  return static_cast<int>(tree_offsets_[tree_id + 1] - tree_offsets_[tree_id]);
+}
+
+template <class Label>
+const std::int32_t* BinaryCollection<Label>::get_postl_to_label_id(
+    const std::size_t tree_id) const {
+  return postl_to_label_id_ + tree_offsets_[tree_id];
+}
+
+template <class Label>
+const std::int32_t* BinaryCollection<Label>::get_postl_to_parent(
+    const std::size_t tree_id) const {
+  return postl_to_parent_ + tree_offsets_[tree_id];
+}
+
+template <class Label>
+void BinaryCollection<Label>::fill_label_dictionary(
+    label::LabelDictionary<Label>& ld) const {
+  ld.clear();
+  for (std::size_t label_id = 0; label_id < header_.number_of_labels;
+      ++label_id) {
+    ld.insert(Label(get_label_string(label_id)));
+  }
+  // Equal labels would shift the ids of all following labels.
+  if (static_cast<std::size_t>(ld.size()) != header_.number_of_labels) {
+    throw std::runtime_error(
+        "ERROR: The binary collection stores a label twice.");
+  }
+}
+
+template <class Label>
+template <typename LabelFunction>
+node::Node<Label> BinaryCollection<Label>::build_tree(
+    const std::size_t tree_id, LabelFunction get_label) const {
+  const int tree_size = get_tree_size(tree_id);
+  const std::int32_t* postl_to_label_id = get_postl_to_label_id(tree_id);
+  const std::int32_t* postl_to_parent = get_postl_to_parent(tree_id);
+  // Built subtrees whose parents are not built yet, and their postorder ids.
+  // In postorder, the children of a node are the last subtrees built before
+  // the node.
+  std::vector<node::Node<Label>> subtrees;
+  std::vector<int> subtree_postl;
+  for (int postl = 0; postl < tree_size; ++postl) {
+    node::Node<Label> current(get_label(postl_to_label_id[postl]));
+    std::size_t first_child = subtrees.size();
+    while (first_child > 0 &&
+        postl_to_parent[subtree_postl[first_child - 1]] == postl) {
+      --first_child;
+    }
+    for (std::size_t i = first_child; i < subtrees.size(); ++i) {
+      current.add_child(std::move(subtrees[i]));
+    }
+    subtrees.erase(subtrees.begin() + first_child, subtrees.end());
+    subtree_postl.resize(first_child);
+    subtrees.push_back(std::move(current));
+    subtree_postl.push_back(postl);
+  }
+  return std::move(subtrees.back());
+}
+
+template <class Label>
+node::Node<Label> BinaryCollection<Label>::get_tree(
+    const std::size_t tree_id) const {
+  return build_tree(tree_id, [this](const int label_id) {
+    return Label(get_label_string(label_id));
+  });
+}
+
+template <class Label>
+node::Node<Label> BinaryCollection<Label>::get_tree(const std::size_t tree_id,
+    const label::LabelDictionary<Label>& ld) const {
+  return build_tree(tree_id, [&ld](const int label_id) -> const Label& {
+    return ld.get(label_id);
+  });
+}
+
+template <class Label>
+node::CompactTree BinaryCollection<Label>::get_compact_tree(
+    const std::size_t tree_id) const {
+  const int tree_size = get_tree_size(tree_id);
+  const std::int32_t* postl_to_label_id = get_postl_to_label_id(tree_id);
+  const std::int32_t* postl_to_parent = get_postl_to_parent(tree_id);
+  // Subtree sizes. Every node precedes its parent in postorder.
+  std::vector<int> postl_to_size(tree_size, 1);
+  for (int postl = 0; postl < tree_size; ++postl) {
+    if (postl_to_parent[postl] != -1) {
+      postl_to_size[postl_to_parent[postl]] += postl_to_size[postl];
+    }
+  }
+  node::CompactTree tree;
+  tree.reserve(tree_size);
+  for (int postl = 0; postl < tree_size; ++postl) {
+    tree.add_node(postl_to_label_id[postl], postl_to_size[postl]);
+  }
+  return tree;
+}
+
+template <class Label>
+void BinaryCollection<Label>::get_trees(
+    std::vector<node::Node<Label>>& trees_collection) const {
+  // Construct every distinct label once and copy it into the nodes.
+  std::vector<Label> labels;
+  labels.reserve(header_.number_of_labels);
+  for (std::size_t label_id = 0; label_id < header_.number_of_labels;
+      ++label_id) {
+    labels.emplace_back(get_label_string(label_id));
+  }
+  trees_collection.reserve(trees_collection.size() + header_.number_of_trees);
+  for (std::size_t tree_id = 0; tree_id < header_.number_of_trees; ++tree_id) {
+    trees_collection.push_back(build_tree(tree_id,
+        [&labels](const int label_id) -> const Label& {
+      return labels[label_id];
+    }));
+  }
+}
+
+template <class Label>
+template <typename TreeIndex, typename CostModel>
+void BinaryCollection<Label>::build_indexes(
+    node::TreeIndexCollection<Label, TreeIndex>& indexes,
+    const CostModel& cm) const {
+  fill_label_dictionary(indexes.get_label_dictionary());
+  indexes.build(get_number_of_trees(), [this](const std::size_t tree_id) {
+    return get_compact_tree(tree_id);
+  }, cm);
+}
@@ -46,13 +46,20 @@
 #pragma once
 
 #include "../node/node.h"
+#include "../node/compact_tree.h"
+#include "../label/label_dictionary.h"
 #include "../label/string_label.h"
+#include "../data_structures/mapped_file.h"
+#include "../parallel/parallel_for.h"
 
 #include <cstring>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <regex>
+#include <algorithm>
+#include <iterator>
+#include <vector>
 
 namespace parser {
 
@@ -69,10 +76,45 @@ public:
   /// \return Root of the parsed tree.
   node::Node<Label> parse_single(const std::string& tree_string);
 
+  /// Parses the tree in bracket notation stored in [begin, end) in a single
+  /// pass over the characters. Labels are constructed directly from the
+  /// input and nodes are moved into their parents.
+  ///
+  /// \param begin First character of the tree.
+  /// \param end One past the last character of the tree.
+  ///
+  /// \return Root of the parsed tree.
+  node::Node<Label> parse_single(const char* begin, const char* end);
+
+  /// Parses the tree in bracket notation stored in tree_string to a
+  /// CompactTree. See parse_single(begin, end, ld).
+  ///
+  /// \param tree_string The string holding the tree in bracket notation.
+  /// \param ld LabelDictionary that assigns the label ids.
+  ///
+  /// \return The parsed tree.
+  node::CompactTree parse_single(const std::string& tree_string,
+      label::LabelDictionary<Label>& ld);
+
+  /// Parses the tree in bracket notation stored in [begin, end) to a
+  /// CompactTree. The labels are inserted into ld in preorder, like
+  /// node::index_tree does for a Node tree. Every node is appended to the
+  /// tree at its right bracket, i.e., in postorder.
+  ///
+  /// \param begin First character of the tree.
+  /// \param end One past the last character of the tree.
+  /// \param ld LabelDictionary that assigns the label ids.
+  ///
+  /// \return The parsed tree.
+  node::CompactTree parse_single(const char* begin, const char* end,
+      label::LabelDictionary<Label>& ld);
+
   /// Takes a file with one tree (in bracket notation) per line and parses it
   /// to a vector of Node objects with StringLabels.
   ///
-  /// NOTE: It executes parse_single for every line in the data file.
+  /// NOTE: The file is memory-mapped and every line is parsed in place with
+  ///       parse_single. Lines that fail validate_input are skipped. Without
+  ///       mmap support the file is read line by line with std::getline.
   /// NOTE: The notation of trees is assumed correct.
   ///
   /// \param trees_collection Container to store all trees.
@@ -80,6 +122,33 @@ public:
   void parse_collection(std::vector<node::Node<Label>>& trees_collection,
       const std::string& file_path);
 
+  /// Parses a file with one tree per line like parse_collection, but on
+  /// multiple threads.
+  ///
+  /// The mapped file is cut at line boundaries into chunks that the threads
+  /// parse independently, each with its own parser. The trees are appended
+  /// to trees_collection in the order of the lines in the file, so the tree
+  /// ids do not depend on the number of threads. Without mmap support the
+  /// whole file is read into memory first.
+  ///
+  /// \param trees_collection Container to store all trees.
+  /// \param file_path The path to the file with set of trees.
+  /// \param number_of_threads Number of parsing threads. Values smaller than
+  ///                          one use all hardware threads.
+  void parse_collection(std::vector<node::Node<Label>>& trees_collection,
+      const std::string& file_path, const int number_of_threads);
+
+  /// Parses a file with one tree per line like parse_collection, but to
+  /// CompactTree objects whose label ids are assigned by ld.
+  ///
+  /// NOTE: All trees share ld, hence the file is parsed on one thread.
+  ///
+  /// \param trees_collection Container to store all trees.
+  /// \param ld LabelDictionary that assigns the label ids.
+  /// \param file_path The path to the file with set of trees.
+  void parse_collection(std::vector<node::CompactTree>& trees_collection,
+      label::LabelDictionary<Label>& ld, const std::string& file_path);
+
   /// Generates the tokens for the input string.
   ///
   /// \param tree_string The string holding the tree in bracket notation.
@@ -94,6 +163,32 @@ public:
   /// \param tree_string Tree in bracket notation.
   /// \return True if the input is correct and false otherwise.
   bool validate_input(const std::string& tree_string) const;
+
+  /// Validates the bracket notation input stored in [begin, end).
+  ///
+  /// \param begin First character of the tree.
+  /// \param end One past the last character of the tree.
+  /// \return True if the input is correct and false otherwise.
+  bool validate_input(const char* begin, const char* end) const;
+// Member functions
+private:
+  /// Finds the first structure bracket in [begin, end) that is not escaped.
+  ///
+  /// \param begin First character to search.
+  /// \param end One past the last character to search.
+  /// \param input_begin First character of the input, for the escape check.
+  /// \return Pointer to the bracket, or end if there is none.
+  const char* find_bracket(const char* begin, const char* end,
+      const char* input_begin) const;
+
+  /// Parses every valid line in [begin, end) and appends the trees to
+  /// trees_collection.
+  ///
+  /// \param begin First character of the first line.
+  /// \param end One past the last character of the last line.
+  /// \param trees_collection Container to store the trees.
+  void parse_lines(const char* begin, const char* end,
+      std::vector<node::Node<Label>>& trees_collection);
 // Member variables
 private:
   /// A stack to store nodes on a path to the root from the current node in the
@@ -101,6 +196,11 @@ private:
   /// while parsing.
   std::vector<std::reference_wrapper<node::Node<Label>>> node_stack;
 
+  /// A stack with the label id and the postorder id of the first subtree
+  /// node of every node on the path to the root from the current node while
+  /// parsing a CompactTree.
+  std::vector<std::pair<int, int>> compact_node_stack;
+
   /// Structure brackets for representing nodes relationships. Could be
   /// modified to other types of paretheses if necessary.
   const std::string kLeftBracket = "{";
@@ -109,6 +209,10 @@ private:
   /// Structure elements of the bracket notation.
   const std::string kStructureElements = "{}";
 
+  /// Number of chunks per thread in the parallel parse_collection. More
+  /// chunks even out lines of different lengths.
+  static constexpr std::size_t kChunksPerThread = 4;
+
   /// Escape character.
   const char kEscapeChar = '\\';
 
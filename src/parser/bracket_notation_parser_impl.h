@@ -26,91 +26,221 @@
 
 #pragma once
 
-/// This is currently a copy of the previous version but with the efficient
-/// tokanization.
 template<class Label>
 node::Node<Label> BracketNotationParser<Label>::parse_single(
     const std::string& tree_string) {
+  return parse_single(tree_string.data(),
+      tree_string.data() + tree_string.size());
+}
 
-  std::vector<std::string> tokens = get_tokens(tree_string);
-
-  // Tokenize the input string - get iterator over tokens.
-  auto tokens_begin = tokens.begin();
-  auto tokens_end = tokens.end();
+template<class Label>
+node::Node<Label> BracketNotationParser<Label>::parse_single(
+    const char* begin, const char* end) {
+  node_stack.clear();
 
-  // Deal with the root node separately.
-  ++tokens_begin; // Advance tokens to label.
-  std::string match_str = *tokens_begin;
-  if (match_str == kLeftBracket || match_str == kRightBracket) { // Root has an empty label.
-    match_str = "";
-    // Do not advance tokens - we're already at kLeftBracket or kRightBracket.
-  } else { // Non-empty label.
-    ++tokens_begin; // Advance tokens.
-  }
-  Label root_label(match_str);
-  node::Node<Label> root(root_label);
+  // Deal with the root node separately. Its label starts after the first
+  // left bracket and ends at the next bracket (empty if there is none).
+  const char* iter = find_bracket(begin, end, begin);
+  const char* label_begin = iter == end ? end : iter + 1;
+  iter = find_bracket(label_begin, end, begin);
+  node::Node<Label> root(Label(std::string(label_begin, iter)));
   node_stack.push_back(std::ref(root));
 
-  bool consumed_token = false;
+  // Iterate all remaining brackets. Characters between a right bracket and
+  // the next bracket are not a label and are skipped.
+  while (iter != end && !node_stack.empty()) {
+    if (*iter == kLeftBracket[0]) { // Enter node.
+      label_begin = iter + 1;
+      iter = find_bracket(label_begin, end, begin);
+      // Move the new node to become a child.
+      // Put a reference to just-moved node (last child of its parent) on a
+      // stack.
+      node_stack.push_back(std::ref(node_stack.back().get().add_child(
+          node::Node<Label>(Label(std::string(label_begin, iter))))));
+    } else { // Exit node.
+      node_stack.pop_back();
+      iter = find_bracket(iter + 1, end, begin);
+    }
+  }
+  node_stack.clear();
+  return root;
+}
 
-  // Iterate all remaining tokens.
-  while (tokens_begin != tokens_end) {
-    match_str = *tokens_begin;
-    consumed_token = false;
+template<class Label>
+node::CompactTree BracketNotationParser<Label>::parse_single(
+    const std::string& tree_string, label::LabelDictionary<Label>& ld) {
+  return parse_single(tree_string.data(),
+      tree_string.data() + tree_string.size(), ld);
+}
 
-    if (match_str == kLeftBracket) { // Enter node.
-      consumed_token = true;
-      ++tokens_begin; // Advance tokens to label.
-      match_str = *tokens_begin;
+template<class Label>
+node::CompactTree BracketNotationParser<Label>::parse_single(
+    const char* begin, const char* end, label::LabelDictionary<Label>& ld) {
+  node::CompactTree tree;
+  compact_node_stack.clear();
 
-      if (match_str == kLeftBracket || match_str == kRightBracket) { // Node has an empty label.
-        match_str = "";
-        // Do not advance tokens - we're already at kLeftBracket or kRightBracket.
-      } else { // Non-empty label.
-        ++tokens_begin; // Advance tokens.
-      }
+  // The root's label is found like in parse_single for Node trees.
+  const char* iter = find_bracket(begin, end, begin);
+  const char* label_begin = iter == end ? end : iter + 1;
+  iter = find_bracket(label_begin, end, begin);
+  compact_node_stack.emplace_back(
+      ld.insert(Label(std::string(label_begin, iter))), 0);
 
-      // Create new node.
-      Label node_label(match_str);
-      node::Node<Label> n(node_label);
+  while (iter != end && !compact_node_stack.empty()) {
+    if (*iter == kLeftBracket[0]) { // Enter node.
+      label_begin = iter + 1;
+      iter = find_bracket(label_begin, end, begin);
+      compact_node_stack.emplace_back(
+          ld.insert(Label(std::string(label_begin, iter))),
+          tree.get_tree_size());
+    } else { // Exit node. Its subtree is complete.
+      tree.add_node(compact_node_stack.back().first,
+          tree.get_tree_size() - compact_node_stack.back().second + 1);
+      compact_node_stack.pop_back();
+      iter = find_bracket(iter + 1, end, begin);
+    }
+  }
+  // Close the nodes of a truncated input.
+  while (!compact_node_stack.empty()) {
+    tree.add_node(compact_node_stack.back().first,
+        tree.get_tree_size() - compact_node_stack.back().second + 1);
+    compact_node_stack.pop_back();
+  }
+  return tree;
+}
 
-      // Move n to become a child.
-      // Return reference from add_child to the 'new-located' object.
-      // Put a reference to just-moved n (last child of its parent) on a stack.
-      node_stack.push_back(std::ref(node_stack.back().get().add_child(n)));
+template<class Label>
+void BracketNotationParser<Label>::parse_collection(
+    std::vector<node::Node<Label>>& trees_collection,
+    const std::string& file_path) {
+#if TREE_SIMILARITY_HAS_MMAP
+  data_structures::MappedFile trees_file(file_path);
+  // Parse the trees line by line in place and move into the container.
+  parse_lines(trees_file.begin(), trees_file.end(), trees_collection);
+#else
+  std::ifstream trees_file(file_path);
+  if (!trees_file) {
+    throw std::runtime_error("ERROR: Problem with opening the file '" + file_path + "' in BracketNotationParser::parse_collection.");
+  }
+  // Read the trees line by line, parse, and move into the container.
+  std::string tree_string;
+  while (std::getline(trees_file, tree_string)) {
+    if (!validate_input(tree_string)) {
+      continue;
     }
+    trees_collection.push_back(parse_single(tree_string));
+  }
+#endif
+}
 
-    if (match_str == kRightBracket) { // Exit node.
-      consumed_token = true;
-      node_stack.pop_back();
-      ++tokens_begin; // Advance tokens.
+template<class Label>
+void BracketNotationParser<Label>::parse_collection(
+    std::vector<node::Node<Label>>& trees_collection,
+    const std::string& file_path, const int number_of_threads) {
+  const unsigned int threads = parallel::get_number_of_threads(
+      number_of_threads);
+  data_structures::MappedFile trees_file(file_path);
+  if (trees_file.size() == 0) {
+    return;
+  }
+  const char* file_begin = trees_file.begin();
+  const char* file_end = trees_file.end();
+
+  // Cut the file into chunks of whole lines. Every chunk boundary is moved
+  // forward to the beginning of the next line.
+  const std::size_t number_of_chunks = kChunksPerThread * threads;
+  const std::size_t chunk_bytes = trees_file.size() / number_of_chunks + 1;
+  std::vector<const char*> chunk_begin = {file_begin};
+  for (std::size_t c = 1; c < number_of_chunks; ++c) {
+    const char* boundary = file_end;
+    if (c * chunk_bytes < trees_file.size()) {
+      boundary = std::max(chunk_begin.back(), file_begin + c * chunk_bytes);
     }
+    if (boundary > file_begin && boundary < file_end &&
+        *(boundary - 1) != '\n') {
+      boundary = static_cast<const char*>(
+          std::memchr(boundary, '\n', file_end - boundary));
+      boundary = boundary == nullptr ? file_end : boundary + 1;
+    }
+    chunk_begin.push_back(boundary);
+  }
+  chunk_begin.push_back(file_end);
 
-    // Skip incorrect token.
-    if (consumed_token == false) {
-      ++tokens_begin; // Advance tokens.
+  // Parse the chunks. Every thread uses its own parser (and node stack).
+  std::vector<std::vector<node::Node<Label>>> chunk_trees(number_of_chunks);
+  parallel::ChunkQueue chunks(number_of_chunks, 1);
+  parallel::run_workers(threads, [&](const unsigned int) {
+    BracketNotationParser<Label> chunk_parser;
+    std::size_t chunk_id = 0;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    while (chunks.next(chunk_id, begin, end)) {
+      chunk_parser.parse_lines(chunk_begin[chunk_id],
+          chunk_begin[chunk_id + 1], chunk_trees[chunk_id]);
     }
+  });
+
+  // Move the trees into the container in the order of the lines.
+  std::size_t number_of_trees = trees_collection.size();
+  for (const auto& trees : chunk_trees) {
+    number_of_trees += trees.size();
+  }
+  trees_collection.reserve(number_of_trees);
+  for (auto& trees : chunk_trees) {
+    std::move(trees.begin(), trees.end(),
+        std::back_inserter(trees_collection));
   }
-  return root;
 }
 
 template<class Label>
 void BracketNotationParser<Label>::parse_collection(
-    std::vector<node::Node<Label>>& trees_collection,
-    const std::string& file_path) {
+    std::vector<node::CompactTree>& trees_collection,
+    label::LabelDictionary<Label>& ld, const std::string& file_path) {
+#if TREE_SIMILARITY_HAS_MMAP
+  data_structures::MappedFile trees_file(file_path);
+  const char* line_begin = trees_file.begin();
+  const char* end = trees_file.end();
+  while (line_begin < end) {
+    const char* line_end = static_cast<const char*>(
+        std::memchr(line_begin, '\n', end - line_begin));
+    if (line_end == nullptr) {
+      line_end = end;
+    }
+    if (validate_input(line_begin, line_end)) {
+      trees_collection.push_back(parse_single(line_begin, line_end, ld));
+    }
+    line_begin = line_end + 1;
+  }
+#else
   std::ifstream trees_file(file_path);
   if (!trees_file) {
-    throw std::runtime_error("ERROR: Problem with opening the file '" + file_path + "' in BracketNotationParser::parse_collection_efficient.");
+    throw std::runtime_error("ERROR: Problem with opening the file '" + file_path + "' in BracketNotationParser::parse_collection.");
   }
-  // Read the trees line by line, parse, and move into the container.
   std::string tree_string;
   while (std::getline(trees_file, tree_string)) {
     if (!validate_input(tree_string)) {
       continue;
     }
-    trees_collection.push_back(parse_single(tree_string)); // -> This invokes a move constructor (due to push_back(<rvalue>)).
+    trees_collection.push_back(parse_single(tree_string, ld));
+  }
+#endif
+}
+
+template<class Label>
+void BracketNotationParser<Label>::parse_lines(const char* begin,
+    const char* end, std::vector<node::Node<Label>>& trees_collection) {
+  const char* line_begin = begin;
+  while (line_begin < end) {
+    const char* line_end = static_cast<const char*>(
+        std::memchr(line_begin, '\n', end - line_begin));
+    if (line_end == nullptr) {
+      line_end = end;
+    }
+    if (validate_input(line_begin, line_end)) {
+      trees_collection.push_back(parse_single(line_begin, line_end));
+    }
+    line_begin = line_end + 1;
   }
-  trees_file.close();
 }
 
 /// This is only a tokanizer that returns a vector with correct tokens.
@@ -152,10 +282,17 @@ std::vector<std::string> BracketNotationParser<Label>::get_tokens(
 
 template<class Label>
 bool BracketNotationParser<Label>::validate_input(const std::string& tree_string) const {
+  return validate_input(tree_string.data(),
+      tree_string.data() + tree_string.size());
+}
+
+template<class Label>
+bool BracketNotationParser<Label>::validate_input(const char* begin,
+    const char* end) const {
   int bracket_diff_counter = 0; // Counts difference between the numbers of left and right brackets.
   int bracket_pair_counter = 0; // Counts number of bracket pairs - number of nodes assuming correct nesting.
   // Loop over all characters.
-  for(auto it = tree_string.begin(); it != tree_string.end(); ++it) {
+  for(const char* it = begin; it < end; ++it) {
     if (*it == kEscapeChar) { // Skip next character if kEscapeChar is found.
       ++it;
     } else if (*it == kLeftBracket[0]) { // Increase bracket_counter when kLeftBracket found.
@@ -170,3 +307,19 @@ bool BracketNotationParser<Label>::validate_input(const std::string& tree_string
   }
   return true;
 }
+
+template<class Label>
+const char* BracketNotationParser<Label>::find_bracket(const char* begin,
+    const char* end, const char* input_begin) const {
+  for (const char* iter = begin; iter < end; ++iter) {
+    if (*iter == kLeftBracket[0] || *iter == kRightBracket[0]) {
+      // Disregard the bracket if the character just before it is
+      // an escape_char.
+      if (iter > input_begin && *(iter-1) == kEscapeChar) {
+        continue;
+      }
+      return iter;
+    }
+  }
+  return end;
+}
@@ -57,6 +57,7 @@ class APTEDTreeIndex : public TEDAlgorithm<CostModel, TreeIndex> {
   using TEDAlgorithm<CostModel, TreeIndex>::TEDAlgorithm;
   using TEDAlgorithm<CostModel, TreeIndex>::c_;
   using TEDAlgorithm<CostModel, TreeIndex>::subproblem_counter_;
+  using TEDAlgorithm<CostModel, TreeIndex>::workspace_;
   using TEDAlgorithm<CostModel, TreeIndex>::ted;
 
 public:
@@ -65,8 +66,8 @@ public:
 
 
 private:
-  data_structures::Matrix<double> compute_opt_strategy_postL(const TreeIndex& t1, const TreeIndex& t2);
-  data_structures::Matrix<double> compute_opt_strategy_postR(const TreeIndex& t1, const TreeIndex& t2);
+  void compute_opt_strategy_postL(const TreeIndex& t1, const TreeIndex& t2);
+  void compute_opt_strategy_postR(const TreeIndex& t1, const TreeIndex& t2);
   void ted_init(const TreeIndex& t1, const TreeIndex& t2);
   double gted(const TreeIndex& t1, int t1_current_subtree,
       const TreeIndex& t2, int t2_current_subtree);
@@ -115,6 +116,30 @@ private:
   std::vector<int> fn_;
   std::vector<int> ft_;
 
+  // Working memory reused across the calls, borrowed from workspace_.
+
+  /// Rows of the strategy cost arrays of the source tree nodes. A node of
+  /// the source tree uses the rows with the same index in all three vectors.
+  std::vector<std::vector<long long int>> cost1_L_rows_;
+  std::vector<std::vector<long long int>> cost1_R_rows_;
+  std::vector<std::vector<long long int>> cost1_I_rows_;
+  /// Index of the rows used by every source tree node, -1 if none.
+  std::vector<int> cost1_row_;
+  /// Indexes of the rows that can be reused by another node.
+  std::vector<int> rows_to_reuse_;
+  /// Strategy cost arrays of the destination tree.
+  std::vector<long long int> cost2_L_;
+  std::vector<long long int> cost2_R_;
+  std::vector<long long int> cost2_I_;
+  std::vector<double> cost2_path_;
+  /// Matrices storing subforest distances in spfA.
+  data_structures::Matrix<double> spfa_s_;
+  data_structures::Matrix<double> spfa_t_;
+  /// Matrix storing subforest distances in spfL and spfR.
+  data_structures::Matrix<double> forestdist_;
+  /// Keyroot nodes in spfL and spfR.
+  std::vector<int> key_roots_;
+
 };
 
 // Implementation details.
@@ -30,9 +30,9 @@ double APTEDTreeIndex<CostModel, TreeIndex>::ted(
   // Use the heuristic from [2, Section 5.3].
   // TODO: Implement compute_opt_strategy_postR.
   // if (ni_1.lchl_ < ni_1.rchl_) {
-    delta_ = compute_opt_strategy_postL(t1, t2);
+    compute_opt_strategy_postL(t1, t2);
   // } else {
-  //   delta_ = compute_opt_strategy_postR(ni_1, ni_2);
+  //   compute_opt_strategy_postR(ni_1, ni_2);
   // }
   // Initialise structures for distance computation.
   ted_init(t1, t2);
@@ -41,46 +41,66 @@ double APTEDTreeIndex<CostModel, TreeIndex>::ted(
 }
 
 template <typename CostModel, typename TreeIndex>
-data_structures::Matrix<double> APTEDTreeIndex<CostModel, TreeIndex>::compute_opt_strategy_postL(const TreeIndex& t1, const TreeIndex& t2) {
+void APTEDTreeIndex<CostModel, TreeIndex>::compute_opt_strategy_postL(const TreeIndex& t1, const TreeIndex& t2) {
   const int size1 = t1.tree_size_;
   const int size2 = t2.tree_size_;
-  data_structures::Matrix<double> strategy(size1, size2);
-  std::vector<std::shared_ptr<std::vector<long long int>>> cost1_L(size1);
-  std::vector<std::shared_ptr<std::vector<long long int>>> cost1_R(size1);
-  std::vector<std::shared_ptr<std::vector<long long int>>> cost1_I(size1);
-  std::vector<long long int> cost2_L(size2);
-  std::vector<long long int> cost2_R(size2);
-  std::vector<long long int> cost2_I(size2);
-  std::vector<double> cost2_path(size2);
-  std::shared_ptr<std::vector<long long int>> leafRow(new std::vector<long long int>(size2));
+  // The strategy is computed directly into delta_.
+  workspace_.borrow(delta_, size1, size2);
+  data_structures::Matrix<double>& strategy = delta_;
+  // Row triple of every node in t1, -1 if the node has no rows yet.
+  workspace_.borrow(cost1_row_, size1, -1);
+  std::vector<int>& cost1_row = cost1_row_;
+  std::vector<long long int>& cost2_L = cost2_L_;
+  std::vector<long long int>& cost2_R = cost2_R_;
+  std::vector<long long int>& cost2_I = cost2_I_;
+  std::vector<double>& cost2_path = cost2_path_;
+  workspace_.borrow(cost2_L, size2);
+  workspace_.borrow(cost2_R, size2);
+  workspace_.borrow(cost2_I, size2);
+  workspace_.borrow(cost2_path, size2);
+  // Row triple 0 is the all-zero row shared by all leaves in t1.
+  const int kLeafRow = 0;
+  int rows_used = 0;
+  auto borrow_cost1_rows = [&]() {
+    if (rows_used == static_cast<int>(cost1_L_rows_.size())) {
+      cost1_L_rows_.emplace_back();
+      cost1_R_rows_.emplace_back();
+      cost1_I_rows_.emplace_back();
+    }
+    workspace_.borrow(cost1_L_rows_[rows_used], size2);
+    workspace_.borrow(cost1_R_rows_[rows_used], size2);
+    workspace_.borrow(cost1_I_rows_[rows_used], size2);
+    return rows_used++;
+  };
+  borrow_cost1_rows();
   double pathIDOffset = static_cast<double>(size1);
   long long int minCost = std::numeric_limits<long long int>::max();
   double strategyPath = -1.0;
 
-  const std::vector<int>& pre2size1 = t1.prel_to_size_;
-  const std::vector<int>& pre2size2 = t2.prel_to_size_;
-  const std::vector<long long int>& pre2descSum1 = t1.prel_to_cost_all_;
-  const std::vector<long long int>& pre2descSum2 = t2.prel_to_cost_all_;
-  const std::vector<long long int>& pre2krSum1 = t1.prel_to_cost_left_;
-  const std::vector<long long int>& pre2krSum2 = t2.prel_to_cost_left_;
-  const std::vector<long long int>& pre2revkrSum1 = t1.prel_to_cost_right_;
-  const std::vector<long long int>& pre2revkrSum2 = t2.prel_to_cost_right_;
-  const std::vector<int>& preL_to_preR_1 = t1.prel_to_prer_;
-  const std::vector<int>& preL_to_preR_2 = t2.prel_to_prer_;
-  const std::vector<int>& preR_to_preL_1 = t1.prer_to_prel_;
-  const std::vector<int>& preR_to_preL_2 = t2.prer_to_prel_;
-  const std::vector<int>& pre2parent1 = t1.prel_to_parent_;
-  const std::vector<int>& pre2parent2 = t2.prel_to_parent_;
-  const std::vector<bool>& nodeType_L_1 = t1.prel_to_type_left_;
-  const std::vector<bool>& nodeType_L_2 = t2.prel_to_type_left_;
-  const std::vector<bool>& nodeType_R_1 = t1.prel_to_type_right_;
-  const std::vector<bool>& nodeType_R_2 = t2.prel_to_type_right_;
+  const node::IndexArray<int>& pre2size1 = t1.prel_to_size_;
+  const node::IndexArray<int>& pre2size2 = t2.prel_to_size_;
+  const node::IndexArray<long long int>& pre2descSum1 = t1.prel_to_cost_all_;
+  const node::IndexArray<long long int>& pre2descSum2 = t2.prel_to_cost_all_;
+  const node::IndexArray<long long int>& pre2krSum1 = t1.prel_to_cost_left_;
+  const node::IndexArray<long long int>& pre2krSum2 = t2.prel_to_cost_left_;
+  const node::IndexArray<long long int>& pre2revkrSum1 = t1.prel_to_cost_right_;
+  const node::IndexArray<long long int>& pre2revkrSum2 = t2.prel_to_cost_right_;
+  const node::IndexArray<int>& preL_to_preR_1 = t1.prel_to_prer_;
+  const node::IndexArray<int>& preL_to_preR_2 = t2.prel_to_prer_;
+  const node::IndexArray<int>& preR_to_preL_1 = t1.prer_to_prel_;
+  const node::IndexArray<int>& preR_to_preL_2 = t2.prer_to_prel_;
+  const node::IndexArray<int>& pre2parent1 = t1.prel_to_parent_;
+  const node::IndexArray<int>& pre2parent2 = t2.prel_to_parent_;
+  const node::IndexArray<bool>& nodeType_L_1 = t1.prel_to_type_left_;
+  const node::IndexArray<bool>& nodeType_L_2 = t2.prel_to_type_left_;
+  const node::IndexArray<bool>& nodeType_R_1 = t1.prel_to_type_right_;
+  const node::IndexArray<bool>& nodeType_R_2 = t2.prel_to_type_right_;
 
-  const std::vector<int>& preL_to_postL_1 = t1.prel_to_postl_;
-  const std::vector<int>& preL_to_postL_2 = t2.prel_to_postl_;
+  const node::IndexArray<int>& preL_to_postL_1 = t1.prel_to_postl_;
+  const node::IndexArray<int>& preL_to_postL_2 = t2.prel_to_postl_;
 
-  const std::vector<int>& postL_to_preL_1 = t1.postl_to_prel_;
-  const std::vector<int>& postL_to_preL_2 = t2.postl_to_prel_;
+  const node::IndexArray<int>& postL_to_preL_1 = t1.postl_to_prel_;
+  const node::IndexArray<int>& postL_to_preL_2 = t2.postl_to_prel_;
 
   int size_v = -1;
   int parent_v_preL = -1;
@@ -90,14 +110,14 @@ data_structures::Matrix<double> APTEDTreeIndex<CostModel, TreeIndex>::compute_op
   int parent_v_postL = -1;
   double leftPath_v;
   double rightPath_v;
-  std::shared_ptr<std::vector<long long int>> cost_Lpointer_v;
-  std::shared_ptr<std::vector<long long int>> cost_Rpointer_v;
-  std::shared_ptr<std::vector<long long int>> cost_Ipointer_v;
+  long long int* cost_Lpointer_v;
+  long long int* cost_Rpointer_v;
+  long long int* cost_Ipointer_v;
   // std::vector<double>* strategypointer_v;
   std::size_t strategypointer_v;
-  std::shared_ptr<std::vector<long long int>> cost_Lpointer_parent_v;
-  std::shared_ptr<std::vector<long long int>> cost_Rpointer_parent_v;
-  std::shared_ptr<std::vector<long long int>> cost_Ipointer_parent_v;
+  long long int* cost_Lpointer_parent_v = nullptr;
+  long long int* cost_Rpointer_parent_v = nullptr;
+  long long int* cost_Ipointer_parent_v = nullptr;
   // std::vector<double>* strategypointer_parent_v;
   std::size_t strategypointer_parent_v;
   long long int krSum_v;
@@ -108,9 +128,8 @@ data_structures::Matrix<double> APTEDTreeIndex<CostModel, TreeIndex>::compute_op
   int v_in_preL;
   int w_in_preL;
 
-  std::stack<std::shared_ptr<std::vector<long long int>>> rowsToReuse_L;
-  std::stack<std::shared_ptr<std::vector<long long int>>> rowsToReuse_R;
-  std::stack<std::shared_ptr<std::vector<long long int>>> rowsToReuse_I;
+  std::vector<int>& rowsToReuse = rows_to_reuse_;
+  rowsToReuse.clear();
 
   for(int v = 0; v < size1; ++v) {
     v_in_preL = postL_to_preL_1[v];
@@ -134,38 +153,32 @@ data_structures::Matrix<double> APTEDTreeIndex<CostModel, TreeIndex>::compute_op
     descSum_v = pre2descSum1[v_in_preL];
 
     if(is_v_leaf) {
-      cost1_L[v] = leafRow;
-      cost1_R[v] = leafRow;
-      cost1_I[v] = leafRow;
+      cost1_row[v] = kLeafRow;
       for(int i = 0; i < size2; ++i) {
         // strategypointer_v[postL_to_preL_2[i]] = v_in_preL;
         strategy.at(strategypointer_v, postL_to_preL_2[i]) = static_cast<double>(v_in_preL);
       }
     }
 
-    cost_Lpointer_v = cost1_L[v];
-    cost_Rpointer_v = cost1_R[v];
-    cost_Ipointer_v = cost1_I[v];
-
-    if(parent_v_preL != -1 && cost1_L[parent_v_postL] == nullptr) {
-      if (rowsToReuse_L.empty()) {
-        cost1_L[parent_v_postL] = std::make_shared<std::vector<long long int>>(size2);
-        cost1_R[parent_v_postL] = std::make_shared<std::vector<long long int>>(size2);
-        cost1_I[parent_v_postL] = std::make_shared<std::vector<long long int>>(size2);
+    if(parent_v_preL != -1 && cost1_row[parent_v_postL] == -1) {
+      if (rowsToReuse.empty()) {
+        cost1_row[parent_v_postL] = borrow_cost1_rows();
       } else {
-        cost1_L[parent_v_postL] = rowsToReuse_L.top();
-        cost1_R[parent_v_postL] = rowsToReuse_R.top();
-        cost1_I[parent_v_postL] = rowsToReuse_I.top();
-        rowsToReuse_L.pop();
-        rowsToReuse_R.pop();
-        rowsToReuse_I.pop();
+        cost1_row[parent_v_postL] = rowsToReuse.back();
+        rowsToReuse.pop_back();
       }
     }
 
+    // NOTE: The row pointers are taken after borrowing new rows, because
+    //       borrowing may move the vectors holding the rows.
+    cost_Lpointer_v = cost1_L_rows_[cost1_row[v]].data();
+    cost_Rpointer_v = cost1_R_rows_[cost1_row[v]].data();
+    cost_Ipointer_v = cost1_I_rows_[cost1_row[v]].data();
+
     if (parent_v_preL != -1) {
-      cost_Lpointer_parent_v = cost1_L[parent_v_postL];
-      cost_Rpointer_parent_v = cost1_R[parent_v_postL];
-      cost_Ipointer_parent_v = cost1_I[parent_v_postL];
+      cost_Lpointer_parent_v = cost1_L_rows_[cost1_row[parent_v_postL]].data();
+      cost_Rpointer_parent_v = cost1_R_rows_[cost1_row[parent_v_postL]].data();
+      cost_Ipointer_parent_v = cost1_I_rows_[cost1_row[parent_v_postL]].data();
       // strategypointer_parent_v = strategy[parent_v_preL];
       strategypointer_parent_v = parent_v_preL;
     }
@@ -201,21 +214,21 @@ data_structures::Matrix<double> APTEDTreeIndex<CostModel, TreeIndex>::compute_op
       if (size_v <= 1 || size_w <= 1) { // USE NEW SINGLE_PATH FUNCTIONS FOR SMALL SUBTREES
         minCost = std::max(size_v, size_w);
       } else {
-        tmpCost = size_v * pre2krSum2[w_in_preL] + (*cost_Lpointer_v)[w];
+        tmpCost = size_v * pre2krSum2[w_in_preL] + cost_Lpointer_v[w];
         // std::cout << "tmpCost [1] = " << tmpCost << std::endl;
         if (tmpCost < minCost) {
           minCost = tmpCost;
           strategyPath = leftPath_v;
           // std::cout << "strategyPath [1] = " << strategyPath << std::endl;
         }
-        tmpCost = size_v * pre2revkrSum2[w_in_preL] + (*cost_Rpointer_v)[w];
+        tmpCost = size_v * pre2revkrSum2[w_in_preL] + cost_Rpointer_v[w];
         // std::cout << "tmpCost [2] = " << tmpCost << std::endl;
         if (tmpCost < minCost) {
           minCost = tmpCost;
           strategyPath = rightPath_v;
           // std::cout << "strategyPath [2] = " << strategyPath << std::endl;
         }
-        tmpCost = size_v * pre2descSum2[w_in_preL] + (*cost_Ipointer_v)[w];
+        tmpCost = size_v * pre2descSum2[w_in_preL] + cost_Ipointer_v[w];
         // std::cout << "tmpCost [3] = " << tmpCost << std::endl;
         if (tmpCost < minCost) {
           minCost = tmpCost;
@@ -249,21 +262,21 @@ data_structures::Matrix<double> APTEDTreeIndex<CostModel, TreeIndex>::compute_op
       // std::cout << "minCost = " << minCost << std::endl;
 
       if (parent_v_preL != -1) {
-        (*cost_Rpointer_parent_v)[w] += minCost;
-        tmpCost = -minCost + (*cost1_I[v])[w];
-        if (tmpCost < (*cost1_I[parent_v_postL])[w]) {
-          (*cost_Ipointer_parent_v)[w] = tmpCost;
+        cost_Rpointer_parent_v[w] += minCost;
+        tmpCost = -minCost + cost_Ipointer_v[w];
+        if (tmpCost < cost_Ipointer_parent_v[w]) {
+          cost_Ipointer_parent_v[w] = tmpCost;
           // strategypointer_parent_v[w_in_preL] = strategypointer_v[w_in_preL];
           strategy.at(strategypointer_parent_v, w_in_preL) = strategy.read_at(strategypointer_v, w_in_preL);
         }
         if (nodeType_R_1[v_in_preL]) {
-          (*cost_Ipointer_parent_v)[w] += (*cost_Rpointer_parent_v)[w];
-          (*cost_Rpointer_parent_v)[w] += (*cost_Rpointer_v)[w] - minCost;
+          cost_Ipointer_parent_v[w] += cost_Rpointer_parent_v[w];
+          cost_Rpointer_parent_v[w] += cost_Rpointer_v[w] - minCost;
         }
         if (nodeType_L_1[v_in_preL]) {
-          (*cost_Lpointer_parent_v)[w] += (*cost_Lpointer_v)[w];
+          cost_Lpointer_parent_v[w] += cost_Lpointer_v[w];
         } else {
-          (*cost_Lpointer_parent_v)[w] += minCost;
+          cost_Lpointer_parent_v[w] += minCost;
         }
       }
       if (parent_w_preL != -1) {
@@ -290,29 +303,25 @@ data_structures::Matrix<double> APTEDTreeIndex<CostModel, TreeIndex>::compute_op
 
     if (!(t1.prel_to_size_[v_in_preL] == 1)) {
       // Arrays.fill(cost1_L[v], 0);
-      std::fill(cost1_L[v]->begin(), cost1_L[v]->end(), 0.0);
+      std::fill(cost_Lpointer_v, cost_Lpointer_v + size2, 0);
       // Arrays.fill(cost1_R[v], 0);
-      std::fill(cost1_R[v]->begin(), cost1_R[v]->end(), 0.0);
+      std::fill(cost_Rpointer_v, cost_Rpointer_v + size2, 0);
       // Arrays.fill(cost1_I[v], 0);
-      std::fill(cost1_I[v]->begin(), cost1_I[v]->end(), 0.0);
-      rowsToReuse_L.push(cost1_L[v]);
-      rowsToReuse_R.push(cost1_R[v]);
-      rowsToReuse_I.push(cost1_I[v]);
-      // NOTE: The pointers under cost1_L[v] do not have to be nulled.
+      std::fill(cost_Ipointer_v, cost_Ipointer_v + size2, 0);
+      rowsToReuse.push_back(cost1_row[v]);
+      // NOTE: The row id under cost1_row[v] does not have to be reset.
     }
 
   }
   
   // std::cout << "strategy[0][0] = " << strategy.read_at(0, 0) << std::endl;
-  return strategy;
 }
 
 template <typename CostModel, typename TreeIndex>
-data_structures::Matrix<double> APTEDTreeIndex<CostModel, TreeIndex>::compute_opt_strategy_postR(const TreeIndex& t1, const TreeIndex& t2) {
+void APTEDTreeIndex<CostModel, TreeIndex>::compute_opt_strategy_postR(const TreeIndex& t1, const TreeIndex& t2) {
   const int size1 = t1.tree_size_;
   const int size2 = t2.tree_size_;
-  data_structures::Matrix<double> strategy(size1, size2);
-  return strategy;
+  workspace_.borrow(delta_, size1, size2);
 }
 
 template <typename CostModel, typename TreeIndex>
@@ -322,10 +331,10 @@ void APTEDTreeIndex<CostModel, TreeIndex>::ted_init(const TreeIndex& t1, const T
   // Initialize arrays.
   int max_size = std::max(t1.tree_size_, t2.tree_size_) + 1;
   // TODO: Move q initialisation to spfA.
-  q_.resize(max_size);
+  workspace_.borrow(q_, max_size);
   // TODO: Do not use fn and ft arrays [1, Section 8.4].
-  fn_.resize(max_size + 1);
-  ft_.resize(max_size + 1);
+  workspace_.borrow(fn_, max_size + 1);
+  workspace_.borrow(ft_, max_size + 1);
   // Compute subtree distances without the root nodes when one of subtrees
   // is a single node.
   int size_x = -1;
@@ -385,7 +394,7 @@ double APTEDTreeIndex<CostModel, TreeIndex>::gted(const TreeIndex& t1,
     strategyPathType = get_strategy_path_type(strategyPathID, pathIDOffset, currentSubtree1, subtreeSize1);
     parent = t1.prel_to_parent_[currentPathNode];
     while(parent >= currentSubtree1) {
-      auto& ai = t1.prel_to_children_[parent];
+      auto ai = t1.prel_to_children_[parent];
       int k = ai.size();
       for(int i = 0; i < k; ++i) {
         int child = ai[i];
@@ -426,7 +435,7 @@ double APTEDTreeIndex<CostModel, TreeIndex>::gted(const TreeIndex& t1,
   while(parent >= currentSubtree2) {
     // std::cerr << "parent = " << parent << std::endl;
     // std::cerr << "# parent's children = " << t2.prel_to_children_[parent].size() << std::endl;
-    auto& ai1 = t2.prel_to_children_[parent];
+    auto ai1 = t2.prel_to_children_[parent];
     int l = ai1.size();
     for(int j = 0; j < l; ++j) {
       int child = ai1[j];
@@ -517,16 +526,16 @@ double APTEDTreeIndex<CostModel, TreeIndex>::spfA(const TreeIndex& t1,
     int t1_current_subtree, const TreeIndex& t2,
     int t2_current_subtree, int pathID, int pathType,
     bool treesSwapped) {
-  const std::vector<int>& it2labels = t2.prel_to_label_id_;
+  const node::IndexArray<int>& it2labels = t2.prel_to_label_id_;
   // const node::Node<Label>& lFNode;
-  const std::vector<int>& it1sizes = t1.prel_to_size_;
-  const std::vector<int>& it2sizes = t2.prel_to_size_;
-  const std::vector<int>& it1parents = t1.prel_to_parent_;
-  const std::vector<int>& it2parents = t2.prel_to_parent_;
-  const std::vector<int>& it1preL_to_preR = t1.prel_to_prer_;
-  const std::vector<int>& it2preL_to_preR = t2.prel_to_prer_;
-  const std::vector<int>& it1preR_to_preL = t1.prer_to_prel_;
-  const std::vector<int>& it2preR_to_preL = t2.prer_to_prel_;
+  const node::IndexArray<int>& it1sizes = t1.prel_to_size_;
+  const node::IndexArray<int>& it2sizes = t2.prel_to_size_;
+  const node::IndexArray<int>& it1parents = t1.prel_to_parent_;
+  const node::IndexArray<int>& it2parents = t2.prel_to_parent_;
+  const node::IndexArray<int>& it1preL_to_preR = t1.prel_to_prer_;
+  const node::IndexArray<int>& it2preL_to_preR = t2.prel_to_prer_;
+  const node::IndexArray<int>& it1preR_to_preL = t1.prer_to_prel_;
+  const node::IndexArray<int>& it2preR_to_preL = t2.prer_to_prel_;
   const int currentSubtreePreL1 = t1_current_subtree;//t1.get_current_node();
   const int currentSubtreePreL2 = t2_current_subtree;//t2.get_current_node();
 
@@ -541,8 +550,10 @@ double APTEDTreeIndex<CostModel, TreeIndex>::spfA(const TreeIndex& t1,
 
   const int subtreeSize2 = t2.prel_to_size_[currentSubtreePreL2];
   const int subtreeSize1 = t1.prel_to_size_[currentSubtreePreL1];
-  data_structures::Matrix<double> t(subtreeSize2+1, subtreeSize2+1);
-  data_structures::Matrix<double> s(subtreeSize1+1, subtreeSize2+1);
+  data_structures::Matrix<double>& t = spfa_t_;
+  data_structures::Matrix<double>& s = spfa_s_;
+  workspace_.borrow(t, subtreeSize2+1, subtreeSize2+1);
+  workspace_.borrow(s, subtreeSize1+1, subtreeSize2+1);
   
   // std::vector<double> q_(std::max(input_size_1_, input_size_2_) + 1);
   
@@ -1017,9 +1028,9 @@ double APTEDTreeIndex<CostModel, TreeIndex>::spfL(const TreeIndex& t1,
     int t2_current_subtree, bool treesSwapped) {
   // Initialise the array to store the keyroot nodes in the right-hand input
   // subtree.
-  std::vector<int> keyRoots(t2.prel_to_size_[t2_current_subtree]);
+  std::vector<int>& keyRoots = key_roots_;
   // Arrays.fill(keyRoots, -1);
-  std::fill(keyRoots.begin(), keyRoots.end(), -1);
+  workspace_.borrow(keyRoots, t2.prel_to_size_[t2_current_subtree], -1);
   // Get the leftmost leaf node of the right-hand input subtree.
   int pathID = t2.prel_to_lld_[t2_current_subtree];
   // Calculate the keyroot nodes in the right-hand input subtree.
@@ -1028,7 +1039,8 @@ double APTEDTreeIndex<CostModel, TreeIndex>::spfL(const TreeIndex& t1,
   // than the number of keyroot nodes.
   int firstKeyRoot = computeKeyRoots(t2, t2_current_subtree, pathID, keyRoots, 0);
   // Initialise an array to store intermediate distances for subforest pairs.
-  data_structures::Matrix<double> forestdist(t1.prel_to_size_[t1_current_subtree]+1, t2.prel_to_size_[t2_current_subtree]+1);
+  data_structures::Matrix<double>& forestdist = forestdist_;
+  workspace_.borrow(forestdist, t1.prel_to_size_[t1_current_subtree]+1, t2.prel_to_size_[t2_current_subtree]+1);
   // Compute the distances between pairs of keyroot nodes. In the left-hand
   // input subtree only the root is the keyroot. Thus, we compute the distance
   // between the left-hand input subtree and all keyroot nodes in the
@@ -1126,9 +1138,9 @@ double APTEDTreeIndex<CostModel, TreeIndex>::spfR(const TreeIndex& t1,
     int t2_current_subtree, bool treesSwapped) {
   // Initialise the array to store the keyroot nodes in the right-hand input
   // subtree.
-  std::vector<int> revKeyRoots(t2.prel_to_size_[t2_current_subtree]);
+  std::vector<int>& revKeyRoots = key_roots_;
   // Arrays.fill(revKeyRoots, -1);
-  std::fill(revKeyRoots.begin(), revKeyRoots.end(), -1);
+  workspace_.borrow(revKeyRoots, t2.prel_to_size_[t2_current_subtree], -1);
   // Get the rightmost leaf node of the right-hand input subtree.
   int pathID = t2.prel_to_rld_[t2_current_subtree];
   // Calculate the keyroot nodes in the right-hand input subtree.
@@ -1137,7 +1149,8 @@ double APTEDTreeIndex<CostModel, TreeIndex>::spfR(const TreeIndex& t1,
   // than the number of keyroot nodes.
   int firstKeyRoot = computeRevKeyRoots(t2, t2_current_subtree, pathID, revKeyRoots, 0);
   // Initialise an array to store intermediate distances for subforest pairs.
-  data_structures::Matrix<double> forestdist(t1.prel_to_size_[t1_current_subtree]+1, t2.prel_to_size_[t2_current_subtree]+1);
+  data_structures::Matrix<double>& forestdist = forestdist_;
+  workspace_.borrow(forestdist, t1.prel_to_size_[t1_current_subtree]+1, t2.prel_to_size_[t2_current_subtree]+1);
   // Compute the distances between pairs of keyroot nodes. In the left-hand
   // input subtree only the root is the keyroot. Thus, we compute the distance
   // between the left-hand input subtree and all keyroot nodes in the
@@ -68,6 +68,7 @@ public:
   using TEDAlgorithm<CostModel, TreeIndex>::TEDAlgorithm;
   using TEDAlgorithm<CostModel, TreeIndex>::c_;
   using TEDAlgorithm<CostModel, TreeIndex>::subproblem_counter_;
+  using TEDAlgorithm<CostModel, TreeIndex>::workspace_;
   using TEDAlgorithm<CostModel, TreeIndex>::ted;
 
   /// Implements ted function from the TEDAlgorithm<CostModel, TreeIndex> class.
@@ -86,9 +87,8 @@ public:
     // NOTE: This `+1` influences BandMatrix width.
     int k = std::abs(t1.tree_size_ - t2.tree_size_) + 1;
 
-    // TODO: When computing ted without k, the matrices are newly initialised.
-    //       Maybe resizing would be more efficient - but it needs to be
-    //       implemented.
+    // NOTE: Every ted_k call below reinitialises the matrices, reusing the
+    //       storage borrowed by the previous call.
 
     double distance = ted_k(t1, t2, k);
     while (k < distance) {
@@ -104,23 +104,19 @@ public:
   };
 
   void init_matrices(int t1_size, int k) {
-    using data_structures::BandMatrix;
-    // NOTE: The default constructor of Matrix is called while constructing
-    //       the algorithm object.
-    // QUESTION: Shouldn't we implement Matrix::resize() instead of constructing
-    //           matrix again?
+    // NOTE: The matrices reuse their storage from previous calls and only
+    //       grow if t1_size or k exceed all previous values.
     // NOTE: The k may be larger than |T2| that uses more memory than needed.
-    td_ = BandMatrix<double>(t1_size, k);
     // Fill in for initially marking all subtree pairs as not eligable, and for debugging.
     // td_.fill_with(std::numeric_limits<double>::signaling_NaN());
-    td_.Matrix::fill_with(std::numeric_limits<double>::infinity());
+    workspace_.borrow(td_, t1_size, k, std::numeric_limits<double>::infinity());
     // NOTE: The band_width=e for Touzet's fd_ matrix varies. It is however
     //       smaller or equal to the initialised band_width=k+1. As long as we
     //       read and write using the original band_width, addresses are not
     //       messed up. We only have to ensure that we do not iterate over too
     //       many elements using k instead of e.
-    fd_ = BandMatrix<double>(t1_size + 1, k + 1);
-    fd_.Matrix::fill_with(std::numeric_limits<double>::infinity());
+    workspace_.borrow(fd_, t1_size + 1, k + 1,
+        std::numeric_limits<double>::infinity());
   };
 
   /// Computes the tree edit distance given a maximum number of deletions and insertions.
@@ -45,6 +45,7 @@ class ZhangShashaTreeIndex : public TEDAlgorithm<CostModel, TreeIndex> {
   using TEDAlgorithm<CostModel, TreeIndex>::TEDAlgorithm;
   using TEDAlgorithm<CostModel, TreeIndex>::c_;
   using TEDAlgorithm<CostModel, TreeIndex>::subproblem_counter_;
+  using TEDAlgorithm<CostModel, TreeIndex>::workspace_;
   using TEDAlgorithm<CostModel, TreeIndex>::ted;
 
 public:
@@ -27,15 +27,12 @@ template <typename CostModel, typename TreeIndex>
 double ZhangShashaTreeIndex<CostModel, TreeIndex>::ted(
     const TreeIndex& t1, const TreeIndex& t2) {
   
-  using data_structures::Matrix;
-
   const int kT1Size = t1.tree_size_;
   const int kT2Size = t2.tree_size_;
 
-  // NOTE: The default constructor of Matrix is called while constructing ZS-Algorithm.
-  // NOTE: Shouldn't we implement Matrix::resize() instead of constructing matrix again?
-  td_ = Matrix<double>(kT1Size+1, kT2Size+1);
-  fd_ = Matrix<double>(kT1Size+1, kT2Size+1);
+  // NOTE: The matrices reuse their storage from previous calls.
+  workspace_.borrow(td_, kT1Size+1, kT2Size+1);
+  workspace_.borrow(fd_, kT1Size+1, kT2Size+1);
 
   // Reset subproblem counter.
   subproblem_counter_ = 0;
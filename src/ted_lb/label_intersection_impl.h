@@ -31,14 +31,13 @@ double LabelIntersection<CostModel, TreeIndex>::ted(
   unsigned long int label_int = 0;
 
   // Verify for each node of the first tree, whether it appears in the second.
+  const auto& tree2 = t2.inverted_list_label_id_to_postl_;
   for (auto& element: t1.inverted_list_label_id_to_postl_) {
-    auto tree2 = t2.inverted_list_label_id_to_postl_;
-    std::unordered_map<int,std::vector<int>>::iterator it =
-      tree2.find(element.first);
+    auto it = tree2.find(element.first);
     // If the node with a certain label exists in both trees, the smaller
     // number is the intersection for the specific label.
     if (it != tree2.end()) {
-      label_int += std::min(element.second.size(), tree2[element.first].size());
+      label_int += std::min(element.second.size(), it->second.size());
     }
   }
 
@@ -44,6 +44,7 @@ class CTEDTreeIndex : public ted::TEDAlgorithm<CostModel, TreeIndex> {
   // Base class members made visible for this class.
   using ted::TEDAlgorithm<CostModel, TreeIndex>::TEDAlgorithm;
   using ted::TEDAlgorithm<CostModel, TreeIndex>::subproblem_counter_;
+  using ted::TEDAlgorithm<CostModel, TreeIndex>::workspace_;
   using ted::TEDAlgorithm<CostModel, TreeIndex>::ted;
   using ted::TEDAlgorithm<CostModel, TreeIndex>::c_;
 
@@ -63,6 +64,10 @@ private:
   data_structures::Matrix<double> df_;
   /// TODO
   data_structures::Matrix<double> e_;
+  /// Row of minimum subtree distances per parent in the destination tree.
+  std::vector<double> dt2_;
+  /// Row of minimum subforest distances per parent in the destination tree.
+  std::vector<double> df2_;
 };
 
 // Implementation details.
@@ -32,20 +32,16 @@ double CTEDTreeIndex<CostModel, TreeIndex>::ted(const TreeIndex& t1, const TreeI
   int t1_input_size = t1.tree_size_;
   int t2_input_size = t2.tree_size_;
   
-  // Initialise distance matrices.
+  // Initialise distance matrices with inf.
+  workspace_.borrow(dt_, t1_input_size+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
+  workspace_.borrow(df_, t1_input_size+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
+  workspace_.borrow(e_, t1_input_size+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
   
-  // TODO: Verify if a move assignment operator is used here.
-  dt_ = data_structures::Matrix<double>(t1_input_size+1, t2_input_size+1);
-  df_ = data_structures::Matrix<double>(t1_input_size+1, t2_input_size+1);
-  e_ = data_structures::Matrix<double>(t1_input_size+1, t2_input_size+1);
-  
-  // Fill the matrices with inf.
-  dt_.fill_with(std::numeric_limits<double>::infinity());
-  df_.fill_with(std::numeric_limits<double>::infinity());
-  e_.fill_with(std::numeric_limits<double>::infinity());
-  
-  std::vector<double> dt2(t2_input_size + 1);
-  std::vector<double> df2(t2_input_size + 1);
+  workspace_.borrow(dt2_, t2_input_size + 1);
+  workspace_.borrow(df2_, t2_input_size + 1);
   
   double a = -1;
   double b = -1;
@@ -69,8 +65,8 @@ double CTEDTreeIndex<CostModel, TreeIndex>::ted(const TreeIndex& t1, const TreeI
   }
   
   for (int i = 1; i <= t1_input_size; ++i) {
-    std::fill(dt2.begin(), dt2.end(), std::numeric_limits<double>::infinity());
-    std::fill(df2.begin(), df2.end(), std::numeric_limits<double>::infinity());
+    std::fill(dt2_.begin(), dt2_.end(), std::numeric_limits<double>::infinity());
+    std::fill(df2_.begin(), df2_.end(), std::numeric_limits<double>::infinity());
     
     for (int j = 1; j <= t2_input_size; ++j) {
       e_.at(0, 0) = 0;
@@ -92,24 +88,24 @@ double CTEDTreeIndex<CostModel, TreeIndex>::ted(const TreeIndex& t1, const TreeI
         }
       }
       
-      a = df_.at(0, j) + df2[j];
+      a = df_.at(0, j) + df2_[j];
       b = df_.at(i, 0) + df_.at(i, j);
       c = e_.at(t1.postl_to_children_[i-1].size(), t2.postl_to_children_[j-1].size());
       
       df_.at(i, j) = a >= b ? b >= c ? c : b : a >= c ? c : a;
       
-      a = dt_.at(0, j) + dt2[j];
+      a = dt_.at(0, j) + dt2_[j];
       b = dt_.at(i, 0) + dt_.at(i, j);
       c = df_.at(i, j) + c_.ren(t1.postl_to_label_id_[i - 1], t2.postl_to_label_id_[j - 1]);
       
       dt_.at(i, j) = a >= b ? b >= c ? c : b : a >= c ? c : a;
       
       if (t2.postl_to_parent_[j-1] > -1) {
-        if (df_.at(i, j) - df_.at(0, j) < df2[t2.postl_to_parent_[j-1]+1]) {
-          df2[t2.postl_to_parent_[j-1]+1] = df_.at(i, j) - df_.at(0, j);
+        if (df_.at(i, j) - df_.at(0, j) < df2_[t2.postl_to_parent_[j-1]+1]) {
+          df2_[t2.postl_to_parent_[j-1]+1] = df_.at(i, j) - df_.at(0, j);
         }
-        if (dt_.at(i, j) - dt_.at(0, j) < dt2[t2.postl_to_parent_[j-1]+1]) {
-          dt2[t2.postl_to_parent_[j-1]+1] = dt_.at(i, j) - dt_.at(0, j);
+        if (dt_.at(i, j) - dt_.at(0, j) < dt2_[t2.postl_to_parent_[j-1]+1]) {
+          dt2_[t2.postl_to_parent_[j-1]+1] = dt_.at(i, j) - dt_.at(0, j);
         }
       }
       if (t1.postl_to_parent_[i-1] > -1) {
@@ -137,20 +133,16 @@ double CTEDTreeIndex<CostModel, TreeIndex>::ted_k(const TreeIndex& t1,
   int t1_input_size = t1.tree_size_;
   int t2_input_size = t2.tree_size_;
   
-  // Initialise distance matrices.
-  
-  // TODO: Verify if a move assignment operator is used here.
-  dt_ = data_structures::Matrix<double>(t1_input_size+1, t2_input_size+1);
-  df_ = data_structures::Matrix<double>(t1_input_size+1, t2_input_size+1);
-  e_ = data_structures::Matrix<double>(t1_input_size+1, t2_input_size+1);
-  
-  // Fill the matrices with inf.
-  dt_.fill_with(std::numeric_limits<double>::infinity());
-  df_.fill_with(std::numeric_limits<double>::infinity());
-  e_.fill_with(std::numeric_limits<double>::infinity());
+  // Initialise distance matrices with inf.
+  workspace_.borrow(dt_, t1_input_size+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
+  workspace_.borrow(df_, t1_input_size+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
+  workspace_.borrow(e_, t1_input_size+1, t2_input_size+1,
+      std::numeric_limits<double>::infinity());
 
-  std::vector<double> dt2(t2_input_size + 1);
-  std::vector<double> df2(t2_input_size + 1);
+  workspace_.borrow(dt2_, t2_input_size + 1);
+  workspace_.borrow(df2_, t2_input_size + 1);
   
   double a = -1;
   double b = -1;
@@ -150,12 +150,12 @@ private:
   /// Updates mapped descendants counters when node is not mapped.
   /// NOTE: Use only when node ids are ordered.
   void update_desc_when_not_mapped(const int node,
-      std::vector<int>& count_mapped_desc, const std::vector<int>& parent,
+      std::vector<int>& count_mapped_desc, const node::IndexArray<int>& parent,
       const int input_size) const;
   /// Updates mapped descendants counters when node is mapped.
   /// NOTE: Use only when node ids are ordered.
   void update_desc_when_mapped(const int node,
-      std::vector<int>& count_mapped_desc, const std::vector<int>& parent,
+      std::vector<int>& count_mapped_desc, const node::IndexArray<int>& parent,
       const int input_size) const;
   /// Updates mapped descendants counters when node is not mapped.
   /// NOTE: Can be uses when node ids are not ordered.
@@ -163,7 +163,7 @@ private:
   void update_prop_desc_when_not_mapped(const int node,
       std::vector<int>& count_mapped_desc,
       std::vector<int>& propagate_mapped_desc_count,
-      const std::vector<int>& parent,
+      const node::IndexArray<int>& parent,
       const int input_size) const;
   /// Updates mapped descendants counters when node is mapped.
   /// NOTE: Can be uses when node ids are not ordered.
@@ -171,7 +171,7 @@ private:
   void update_prop_desc_when_mapped(const int node,
       std::vector<int>& count_mapped_desc,
       std::vector<int>& propagate_mapped_desc_count,
-      const std::vector<int>& parent,
+      const node::IndexArray<int>& parent,
       const int input_size) const;
   /// Reads a TED mapping and counts for each node the number of its mapped
   /// ancestors. Stores the values in the passed vectors.
@@ -124,7 +124,7 @@ std::vector<std::pair<int, int>> LGMTreeIndex<CostModel, TreeIndex>::lb_mapping_
 template <typename CostModel, typename TreeIndex>
 void LGMTreeIndex<CostModel, TreeIndex>::update_desc_when_not_mapped(
     const int node, std::vector<int>& count_mapped_desc,
-    const std::vector<int>& parent, const int input_size) const {
+    const node::IndexArray<int>& parent, const int input_size) const {
   if (node < input_size - 1) { // Root has no parent nor the right leaf, and
                                // the nodes of dummy mapping in fill_gaps_in_mapping
                                // do not exist.
@@ -135,7 +135,7 @@ void LGMTreeIndex<CostModel, TreeIndex>::update_desc_when_not_mapped(
 template <typename CostModel, typename TreeIndex>
 void LGMTreeIndex<CostModel, TreeIndex>::update_desc_when_mapped(
     const int node, std::vector<int>& count_mapped_desc,
-    const std::vector<int>& parent, const int input_size) const {
+    const node::IndexArray<int>& parent, const int input_size) const {
   if (node < input_size - 1) { // Root has no parent nor the right leaf, and
                                // the nodes of dummy mapping in fill_gaps_in_mapping
                                // do not exist.
@@ -147,7 +147,7 @@ template <typename CostModel, typename TreeIndex>
 void LGMTreeIndex<CostModel, TreeIndex>::update_prop_desc_when_not_mapped(
     const int node, std::vector<int>& count_mapped_desc,
     std::vector<int>& propagate_mapped_desc_count,
-    const std::vector<int>& parent, const int input_size) const {
+    const node::IndexArray<int>& parent, const int input_size) const {
   int prop = propagate_mapped_desc_count[node];
   if (prop > 0) {
     if (node < input_size - 1) { // Root has no parent nor the right leaf, and
@@ -165,7 +165,7 @@ template <typename CostModel, typename TreeIndex>
 void LGMTreeIndex<CostModel, TreeIndex>::update_prop_desc_when_mapped(
     const int node, std::vector<int>& count_mapped_desc,
     std::vector<int>& propagate_mapped_desc_count,
-    const std::vector<int>& parent, const int input_size) const {
+    const node::IndexArray<int>& parent, const int input_size) const {
   if (node < input_size - 1) { // Root has no parent nor the right leaf, and
                                // the nodes of dummy mapping in fill_gaps_in_mapping
                                // do not exist.
@@ -2,6 +2,7 @@ list(
   APPEND CTEST_CUSTOM_MEMCHECK_IGNORE
   ted_join_correctness_test_naivejoin_129
   ted_join_correctness_test_tjoin_129
+  ted_join_correctness_test_tjoinparallel_129
   ted_join_correctness_test_tangjoin_129
   ted_join_correctness_test_guhajoin_129
   ted_join_correctness_test_bbjoin_129
@@ -0,0 +1,110 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// \file common/lookup_test_data.h
+///
+/// \details
+/// Shared setup of the lookup tests. All of them read the trees of
+/// lookup_test_data.txt, which the CMake loop of test/lookup copies once.
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "tree_index_collection.h"
+#include "label_set_element.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+
+namespace lookup_test {
+
+/// File with the trees of the lookup tests.
+const std::string kTestDataFile = "lookup_test_data.txt";
+
+/// Number of leading trees in kTestDataFile for which JOFilter computes the
+/// exact distance. The trees after them reorder arrays.
+const std::size_t kJOFilterExactTrees = 60;
+
+/// Parses the trees of the lookup tests.
+///
+/// \param trees_collection Vector to append the trees to.
+/// \return False if there are no trees; an error is printed.
+template <typename Label>
+bool parse_trees(std::vector<node::Node<Label>>& trees_collection) {
+  parser::BracketNotationParser<Label> bnp;
+  bnp.parse_collection(trees_collection, kTestDataFile);
+  if (trees_collection.empty()) {
+    std::cerr << "Error while reading the test trees." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/// Trees of the lookup tests, indexed for VerificationAlgorithm, converted
+/// into label sets, and in a TwoStageInvertedList.
+template <typename Label, typename VerificationAlgorithm>
+struct LookupTestData {
+  /// Parsed trees.
+  std::vector<node::Node<Label>> trees_collection;
+  /// Indexed trees of the verification.
+  node::TreeIndexCollection<Label,
+      typename VerificationAlgorithm::AlgsTreeIndex> indexed_collection;
+  /// Label sets of the trees.
+  std::vector<std::pair<int,
+      std::vector<label_set_converter_index::LabelSetElement>>> sets_collection;
+  /// Pairs of tree size and set id in ascending size.
+  std::vector<std::pair<int, int>> size_setid_map;
+  /// Converter of the label sets.
+  label_set_converter_index::Converter<Label> converter;
+  /// Inverted list built on sets_collection.
+  lookup::TwoStageInvertedList index{0};
+  /// Parses the trees, indexes and converts them, and builds the inverted
+  /// list.
+  ///
+  /// \param number_of_trees Only the leading trees are kept.
+  /// \return False if there are no trees; an error is printed.
+  bool load(const std::size_t number_of_trees =
+      std::numeric_limits<std::size_t>::max()) {
+    if (!parse_trees(trees_collection)) {
+      return false;
+    }
+    if (trees_collection.size() > number_of_trees) {
+      trees_collection.erase(trees_collection.begin() + number_of_trees,
+          trees_collection.end());
+    }
+    typename VerificationAlgorithm::AlgsCostModel cm(
+        indexed_collection.get_label_dictionary());
+    indexed_collection.build(trees_collection, cm);
+    converter.assignFrequencyIdentifiers(trees_collection, sets_collection,
+        size_setid_map);
+    index = lookup::TwoStageInvertedList(converter.get_number_of_labels());
+    index.build(sets_collection);
+    return true;
+  }
+};
+
+}
@@ -65,11 +65,11 @@ const std::string vector_to_string(const std::vector<T>& v) {
  * \return String representation of v.
  */
 const std::string vector_to_string(const std::vector<double>& v) {
-  char int_part[2];
+  char int_part[32];
   // printf ("[%s] is a string %d chars long\n",buffer,n);
   std::string s("{");
   for (auto e : v) {
-    sprintf(int_part, "%.0f", e);
+    snprintf(int_part, sizeof(int_part), "%.0f", e);
     s += std::string(int_part) + ",";
   }
   s.pop_back();
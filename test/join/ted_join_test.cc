@@ -2,10 +2,13 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <algorithm>
+#include <tuple>
 #include "unit_cost_model.h"
 #include "string_label.h"
 #include "node.h"
 #include "bracket_notation_parser.h"
+#include "binary_collection.h"
 #include "tree_indexer.h"
 #include "to_string_converters.h"
 #include "touzet_baseline_tree_index.h"
@@ -74,6 +77,67 @@ int main(int, char** argv) {
         return -1;
       }
     }
+  } else if (ted_join_algorithm_name == "naivejoinparallel") {
+    for (int i = min_thres; i <= max_thres; i += thres_step) {
+      join::NaiveJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> ted_join_algorithm(4);
+      auto join_result = ted_join_algorithm.execute_join(trees_collection, (double)i);
+      if (join_result.size() != results[i - 1]) {
+        std::cout << " ERROR Incorrect join result for threshold " << i << ": " <<
+            join_result.size() << " instead of " << results[i - 1] << std::endl;
+        return -1;
+      }
+      // The result has to be identical to the single-threaded one.
+      join::NaiveJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> serial_join_algorithm;
+      auto serial_join_result = serial_join_algorithm.execute_join(trees_collection, (double)i);
+      if (join_result.size() != serial_join_result.size()) {
+        std::cout << " ERROR Parallel join result has " << join_result.size() <<
+            " pairs instead of " << serial_join_result.size() <<
+            " for threshold " << i << std::endl;
+        return -1;
+      }
+      for (std::size_t r = 0; r < join_result.size(); ++r) {
+        if (join_result[r].tree_id_1 != serial_join_result[r].tree_id_1 ||
+            join_result[r].tree_id_2 != serial_join_result[r].tree_id_2 ||
+            join_result[r].ted_value != serial_join_result[r].ted_value) {
+          std::cout << " ERROR Parallel join result differs at position " << r <<
+              " for threshold " << i << std::endl;
+          return -1;
+        }
+      }
+    }
+  } else if (ted_join_algorithm_name == "naivejoinstream") {
+    for (int i = min_thres; i <= max_thres; i += thres_step) {
+      join::NaiveJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> ted_join_algorithm;
+      auto join_result = ted_join_algorithm.execute_join(trees_collection, (double)i);
+      // The streamed result arrives in batches of at most 3 pairs and in the
+      // same order as the vector result, for one and for multiple threads.
+      for (const int number_of_threads : {1, 4}) {
+        std::vector<join::JoinResultElement> streamed_result;
+        bool oversized_batch = false;
+        data_structures::ResultSink<join::JoinResultElement> sink(
+            [&](const std::vector<join::JoinResultElement>& batch) {
+              oversized_batch = oversized_batch || batch.size() > 3;
+              streamed_result.insert(streamed_result.end(), batch.begin(),
+                  batch.end());
+            }, 3);
+        join::NaiveJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> stream_join_algorithm(number_of_threads);
+        stream_join_algorithm.execute_join(trees_collection, sink, (double)i);
+        if (streamed_result.size() != results[i - 1] || oversized_batch) {
+          std::cout << " ERROR Incorrect streamed join result for threshold " << i << ": " <<
+              streamed_result.size() << " instead of " << results[i - 1] << std::endl;
+          return -1;
+        }
+        for (std::size_t r = 0; r < join_result.size(); ++r) {
+          if (join_result[r].tree_id_1 != streamed_result[r].tree_id_1 ||
+              join_result[r].tree_id_2 != streamed_result[r].tree_id_2 ||
+              join_result[r].ted_value != streamed_result[r].ted_value) {
+            std::cout << " ERROR Streamed join result differs at position " << r <<
+                " for threshold " << i << std::endl;
+            return -1;
+          }
+        }
+      }
+    }
   } else if (ted_join_algorithm_name == "tjoin") {
     for (int i = min_thres; i <= max_thres; i += thres_step) {
       std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> sets_collection;
@@ -88,6 +152,256 @@ int main(int, char** argv) {
         return -1;
       }
     }
+  } else if (ted_join_algorithm_name == "tjoinparallel") {
+    for (int i = min_thres; i <= max_thres; i += thres_step) {
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> sets_collection;
+      std::vector<std::pair<int, int>> candidates;
+      std::vector<join::JoinResultElement> join_result;
+      join::TJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> ted_join_algorithm(4);
+      ted_join_algorithm.execute_join(trees_collection,
+          sets_collection, candidates, join_result, (double)i);
+      if (join_result.size() != results[i - 1]) {
+        std::cout << " ERROR Incorrect join result for threshold " << i << ": " <<
+            join_result.size() << " instead of " << results[i - 1] << std::endl;
+        return -1;
+      }
+      // The candidate generation has to return the same candidates as the
+      // single-threaded one.
+      std::vector<std::pair<int, int>> parallel_candidates;
+      ted_join_algorithm.retrieve_candidates(sets_collection,
+          parallel_candidates, (double)i);
+      join::TJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> serial_join_algorithm;
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> serial_sets_collection;
+      std::vector<std::pair<int, int>> serial_candidates;
+      serial_join_algorithm.convert_trees_to_sets(trees_collection,
+          serial_sets_collection);
+      serial_join_algorithm.retrieve_candidates(serial_sets_collection,
+          serial_candidates, (double)i);
+      if (parallel_candidates != serial_candidates ||
+          ted_join_algorithm.get_number_of_pre_candidates() !=
+          serial_join_algorithm.get_number_of_pre_candidates() ||
+          ted_join_algorithm.get_number_of_il_lookups() !=
+          serial_join_algorithm.get_number_of_il_lookups()) {
+        std::cout << " ERROR Parallel candidates differ for threshold " << i <<
+            ": " << parallel_candidates.size() << " instead of " <<
+            serial_candidates.size() << std::endl;
+        return -1;
+      }
+    }
+  } else if (ted_join_algorithm_name == "tjoincompressed") {
+    for (int i = min_thres; i <= max_thres; i += thres_step) {
+      join::TJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> serial_join_algorithm;
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> serial_sets_collection;
+      std::vector<std::pair<int, int>> serial_candidates;
+      serial_join_algorithm.convert_trees_to_sets(trees_collection,
+          serial_sets_collection);
+      serial_join_algorithm.retrieve_candidates(serial_sets_collection,
+          serial_candidates, (double)i);
+      // The compressed inverted lists have to return the same candidates,
+      // with one and with multiple threads.
+      for (int threads : {1, 4}) {
+        std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> sets_collection;
+        std::vector<std::pair<int, int>> candidates;
+        std::vector<join::JoinResultElement> join_result;
+        join::TJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> ted_join_algorithm(threads);
+        ted_join_algorithm.set_candidate_index_compression(true);
+        ted_join_algorithm.execute_join(trees_collection,
+            sets_collection, candidates, join_result, (double)i);
+        if (join_result.size() != results[i - 1]) {
+          std::cout << " ERROR Incorrect join result for threshold " << i << ": " <<
+              join_result.size() << " instead of " << results[i - 1] << std::endl;
+          return -1;
+        }
+        std::vector<std::pair<int, int>> compressed_candidates;
+        ted_join_algorithm.retrieve_candidates(sets_collection,
+            compressed_candidates, (double)i);
+        if (compressed_candidates != serial_candidates ||
+            ted_join_algorithm.get_number_of_pre_candidates() !=
+            serial_join_algorithm.get_number_of_pre_candidates() ||
+            ted_join_algorithm.get_number_of_il_lookups() !=
+            serial_join_algorithm.get_number_of_il_lookups()) {
+          std::cout << " ERROR Compressed candidates differ for threshold " <<
+              i << " with " << threads << " threads: " <<
+              compressed_candidates.size() << " instead of " <<
+              serial_candidates.size() << std::endl;
+          return -1;
+        }
+      }
+    }
+  } else if (ted_join_algorithm_name == "tjoinstream") {
+    for (int i = min_thres; i <= max_thres; i += thres_step) {
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> sets_collection;
+      std::vector<std::pair<int, int>> candidates;
+      std::vector<join::JoinResultElement> join_result;
+      join::TJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> ted_join_algorithm(4);
+      ted_join_algorithm.execute_join(trees_collection,
+          sets_collection, candidates, join_result, (double)i);
+      // The streamed result arrives in batches of at most 3 pairs and in
+      // the same order as the vector result.
+      std::vector<join::JoinResultElement> streamed_result;
+      bool oversized_batch = false;
+      data_structures::ResultSink<join::JoinResultElement> sink(
+          [&](const std::vector<join::JoinResultElement>& batch) {
+            oversized_batch = oversized_batch || batch.size() > 3;
+            streamed_result.insert(streamed_result.end(), batch.begin(),
+                batch.end());
+          }, 3);
+      sets_collection.clear();
+      candidates.clear();
+      join::TJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> stream_join_algorithm(4);
+      stream_join_algorithm.execute_join(trees_collection,
+          sets_collection, candidates, sink, (double)i);
+      if (streamed_result.size() != results[i - 1] || oversized_batch) {
+        std::cout << " ERROR Incorrect streamed join result for threshold " << i << ": " <<
+            streamed_result.size() << " instead of " << results[i - 1] << std::endl;
+        return -1;
+      }
+      for (std::size_t r = 0; r < join_result.size(); ++r) {
+        if (join_result[r].tree_id_1 != streamed_result[r].tree_id_1 ||
+            join_result[r].tree_id_2 != streamed_result[r].tree_id_2 ||
+            join_result[r].ted_value != streamed_result[r].ted_value) {
+          std::cout << " ERROR Streamed join result differs at position " << r <<
+              " for threshold " << i << std::endl;
+          return -1;
+        }
+      }
+    }
+  } else if (ted_join_algorithm_name == "tjoinpipeline") {
+    for (int i = min_thres; i <= max_thres; i += thres_step) {
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> sets_collection;
+      std::vector<std::pair<int, int>> candidates;
+      std::vector<join::JoinResultElement> join_result;
+      join::TJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> ted_join_algorithm;
+      ted_join_algorithm.execute_join(trees_collection,
+          sets_collection, candidates, join_result, (double)i);
+      std::vector<std::tuple<int, int, double>> expected;
+      for (const auto& r : join_result)
+        expected.emplace_back(r.tree_id_1, r.tree_id_2, r.ted_value);
+      std::sort(expected.begin(), expected.end());
+      // The pipelined join returns the same pairs for every number of
+      // threads, in the same order.
+      std::vector<join::JoinResultElement> first_result;
+      for (int threads : {1, 4}) {
+        std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> pipeline_sets_collection;
+        std::vector<join::JoinResultElement> pipeline_result;
+        join::TJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> pipeline_join_algorithm(threads);
+        pipeline_join_algorithm.execute_pipelined_join(trees_collection,
+            pipeline_sets_collection, pipeline_result, (double)i);
+        std::vector<std::tuple<int, int, double>> computed;
+        for (const auto& r : pipeline_result)
+          computed.emplace_back(r.tree_id_1, r.tree_id_2, r.ted_value);
+        std::sort(computed.begin(), computed.end());
+        if (pipeline_result.size() != results[i - 1] || computed != expected ||
+            pipeline_join_algorithm.get_number_of_pre_candidates() !=
+            ted_join_algorithm.get_number_of_pre_candidates()) {
+          std::cout << " ERROR Incorrect pipelined join result for threshold " << i <<
+              " and " << threads << " threads: " << pipeline_result.size() <<
+              " instead of " << results[i - 1] << std::endl;
+          return -1;
+        }
+        if (threads == 1) {
+          first_result = pipeline_result;
+          continue;
+        }
+        for (std::size_t r = 0; r < pipeline_result.size(); ++r) {
+          if (pipeline_result[r].tree_id_1 != first_result[r].tree_id_1 ||
+              pipeline_result[r].tree_id_2 != first_result[r].tree_id_2) {
+            std::cout << " ERROR Pipelined join result differs at position " << r <<
+                " for threshold " << i << std::endl;
+            return -1;
+          }
+        }
+      }
+    }
+  } else if (ted_join_algorithm_name == "binaryjoin") {
+    using TJoin = join::TJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>>;
+    using NaiveJoin = join::NaiveJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>>;
+    // The joins on the indexes of a binary collection have to return the
+    // same result as the joins on the parsed trees.
+    std::string binary_file_path = input_file_name + ".bin";
+    parser::BinaryCollection<Label>::write(trees_collection, binary_file_path);
+    parser::BinaryCollection<Label> binary_collection(binary_file_path);
+    node::TreeIndexCollection<Label, TJoin::JoinTreeIndex> tjoin_indexes;
+    CostModel tjoin_cm(tjoin_indexes.get_label_dictionary());
+    binary_collection.build_indexes(tjoin_indexes, tjoin_cm);
+    node::TreeIndexCollection<Label, node::TreeIndexTouzetBaseline> naive_indexes;
+    CostModel naive_cm(naive_indexes.get_label_dictionary());
+    binary_collection.build_indexes(naive_indexes, naive_cm);
+    auto same_result = [](const std::vector<join::JoinResultElement>& a,
+        const std::vector<join::JoinResultElement>& b) {
+      if (a.size() != b.size()) {
+        return false;
+      }
+      for (std::size_t r = 0; r < a.size(); ++r) {
+        if (a[r].tree_id_1 != b[r].tree_id_1 ||
+            a[r].tree_id_2 != b[r].tree_id_2 ||
+            a[r].ted_value != b[r].ted_value) {
+          return false;
+        }
+      }
+      return true;
+    };
+    // The label sets converted from the indexes equal those of the trees.
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> tree_sets;
+    std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> index_sets;
+    TJoin().convert_trees_to_sets(trees_collection, tree_sets);
+    TJoin().convert_indexes_to_sets(tjoin_indexes, index_sets);
+    bool same_sets = tree_sets.size() == index_sets.size();
+    for (std::size_t t = 0; same_sets && t < tree_sets.size(); ++t) {
+      same_sets = tree_sets[t].first == index_sets[t].first &&
+          tree_sets[t].second.size() == index_sets[t].second.size();
+      for (std::size_t e = 0; same_sets && e < tree_sets[t].second.size(); ++e) {
+        const auto& te = tree_sets[t].second[e];
+        const auto& ie = index_sets[t].second[e];
+        same_sets = te.id == ie.id && te.weight == ie.weight &&
+            te.weight_so_far == ie.weight_so_far &&
+            te.struct_vect.size() == ie.struct_vect.size();
+        for (std::size_t v = 0; same_sets && v < te.struct_vect.size(); ++v) {
+          const auto& tv = te.struct_vect[v];
+          const auto& iv = ie.struct_vect[v];
+          same_sets = tv.postorder_id == iv.postorder_id &&
+              tv.number_nodes_left == iv.number_nodes_left &&
+              tv.number_nodes_right == iv.number_nodes_right &&
+              tv.number_nodes_ancestor == iv.number_nodes_ancestor &&
+              tv.number_nodes_descendant == iv.number_nodes_descendant;
+        }
+      }
+    }
+    if (!same_sets) {
+      std::cout << " ERROR Label sets of the binary collection differ" << std::endl;
+      return -1;
+    }
+    for (int i = min_thres; i <= max_thres; i += thres_step) {
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> sets_collection;
+      std::vector<std::pair<int, int>> candidates;
+      std::vector<join::JoinResultElement> join_result;
+      TJoin tree_join_algorithm;
+      tree_join_algorithm.execute_join(trees_collection,
+          sets_collection, candidates, join_result, (double)i);
+      std::vector<std::pair<int, std::vector<label_set_converter::LabelSetElement>>> binary_sets_collection;
+      std::vector<std::pair<int, int>> binary_candidates;
+      std::vector<join::JoinResultElement> binary_join_result;
+      TJoin binary_join_algorithm;
+      binary_join_algorithm.execute_join(tjoin_indexes,
+          binary_sets_collection, binary_candidates, binary_join_result,
+          (double)i);
+      if (binary_join_result.size() != results[i - 1] ||
+          !same_result(binary_join_result, join_result)) {
+        std::cout << " ERROR Incorrect binary collection join result for threshold " <<
+            i << ": " << binary_join_result.size() << " instead of " <<
+            results[i - 1] << std::endl;
+        return -1;
+      }
+      auto naive_join_result = NaiveJoin().execute_join(naive_indexes, (double)i);
+      if (naive_join_result.size() != results[i - 1] ||
+          !same_result(naive_join_result,
+              NaiveJoin().execute_join(trees_collection, (double)i))) {
+        std::cout << " ERROR Incorrect binary collection naive join result for threshold " <<
+            i << ": " << naive_join_result.size() << " instead of " <<
+            results[i - 1] << std::endl;
+        return -1;
+      }
+    }
   } else if (ted_join_algorithm_name == "tangjoin") {
     // TODO: If TangJoinTI is initialized here, SIGSEGV is reported on label
     //       comparison in:
@@ -119,9 +433,129 @@ int main(int, char** argv) {
         return -1;
       }
     }
+  } else if (ted_join_algorithm_name == "guhajoinparallel") {
+    using GuhaJoin = join::GuhaJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>>;
+    for (int i = min_thres; i <= max_thres; i += thres_step) {
+      std::vector<std::pair<int, int>> candidates;
+      std::vector<join::JoinResultElement> join_result;
+      GuhaJoin ted_join_algorithm(4);
+      ted_join_algorithm.execute_rsb_join(trees_collection, candidates, join_result, (double)i);
+      if (join_result.size() != results[i - 1]) {
+        std::cout << " ERROR Incorrect join result for threshold " << i << ": " <<
+            join_result.size() << " instead of " << results[i - 1] << std::endl;
+        return -1;
+      }
+      // The blocked metric filter has to return the same candidates and
+      // result pairs as evaluating the metric bounds for every pair.
+      node::TreeIndexCollection<Label, GuhaJoin::JoinTreeIndex> indexed_collection;
+      CostModel cm(indexed_collection.get_label_dictionary());
+      indexed_collection.build(trees_collection, cm);
+      GuhaJoin reference_algorithm;
+      std::vector<int> reference_set = reference_algorithm.get_reference_set(
+          indexed_collection, (double)i);
+      data_structures::Matrix<double> lb_vectors(indexed_collection.size(), reference_set.size());
+      data_structures::Matrix<double> ub_vectors(indexed_collection.size(), reference_set.size());
+      reference_algorithm.compute_vectors(indexed_collection, reference_set,
+          lb_vectors, ub_vectors);
+      // The same seed has to give the same reference set, and the vectors
+      // computed by several threads have to be the same.
+      GuhaJoin seeded_algorithm(4);
+      seeded_algorithm.set_random_seed(7);
+      std::vector<int> seeded_reference_set = seeded_algorithm.get_reference_set(
+          indexed_collection, (double)i);
+      GuhaJoin reseeded_algorithm;
+      reseeded_algorithm.set_random_seed(seeded_algorithm.get_random_seed());
+      if (seeded_reference_set != reseeded_algorithm.get_reference_set(
+          indexed_collection, (double)i)) {
+        std::cout << " ERROR Different reference sets for the same seed for threshold " <<
+            i << std::endl;
+        return -1;
+      }
+      data_structures::Matrix<double> parallel_lb_vectors(indexed_collection.size(), reference_set.size());
+      data_structures::Matrix<double> parallel_ub_vectors(indexed_collection.size(), reference_set.size());
+      seeded_algorithm.compute_vectors(indexed_collection, reference_set,
+          parallel_lb_vectors, parallel_ub_vectors);
+      for (std::size_t t = 0; t < indexed_collection.size(); ++t) {
+        for (std::size_t l = 0; l < reference_set.size(); ++l) {
+          if (parallel_lb_vectors.read_at(t, l) != lb_vectors.read_at(t, l) ||
+              parallel_ub_vectors.read_at(t, l) != ub_vectors.read_at(t, l)) {
+            std::cout << " ERROR Parallel vectors differ for tree " << t <<
+                " for threshold " << i << std::endl;
+            return -1;
+          }
+        }
+      }
+      std::vector<std::vector<double>> lb_rows(indexed_collection.size());
+      std::vector<std::vector<double>> ub_rows(indexed_collection.size());
+      for (std::size_t t = 0; t < indexed_collection.size(); ++t) {
+        for (std::size_t l = 0; l < reference_set.size(); ++l) {
+          lb_rows[t].push_back(lb_vectors.read_at(t, l));
+          ub_rows[t].push_back(ub_vectors.read_at(t, l));
+        }
+      }
+      // Every test evaluates the bounds either on the SED/CTED intervals or
+      // on the CTED values alone, standing in for exact TED values.
+      for (int exact = 0; exact < 2; ++exact) {
+        std::vector<std::pair<int, int>> pair_candidates;
+        std::vector<join::JoinResultElement> pair_result;
+        for (int v1 = 0; v1 < (int)indexed_collection.size(); ++v1) {
+          for (int v2 = v1 + 1; v2 < (int)indexed_collection.size(); ++v2) {
+            double pair_l_t = exact ?
+                reference_algorithm.l_t(ub_rows[v1], ub_rows[v2]) :
+                reference_algorithm.l_t(lb_rows[v1], ub_rows[v1],
+                    lb_rows[v2], ub_rows[v2]);
+            if (pair_l_t > (double)i) {
+              continue;
+            }
+            double pair_u_t = reference_algorithm.u_t(ub_rows[v1], ub_rows[v2]);
+            if (pair_u_t <= (double)i) {
+              pair_result.emplace_back(v1, v2, pair_u_t);
+            } else {
+              pair_candidates.push_back({v1, v2});
+            }
+          }
+        }
+        for (int pivot = 0; pivot < 2; ++pivot) {
+          GuhaJoin blocked_algorithm(4, pivot == 1);
+          std::vector<std::pair<int, int>> blocked_candidates;
+          std::vector<join::JoinResultElement> blocked_result;
+          if (exact) {
+            blocked_algorithm.retrieve_metric_candidates(blocked_candidates,
+                blocked_result, (double)i, ub_vectors);
+          } else {
+            blocked_algorithm.retrieve_metric_candidates(blocked_candidates,
+                blocked_result, (double)i, lb_vectors, ub_vectors);
+          }
+          // The pivot table changes the order of the pairs.
+          std::sort(blocked_candidates.begin(), blocked_candidates.end());
+          std::sort(blocked_result.begin(), blocked_result.end(),
+              [](const join::JoinResultElement& a, const join::JoinResultElement& b) {
+                return std::make_pair(a.tree_id_1, a.tree_id_2) <
+                    std::make_pair(b.tree_id_1, b.tree_id_2);
+              });
+          bool equal = blocked_candidates == pair_candidates &&
+              blocked_result.size() == pair_result.size() &&
+              blocked_algorithm.get_l_t_candidates() ==
+                  (long long int)(pair_candidates.size() + pair_result.size()) &&
+              blocked_algorithm.get_u_t_result_pairs() ==
+                  (long long int)pair_result.size();
+          for (std::size_t r = 0; equal && r < pair_result.size(); ++r) {
+            equal = blocked_result[r].tree_id_1 == pair_result[r].tree_id_1 &&
+                blocked_result[r].tree_id_2 == pair_result[r].tree_id_2 &&
+                blocked_result[r].ted_value == pair_result[r].ted_value;
+          }
+          if (!equal) {
+            std::cout << " ERROR Blocked metric filter differs for threshold " <<
+                i << (pivot ? " with" : " without") << " pivot table" <<
+                (exact ? " on TED vectors" : " on SED/CTED vectors") << std::endl;
+            return -1;
+          }
+        }
+      }
+    }
   } else if (ted_join_algorithm_name == "bbjoin") {
     for (int i = min_thres; i <= max_thres; i += thres_step) {
-      std::vector<std::pair<int, std::unordered_map<int, int>>> histogram_collection;
+      data_structures::HistogramCollection histogram_collection;
       std::vector<std::pair<int, int>> candidates;
       std::vector<join::JoinResultElement> join_result;
       join::BBJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> ted_join_algorithm;
@@ -133,11 +567,70 @@ int main(int, char** argv) {
         return -1;
       }
     }
+  } else if (ted_join_algorithm_name == "histojoincompressed") {
+    // Retrieves the candidates of a histogram join with uncompressed and
+    // with compressed inverted lists.
+    auto same_candidates = [&trees_collection](auto& join_algorithm,
+        auto& compressed_join_algorithm, const double threshold) {
+      compressed_join_algorithm.set_candidate_index_compression(true);
+      data_structures::HistogramCollection histogram_collection;
+      std::vector<std::pair<int, int>> candidates;
+      join_algorithm.convert_trees_to_histograms(trees_collection,
+          histogram_collection);
+      join_algorithm.retrieve_candidates(histogram_collection, candidates,
+          threshold);
+      data_structures::HistogramCollection compressed_histogram_collection;
+      std::vector<std::pair<int, int>> compressed_candidates;
+      compressed_join_algorithm.convert_trees_to_histograms(trees_collection,
+          compressed_histogram_collection);
+      compressed_join_algorithm.retrieve_candidates(
+          compressed_histogram_collection, compressed_candidates, threshold);
+      return candidates == compressed_candidates &&
+          join_algorithm.get_number_of_pre_candidates() ==
+          compressed_join_algorithm.get_number_of_pre_candidates();
+    };
+    for (int i = min_thres; i <= max_thres; i += thres_step) {
+      join::BBJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> bb_join, compressed_bb_join;
+      join::DHJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> dh_join, compressed_dh_join;
+      join::LHJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> lh_join, compressed_lh_join;
+      join::LDHJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> ldh_join, compressed_ldh_join;
+      if (!same_candidates(bb_join, compressed_bb_join, (double)i) ||
+          !same_candidates(dh_join, compressed_dh_join, (double)i) ||
+          !same_candidates(lh_join, compressed_lh_join, (double)i) ||
+          !same_candidates(ldh_join, compressed_ldh_join, (double)i)) {
+        std::cout << " ERROR Compressed candidates differ for threshold " <<
+            i << std::endl;
+        return -1;
+      }
+      // HJoin uses three histograms.
+      std::vector<data_structures::HistogramCollection> histogram_collections(6);
+      std::vector<std::pair<int, int>> candidates;
+      std::vector<std::pair<int, int>> compressed_candidates;
+      join::HJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> h_join, compressed_h_join;
+      compressed_h_join.set_candidate_index_compression(true);
+      h_join.convert_trees_to_histograms(trees_collection,
+          histogram_collections[0], histogram_collections[1],
+          histogram_collections[2]);
+      h_join.retrieve_candidates(histogram_collections[0],
+          histogram_collections[1], histogram_collections[2], candidates,
+          (double)i);
+      compressed_h_join.convert_trees_to_histograms(trees_collection,
+          histogram_collections[3], histogram_collections[4],
+          histogram_collections[5]);
+      compressed_h_join.retrieve_candidates(histogram_collections[3],
+          histogram_collections[4], histogram_collections[5],
+          compressed_candidates, (double)i);
+      if (candidates != compressed_candidates) {
+        std::cout << " ERROR Compressed HJoin candidates differ for threshold " <<
+            i << std::endl;
+        return -1;
+      }
+    }
   } else if (ted_join_algorithm_name == "hjoin") {
     for (int i = min_thres; i <= max_thres; i += thres_step) {
-      std::vector<std::pair<int, std::unordered_map<int, int>>> label_histogram_collection;
-      std::vector<std::pair<int, std::unordered_map<int, int>>> degree_histogram_collection;
-      std::vector<std::pair<int, std::unordered_map<int, int>>> leaf_distance_histogram_collection;
+      data_structures::HistogramCollection label_histogram_collection;
+      data_structures::HistogramCollection degree_histogram_collection;
+      data_structures::HistogramCollection leaf_distance_histogram_collection;
       std::vector<std::pair<int, int>> candidates;
       std::vector<join::JoinResultElement> join_result;
       join::HJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> ted_join_algorithm;
@@ -151,7 +644,7 @@ int main(int, char** argv) {
     }
   } else if (ted_join_algorithm_name == "dhjoin") {
     for (int i = min_thres; i <= max_thres; i += thres_step) {
-      std::vector<std::pair<int, std::unordered_map<int, int>>> histogram_collection;
+      data_structures::HistogramCollection histogram_collection;
       std::vector<std::pair<int, int>> candidates;
       std::vector<join::JoinResultElement> join_result;
       join::DHJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> ted_join_algorithm;
@@ -165,7 +658,7 @@ int main(int, char** argv) {
     }
   } else if (ted_join_algorithm_name == "lhjoin") {
     for (int i = min_thres; i <= max_thres; i += thres_step) {
-      std::vector<std::pair<int, std::unordered_map<int, int>>> histogram_collection;
+      data_structures::HistogramCollection histogram_collection;
       std::vector<std::pair<int, int>> candidates;
       std::vector<join::JoinResultElement> join_result;
       join::LHJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> ted_join_algorithm;
@@ -179,7 +672,7 @@ int main(int, char** argv) {
     }
   } else if (ted_join_algorithm_name == "ldhjoin") {
     for (int i = min_thres; i <= max_thres; i += thres_step) {
-      std::vector<std::pair<int, std::unordered_map<int, int>>> histogram_collection;
+      data_structures::HistogramCollection histogram_collection;
       std::vector<std::pair<int, int>> candidates;
       std::vector<join::JoinResultElement> join_result;
       join::LDHJoinTI<Label, ted::TouzetBaselineTreeIndex<CostModel>> ted_join_algorithm;
@@ -0,0 +1,116 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include "unit_cost_model.h"
+#include "json_label.h"
+#include "node.h"
+#include "tree_index_collection.h"
+#include "quickjedi_index.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+#include "index.h"
+#include "lookup_test_data.h"
+
+// Type aliases.
+using Label = label::JSONLabel;
+using CostModel = cost_model::UnitCostModelJSON<Label>;
+using QUICKJEDI = json::QuickJEDITreeIndex<CostModel>;
+using ResultTuple = std::tuple<int, int, double, double, double>;
+
+/// Converts a lookup result into sorted tuples.
+std::vector<ResultTuple> to_tuples(
+    const std::vector<lookup::LookupResultElement>& result_set) {
+  std::vector<ResultTuple> tuples;
+  for (const auto& r : result_set) {
+    tuples.emplace_back(r.tree_id_1, r.tree_id_2, r.lower_bound,
+        r.upper_bound, r.jedi_value);
+  }
+  std::sort(tuples.begin(), tuples.end());
+  return tuples;
+}
+
+/// Executes single and batched lookups of all trees with Lookup and compares
+/// the results.
+template <typename Lookup>
+int compare_lookups(const std::string& name,
+    const node::TreeIndexCollection<Label, QUICKJEDI::AlgsTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    std::vector<std::pair<int, int>>& size_setid_map,
+    lookup::TwoStageInvertedList& index) {
+  std::vector<unsigned int> query_tree_ids;
+  for (unsigned int q = 0; q < sets_collection.size(); ++q) {
+    query_tree_ids.push_back(q);
+  }
+  // Query every tree twice to test duplicate queries.
+  query_tree_ids.insert(query_tree_ids.end(), query_tree_ids.begin(),
+      query_tree_ids.end());
+  for (double threshold : {1.0, 3.0, 6.0, 10.0}) {
+    std::vector<lookup::LookupResultElement> single_results;
+    long long int pre_candidates = 0;
+    for (unsigned int q : query_tree_ids) {
+      Lookup single_lookup;
+      auto r = single_lookup.execute_lookup(indexed_collection,
+          sets_collection, size_setid_map, index, q, threshold);
+      single_results.insert(single_results.end(), r.begin(), r.end());
+      pre_candidates += single_lookup.get_pre_candidates_count();
+    }
+    for (int threads : {1, 3}) {
+      Lookup batch_lookup(threads);
+      auto batch_results = batch_lookup.execute_lookup_batch(
+          indexed_collection, sets_collection, size_setid_map, index,
+          query_tree_ids, threshold);
+      if (to_tuples(batch_results) != to_tuples(single_results)) {
+        std::cerr << "Incorrect " << name << " batch result for threshold "
+            << threshold << " and " << threads << " threads: "
+            << batch_results.size() << " instead of " << single_results.size()
+            << " results." << std::endl;
+        return -1;
+      }
+      if (batch_lookup.get_pre_candidates_count() != pre_candidates) {
+        std::cerr << "Incorrect " << name << " number of precandidates for "
+            << "threshold " << threshold << ": "
+            << batch_lookup.get_pre_candidates_count() << " instead of "
+            << pre_candidates << "." << std::endl;
+        return -1;
+      }
+      // Results are ordered by query, then by candidate.
+      for (std::size_t i = 1; i < batch_results.size(); ++i) {
+        if (batch_results[i - 1].tree_id_1 == batch_results[i].tree_id_1 &&
+            batch_results[i - 1].tree_id_2 >= batch_results[i].tree_id_2) {
+          std::cerr << "Unordered " << name << " batch result for threshold "
+              << threshold << "." << std::endl;
+          return -1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+int main() {
+
+  // Parse, index, and convert the trees and build the inverted list.
+  lookup_test::LookupTestData<Label, QUICKJEDI> data;
+  if (!data.load()) {
+    return -1;
+  }
+  const auto& indexed_collection = data.indexed_collection;
+  auto& sets_collection = data.sets_collection;
+  auto& size_setid_map = data.size_setid_map;
+  auto& index = data.index;
+
+  if (compare_lookups<lookup::VerificationIndex<Label, QUICKJEDI>>(
+      "VerificationIndex", indexed_collection, sets_collection,
+      size_setid_map, index) != 0) {
+    return -1;
+  }
+  if (compare_lookups<lookup::VerificationUBkIndex<Label, QUICKJEDI, QUICKJEDI>>(
+      "VerificationUBkIndex", indexed_collection, sets_collection,
+      size_setid_map, index) != 0) {
+    return -1;
+  }
+
+  return 0;
+}
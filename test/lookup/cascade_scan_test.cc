@@ -0,0 +1,81 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "unit_cost_model.h"
+#include "json_label.h"
+#include "node.h"
+#include "tree_index_collection.h"
+#include "quickjedi_index.h"
+#include "jofilter_index.h"
+#include "scan.h"
+#include "cascade_scan.h"
+#include "lookup_test_data.h"
+
+int main() {
+
+  // Type aliases.
+  using Label = label::JSONLabel;
+  using CostModel = cost_model::UnitCostModelJSON<Label>;
+  using QUICKJEDI = json::QuickJEDITreeIndex<CostModel>;
+  using JOFILTER = json::JOFilterTreeIndex<CostModel>;
+
+  // Parse and index the trees.
+  lookup_test::LookupTestData<Label, QUICKJEDI> data;
+  if (!data.load()) {
+    return -1;
+  }
+  const auto& indexed_collection = data.indexed_collection;
+
+  // Both algorithms compute upper bounds. The first cascade verifies the
+  // trees JOFilter does not accept, the second one accepts all trees with
+  // QuickJEDI as the upper bound.
+  lookup::CascadeScan<Label, QUICKJEDI, JOFILTER> cascade_scan(1);
+  lookup::CascadeScan<Label, JOFILTER, QUICKJEDI> parallel_cascade_scan(3);
+  for (double threshold : {0.0, 1.0, 3.0, 6.0, 10.0, 20.0}) {
+    for (unsigned int q = 0; q < indexed_collection.size(); q += 3) {
+      // The reference scan verifies every tree.
+      lookup::VerificationScan<Label, QUICKJEDI> scan;
+      std::vector<int> expected;
+      for (const auto& r : scan.execute_lookup(indexed_collection, q,
+          threshold)) {
+        expected.push_back(r.tree_id_2);
+      }
+      std::sort(expected.begin(), expected.end());
+      // The results are in ascending tree id.
+      std::vector<int> computed;
+      for (const auto& r : cascade_scan.execute_lookup(indexed_collection,
+          q, threshold)) {
+        computed.push_back(r.tree_id_2);
+      }
+      std::vector<int> parallel_computed;
+      for (const auto& r : parallel_cascade_scan.execute_lookup(
+          indexed_collection, q, threshold)) {
+        parallel_computed.push_back(r.tree_id_2);
+      }
+      if (computed != expected || parallel_computed != expected) {
+        std::cerr << "Incorrect cascade scan result for query " << q
+            << " and threshold " << threshold << ": " << computed.size()
+            << " and " << parallel_computed.size() << " instead of "
+            << expected.size() << " trees." << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  // Every tree leaves the cascade at exactly one stage.
+  for (const auto* s : {&cascade_scan.get_statistics(),
+      &parallel_cascade_scan.get_statistics()}) {
+    if (s->candidates != s->size_pruned + s->label_intersection_pruned +
+        s->upper_bound_accepted + s->verifications) {
+      std::cerr << "Inconsistent cascade statistics." << std::endl;
+      return -1;
+    }
+  }
+  if (cascade_scan.get_statistics().verifications == 0) {
+    std::cerr << "No tree reached the verification." << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
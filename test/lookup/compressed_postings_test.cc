@@ -0,0 +1,160 @@
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include "string_label.h"
+#include "node.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+#include "var_byte.h"
+#include "lookup_test_data.h"
+
+using SetsCollection = std::vector<std::pair<int,
+    std::vector<label_set_converter_index::LabelSetElement>>>;
+
+/// Looks up every element of every set in both indexes for different
+/// thresholds and compares the candidates.
+int compare_indexes(const std::string& step, SetsCollection& sets_collection,
+    lookup::TwoStageInvertedList& index,
+    lookup::TwoStageInvertedList& reference_index) {
+  for (double threshold : {0.0, 1.0, 2.0, 3.0, 5.0, 8.0, 13.0}) {
+    for (std::size_t q = 0; q < sets_collection.size(); ++q) {
+      auto& set = sets_collection[q];
+      for (auto& element : set.second) {
+        std::unordered_set<long int> reference_candidates;
+        std::unordered_set<long int> candidates;
+        reference_index.lookup(element.id, element.descendants,
+            element.ancestors, set.first, reference_candidates, threshold);
+        index.lookup(element.id, element.descendants, element.ancestors,
+            set.first, candidates, threshold);
+        if (reference_candidates != candidates) {
+          std::cerr << "Incorrect candidates " << step << " of tree " << q
+              << " for label " << element.id << " and threshold " << threshold
+              << ": " << candidates.size() << " instead of "
+              << reference_candidates.size() << " candidates." << std::endl;
+          return -1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+int main() {
+
+  // Type aliases.
+  using Label = label::StringLabel;
+
+  // Round trip of lists with one-byte runs and differences of every length.
+  std::vector<int> values;
+  for (int i = 0; i < 20; ++i) {
+    values.push_back(i);
+  }
+  for (int value : {127, 255, 16383, 16384, 16390, 2097152, 2097153,
+      INT_MAX - 1, INT_MAX}) {
+    values.push_back(value);
+  }
+  std::vector<std::uint8_t> bytes;
+  data_structures::var_byte_encode_deltas(values.data(),
+      values.data() + values.size(), bytes);
+  std::vector<int> decoded;
+  data_structures::var_byte_decode_deltas(bytes.data(),
+      bytes.data() + bytes.size(), decoded);
+  if (decoded != values) {
+    std::cerr << "Incorrect variable-byte round trip." << std::endl;
+    return -1;
+  }
+
+  // Parse the trees.
+  std::vector<node::Node<Label>> trees_collection;
+  if (!lookup_test::parse_trees(trees_collection)) {
+    return -1;
+  }
+  if (trees_collection.size() < 4) {
+    std::cerr << "Too few test trees." << std::endl;
+    return -1;
+  }
+  SetsCollection sets_collection;
+  std::vector<std::pair<int, int>> size_setid_map;
+  label_set_converter_index::Converter<Label> lsc;
+  lsc.assignFrequencyIdentifiers(trees_collection, sets_collection,
+      size_setid_map);
+
+  // A compressed index returns the same candidates in less memory.
+  lookup::TwoStageInvertedList index(lsc.get_number_of_labels());
+  index.build(sets_collection);
+  lookup::TwoStageInvertedList compressed_index(lsc.get_number_of_labels(),
+      true);
+  compressed_index.build(sets_collection);
+  if (!compressed_index.get_posting_compression() ||
+      compressed_index.get_sorted_arrays().postings != nullptr ||
+      compressed_index.get_sorted_arrays().compressed_postings == nullptr) {
+    std::cerr << "The postings are not compressed." << std::endl;
+    return -1;
+  }
+  if (compressed_index.get_memory_usage() >= index.get_memory_usage()) {
+    std::cerr << "Compressed index takes " <<
+        compressed_index.get_memory_usage() << " instead of less than " <<
+        index.get_memory_usage() << " bytes." << std::endl;
+    return -1;
+  }
+  if (compare_indexes("after build", sets_collection, compressed_index,
+      index) != 0) {
+    return -1;
+  }
+
+  // Toggling the compression keeps the candidates.
+  compressed_index.set_posting_compression(false);
+  if (compressed_index.get_memory_usage() != index.get_memory_usage()) {
+    std::cerr << "Decompressed index takes " <<
+        compressed_index.get_memory_usage() << " instead of " <<
+        index.get_memory_usage() << " bytes." << std::endl;
+    return -1;
+  }
+  if (compare_indexes("after decompression", sets_collection,
+      compressed_index, index) != 0) {
+    return -1;
+  }
+  compressed_index.set_posting_compression(true);
+  if (compare_indexes("after recompression", sets_collection,
+      compressed_index, index) != 0) {
+    return -1;
+  }
+
+  // Inserts, removals, and merges of a compressed index.
+  std::size_t half = sets_collection.size() / 2;
+  SetsCollection first_sets(sets_collection.begin(),
+      sets_collection.begin() + half);
+  lookup::TwoStageInvertedList incremental_index(lsc.get_number_of_labels(),
+      true);
+  incremental_index.build(first_sets);
+  for (std::size_t s = half; s < sets_collection.size(); ++s) {
+    incremental_index.insert(s, sets_collection[s]);
+  }
+  if (compare_indexes("after inserts", sets_collection, incremental_index,
+      index) != 0) {
+    return -1;
+  }
+  SetsCollection remaining_sets = sets_collection;
+  for (std::size_t s = 0; s < sets_collection.size(); s += 3) {
+    incremental_index.remove(s);
+    remaining_sets[s].second.clear();
+  }
+  lookup::TwoStageInvertedList remaining_index(lsc.get_number_of_labels());
+  remaining_index.build(remaining_sets);
+  incremental_index.merge();
+  if (!incremental_index.get_posting_compression() ||
+      incremental_index.get_sorted_arrays().compressed_postings == nullptr) {
+    std::cerr << "The postings are not compressed after a merge."
+        << std::endl;
+    return -1;
+  }
+  if (compare_indexes("after merge", sets_collection, incremental_index,
+      remaining_index) != 0) {
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,318 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <unordered_set>
+#include <tuple>
+#include <algorithm>
+#include "unit_cost_model.h"
+#include "json_label.h"
+#include "node.h"
+#include "tree_index_collection.h"
+#include "quickjedi_index.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+#include "batch_lookup.h"
+#include "index.h"
+#include "shared_index.h"
+#include "mapped_index.h"
+#include "lookup_test_data.h"
+
+using Label = label::JSONLabel;
+using CostModel = cost_model::UnitCostModelJSON<Label>;
+using QUICKJEDI = json::QuickJEDITreeIndex<CostModel>;
+using IndexedCollection = node::TreeIndexCollection<Label,
+    QUICKJEDI::AlgsTreeIndex>;
+using ResultTuple = std::tuple<int, int, double, double, double>;
+using SetsCollection = std::vector<std::pair<int,
+    std::vector<label_set_converter_index::LabelSetElement>>>;
+
+/// Compares the candidates of every query node and of every query tree of
+/// the mapped index with the ones of the index that was written.
+int compare_candidates(const std::string& step,
+    SetsCollection& sets_collection,
+    std::vector<std::pair<int, int>>& size_setid_map,
+    lookup::TwoStageInvertedList& index,
+    const lookup::MappedIndex& mapped_index) {
+  std::vector<unsigned int> query_tree_ids;
+  for (unsigned int q = 0; q < sets_collection.size(); ++q) {
+    query_tree_ids.push_back(q);
+  }
+  for (double threshold : {0.0, 1.0, 3.0, 6.0, 10.0}) {
+    for (std::size_t q = 0; q < sets_collection.size(); ++q) {
+      auto& set = sets_collection[q];
+      for (auto& element : set.second) {
+        std::unordered_set<long int> candidates;
+        std::unordered_set<long int> mapped_candidates;
+        index.lookup(element.id, element.descendants, element.ancestors,
+            set.first, candidates, threshold);
+        mapped_index.lookup(element.id, element.descendants,
+            element.ancestors, set.first, mapped_candidates, threshold);
+        if (candidates != mapped_candidates) {
+          std::cerr << "Incorrect candidates " << step << " of tree " << q
+              << " for label " << element.id << " and threshold " << threshold
+              << ": " << mapped_candidates.size() << " instead of "
+              << candidates.size() << " candidates." << std::endl;
+          return -1;
+        }
+      }
+    }
+    // The candidates of whole query trees include the small trees of the
+    // size_setid_map.
+    std::vector<std::pair<unsigned int, long int>> batch_candidates;
+    lookup::retrieve_batch_candidates(sets_collection, size_setid_map, index,
+        query_tree_ids, threshold, batch_candidates);
+    std::vector<std::unordered_set<long int>> tree_candidates(
+        sets_collection.size());
+    for (const auto& c : batch_candidates) {
+      tree_candidates[c.first].insert(c.second);
+    }
+    for (std::size_t q = 0; q < sets_collection.size(); ++q) {
+      std::unordered_set<long int> mapped_candidates;
+      mapped_index.retrieve_candidates(q, threshold, mapped_candidates);
+      if (tree_candidates[q] != mapped_candidates) {
+        std::cerr << "Incorrect candidates " << step << " of tree " << q
+            << " for threshold " << threshold << ": "
+            << mapped_candidates.size() << " instead of "
+            << tree_candidates[q].size() << " candidates." << std::endl;
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+/// Converts a lookup result into sorted tuples.
+std::vector<ResultTuple> to_tuples(
+    const std::vector<lookup::LookupResultElement>& result_set) {
+  std::vector<ResultTuple> tuples;
+  for (const auto& r : result_set) {
+    tuples.emplace_back(r.tree_id_1, r.tree_id_2, r.lower_bound,
+        r.upper_bound, r.jedi_value);
+  }
+  std::sort(tuples.begin(), tuples.end());
+  return tuples;
+}
+
+/// Compares the lookups over the mapped index, which reads the label sets
+/// in place, with the ones over the index that was written.
+int compare_lookups(const std::string& step,
+    const IndexedCollection& indexed_collection,
+    SetsCollection& sets_collection,
+    std::vector<std::pair<int, int>>& size_setid_map,
+    lookup::TwoStageInvertedList& index,
+    const lookup::MappedIndex& mapped_index) {
+  std::vector<unsigned int> query_tree_ids;
+  for (unsigned int q = 0; q < sets_collection.size(); ++q) {
+    if (!index.is_removed(q)) {
+      query_tree_ids.push_back(q);
+    }
+  }
+  const lookup::SharedIndex<Label, QUICKJEDI, QUICKJEDI, lookup::MappedIndex,
+      lookup::MappedIndex> shared_index(indexed_collection, mapped_index,
+      mapped_index);
+  const unsigned int kTopK = 3;
+  for (double threshold : {1.0, 3.0, 6.0}) {
+    lookup::VerificationUBkIndex<Label, QUICKJEDI, QUICKJEDI> ubk_lookup;
+    lookup::VerificationIndex<Label, QUICKJEDI> lookup;
+    std::vector<lookup::LookupResultElement> results;
+    std::vector<lookup::LookupResultElement> mapped_results;
+    std::vector<lookup::LookupResultElement> shared_results;
+    lookup::LookupStatistics statistics;
+    for (unsigned int q : query_tree_ids) {
+      auto r = ubk_lookup.execute_lookup(indexed_collection, sets_collection,
+          size_setid_map, index, q, threshold);
+      results.insert(results.end(), r.begin(), r.end());
+      r = ubk_lookup.execute_lookup(indexed_collection, mapped_index,
+          mapped_index, q, threshold);
+      mapped_results.insert(mapped_results.end(), r.begin(), r.end());
+      r = shared_index.execute_lookup(q, threshold, statistics);
+      shared_results.insert(shared_results.end(), r.begin(), r.end());
+      if (to_tuples(lookup.execute_lookup(indexed_collection, mapped_index,
+          mapped_index, q, threshold)) != to_tuples(lookup.execute_lookup(
+          indexed_collection, sets_collection, size_setid_map, index, q,
+          threshold))) {
+        std::cerr << "Incorrect lookup " << step << " of tree " << q
+            << " without upper bound for threshold " << threshold << "."
+            << std::endl;
+        return -1;
+      }
+      if (to_tuples(shared_index.execute_top_k_lookup(q, kTopK, statistics))
+          != to_tuples(ubk_lookup.execute_top_k_lookup(indexed_collection,
+          sets_collection, size_setid_map, index, q, kTopK))) {
+        std::cerr << "Incorrect top-" << kTopK << " lookup " << step
+            << " of tree " << q << "." << std::endl;
+        return -1;
+      }
+    }
+    if (to_tuples(mapped_results) != to_tuples(results) ||
+        to_tuples(shared_results) != to_tuples(results)) {
+      std::cerr << "Incorrect lookups " << step << " for threshold "
+          << threshold << ": " << mapped_results.size() << " and "
+          << shared_results.size() << " instead of " << results.size()
+          << " results." << std::endl;
+      return -1;
+    }
+    if (to_tuples(ubk_lookup.execute_lookup_batch(indexed_collection,
+        mapped_index, mapped_index, query_tree_ids, threshold)) !=
+        to_tuples(results)) {
+      std::cerr << "Incorrect batch lookup " << step << " for threshold "
+          << threshold << "." << std::endl;
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int main() {
+  // Parse, index, and convert the trees and build the inverted list.
+  lookup_test::LookupTestData<Label, QUICKJEDI> data;
+  if (!data.load()) {
+    return -1;
+  }
+  const auto& indexed_collection = data.indexed_collection;
+  auto& sets_collection = data.sets_collection;
+  auto& size_setid_map = data.size_setid_map;
+  auto& index = data.index;
+
+  // Write the index and map it.
+  const std::string file_path = "mapped_index_test.idx";
+  lookup::MappedIndex::write(index, sets_collection, size_setid_map,
+      file_path);
+  {
+    lookup::MappedIndex mapped_index(file_path);
+    mapped_index.validate();
+    if (mapped_index.get_number_of_labels() != index.get_number_of_labels() ||
+        mapped_index.get_number_of_sets() != sets_collection.size() ||
+        mapped_index.get_number_of_size_entries() != size_setid_map.size()) {
+      std::cerr << "Incorrect sizes of the mapped index." << std::endl;
+      return -1;
+    }
+    // The label set collection and the size_setid_map are stored as well.
+    for (std::size_t s = 0; s < sets_collection.size(); ++s) {
+      const label_set_converter_index::LabelSetElement* elements =
+          mapped_index.get_set_elements(s);
+      bool equal = mapped_index.get_tree_size(s) == sets_collection[s].first &&
+          mapped_index.get_set_size(s) == sets_collection[s].second.size();
+      for (std::size_t i = 0; equal && i < mapped_index.get_set_size(s); ++i) {
+        const auto& e = elements[i];
+        const auto& f = sets_collection[s].second[i];
+        equal = e.id == f.id && e.postorder_id == f.postorder_id &&
+            e.ancestors == f.ancestors && e.descendants == f.descendants &&
+            e.weight == f.weight && e.weight_so_far == f.weight_so_far;
+      }
+      if (!equal) {
+        std::cerr << "Incorrect label set " << s << " of the mapped index."
+            << std::endl;
+        return -1;
+      }
+    }
+    for (std::size_t i = 0; i < size_setid_map.size(); ++i) {
+      if (mapped_index.get_size_entry(i) != size_setid_map[i]) {
+        std::cerr << "Incorrect size_setid_map entry " << i
+            << " of the mapped index." << std::endl;
+        return -1;
+      }
+    }
+    if (compare_candidates("after build", sets_collection, size_setid_map,
+        index, mapped_index) != 0 ||
+        compare_lookups("after build", indexed_collection, sets_collection,
+        size_setid_map, index, mapped_index) != 0) {
+      return -1;
+    }
+  }
+
+  // Unmerged updates are merged in the written file.
+  for (std::size_t s = 0; s < sets_collection.size(); s += 4) {
+    index.remove(s);
+  }
+  if (index.get_number_of_unmerged_postings() == 0) {
+    std::cerr << "The removals are already merged." << std::endl;
+    return -1;
+  }
+  lookup::MappedIndex::write(index, sets_collection, size_setid_map,
+      file_path);
+  {
+    lookup::MappedIndex mapped_index(file_path);
+    mapped_index.validate();
+    if (compare_candidates("after removals", sets_collection, size_setid_map,
+        index, mapped_index) != 0 ||
+        compare_lookups("after removals", indexed_collection, sets_collection,
+        size_setid_map, index, mapped_index) != 0) {
+      return -1;
+    }
+  }
+
+  // Corrupt files are rejected. The constructor checks the header and the
+  // section bounds only, validate checks the contents of the sections.
+  std::string bytes;
+  {
+    std::ifstream input(file_path, std::ios::binary);
+    bytes.assign((std::istreambuf_iterator<char>(input)),
+        std::istreambuf_iterator<char>());
+  }
+  lookup::MappedIndexHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  auto align = [](const std::size_t b) { return (b + 7) & ~std::size_t(7); };
+  const std::size_t label_offsets_position = align(sizeof(header));
+  const std::size_t postings_position = label_offsets_position +
+      8 * (header.number_of_labels + 1) +
+      align(4 * header.number_of_descendants_keys) +
+      8 * (header.number_of_descendants_keys + 1) +
+      align(4 * header.number_of_ancestors_keys) +
+      8 * (header.number_of_ancestors_keys + 1) +
+      align(4 * header.number_of_right_left_keys) +
+      8 * (header.number_of_right_left_keys + 1);
+  auto write_bytes = [&file_path](const std::string& file_bytes) {
+    std::ofstream output(file_path, std::ios::binary | std::ios::trunc);
+    output.write(file_bytes.data(), file_bytes.size());
+  };
+  auto is_rejected = [&file_path, &write_bytes](const std::string& file_bytes) {
+    write_bytes(file_bytes);
+    try {
+      lookup::MappedIndex mapped_index(file_path);
+    } catch (const std::runtime_error&) {
+      return true;
+    }
+    return false;
+  };
+  auto is_invalid = [&file_path, &write_bytes](const std::string& file_bytes) {
+    write_bytes(file_bytes);
+    try {
+      lookup::MappedIndex mapped_index(file_path);
+      mapped_index.validate();
+    } catch (const std::runtime_error&) {
+      return true;
+    }
+    return false;
+  };
+  // An intermediate label offset beyond the keys of the next level.
+  std::string corrupt = bytes;
+  const std::uint64_t large_offset = header.number_of_descendants_keys + 1000;
+  std::memcpy(&corrupt[label_offsets_position + 8], &large_offset, 8);
+  if (header.number_of_labels < 2 || is_rejected(corrupt) ||
+      !is_invalid(corrupt)) {
+    std::cerr << "A file with decreasing offsets is not rejected by validate only." << std::endl;
+    return -1;
+  }
+  // A posting with a set id beyond the sets.
+  corrupt = bytes;
+  const std::int32_t large_set_id =
+      static_cast<std::int32_t>(header.number_of_sets);
+  std::memcpy(&corrupt[postings_position], &large_set_id, 4);
+  if (header.number_of_postings == 0 || is_rejected(corrupt) ||
+      !is_invalid(corrupt)) {
+    std::cerr << "A file with an invalid set id is not rejected by validate only." << std::endl;
+    return -1;
+  }
+  // A truncated file.
+  if (!is_rejected(bytes.substr(0, bytes.size() / 2))) {
+    std::cerr << "A truncated file is accepted." << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
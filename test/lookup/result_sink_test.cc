@@ -0,0 +1,232 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include "unit_cost_model.h"
+#include "json_label.h"
+#include "node.h"
+#include "tree_index_collection.h"
+#include "quickjedi_index.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+#include "index.h"
+#include "scan.h"
+#include "shared_index.h"
+#include "result_sink.h"
+#include "lookup_test_data.h"
+
+// Type aliases.
+using Label = label::JSONLabel;
+using CostModel = cost_model::UnitCostModelJSON<Label>;
+using QUICKJEDI = json::QuickJEDITreeIndex<CostModel>;
+using ResultTuple = std::tuple<int, int, double>;
+using Sink = data_structures::ResultSink<lookup::LookupResultElement>;
+
+/// Maximum number of elements in a batch of the sinks.
+const std::size_t kBufferSize = 5;
+
+/// Converts a lookup result into pairs of tree ids and distances in the same
+/// order. Pairs accepted by the upper bound carry the upper bound.
+std::vector<ResultTuple> to_tuples(
+    const std::vector<lookup::LookupResultElement>& result_set) {
+  std::vector<ResultTuple> tuples;
+  for (const auto& r : result_set) {
+    tuples.emplace_back(r.tree_id_1, r.tree_id_2,
+        r.jedi_value < 0 ? r.upper_bound : r.jedi_value);
+  }
+  return tuples;
+}
+
+/// Returns the sorted result of a scan over all trees.
+template <typename Scan>
+std::vector<ResultTuple> scan_result(
+    const node::TreeIndexCollection<Label, QUICKJEDI::AlgsTreeIndex>& indexed_collection,
+    const unsigned int query_tree_id, const double distance_threshold) {
+  Scan scan;
+  auto expected = to_tuples(scan.execute_lookup(indexed_collection,
+      query_tree_id, distance_threshold));
+  std::sort(expected.begin(), expected.end());
+  return expected;
+}
+
+/// Collects the batches of a sink and checks their size.
+struct Collector {
+  std::vector<lookup::LookupResultElement> results;
+  bool oversized_batch = false;
+  Sink::Consumer consumer() {
+    return [this](const std::vector<lookup::LookupResultElement>& batch) {
+      if (batch.empty() || batch.size() > kBufferSize) {
+        oversized_batch = true;
+      }
+      results.insert(results.end(), batch.begin(), batch.end());
+    };
+  }
+};
+
+/// Streams single and batched lookups of all trees with Lookup into a sink
+/// with a consumer and into a sink on a vector. Both have to return the
+/// results of Scan, the batches in the order of the queries and candidates.
+template <typename Lookup, typename Scan>
+int compare_sinks(const std::string& name,
+    const node::TreeIndexCollection<Label, QUICKJEDI::AlgsTreeIndex>& indexed_collection,
+    std::vector<std::pair<int, std::vector<label_set_converter_index::LabelSetElement>>>& sets_collection,
+    std::vector<std::pair<int, int>>& size_setid_map,
+    lookup::TwoStageInvertedList& index) {
+  std::vector<unsigned int> query_tree_ids;
+  for (unsigned int q = 0; q < sets_collection.size(); ++q) {
+    query_tree_ids.push_back(q);
+  }
+  // The elements of a vector sink are appended after this one.
+  const lookup::LookupResultElement first(-1, -1, 0, 0, 0);
+  for (double threshold : {1.0, 3.0, 6.0, 10.0}) {
+    // Single lookups, in any order.
+    std::vector<ResultTuple> batch_expected;
+    for (unsigned int q : query_tree_ids) {
+      auto expected = scan_result<Scan>(indexed_collection, q, threshold);
+      batch_expected.insert(batch_expected.end(), expected.begin(),
+          expected.end());
+      Lookup lookup;
+      Collector collector;
+      Sink sink(collector.consumer(), kBufferSize);
+      lookup.execute_lookup(indexed_collection, sets_collection,
+          size_setid_map, index, q, sink, threshold);
+      auto streamed = to_tuples(collector.results);
+      std::sort(streamed.begin(), streamed.end());
+      std::vector<lookup::LookupResultElement> results(1, first);
+      Sink vector_sink(results);
+      lookup.execute_lookup(indexed_collection, sets_collection,
+          size_setid_map, index, q, vector_sink, threshold);
+      auto appended = to_tuples(std::vector<lookup::LookupResultElement>(
+          results.begin() + 1, results.end()));
+      std::sort(appended.begin(), appended.end());
+      if (streamed != expected || collector.oversized_batch ||
+          sink.get_number_of_results() != (long long int) expected.size() ||
+          appended != expected || results[0].tree_id_1 != -1 ||
+          vector_sink.get_number_of_results() !=
+          (long long int) expected.size()) {
+        std::cerr << "Incorrect " << name << " streamed result of tree " << q
+            << " for threshold " << threshold << ": " << streamed.size()
+            << " and " << appended.size() << " instead of "
+            << expected.size() << " results." << std::endl;
+        return -1;
+      }
+    }
+    // Batched lookups, in the order of the queries and candidates.
+    for (int threads : {1, 3}) {
+      Lookup lookup(threads);
+      Collector collector;
+      Sink sink(collector.consumer(), kBufferSize);
+      lookup.execute_lookup_batch(indexed_collection, sets_collection,
+          size_setid_map, index, query_tree_ids, sink, threshold);
+      std::vector<lookup::LookupResultElement> results;
+      Sink vector_sink(results);
+      lookup.execute_lookup_batch(indexed_collection, sets_collection,
+          size_setid_map, index, query_tree_ids, vector_sink, threshold);
+      if (to_tuples(collector.results) != batch_expected ||
+          collector.oversized_batch ||
+          to_tuples(results) != batch_expected) {
+        std::cerr << "Incorrect " << name << " streamed batch result for "
+            << "threshold " << threshold << " and " << threads
+            << " threads: " << collector.results.size() << " and "
+            << results.size() << " instead of " << batch_expected.size()
+            << " results." << std::endl;
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+int main() {
+
+  // Parse, index, and convert the trees and build the inverted list.
+  lookup_test::LookupTestData<Label, QUICKJEDI> data;
+  if (!data.load()) {
+    return -1;
+  }
+  const auto& indexed_collection = data.indexed_collection;
+  auto& sets_collection = data.sets_collection;
+  auto& size_setid_map = data.size_setid_map;
+  auto& index = data.index;
+
+  // A sink passes full batches on and keeps the rest until it is flushed.
+  Collector collector;
+  Sink sink(collector.consumer(), kBufferSize);
+  for (int i = 0; i < 7; ++i) {
+    sink.emplace_back(i, i, 0, 0, 0);
+  }
+  if (collector.results.size() != kBufferSize) {
+    std::cerr << "The sink passed on " << collector.results.size()
+        << " instead of " << kBufferSize << " elements." << std::endl;
+    return -1;
+  }
+  sink.flush();
+  bool in_order = collector.results.size() == 7;
+  for (std::size_t i = 0; in_order && i < 7; ++i) {
+    in_order = collector.results[i].tree_id_2 == (int) i;
+  }
+  if (!in_order || sink.get_number_of_results() != 7) {
+    std::cerr << "The flushed sink passed on " << collector.results.size()
+        << " instead of 7 elements in order." << std::endl;
+    return -1;
+  }
+
+  // A sink on a vector appends every element directly and has no buffer.
+  std::vector<lookup::LookupResultElement> direct(1,
+      lookup::LookupResultElement(-1, -1, 0, 0, 0));
+  Sink direct_sink(direct);
+  for (int i = 0; i < 3; ++i) {
+    direct_sink.emplace_back(i, i, 0, 0, 0);
+    if (direct.size() != (std::size_t) i + 2 || direct.back().tree_id_2 != i) {
+      std::cerr << "The vector sink did not append element " << i << "."
+          << std::endl;
+      return -1;
+    }
+  }
+  direct_sink.append(std::vector<lookup::LookupResultElement>(2,
+      lookup::LookupResultElement(3, 3, 0, 0, 0)));
+  direct_sink.flush();
+  if (direct.size() != 6 || direct[0].tree_id_1 != -1 ||
+      direct[5].tree_id_2 != 3 || direct_sink.get_number_of_results() != 5 ||
+      direct_sink.get_buffer_size() != 0) {
+    std::cerr << "The vector sink holds " << direct.size()
+        << " instead of 6 elements." << std::endl;
+    return -1;
+  }
+
+  if (compare_sinks<lookup::VerificationIndex<Label, QUICKJEDI>,
+      lookup::VerificationScan<Label, QUICKJEDI>>(
+      "VerificationIndex", indexed_collection, sets_collection,
+      size_setid_map, index) != 0) {
+    return -1;
+  }
+  if (compare_sinks<lookup::VerificationUBkIndex<Label, QUICKJEDI, QUICKJEDI>,
+      lookup::VerificationUBkScan<Label, QUICKJEDI, QUICKJEDI>>(
+      "VerificationUBkIndex", indexed_collection, sets_collection,
+      size_setid_map, index) != 0) {
+    return -1;
+  }
+
+  // The shared index streams the results of every query.
+  lookup::SharedIndex<Label, QUICKJEDI, QUICKJEDI> shared_index(
+      indexed_collection, sets_collection, size_setid_map, index);
+  for (unsigned int q = 0; q < sets_collection.size(); ++q) {
+    lookup::LookupStatistics statistics;
+    auto expected = scan_result<lookup::VerificationUBkScan<Label, QUICKJEDI,
+        QUICKJEDI>>(indexed_collection, q, 3.0);
+    Collector shared_collector;
+    Sink shared_sink(shared_collector.consumer(), kBufferSize);
+    shared_index.execute_lookup(q, shared_sink, 3.0, statistics);
+    auto streamed = to_tuples(shared_collector.results);
+    std::sort(streamed.begin(), streamed.end());
+    if (streamed != expected) {
+      std::cerr << "Incorrect SharedIndex streamed result of tree " << q
+          << ": " << streamed.size() << " instead of " << expected.size()
+          << " results." << std::endl;
+      return -1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include "unit_cost_model.h"
+#include "json_label.h"
+#include "node.h"
+#include "tree_index_collection.h"
+#include "quickjedi_index.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+#include "index.h"
+#include "shared_index.h"
+#include "lookup_test_data.h"
+
+// Type aliases.
+using Label = label::JSONLabel;
+using CostModel = cost_model::UnitCostModelJSON<Label>;
+using QUICKJEDI = json::QuickJEDITreeIndex<CostModel>;
+using ResultTuple = std::tuple<int, int, double, double, double>;
+
+/// Converts a lookup result into sorted tuples.
+std::vector<ResultTuple> to_tuples(
+    const std::vector<lookup::LookupResultElement>& result_set) {
+  std::vector<ResultTuple> tuples;
+  for (const auto& r : result_set) {
+    tuples.emplace_back(r.tree_id_1, r.tree_id_2, r.lower_bound,
+        r.upper_bound, r.jedi_value);
+  }
+  std::sort(tuples.begin(), tuples.end());
+  return tuples;
+}
+
+int main() {
+
+  // Parse, index, and convert the trees and build the inverted list.
+  lookup_test::LookupTestData<Label, QUICKJEDI> data;
+  if (!data.load()) {
+    return -1;
+  }
+  const auto& indexed_collection = data.indexed_collection;
+  auto& sets_collection = data.sets_collection;
+  auto& size_setid_map = data.size_setid_map;
+  auto& index = data.index;
+  const lookup::SharedIndex<Label, QUICKJEDI, QUICKJEDI> shared_index(
+      indexed_collection, sets_collection, size_setid_map, index);
+
+  const int kNumberOfThreads = 4;
+  const unsigned int kTopK = 3;
+  for (double threshold : {1.0, 3.0, 6.0}) {
+    // Reference results and counters of one lookup object per query.
+    std::vector<lookup::LookupResultElement> results;
+    lookup::LookupStatistics statistics;
+    std::vector<std::vector<lookup::LookupResultElement>> top_k_results;
+    for (unsigned int q = 0; q < sets_collection.size(); ++q) {
+      lookup::VerificationUBkIndex<Label, QUICKJEDI, QUICKJEDI> lookup;
+      auto r = lookup.execute_lookup(indexed_collection, sets_collection,
+          size_setid_map, index, q, threshold);
+      results.insert(results.end(), r.begin(), r.end());
+      statistics.pre_candidates += lookup.get_pre_candidates_count();
+      statistics.candidates += lookup.get_candidates_count();
+      statistics.verifications += lookup.get_verification_count();
+      lookup::VerificationUBkIndex<Label, QUICKJEDI, QUICKJEDI> top_k_lookup;
+      top_k_results.push_back(top_k_lookup.execute_top_k_lookup(indexed_collection,
+          sets_collection, size_setid_map, index, q, kTopK));
+    }
+
+    // Every thread queries all trees with its own statistics.
+    std::vector<std::vector<lookup::LookupResultElement>> thread_results(
+        kNumberOfThreads);
+    std::vector<lookup::LookupStatistics> thread_statistics(kNumberOfThreads);
+    std::vector<int> thread_errors(kNumberOfThreads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumberOfThreads; ++t) {
+      threads.emplace_back([&, t]() {
+        for (unsigned int q = 0; q < sets_collection.size(); ++q) {
+          auto r = shared_index.execute_lookup(q, threshold,
+              thread_statistics[t]);
+          thread_results[t].insert(thread_results[t].end(), r.begin(),
+              r.end());
+          lookup::LookupStatistics top_k_statistics;
+          if (to_tuples(shared_index.execute_top_k_lookup(q, kTopK,
+              top_k_statistics)) != to_tuples(top_k_results[q])) {
+            ++thread_errors[t];
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (int t = 0; t < kNumberOfThreads; ++t) {
+      if (to_tuples(thread_results[t]) != to_tuples(results)) {
+        std::cerr << "Incorrect result of thread " << t << " for threshold "
+            << threshold << ": " << thread_results[t].size() << " instead of "
+            << results.size() << " results." << std::endl;
+        return -1;
+      }
+      if (thread_errors[t] != 0) {
+        std::cerr << "Incorrect top-" << kTopK << " results of thread " << t
+            << " for threshold " << threshold << "." << std::endl;
+        return -1;
+      }
+      const lookup::LookupStatistics& s = thread_statistics[t];
+      if (s.pre_candidates != statistics.pre_candidates ||
+          s.candidates != statistics.candidates ||
+          s.verifications != statistics.verifications) {
+        std::cerr << "Incorrect statistics of thread " << t
+            << " for threshold " << threshold << ": " << s.pre_candidates
+            << "/" << s.candidates << "/" << s.verifications << " instead of "
+            << statistics.pre_candidates << "/" << statistics.candidates
+            << "/" << statistics.verifications << "." << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,195 @@
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include "unit_cost_model.h"
+#include "json_label.h"
+#include "node.h"
+#include "tree_index_collection.h"
+#include "quickjedi_index.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+#include "size_window.h"
+#include "index.h"
+#include "scan.h"
+#include "lookup_test_data.h"
+
+// Type aliases.
+using Label = label::JSONLabel;
+using CostModel = cost_model::UnitCostModelJSON<Label>;
+using QUICKJEDI = json::QuickJEDITreeIndex<CostModel>;
+
+/// Converts a lookup result into sorted pairs of tree ids and distances.
+std::vector<std::tuple<int, int, double>> to_tuples(
+    const std::vector<lookup::LookupResultElement>& result_set) {
+  std::vector<std::tuple<int, int, double>> tuples;
+  for (const auto& r : result_set) {
+    // Pairs accepted by the upper bound carry the upper bound.
+    tuples.emplace_back(r.tree_id_1, r.tree_id_2,
+        r.jedi_value < 0 ? r.upper_bound : r.jedi_value);
+  }
+  std::sort(tuples.begin(), tuples.end());
+  return tuples;
+}
+
+int main() {
+
+  // The window contains the sizes within the threshold, both inclusive.
+  std::vector<std::pair<int, int>> sizes = {{1, 4}, {3, 0}, {3, 2}, {5, 1},
+      {6, 5}, {9, 3}};
+  const std::vector<std::tuple<int, double, std::size_t, std::size_t>>
+      windows = {
+    std::make_tuple(3, 0.0, 1, 3),
+    std::make_tuple(4, 1.0, 1, 4),
+    std::make_tuple(4, 1.5, 1, 4),
+    std::make_tuple(7, 1.0, 4, 5),
+    std::make_tuple(7, 2.0, 3, 6),
+    std::make_tuple(20, 3.0, 6, 6),
+    std::make_tuple(5, std::numeric_limits<double>::infinity(), 0, 6)
+  };
+  for (const auto& w : windows) {
+    auto window = lookup::get_size_window(sizes, std::get<0>(w),
+        std::get<1>(w));
+    if (window.first != std::get<2>(w) || window.second != std::get<3>(w)) {
+      std::cerr << "Incorrect size window for size " << std::get<0>(w)
+          << " and threshold " << std::get<1>(w) << ": [" << window.first
+          << ", " << window.second << ") instead of [" << std::get<2>(w)
+          << ", " << std::get<3>(w) << ")." << std::endl;
+      return -1;
+    }
+  }
+
+  // Parse, index, and convert the trees and build the inverted list.
+  lookup_test::LookupTestData<Label, QUICKJEDI> data;
+  if (!data.load()) {
+    return -1;
+  }
+  const auto& indexed_collection = data.indexed_collection;
+  auto& sets_collection = data.sets_collection;
+  auto& size_setid_map = data.size_setid_map;
+  auto& index = data.index;
+
+  // The Converter sorts the size_setid_map by tree size.
+  if (!std::is_sorted(size_setid_map.begin(), size_setid_map.end())) {
+    std::cerr << "The size_setid_map is not sorted." << std::endl;
+    return -1;
+  }
+
+  // Large thresholds make the queries smaller than the threshold. Their
+  // results have to match the ones of a scan.
+  for (double threshold : {2.0, 6.0, 12.0}) {
+    for (unsigned int q = 0; q < sets_collection.size(); ++q) {
+      lookup::VerificationUBkIndex<Label, QUICKJEDI, QUICKJEDI> index_lookup;
+      lookup::VerificationUBkScan<Label, QUICKJEDI, QUICKJEDI> scan;
+      auto index_results = to_tuples(index_lookup.execute_lookup(
+          indexed_collection, sets_collection, size_setid_map, index, q,
+          threshold));
+      auto scan_results = to_tuples(scan.execute_lookup(indexed_collection,
+          q, threshold));
+      if (index_results != scan_results) {
+        std::cerr << "Incorrect result of tree " << q << " for threshold "
+            << threshold << ": " << index_results.size() << " instead of "
+            << scan_results.size() << " results." << std::endl;
+        return -1;
+      }
+      // No candidate is outside of the size window.
+      auto window = lookup::get_size_window(size_setid_map,
+          sets_collection[q].first, threshold);
+      if (index_lookup.get_pre_candidates_count() >
+          (long long int) (window.second - window.first)) {
+        std::cerr << "Too many candidates of tree " << q << " for threshold "
+            << threshold << "." << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  // Removed trees are no candidates, also not in the size window of small
+  // queries. The results have to match the ones of a scan without them.
+  std::vector<unsigned int> live_tree_ids;
+  for (unsigned int s = 0; s < sets_collection.size(); ++s) {
+    if (s % 3 == 0) {
+      index.remove(s);
+    } else {
+      live_tree_ids.push_back(s);
+    }
+  }
+  auto without_removed = [&index](std::vector<std::tuple<int, int, double>>
+      tuples) {
+    tuples.erase(std::remove_if(tuples.begin(), tuples.end(),
+        [&index](const std::tuple<int, int, double>& t) {
+      return index.is_removed(std::get<1>(t));
+    }), tuples.end());
+    return tuples;
+  };
+  for (double threshold : {2.0, 6.0, 12.0}) {
+    std::vector<std::tuple<int, int, double>> batch_expected;
+    for (unsigned int q : live_tree_ids) {
+      lookup::VerificationUBkIndex<Label, QUICKJEDI, QUICKJEDI> index_lookup;
+      lookup::VerificationUBkScan<Label, QUICKJEDI, QUICKJEDI> scan;
+      auto index_results = to_tuples(index_lookup.execute_lookup(
+          indexed_collection, sets_collection, size_setid_map, index, q,
+          threshold));
+      auto scan_results = without_removed(to_tuples(scan.execute_lookup(
+          indexed_collection, q, threshold)));
+      if (index_results != scan_results) {
+        std::cerr << "Incorrect result of tree " << q << " for threshold "
+            << threshold << " after removals: " << index_results.size()
+            << " instead of " << scan_results.size() << " results."
+            << std::endl;
+        return -1;
+      }
+      batch_expected.insert(batch_expected.end(), scan_results.begin(),
+          scan_results.end());
+      // The top-k lookup seeds with live trees only.
+      lookup::VerificationUBkIndex<Label, QUICKJEDI, QUICKJEDI> top_k_lookup;
+      for (const auto& r : top_k_lookup.execute_top_k_lookup(
+          indexed_collection, sets_collection, size_setid_map, index, q, 3)) {
+        if (index.is_removed(r.tree_id_2)) {
+          std::cerr << "Removed tree " << r.tree_id_2 << " in the top-k "
+              << "result of tree " << q << "." << std::endl;
+          return -1;
+        }
+      }
+    }
+    lookup::VerificationUBkIndex<Label, QUICKJEDI, QUICKJEDI> batch_lookup;
+    auto batch_results = to_tuples(batch_lookup.execute_lookup_batch(
+        indexed_collection, sets_collection, size_setid_map, index,
+        live_tree_ids, threshold));
+    std::sort(batch_expected.begin(), batch_expected.end());
+    if (batch_results != batch_expected) {
+      std::cerr << "Incorrect batch result for threshold " << threshold
+          << " after removals: " << batch_results.size() << " instead of "
+          << batch_expected.size() << " results." << std::endl;
+      return -1;
+    }
+  }
+
+  // Reinserted trees are found again. The reinsertion only appends to the
+  // delta lists of the index.
+  for (unsigned int s = 0; s < sets_collection.size(); s += 3) {
+    index.insert(s, sets_collection[s]);
+  }
+  if (index.get_number_of_unmerged_postings() == 0) {
+    std::cerr << "Reinserting trees merged the index." << std::endl;
+    return -1;
+  }
+  for (unsigned int q = 0; q < sets_collection.size(); ++q) {
+    lookup::VerificationUBkIndex<Label, QUICKJEDI, QUICKJEDI> index_lookup;
+    lookup::VerificationUBkScan<Label, QUICKJEDI, QUICKJEDI> scan;
+    auto index_results = to_tuples(index_lookup.execute_lookup(
+        indexed_collection, sets_collection, size_setid_map, index, q, 6.0));
+    auto scan_results = to_tuples(scan.execute_lookup(indexed_collection, q,
+        6.0));
+    if (index_results != scan_results) {
+      std::cerr << "Incorrect result of tree " << q << " after reinserts: "
+          << index_results.size() << " instead of " << scan_results.size()
+          << " results." << std::endl;
+      return -1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include "unit_cost_model.h"
+#include "json_label.h"
+#include "node.h"
+#include "tree_index_collection.h"
+#include "quickjedi_index.h"
+#include "jofilter_index.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+#include "index.h"
+#include "scan.h"
+#include "lookup_test_data.h"
+
+// Type aliases.
+using Label = label::JSONLabel;
+using CostModel = cost_model::UnitCostModelJSON<Label>;
+using QUICKJEDI = json::QuickJEDITreeIndex<CostModel>;
+using JOFILTER = json::JOFilterTreeIndex<CostModel>;
+
+/// Compares a top-k result with the expected distances and tree ids.
+int compare_results(const std::string& name, const unsigned int query,
+    const unsigned int k,
+    const std::vector<lookup::LookupResultElement>& result,
+    const std::vector<std::pair<double, int>>& expected) {
+  std::vector<std::pair<double, int>> computed;
+  for (const auto& r : result) {
+    computed.emplace_back(r.jedi_value, r.tree_id_2);
+  }
+  if (computed != expected) {
+    std::cerr << "Incorrect " << name << " result for query " << query
+        << " and k = " << k << ":";
+    for (const auto& c : computed) {
+      std::cerr << " (" << c.first << ", " << c.second << ")";
+    }
+    std::cerr << " instead of";
+    for (const auto& e : expected) {
+      std::cerr << " (" << e.first << ", " << e.second << ")";
+    }
+    std::cerr << std::endl;
+    return -1;
+  }
+  return 0;
+}
+
+int main() {
+
+  // Parse, index, and convert the trees and build the inverted list. The
+  // top-k lookups verify with JOFilter, which is exact on the leading trees.
+  lookup_test::LookupTestData<Label, QUICKJEDI> data;
+  if (!data.load(lookup_test::kJOFilterExactTrees)) {
+    return -1;
+  }
+  const auto& indexed_collection = data.indexed_collection;
+  auto& sets_collection = data.sets_collection;
+  auto& size_setid_map = data.size_setid_map;
+  auto& index = data.index;
+
+  CostModel ucm(indexed_collection.get_label_dictionary());
+  QUICKJEDI quickjedi_algorithm(ucm);
+  const unsigned int n = indexed_collection.size();
+  for (unsigned int query = 0; query < n; query += 7) {
+    // Expected result: all distances in ascending order, ties broken by the
+    // tree id.
+    std::vector<std::pair<double, int>> all_distances;
+    for (unsigned int t = 0; t < n; ++t) {
+      all_distances.emplace_back(quickjedi_algorithm.jedi(
+          indexed_collection[query], indexed_collection[t]), t);
+    }
+    std::sort(all_distances.begin(), all_distances.end());
+
+    for (unsigned int k : {0u, 1u, 2u, 5u, 10u, n, n + 3}) {
+      std::vector<std::pair<double, int>> expected(all_distances.begin(),
+          all_distances.begin() + std::min(k, n));
+
+      lookup::VerificationScan<Label, QUICKJEDI> scan;
+      lookup::VerificationScan<Label, JOFILTER> jofilter_scan;
+      lookup::VerificationUBkScan<Label, QUICKJEDI, JOFILTER> ubk_scan;
+      lookup::VerificationIndex<Label, JOFILTER> index_lookup;
+      lookup::VerificationUBkIndex<Label, JOFILTER, QUICKJEDI> ubk_index_lookup;
+      if (compare_results("VerificationScan", query, k,
+              scan.execute_top_k_lookup(indexed_collection, query, k),
+              expected) != 0 ||
+          compare_results("VerificationScan (JOFilter)", query, k,
+              jofilter_scan.execute_top_k_lookup(indexed_collection, query, k),
+              expected) != 0 ||
+          compare_results("VerificationUBkScan", query, k,
+              ubk_scan.execute_top_k_lookup(indexed_collection, query, k),
+              expected) != 0 ||
+          compare_results("VerificationIndex", query, k,
+              index_lookup.execute_top_k_lookup(indexed_collection,
+                  sets_collection, size_setid_map, index, query, k),
+              expected) != 0 ||
+          compare_results("VerificationUBkIndex", query, k,
+              ubk_index_lookup.execute_top_k_lookup(indexed_collection,
+                  sets_collection, size_setid_map, index, query, k),
+              expected) != 0) {
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include "string_label.h"
+#include "node.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+#include "two_stage_inverted_list_map.h"
+#include "lookup_test_data.h"
+
+int main() {
+
+  // Type aliases.
+  using Label = label::StringLabel;
+  using SetsCollection = std::vector<std::pair<int,
+      std::vector<label_set_converter_index::LabelSetElement>>>;
+
+  // Parse the trees.
+  std::vector<node::Node<Label>> trees_collection;
+  if (!lookup_test::parse_trees(trees_collection)) {
+    return -1;
+  }
+
+  // Convert the trees into label sets.
+  SetsCollection sets_collection;
+  std::vector<std::pair<int, int>> size_setid_map;
+  label_set_converter_index::Converter<Label> lsc;
+  lsc.assignFrequencyIdentifiers(trees_collection, sets_collection,
+      size_setid_map);
+
+  // The map-based index is the reference.
+  lookup::TwoStageInvertedListMap map_index(lsc.get_number_of_labels());
+  map_index.build(sets_collection);
+  lookup::TwoStageInvertedList index(lsc.get_number_of_labels());
+  index.build(sets_collection);
+
+  // Look up every element of every set for different thresholds. Both
+  // indexes have to return the same candidates.
+  for (double threshold : {0.0, 0.5, 1.0, 2.0, 3.0, 5.0, 8.0, 13.0}) {
+    for (std::size_t q = 0; q < sets_collection.size(); ++q) {
+      auto& set = sets_collection[q];
+      for (auto& element : set.second) {
+        std::unordered_set<long int> map_candidates;
+        std::unordered_set<long int> candidates;
+        map_index.lookup(element.id, element.descendants, element.ancestors,
+            set.first, map_candidates, threshold);
+        index.lookup(element.id, element.descendants, element.ancestors,
+            set.first, candidates, threshold);
+        if (map_candidates != candidates) {
+          std::cerr << "Incorrect candidates of tree " << q << " for label "
+              << element.id << " and threshold " << threshold << ": "
+              << candidates.size() << " instead of " << map_candidates.size()
+              << " candidates." << std::endl;
+          return -1;
+        }
+        // A tree is always a candidate of its own elements.
+        if (candidates.count(q) == 0) {
+          std::cerr << "Tree " << q << " is not its own candidate for label "
+              << element.id << " and threshold " << threshold << "."
+              << std::endl;
+          return -1;
+        }
+      }
+    }
+  }
+
+  // Labels unknown to the index have no candidates.
+  std::unordered_set<long int> candidates;
+  long int unknown_label = lsc.get_number_of_labels();
+  int tree_size = 1;
+  index.lookup(unknown_label, 0, 0, tree_size, candidates, 1.0);
+  if (!candidates.empty()) {
+    std::cerr << "Unknown label has " << candidates.size() << " candidates."
+        << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
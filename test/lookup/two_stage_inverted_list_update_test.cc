@@ -0,0 +1,133 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include "string_label.h"
+#include "node.h"
+#include "label_set_converter.h"
+#include "two_stage_inverted_list.h"
+#include "lookup_test_data.h"
+
+using SetsCollection = std::vector<std::pair<int,
+    std::vector<label_set_converter_index::LabelSetElement>>>;
+
+/// Looks up every element of every set in both indexes for different
+/// thresholds and compares the candidates.
+int compare_indexes(const std::string& step, SetsCollection& sets_collection,
+    lookup::TwoStageInvertedList& incremental_index,
+    lookup::TwoStageInvertedList& bulk_index) {
+  for (double threshold : {0.0, 1.0, 2.0, 3.0, 5.0, 8.0, 13.0}) {
+    for (std::size_t q = 0; q < sets_collection.size(); ++q) {
+      auto& set = sets_collection[q];
+      for (auto& element : set.second) {
+        std::unordered_set<long int> bulk_candidates;
+        std::unordered_set<long int> candidates;
+        bulk_index.lookup(element.id, element.descendants, element.ancestors,
+            set.first, bulk_candidates, threshold);
+        incremental_index.lookup(element.id, element.descendants,
+            element.ancestors, set.first, candidates, threshold);
+        if (bulk_candidates != candidates) {
+          std::cerr << "Incorrect candidates " << step << " of tree " << q
+              << " for label " << element.id << " and threshold " << threshold
+              << ": " << candidates.size() << " instead of "
+              << bulk_candidates.size() << " candidates." << std::endl;
+          return -1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+int main() {
+
+  // Type aliases.
+  using Label = label::StringLabel;
+
+  // Parse the trees.
+  std::vector<node::Node<Label>> trees_collection;
+  if (!lookup_test::parse_trees(trees_collection)) {
+    return -1;
+  }
+  if (trees_collection.size() < 4) {
+    std::cerr << "Too few test trees." << std::endl;
+    return -1;
+  }
+
+  // Convert the first half of the trees in bulk, the other trees one by one.
+  // The latter contain labels that are unknown to the bulk conversion.
+  std::size_t half = trees_collection.size() / 2;
+  std::vector<node::Node<Label>> first_half(trees_collection.begin(),
+      trees_collection.begin() + half);
+  SetsCollection sets_collection;
+  std::vector<std::pair<int, int>> size_setid_map;
+  label_set_converter_index::Converter<Label> lsc;
+  lsc.assignFrequencyIdentifiers(first_half, sets_collection, size_setid_map);
+  long int bulk_labels = lsc.get_number_of_labels();
+  for (std::size_t i = half; i < trees_collection.size(); ++i) {
+    sets_collection.emplace_back();
+    lsc.convert_tree(trees_collection[i], sets_collection.back());
+  }
+  if (lsc.get_number_of_labels() == bulk_labels) {
+    std::cerr << "The test trees have no new labels." << std::endl;
+    return -1;
+  }
+
+  // Build the index on the first half and insert the remaining sets.
+  SetsCollection first_sets(sets_collection.begin(),
+      sets_collection.begin() + half);
+  lookup::TwoStageInvertedList incremental_index(bulk_labels);
+  incremental_index.build(first_sets);
+  for (std::size_t s = half; s < sets_collection.size(); ++s) {
+    incremental_index.insert(s, sets_collection[s]);
+  }
+  lookup::TwoStageInvertedList bulk_index(lsc.get_number_of_labels());
+  bulk_index.build(sets_collection);
+  if (compare_indexes("after inserts", sets_collection, incremental_index,
+      bulk_index) != 0) {
+    return -1;
+  }
+
+  // Remove every third set, from the bulk built and the inserted ones. The
+  // reference index is built without their elements.
+  SetsCollection remaining_sets = sets_collection;
+  for (std::size_t s = 0; s < sets_collection.size(); s += 3) {
+    incremental_index.remove(s);
+    remaining_sets[s].second.clear();
+  }
+  lookup::TwoStageInvertedList remaining_index(lsc.get_number_of_labels());
+  remaining_index.build(remaining_sets);
+  if (compare_indexes("after removals", sets_collection, incremental_index,
+      remaining_index) != 0) {
+    return -1;
+  }
+  incremental_index.merge();
+  if (compare_indexes("after merge", sets_collection, incremental_index,
+      remaining_index) != 0) {
+    return -1;
+  }
+
+  // Insert the removed sets again.
+  for (std::size_t s = 0; s < sets_collection.size(); s += 3) {
+    incremental_index.remove(s);
+    incremental_index.insert(s, sets_collection[s]);
+  }
+  if (compare_indexes("after reinserts", sets_collection, incremental_index,
+      bulk_index) != 0) {
+    return -1;
+  }
+
+  // Many updates trigger merges.
+  for (int round = 0; round < 200; ++round) {
+    for (std::size_t s = 0; s < sets_collection.size(); ++s) {
+      incremental_index.remove(s);
+      incremental_index.insert(s, sets_collection[s]);
+    }
+  }
+  if (compare_indexes("after many updates", sets_collection,
+      incremental_index, bulk_index) != 0) {
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,89 @@
+// The MIT License (MIT)
+// Copyright (c) 2026 tree-similarity contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include "unit_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "tree_indexer.h"
+
+// Moves an arena and a TreeIndex and reuses the moved-from objects.
+int main() {
+  using Label = label::StringLabel;
+  using CostModel = cost_model::UnitCostModelLD<Label>;
+  using LabelDictionary = label::LabelDictionary<Label>;
+
+  // Move construction and move assignment leave the source empty.
+  node::IndexArena arena;
+  node::IndexArray<int> array;
+  arena.reset(node::IndexArena::get_slice_size<int>(8));
+  arena.assign(array, 8);
+  node::IndexArena moved_arena(std::move(arena));
+  if (arena.get_capacity() != 0 || moved_arena.get_capacity() == 0) {
+    std::cerr << "Incorrect capacity after move construction." << std::endl;
+    return -1;
+  }
+  node::IndexArena assigned_arena;
+  assigned_arena = std::move(moved_arena);
+  if (moved_arena.get_capacity() != 0 || assigned_arena.get_capacity() == 0) {
+    std::cerr << "Incorrect capacity after move assignment." << std::endl;
+    return -1;
+  }
+  // The moved-from arena allocates a new buffer.
+  for (node::IndexArena* reused : {&arena, &moved_arena}) {
+    node::IndexArray<int> reused_array;
+    reused->reset(node::IndexArena::get_slice_size<int>(8));
+    reused->assign(reused_array, 8);
+    for (int i = 0; i < 8; ++i) {
+      reused_array[i] = i;
+    }
+    if (reused_array[7] != 7) {
+      std::cerr << "Incorrect value in a reused arena." << std::endl;
+      return -1;
+    }
+  }
+
+  // A moved-from TreeIndex indexes the next tree like a new one.
+  parser::BracketNotationParser<Label> bnp;
+  node::Node<Label> tree = bnp.parse_single("{a{b{c}{d}}{e}}");
+  node::Node<Label> next_tree = bnp.parse_single("{x{y}{z{w}}}");
+  LabelDictionary ld;
+  CostModel ucm(ld);
+  node::TreeIndexAll tia;
+  node::index_tree(tia, tree, ld, ucm);
+  node::TreeIndexAll moved_tia(std::move(tia));
+  node::index_tree(tia, next_tree, ld, ucm);
+  node::TreeIndexAll new_tia;
+  node::index_tree(new_tia, next_tree, ld, ucm);
+  std::vector<int> reused_sizes(tia.postl_to_size_.begin(), tia.postl_to_size_.end());
+  std::vector<int> new_sizes(new_tia.postl_to_size_.begin(), new_tia.postl_to_size_.end());
+  std::vector<int> moved_sizes(moved_tia.postl_to_size_.begin(), moved_tia.postl_to_size_.end());
+  if (reused_sizes != new_sizes || moved_sizes != std::vector<int>({1, 1, 3, 1, 5})) {
+    std::cerr << "Incorrect index of a moved or moved-from TreeIndex." << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
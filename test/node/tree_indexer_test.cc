@@ -21,104 +21,110 @@ int main(int, char** argv) {
   //       Can be done here. Only the indexes are empty.
   node::TreeIndexAll tia;
   
-  // A tree index is either a vector or vector of vectors.
+  // A per-node tree index is either an array or a list array in the index
+  // arena. The remaining indexes are vectors or maps.
   // We use a pointer because we can't use reference at this point.
-  // v_index has to point to the updated index inside the test-cases loop.
+  // a_index has to point to the updated index inside the test-cases loop.
+  node::IndexArray<int>* a_index;
+  node::IndexListArray<int>* l_index;
+  node::IndexArray<bool>* a_bool_index;
+  node::IndexArray<double>* a_double_index;
+  node::IndexArray<long long int>* a_ll_index;
   std::vector<int>* v_index;
   std::vector<std::vector<int>>* vv_index;
-  std::vector<bool>* v_bool_index;
-  std::vector<double>* v_double_index;
-  std::vector<long long int>* v_ll_index;
   std::unordered_map<int, std::vector<int>>* m_ivi_index;
   
   // Index data type:
-  const int kVInt = 0; // std::vector<int> (default)
-  const int kVVInt = 1; // std::vector<std::vector<int>>
-  const int kVBool = 2; // std::vector<bool>
-  const int kVDouble = 3; // std::vector<double>
-  const int kVLLInt = 4; // std::vector<long long int>
+  const int kAInt = 0; // node::IndexArray<int> (default)
+  const int kLInt = 1; // node::IndexListArray<int>
+  const int kABool = 2; // node::IndexArray<bool>
+  const int kADouble = 3; // node::IndexArray<double>
+  const int kALLInt = 4; // node::IndexArray<long long int>
   const int kMIntVInt = 5; // std::unordered_map<int, std::vector<int>>
-  int index_data_type = kVInt;
+  const int kVInt = 6; // std::vector<int>
+  const int kVVInt = 7; // std::vector<std::vector<int>>
+  int index_data_type = kAInt;
   // TODO: Change index_data_type in an if statement below if needed.
   
   // Get a tree index by index test name.
   if (index_test_name == "postl_to_size_test") {
-    v_index = &tia.postl_to_size_;
+    a_index = &tia.postl_to_size_;
   } else if (index_test_name == "prel_to_size_test") {
-    v_index = &tia.prel_to_size_;
+    a_index = &tia.prel_to_size_;
   } else if (index_test_name == "postl_to_parent_test") {
-    v_index = &tia.postl_to_parent_;
+    a_index = &tia.postl_to_parent_;
   } else if (index_test_name == "prel_to_parent_test") {
-    v_index = &tia.prel_to_parent_;
+    a_index = &tia.prel_to_parent_;
   } else if (index_test_name == "postl_to_prel_test") {
-    v_index = &tia.postl_to_prel_;
+    a_index = &tia.postl_to_prel_;
   } else if (index_test_name == "prel_to_postl_test") {
-    v_index = &tia.prel_to_postl_;
+    a_index = &tia.prel_to_postl_;
   } else if (index_test_name == "prel_to_prer_test") {
-    v_index = &tia.prel_to_prer_;
+    a_index = &tia.prel_to_prer_;
   } else if (index_test_name == "prer_to_prel_test") {
-    v_index = &tia.prer_to_prel_;
+    a_index = &tia.prer_to_prel_;
   } else if (index_test_name == "prel_to_postr_test") {
-    v_index = &tia.prel_to_postr_;
+    a_index = &tia.prel_to_postr_;
   } else if (index_test_name == "postr_to_prel_test") {
-    v_index = &tia.postr_to_prel_;
+    a_index = &tia.postr_to_prel_;
   } else if (index_test_name == "postl_to_children_test") {
-    vv_index = &tia.postl_to_children_;
-    index_data_type = kVVInt;
+    l_index = &tia.postl_to_children_;
+    index_data_type = kLInt;
   } else if (index_test_name == "prel_to_children_test") {
-    vv_index = &tia.prel_to_children_;
-    index_data_type = kVVInt;
+    l_index = &tia.prel_to_children_;
+    index_data_type = kLInt;
   } else if (index_test_name == "prel_to_label_id_test") {
-    v_index = &tia.prel_to_label_id_;
+    a_index = &tia.prel_to_label_id_;
   } else if (index_test_name == "postl_to_label_id_test") {
-    v_index = &tia.postl_to_label_id_;
+    a_index = &tia.postl_to_label_id_;
   } else if (index_test_name == "postr_to_label_id_test") {
-    v_index = &tia.postr_to_label_id_;
+    a_index = &tia.postr_to_label_id_;
   } else if (index_test_name == "postl_to_lld_test") {
-    v_index = &tia.postl_to_lld_;
+    a_index = &tia.postl_to_lld_;
   } else if (index_test_name == "prel_to_lld_test") {
-    v_index = &tia.prel_to_lld_;
+    a_index = &tia.prel_to_lld_;
   } else if (index_test_name == "prel_to_rld_test") {
-    v_index = &tia.prel_to_rld_;
+    a_index = &tia.prel_to_rld_;
   } else if (index_test_name == "postr_to_rld_test") {
-    v_index = &tia.postr_to_rld_;
+    a_index = &tia.postr_to_rld_;
   } else if (index_test_name == "postl_to_label_id_test") {
-    v_index = &tia.postl_to_label_id_;
+    a_index = &tia.postl_to_label_id_;
   } else if (index_test_name == "postl_to_depth_test") {
-    v_index = &tia.postl_to_depth_;
+    a_index = &tia.postl_to_depth_;
   } else if (index_test_name == "postl_to_lch_test") {
-    v_index = &tia.postl_to_lch_;
+    a_index = &tia.postl_to_lch_;
   } else if (index_test_name == "postl_to_subtree_max_depth_test") {
-    v_index = &tia.postl_to_subtree_max_depth_;
+    a_index = &tia.postl_to_subtree_max_depth_;
   } else if (index_test_name == "postl_to_kr_ancestor_test") {
-    v_index = &tia.postl_to_kr_ancestor_;
+    a_index = &tia.postl_to_kr_ancestor_;
   } else if (index_test_name == "prel_to_ln_test") {
-    v_index = &tia.prel_to_ln_;
+    a_index = &tia.prel_to_ln_;
   } else if (index_test_name == "prer_to_ln_test") {
-    v_index = &tia.prer_to_ln_;
+    a_index = &tia.prer_to_ln_;
   } else if (index_test_name == "prel_to_type_left_test") {
-    v_bool_index = &tia.prel_to_type_left_;
-    index_data_type = kVBool;
+    a_bool_index = &tia.prel_to_type_left_;
+    index_data_type = kABool;
   } else if (index_test_name == "prel_to_type_right_test") {
-    v_bool_index = &tia.prel_to_type_right_;
-    index_data_type = kVBool;
+    a_bool_index = &tia.prel_to_type_right_;
+    index_data_type = kABool;
   } else if (index_test_name == "prel_to_spf_cost_all_test") {
-    v_ll_index = &tia.prel_to_cost_all_;
-    index_data_type = kVLLInt;
+    a_ll_index = &tia.prel_to_cost_all_;
+    index_data_type = kALLInt;
   } else if (index_test_name == "prel_to_spf_cost_left_test") {
-    v_ll_index = &tia.prel_to_cost_left_;
-    index_data_type = kVLLInt;
+    a_ll_index = &tia.prel_to_cost_left_;
+    index_data_type = kALLInt;
   } else if (index_test_name == "prel_to_spf_cost_right_test") {
-    v_ll_index = &tia.prel_to_cost_right_;
-    index_data_type = kVLLInt;
+    a_ll_index = &tia.prel_to_cost_right_;
+    index_data_type = kALLInt;
   } else if (index_test_name == "prel_to_subtree_del_cost_test") {
-    v_double_index = &tia.prel_to_subtree_del_cost_;
-    index_data_type = kVDouble;
+    a_double_index = &tia.prel_to_subtree_del_cost_;
+    index_data_type = kADouble;
   } else if (index_test_name == "prel_to_subtree_ins_cost_test") {
-    v_double_index = &tia.prel_to_subtree_ins_cost_;
-    index_data_type = kVDouble;
+    a_double_index = &tia.prel_to_subtree_ins_cost_;
+    index_data_type = kADouble;
   } else if (index_test_name == "list_kr_test") {
     v_index = &tia.list_kr_;
+    index_data_type = kVInt;
   } else if (index_test_name == "inverted_list_depth_to_postl_test") {
     vv_index = &tia.inverted_list_depth_to_postl_;
     index_data_type = kVVInt;
@@ -161,38 +167,62 @@ int main(int, char** argv) {
       // Parse test tree.
       node::Node<Label> tree = bnp.parse_single(input_tree);
       
-      // Initialise label dictionary - separate dictionary for each test tree
-      // becuse it is easier to keep track of label ids.
-      LabelDictionary ld;
+      // Index the tree parsed to Node objects, then the tree parsed to a
+      // CompactTree. Both have to give the same result.
+      for (int tree_type = 0; tree_type < 2; ++tree_type) {
+        // Initialise label dictionary - separate dictionary for each test tree
+        // becuse it is easier to keep track of label ids.
+        LabelDictionary ld;
       
-      // Initialise cost model.
-      CostModel ucm(ld);
+        // Initialise cost model.
+        CostModel ucm(ld);
       
-      // Index the tree with all indexes.
-      node::index_tree(tia, tree, ld, ucm);
+        // Index the tree with all indexes.
+        if (tree_type == 0) {
+          node::index_tree(tia, tree, ld, ucm);
+        } else {
+          node::CompactTree compact_tree = bnp.parse_single(input_tree, ld);
+          node::index_tree(tia, compact_tree, ld, ucm);
+        }
       
-      // Convert the computed results based on index output type.
-      std::string computed_results;
-      switch(index_data_type) {
-        case 0 : computed_results = common::vector_to_string(*v_index);
-          break;
-        case 1 : computed_results = common::vector_to_string(*vv_index);
-          break;
-        case 2 : computed_results = common::vector_to_string(*v_bool_index);
-          break;
-        case 3 : computed_results = common::vector_to_string(*v_double_index);
-          break;
-        case 4 : computed_results = common::vector_to_string(*v_ll_index);
-          break;
-        case 5 : computed_results = common::map_to_string(*m_ivi_index);
-          break;
-      }
+        // Convert the computed results based on index output type.
+        std::string computed_results;
+        switch(index_data_type) {
+          case 0 : computed_results = common::vector_to_string(
+                std::vector<int>(a_index->begin(), a_index->end()));
+            break;
+          case 1 : {
+            std::vector<std::vector<int>> lists;
+            for (std::size_t i = 0; i < l_index->size(); ++i) {
+              auto list = (*l_index)[i];
+              lists.emplace_back(list.begin(), list.end());
+            }
+            computed_results = common::vector_to_string(lists);
+            break;
+          }
+          case 2 : computed_results = common::vector_to_string(
+                std::vector<bool>(a_bool_index->begin(), a_bool_index->end()));
+            break;
+          case 3 : computed_results = common::vector_to_string(
+                std::vector<double>(a_double_index->begin(), a_double_index->end()));
+            break;
+          case 4 : computed_results = common::vector_to_string(
+                std::vector<long long int>(a_ll_index->begin(), a_ll_index->end()));
+            break;
+          case 5 : computed_results = common::map_to_string(*m_ivi_index);
+            break;
+          case 6 : computed_results = common::vector_to_string(*v_index);
+            break;
+          case 7 : computed_results = common::vector_to_string(*vv_index);
+            break;
+        }
       
-      if (correct_result != computed_results) {
-        std::cerr << "Incorrect " + index_test_name + " result: " <<
-            computed_results << " instead of " << correct_result << std::endl;
-        std::cerr << "Input: " <<  input_tree << std::endl;
-        return -1;
+        if (correct_result != computed_results) {
+          std::cerr << "Incorrect " + index_test_name + " result: " <<
+              computed_results << " instead of " << correct_result << std::endl;
+          std::cerr << "Input: " <<  input_tree << (tree_type == 0 ? "" : " (CompactTree)") << std::endl;
+          return -1;
+        }
       }
     }
   }
@@ -0,0 +1,147 @@
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "binary_collection.h"
+#include "tree_indexer.h"
+#include "tree_index_collection.h"
+#include "unit_cost_model.h"
+
+int main() {
+  using Label = label::StringLabel;
+  using CostModel = cost_model::UnitCostModelLD<Label>;
+  using TreeIndexCollection = node::TreeIndexCollection<Label, node::TreeIndexAll>;
+
+  std::string file_path = "parser_binary_collection_test_data.txt";
+  std::string binary_file_path = "parser_binary_collection_test_data.bin";
+
+  // Parse the collection and write it in the binary format.
+  std::vector<node::Node<Label>> trees_collection;
+  parser::BracketNotationParser<Label> bnp;
+  bnp.parse_collection(trees_collection, file_path);
+  parser::BinaryCollection<Label>::write(trees_collection, binary_file_path);
+
+  parser::BinaryCollection<Label> binary_collection(binary_file_path);
+  if (binary_collection.get_number_of_trees() != trees_collection.size()) {
+    std::cerr << "Incorrect number of trees in binary collection: " << binary_collection.get_number_of_trees() << " instead of " << trees_collection.size() << std::endl;
+    return -1;
+  }
+
+  // The trees read back have to equal the parsed trees.
+  std::vector<node::Node<Label>> loaded_trees_collection;
+  binary_collection.get_trees(loaded_trees_collection);
+  for (std::size_t i = 0; i < trees_collection.size(); ++i) {
+    if (binary_collection.get_tree_size(i) != trees_collection[i].get_tree_size()) {
+      std::cerr << "Incorrect size of tree " << i << " in binary collection: " << binary_collection.get_tree_size(i) << " instead of " << trees_collection[i].get_tree_size() << std::endl;
+      return -1;
+    }
+    if (loaded_trees_collection[i].get_all_labels() != trees_collection[i].get_all_labels() ||
+        binary_collection.get_tree(i).get_all_labels() != trees_collection[i].get_all_labels()) {
+      std::cerr << "Incorrect labels of tree " << i << " read from binary collection." << std::endl;
+      return -1;
+    }
+  }
+
+  // The indexes built from the binary collection have to equal the indexes
+  // built from the parsed trees, and the stored arrays have to equal the
+  // corresponding indexes.
+  TreeIndexCollection parsed_indexes;
+  CostModel parsed_cm(parsed_indexes.get_label_dictionary());
+  parsed_indexes.build(trees_collection, parsed_cm);
+  TreeIndexCollection binary_indexes;
+  CostModel binary_cm(binary_indexes.get_label_dictionary());
+  binary_collection.build_indexes(binary_indexes, binary_cm);
+  for (std::size_t i = 0; i < trees_collection.size(); ++i) {
+    const node::TreeIndexAll& parsed_index = parsed_indexes[i];
+    const node::TreeIndexAll& binary_index = binary_indexes[i];
+    const std::int32_t* postl_to_label_id = binary_collection.get_postl_to_label_id(i);
+    const std::int32_t* postl_to_parent = binary_collection.get_postl_to_parent(i);
+    for (int postl = 0; postl < binary_collection.get_tree_size(i); ++postl) {
+      std::string parsed_label = parsed_indexes.get_label_dictionary().get(
+          parsed_index.postl_to_label_id_[postl]).to_string();
+      if (binary_collection.get_label_string(postl_to_label_id[postl]) != parsed_label ||
+          binary_index.postl_to_label_id_[postl] != postl_to_label_id[postl]) {
+        std::cerr << "Incorrect label of node " << postl << " of tree " << i << " in binary collection." << std::endl;
+        return -1;
+      }
+      if (postl_to_parent[postl] != parsed_index.postl_to_parent_[postl] ||
+          binary_index.postl_to_parent_[postl] != parsed_index.postl_to_parent_[postl] ||
+          binary_index.postl_to_size_[postl] != parsed_index.postl_to_size_[postl]) {
+        std::cerr << "Incorrect structure of node " << postl << " of tree " << i << " in binary collection." << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  // Corrupt copies of the binary file have to be rejected. Section
+  // positions as in the format description.
+  std::ifstream binary_file(binary_file_path, std::ios::binary);
+  const std::string binary_bytes((std::istreambuf_iterator<char>(binary_file)),
+      std::istreambuf_iterator<char>());
+  parser::BinaryCollectionHeader header;
+  std::memcpy(&header, binary_bytes.data(), sizeof(header));
+  auto align = [](const std::size_t bytes) { return (bytes + 7) / 8 * 8; };
+  const std::size_t tree_offsets_position = align(sizeof(header)) +
+      align((header.number_of_labels + 1) * sizeof(std::uint64_t)) +
+      align(header.label_bytes);
+  const std::size_t label_ids_position = tree_offsets_position +
+      align((header.number_of_trees + 1) * sizeof(std::uint64_t));
+  const std::size_t parents_position = label_ids_position +
+      align(header.number_of_nodes * sizeof(std::int32_t));
+  std::string corrupt_file_path = "parser_binary_collection_test_corrupt.bin";
+  // Writes value at position into a copy of the binary file and expects the
+  // copy to be rejected.
+  auto rejects = [&](const std::size_t position, const void* value,
+      const std::size_t bytes, const std::string& corruption) {
+    std::string corrupt_bytes = binary_bytes;
+    std::memcpy(&corrupt_bytes[position], value, bytes);
+    std::ofstream(corrupt_file_path, std::ios::binary | std::ios::trunc) <<
+        corrupt_bytes;
+    try {
+      parser::BinaryCollection<Label> corrupt_collection(corrupt_file_path);
+      std::cerr << "A binary collection with " << corruption << " was accepted." << std::endl;
+      return false;
+    } catch (const std::runtime_error&) {}
+    return true;
+  };
+  // The second tree starts where the first one starts, i.e., the first tree
+  // has no nodes.
+  const std::uint64_t zero_offset = 0;
+  // The first node gets a label id beyond the labels and the root of the
+  // first tree gets a parent.
+  const std::int32_t large_id = static_cast<std::int32_t>(header.number_of_labels);
+  const std::int32_t root_parent = 0;
+  const std::size_t root_position = parents_position +
+      (binary_collection.get_tree_size(0) - 1) * sizeof(std::int32_t);
+  if (!rejects(tree_offsets_position + sizeof(std::uint64_t), &zero_offset,
+          sizeof(zero_offset), "an empty tree") ||
+      !rejects(label_ids_position, &large_id, sizeof(large_id),
+          "a label id out of range") ||
+      !rejects(root_position, &root_parent, sizeof(root_parent),
+          "a root with a parent")) {
+    return -1;
+  }
+  // A truncated file.
+  std::ofstream(corrupt_file_path, std::ios::binary | std::ios::trunc) <<
+      binary_bytes.substr(0, parents_position);
+  try {
+    parser::BinaryCollection<Label> corrupt_collection(corrupt_file_path);
+    std::cerr << "A truncated binary collection was accepted." << std::endl;
+    return -1;
+  } catch (const std::runtime_error&) {}
+
+  // A file in another format has to be rejected.
+  try {
+    parser::BinaryCollection<Label> text_collection(file_path);
+    std::cerr << "A text file was accepted as a binary collection." << std::endl;
+    return -1;
+  } catch (const std::runtime_error&) {}
+
+  return 0;
+}
@@ -37,5 +37,22 @@ int main() {
     return -1;
   }
 
+  // Parse the collection with multiple threads. The trees have to come in the
+  // same order.
+  std::vector<node::Node<Label>> parallel_trees_collection;
+  bnp.parse_collection(parallel_trees_collection, file_path, 4);
+
+  if (trees_collection.size() != parallel_trees_collection.size()) {
+    std::cerr << "Incorrect number of trees in collection parsed in parallel: " << parallel_trees_collection.size() << " instead of " << trees_collection.size() << std::endl;
+    return -1;
+  }
+
+  for (std::size_t i = 0; i < trees_collection.size(); ++i) {
+    if (trees_collection[i].get_all_labels() != parallel_trees_collection[i].get_all_labels()) {
+      std::cerr << "Incorrect tree " << i << " in collection parsed in parallel." << std::endl;
+      return -1;
+    }
+  }
+
   return 0;
 }